@@ -49,6 +49,13 @@ __nsec ukplat_time_get_ticks(void);
 __nsec ukplat_monotonic_clock(void);
 __nsec ukplat_wall_clock(void);
 
+/*
+ * Raises the timer interrupt once the monotonic clock reaches `until`, right
+ * away if it already has. Replaces the previous alarm, also the one used by
+ * ukplat_lcpu_halt_to(). Only platforms with HAVE_TIME_ALARM provide it.
+ */
+void ukplat_time_set_alarm(__nsec until);
+
 /* Time tick length */
 #define UKPLAT_TIME_TICK_NSEC  (UKARCH_NSEC_PER_SEC / CONFIG_HZ)
 #define UKPLAT_TIME_TICK_MSEC  ukarch_time_nsec_to_msec(UKPLAT_TIME_TICK_NSEC)
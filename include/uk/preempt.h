@@ -34,7 +34,74 @@
 #ifndef __UK_PREEMPT_H__
 #define __UK_PREEMPT_H__
 
+#include <uk/config.h>
+#include <uk/arch/lcpu.h>
+#include <uk/arch/time.h>
+
+#if CONFIG_HAVE_SCHED_PREEMPT
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * A preemptive scheduler never switches threads from an interrupt, but
+ * only at safe points: when the running thread blocks or yields, returns
+ * from a system call, or re-enables preemption. The scheduler sets
+ * uk_preempt_deadline to the end of the running thread's time slice or the
+ * next wake-up of a sleeping thread, whichever comes first, and arms the
+ * platform's one-shot timer for it. The timer interrupt only calls
+ * uk_preempt_tick(), which raises uk_preempt_pending once the deadline is
+ * reached. The scheduler also raises it when a thread with a higher
+ * priority becomes runnable. Safe points test nothing but these two
+ * variables.
+ */
+extern unsigned int uk_preempt_count;
+extern volatile int uk_preempt_pending;
+extern __snsec uk_preempt_deadline;
+
+void uk_preempt_schedule(void);
+
+/*
+ * Called by the platform from its timer interrupt. It must neither switch
+ * threads nor touch the extended registers of the interrupted thread.
+ */
+static inline void uk_preempt_tick(__snsec now)
+{
+	if (now >= uk_preempt_deadline)
+		uk_preempt_pending = 1;
+}
+
+static inline void uk_preempt_point(void)
+{
+	if (uk_preempt_count == 0 && uk_preempt_pending)
+		uk_preempt_schedule();
+}
+
+#define uk_preempt_disable()			\
+	do {					\
+		uk_preempt_count++;		\
+		barrier();			\
+	} while (0)
+
+#define uk_preempt_enable()			\
+	do {					\
+		barrier();			\
+		if (--uk_preempt_count == 0)	\
+			uk_preempt_point();	\
+	} while (0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#else /* CONFIG_HAVE_SCHED_PREEMPT */
+
+#define uk_preempt_tick(now)  do { } while (0)
+#define uk_preempt_point()    do { } while (0)
 #define uk_preempt_disable()  barrier()
 #define uk_preempt_enable()   barrier()
 
+#endif /* CONFIG_HAVE_SCHED_PREEMPT */
+
 #endif /* __UK_PREEMPT_H__ */
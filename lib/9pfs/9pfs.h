@@ -40,10 +40,13 @@
 #include <vfscore/prex.h>
 
 /*
- * Currently supports only the 9P2000.u variant of the protocol.
+ * Supported variants of the protocol. 9P2000.L replaces the string-based
+ * stat messages with fixed-size ones and lists directories with
+ * TREADDIR, which needs fewer and smaller round-trips.
  */
 enum uk_9pfs_proto {
 	UK_9P_PROTO_2000U,
+	UK_9P_PROTO_2000L,
 	UK_9P_PROTO_MAX
 };
 
@@ -54,6 +57,10 @@ struct uk_9pfs_mount_data {
 	struct uk_9pdev_trans	*trans;
 	/* Protocol version used. */
 	enum uk_9pfs_proto	proto;
+	/* Was the protocol version given in the mount options? */
+	bool			proto_set;
+	/* Cache file data in the vfscore page cache? */
+	bool			cache;
 	/* Username to attempt to mount as on the remote server. */
 	const char		*uname;
 	/* File tree to access when offered multiple exported filesystems. */
@@ -80,6 +87,9 @@ struct uk_9pfs_file_data {
 struct uk_9pfs_node_data {
 	/* Fid associated with the vfs node. */
 	struct uk_9pfid        *fid;
+	/* Opened fids for reading and writing back cached pages. */
+	struct uk_9pfid        *rd_fid;
+	struct uk_9pfid        *wr_fid;
 	/* Number of files opened from the vfs node. */
 	int                    nb_open_files;
 	/* Is a 9P remove call required when nb_open_files reaches 0? */
@@ -96,5 +106,6 @@ void uk_9pfs_free_vnode_data(struct vnode *vp);
 #define UK_9PFS_ND(vnode) ((struct uk_9pfs_node_data *) (vnode)->v_data)
 #define UK_9PFS_VFID(vnode) (UK_9PFS_ND(vnode)->fid)
 #define UK_9PFS_MD(mount) ((struct uk_9pfs_mount_data *) (mount)->m_data)
+#define UK_9PFS_DOTL(mount) (UK_9PFS_MD(mount)->proto == UK_9P_PROTO_2000L)
 
 #endif /* __UK_9PFS__ */
@@ -37,6 +37,8 @@
 #include <vfscore/mount.h>
 #include <vfscore/dentry.h>
 #include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
 
 #include "9pfs.h"
 
@@ -47,9 +49,10 @@ static int uk_9pfs_mount(struct mount *mp, const char *dev, int flags,
 
 static int uk_9pfs_unmount(struct mount *mp, int flags);
 
+static int uk_9pfs_statfs(struct mount *mp, struct statfs *sfp);
+
 #define uk_9pfs_sync		((vfsop_sync_t)vfscore_nullop)
 #define uk_9pfs_vget		((vfsop_vget_t)vfscore_nullop)
-#define uk_9pfs_statfs		((vfsop_statfs_t)vfscore_nullop)
 
 struct vfsops uk_9pfs_vfsops = {
 	.vfs_mount	= uk_9pfs_mount,
@@ -69,11 +72,93 @@ static struct vfscore_fs_type uk_9pfs_fs = {
 UK_FS_REGISTER(uk_9pfs_fs);
 
 static const char *uk_9pfs_proto_str[UK_9P_PROTO_MAX] = {
-	[UK_9P_PROTO_2000U] = "9P2000.u"
+	[UK_9P_PROTO_2000U] = "9P2000.u",
+	[UK_9P_PROTO_2000L] = "9P2000.L"
 };
 
+#define UK_9PFS_OPT_VERSION	"version="
+#define UK_9PFS_OPT_CACHE	"cache="
+
+/* Case-insensitive, Linux spells the versions 9p2000.u and 9p2000.L. */
+static int uk_9pfs_opt_equal(const char *opt, size_t len, const char *name)
+{
+	size_t i;
+
+	if (strlen(name) != len)
+		return 0;
+	for (i = 0; i < len; i++)
+		if (tolower(opt[i]) != tolower(name[i]))
+			return 0;
+	return 1;
+}
+
+/* If opt starts with prefix, skips it and returns 1 */
+static int uk_9pfs_opt_prefix(const char **opt, size_t *len,
+		const char *prefix)
+{
+	size_t plen = strlen(prefix);
+
+	if (*len < plen || strncmp(*opt, prefix, plen))
+		return 0;
+
+	*opt += plen;
+	*len -= plen;
+	return 1;
+}
+
+/*
+ * Looks for version=<proto> and cache=none|loose in the comma-separated
+ * mount options, other options are left to the transport.
+ */
+static int uk_9pfs_parse_opts(struct uk_9pfs_mount_data *md,
+		const char *opts)
+{
+	const char *opt, *end;
+	size_t len;
+	int i;
+
+	for (opt = opts; opt && *opt; opt = end) {
+		end = strchr(opt, ',');
+		if (!end)
+			end = opt + strlen(opt);
+		len = end - opt;
+		if (*end)
+			end++;
+
+		if (uk_9pfs_opt_prefix(&opt, &len, UK_9PFS_OPT_CACHE)) {
+			if (uk_9pfs_opt_equal(opt, len, "none")) {
+				md->cache = false;
+			} else if (uk_9pfs_opt_equal(opt, len, "loose")) {
+				md->cache = true;
+			} else {
+				uk_pr_err("Unsupported 9pfs cache mode %.*s\n",
+					  (int)len, opt);
+				return EINVAL;
+			}
+			continue;
+		}
+
+		if (!uk_9pfs_opt_prefix(&opt, &len, UK_9PFS_OPT_VERSION))
+			continue;
+
+		for (i = 0; i < UK_9P_PROTO_MAX; i++) {
+			if (uk_9pfs_opt_equal(opt, len, uk_9pfs_proto_str[i]))
+				break;
+		}
+		if (i == UK_9P_PROTO_MAX) {
+			uk_pr_err("Unsupported 9P protocol version %.*s\n",
+				  (int)len, opt);
+			return EINVAL;
+		}
+		md->proto = i;
+		md->proto_set = true;
+	}
+
+	return 0;
+}
+
 static int uk_9pfs_parse_options(struct uk_9pfs_mount_data *md,
-		const void *data __unused)
+		const void *data)
 {
 	int rc = 0;
 
@@ -81,24 +166,49 @@ static int uk_9pfs_parse_options(struct uk_9pfs_mount_data *md,
 	if (!md->trans)
 		goto out;
 
-	/* Currently, no options are supported. */
-
+#if CONFIG_LIB9PFS_PROTO_2000U
 	md->proto = UK_9P_PROTO_2000U;
+#else
+	md->proto = UK_9P_PROTO_2000L;
+#endif
+	md->proto_set = false;
+#ifdef CONFIG_LIBVFSCORE_PAGECACHE
+	md->cache = true;
+#else
+	md->cache = false;
+#endif
 	md->uname = "";
 	md->aname = "";
 
+	rc = uk_9pfs_parse_opts(md, data);
+
 out:
 	return rc;
 }
 
+static int uk_9pfs_negotiate_version(struct uk_9pfs_mount_data *md)
+{
+	struct uk_9preq *version_req;
+	struct uk_9p_str rcvd_version;
+	int version_accepted;
+
+	version_req = uk_9p_version(md->dev, uk_9pfs_proto_str[md->proto],
+			&rcvd_version);
+	if (PTRISERR(version_req))
+		return -PTR2ERR(version_req);
+
+	version_accepted = uk_9p_str_equal(&rcvd_version,
+			uk_9pfs_proto_str[md->proto]);
+	uk_9pdev_req_remove(md->dev, version_req);
+
+	return version_accepted ? 0 : EPROTONOSUPPORT;
+}
+
 static int uk_9pfs_mount(struct mount *mp, const char *dev,
 			int flags __unused, const void *data)
 {
 	struct uk_9pfs_mount_data *md;
-	struct uk_9preq *version_req;
-	struct uk_9p_str rcvd_version;
 	struct uk_9pfid *rootfid;
-	int version_accepted;
 	int rc;
 
 	/* Set data as null, vnop_inactive() checks this for the root fid. */
@@ -122,24 +232,27 @@ static int uk_9pfs_mount(struct mount *mp, const char *dev,
 		goto out_free_mdata;
 	}
 
-	/* Create a new 9pfs session via a VERSION message. */
-	version_req = uk_9p_version(md->dev, uk_9pfs_proto_str[md->proto],
-			&rcvd_version);
-	if (PTRISERR(version_req)) {
-		rc = -PTR2ERR(version_req);
-		goto out_disconnect;
+	/*
+	 * Create a new 9pfs session via a VERSION message. Unless the mount
+	 * options asked for 9P2000.L explicitly, fall back to 9P2000.u for
+	 * servers that do not implement it.
+	 */
+	rc = uk_9pfs_negotiate_version(md);
+	if (rc == EPROTONOSUPPORT && !md->proto_set &&
+	    md->proto == UK_9P_PROTO_2000L) {
+		uk_pr_info("Server does not offer %s, trying %s\n",
+			   uk_9pfs_proto_str[UK_9P_PROTO_2000L],
+			   uk_9pfs_proto_str[UK_9P_PROTO_2000U]);
+		md->proto = UK_9P_PROTO_2000U;
+		rc = uk_9pfs_negotiate_version(md);
 	}
-
-	version_accepted = uk_9p_str_equal(&rcvd_version,
-			uk_9pfs_proto_str[md->proto]);
-	uk_9pdev_req_remove(md->dev, version_req);
-
-	if (!version_accepted) {
+	if (rc == EPROTONOSUPPORT) {
 		rc = EIO;
 		uk_pr_warn("Could not negotiate protocol %s\n",
 				uk_9pfs_proto_str[md->proto]);
-		goto out_disconnect;
 	}
+	if (rc)
+		goto out_disconnect;
 
 	/* Create root fid. */
 	rootfid = uk_9p_attach(md->dev, UK_9P_NOFID, md->uname,
@@ -185,3 +298,32 @@ static int uk_9pfs_unmount(struct mount *mp, int flags __unused)
 
 	return 0;
 }
+
+static int uk_9pfs_statfs(struct mount *mp, struct statfs *sfp)
+{
+	struct uk_9pfs_mount_data *md = UK_9PFS_MD(mp);
+	struct uk_9p_statfs st;
+	int rc;
+
+	/* 9P2000.u has no way to query the file system. */
+	if (!UK_9PFS_DOTL(mp))
+		return 0;
+
+	rc = uk_9p_statfs(md->dev, UK_9PFS_VFID(mp->m_root->d_vnode), &st);
+	if (rc)
+		return -rc;
+
+	sfp->f_type = st.type;
+	sfp->f_bsize = st.bsize;
+	sfp->f_blocks = st.blocks;
+	sfp->f_bfree = st.bfree;
+	sfp->f_bavail = st.bavail;
+	sfp->f_files = st.files;
+	sfp->f_ffree = st.ffree;
+	sfp->f_fsid.__val[0] = (int)st.fsid;
+	sfp->f_fsid.__val[1] = (int)(st.fsid >> 32);
+	sfp->f_namelen = st.namelen;
+	sfp->f_frsize = st.bsize;
+
+	return 0;
+}
@@ -43,6 +43,7 @@
 #include <vfscore/vnode.h>
 #include <vfscore/file.h>
 #include <vfscore/fs.h>
+#include <vfscore/pagecache.h>
 
 #include "9pfs.h"
 
@@ -81,6 +82,17 @@ static int uk_9pfs_posix_perm_from_mode(int mode)
 	return res;
 }
 
+static uint32_t uk_9pfs_lopen_flags_from_posix_flags(int flags)
+{
+	uint32_t flags_rw = flags & (UK_FREAD | UK_FWRITE);
+
+	if (flags_rw == UK_FWRITE)
+		return UK_9P_L_O_WRONLY;
+	if (flags_rw == (UK_FREAD | UK_FWRITE))
+		return UK_9P_L_O_RDWR;
+	return UK_9P_L_O_RDONLY;
+}
+
 static uint32_t uk_9pfs_perm_from_posix_mode(mode_t mode)
 {
 	int res;
@@ -120,11 +132,47 @@ static int uk_9pfs_vtype_from_mode(int mode)
 	return VREG;
 }
 
+static int uk_9pfs_vtype_from_posix_mode(mode_t mode)
+{
+	switch (mode & S_IFMT) {
+	case S_IFDIR:
+		return VDIR;
+	case S_IFLNK:
+		return VLNK;
+	case S_IFCHR:
+		return VCHR;
+	case S_IFBLK:
+		return VBLK;
+	case S_IFIFO:
+		return VFIFO;
+	case S_IFSOCK:
+		return VSOCK;
+	default:
+		return VREG;
+	}
+}
+
 static uint64_t uk_9pfs_ino(struct uk_9p_stat *stat)
 {
 	return stat->qid.path;
 }
 
+static int uk_9pfs_stat_dotl(struct uk_9pdev *dev, struct uk_9pfid *fid,
+		struct uk_9p_attr *attr)
+{
+	int rc;
+
+	rc = uk_9p_getattr(dev, fid, UK_9P_GETATTR_BASIC, attr);
+	if (rc)
+		return rc;
+
+	/* Without a type, the node cannot be set up. */
+	if (!(attr->valid & UK_9P_GETATTR_MODE))
+		return -EIO;
+
+	return 0;
+}
+
 int uk_9pfs_allocate_vnode_data(struct vnode *vp, struct uk_9pfid *fid)
 {
 	struct uk_9pfs_node_data *nd;
@@ -134,6 +182,8 @@ int uk_9pfs_allocate_vnode_data(struct vnode *vp, struct uk_9pfid *fid)
 		return -ENOMEM;
 
 	nd->fid = fid;
+	nd->rd_fid = NULL;
+	nd->wr_fid = NULL;
 	nd->nb_open_files = 0;
 	nd->removed = false;
 	vp->v_data = nd;
@@ -149,6 +199,11 @@ void uk_9pfs_free_vnode_data(struct vnode *vp)
 	if (!vp->v_data)
 		return;
 
+	if (nd->rd_fid)
+		uk_9pfid_put(nd->rd_fid);
+	if (nd->wr_fid)
+		uk_9pfid_put(nd->wr_fid);
+
 	if (nd->removed)
 		uk_9p_remove(dev, nd->fid);
 
@@ -178,8 +233,12 @@ static int uk_9pfs_open(struct vfscore_file *file)
 	}
 
 	/* Open cloned fid. */
-	rc = uk_9p_open(dev, openedfid,
-		uk_9pfs_open_mode_from_posix_flags(file->f_flags));
+	if (UK_9PFS_DOTL(file->f_dentry->d_mount))
+		rc = uk_9p_lopen(dev, openedfid,
+			uk_9pfs_lopen_flags_from_posix_flags(file->f_flags));
+	else
+		rc = uk_9p_open(dev, openedfid,
+			uk_9pfs_open_mode_from_posix_flags(file->f_flags));
 
 	if (rc)
 		goto out_err;
@@ -211,14 +270,111 @@ static int uk_9pfs_close(struct vnode *vn __unused, struct vfscore_file *file)
 	return 0;
 }
 
+/*
+ * Returns the fid that is opened for reading or writing on behalf of the
+ * vnode itself (page cache fills and write-back, uncached writes). It is
+ * opened on first use and clunked with the vnode data.
+ */
+static struct uk_9pfid *uk_9pfs_io_fid(struct vnode *vp, int write)
+{
+	struct uk_9pdev *dev = UK_9PFS_MD(vp->v_mount)->dev;
+	struct uk_9pfs_node_data *nd = UK_9PFS_ND(vp);
+	struct uk_9pfid **fidp = write ? &nd->wr_fid : &nd->rd_fid;
+	struct uk_9pfid *fid;
+	int rc;
+
+	if (*fidp)
+		return *fidp;
+
+	fid = uk_9p_walk(dev, nd->fid, NULL);
+	if (PTRISERR(fid))
+		return fid;
+
+	if (UK_9PFS_DOTL(vp->v_mount))
+		rc = uk_9p_lopen(dev, fid, write ? UK_9P_L_O_WRONLY
+					  : UK_9P_L_O_RDONLY);
+	else
+		rc = uk_9p_open(dev, fid, write ? UK_9P_OWRITE : UK_9P_OREAD);
+	if (rc) {
+		uk_9pfid_put(fid);
+		return ERR2PTR(rc);
+	}
+
+	*fidp = fid;
+	return fid;
+}
+
+/*
+ * Transfers the whole uio through an opened fid, with multiple requests in
+ * flight for large transfers. Stops early only at the end of the file (for
+ * reads). Returns 0 or a positive errno.
+ */
+static int uk_9pfs_fid_io(struct uk_9pdev *dev, struct uk_9pfid *fid,
+			  struct uio *uio)
+{
+	struct iovec *iov;
+	size_t left, len;
+	int64_t rc;
+
+	while (uio->uio_resid > 0) {
+		UK_ASSERT(uio->uio_iovcnt > 0);
+		if (uio->uio_rw == UIO_READ)
+			rc = uk_9p_readv(dev, fid, uio->uio_offset,
+					 uio->uio_iov, uio->uio_iovcnt);
+		else
+			rc = uk_9p_writev(dev, fid, uio->uio_offset,
+					  uio->uio_iov, uio->uio_iovcnt);
+		if (rc < 0)
+			return -rc;
+		if (rc == 0)
+			return (uio->uio_rw == UIO_READ) ? 0 : EIO;
+
+		uio->uio_resid -= rc;
+		uio->uio_offset += rc;
+		for (left = rc; left > 0; ) {
+			iov = uio->uio_iov;
+			len = MIN(left, iov->iov_len);
+			iov->iov_base = (char *)iov->iov_base + len;
+			iov->iov_len -= len;
+			left -= len;
+			if (!iov->iov_len) {
+				uio->uio_iov++;
+				uio->uio_iovcnt--;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int uk_9pfs_pcache_io(struct vnode *vp, struct uio *uio)
+{
+	struct uk_9pdev *dev = UK_9PFS_MD(vp->v_mount)->dev;
+	struct uk_9pfid *fid;
+
+	fid = uk_9pfs_io_fid(vp, uio->uio_rw == UIO_WRITE);
+	if (PTRISERR(fid))
+		return -PTR2ERR(fid);
+
+	return uk_9pfs_fid_io(dev, fid, uio);
+}
+
+static const struct vfscore_pcache_ops uk_9pfs_pcache_ops = {
+	.pco_read  = uk_9pfs_pcache_io,
+	.pco_write = uk_9pfs_pcache_io,
+};
+
 static int uk_9pfs_lookup(struct vnode *dvp, char *name, struct vnode **vpp)
 {
 	struct uk_9pdev *dev = UK_9PFS_MD(dvp->v_mount)->dev;
 	struct uk_9pfid *dfid = UK_9PFS_VFID(dvp);
 	struct uk_9pfid *fid;
 	struct uk_9p_stat stat;
+	struct uk_9p_attr attr;
 	struct uk_9preq *stat_req;
 	struct vnode *vp;
+	uint64_t ino;
+	int dotl = UK_9PFS_DOTL(dvp->v_mount);
 	int rc;
 
 	if (strlen(name) > NAME_MAX)
@@ -230,16 +386,24 @@ static int uk_9pfs_lookup(struct vnode *dvp, char *name, struct vnode **vpp)
 		goto out;
 	}
 
-	stat_req = uk_9p_stat(dev, fid, &stat);
-	if (PTRISERR(stat_req)) {
-		rc = PTR2ERR(stat_req);
-		goto out_fid;
-	}
+	if (dotl) {
+		rc = uk_9pfs_stat_dotl(dev, fid, &attr);
+		if (rc)
+			goto out_fid;
+		ino = attr.qid.path;
+	} else {
+		stat_req = uk_9p_stat(dev, fid, &stat);
+		if (PTRISERR(stat_req)) {
+			rc = PTR2ERR(stat_req);
+			goto out_fid;
+		}
 
-	/* No stat string fields are used below. */
-	uk_9pdev_req_remove(dev, stat_req);
+		/* No stat string fields are used below. */
+		uk_9pdev_req_remove(dev, stat_req);
+		ino = uk_9pfs_ino(&stat);
+	}
 
-	if (vfscore_vget(dvp->v_mount, uk_9pfs_ino(&stat), &vp)) {
+	if (vfscore_vget(dvp->v_mount, ino, &vp)) {
 		/* Already in cache. */
 		rc = 0;
 		*vpp = vp;
@@ -254,14 +418,23 @@ static int uk_9pfs_lookup(struct vnode *dvp, char *name, struct vnode **vpp)
 	}
 
 	vp->v_flags = 0;
-	vp->v_mode = uk_9pfs_posix_mode_from_mode(stat.mode);
-	vp->v_type = uk_9pfs_vtype_from_mode(stat.mode);
-	vp->v_size = stat.length;
+	if (dotl) {
+		vp->v_mode = attr.mode;
+		vp->v_type = uk_9pfs_vtype_from_posix_mode(attr.mode);
+		vp->v_size = attr.size;
+	} else {
+		vp->v_mode = uk_9pfs_posix_mode_from_mode(stat.mode);
+		vp->v_type = uk_9pfs_vtype_from_mode(stat.mode);
+		vp->v_size = stat.length;
+	}
 
 	rc = uk_9pfs_allocate_vnode_data(vp, fid);
 	if (rc != 0)
 		goto out_fid;
 
+	if (vp->v_type == VREG && UK_9PFS_MD(dvp->v_mount)->cache)
+		vfscore_pcache_init(vp, &uk_9pfs_pcache_ops);
+
 	*vpp = vp;
 
 	return 0;
@@ -284,16 +457,30 @@ static int uk_9pfs_create_generic(struct vnode *dvp, char *name, mode_t mode)
 {
 	struct uk_9pdev *dev = UK_9PFS_MD(dvp->v_mount)->dev;
 	struct uk_9pfid *fid;
+	struct uk_9p_qid qid;
 	int rc;
 
 	if (strlen(name) > NAME_MAX)
 		return ENAMETOOLONG;
 
+	/* Directories are not created through a fid in 9P2000.L. */
+	if (UK_9PFS_DOTL(dvp->v_mount) && S_ISDIR(mode))
+		return -uk_9p_mkdir(dev, UK_9PFS_VFID(dvp), name,
+				    mode & 07777, 0, &qid);
+
 	/* Clone parent fid. */
 	fid = uk_9p_walk(dev, UK_9PFS_VFID(dvp), NULL);
+	if (PTRISERR(fid))
+		return -PTR2ERR(fid);
 
-	rc = uk_9p_create(dev, fid, name, uk_9pfs_perm_from_posix_mode(mode),
-			UK_9P_OTRUNC | UK_9P_OWRITE, NULL);
+	if (UK_9PFS_DOTL(dvp->v_mount))
+		rc = uk_9p_lcreate(dev, fid, name,
+				UK_9P_L_O_WRONLY | UK_9P_L_O_CREAT |
+				UK_9P_L_O_TRUNC, mode & 07777, 0);
+	else
+		rc = uk_9p_create(dev, fid, name,
+				uk_9pfs_perm_from_posix_mode(mode),
+				UK_9P_OTRUNC | UK_9P_OWRITE, NULL);
 
 	uk_9pfid_put(fid);
 	return -rc;
@@ -343,6 +530,67 @@ static int uk_9pfs_rmdir(struct vnode *dvp, struct vnode *vp,
 	return uk_9pfs_remove_generic(dvp, vp);
 }
 
+static int uk_9pfs_readdir_dotl(struct vnode *vp, struct vfscore_file *fp,
+		struct dirent *dir)
+{
+	struct uk_9pdev *dev = UK_9PFS_MD(vp->v_mount)->dev;
+	struct uk_9pfs_file_data *fd = UK_9PFS_FD(fp);
+	struct uk_9p_dirent dirent;
+	struct uk_9preq fake_request;
+	int64_t sz;
+	int rc;
+
+	if (!fd->readdir_buf) {
+		fd->readdir_buf = malloc(UK_9PFS_READDIR_BUFSZ);
+		if (!fd->readdir_buf)
+			return ENOMEM;
+
+		fd->readdir_off = 0;
+		fd->readdir_sz = 0;
+	}
+
+	/*
+	 * Unlike with TREAD, the offset of TREADDIR is the cookie of the last
+	 * consumed entry, which is kept in f_offset.
+	 */
+	if (fd->readdir_off == fd->readdir_sz) {
+		fd->readdir_off = 0;
+		fd->readdir_sz = 0;
+		sz = uk_9p_readdir(dev, fd->fid, fp->f_offset,
+				   UK_9PFS_READDIR_BUFSZ, fd->readdir_buf);
+		if (sz < 0)
+			return -sz;
+
+		/* End of directory. */
+		if (sz == 0)
+			return ENOENT;
+
+		fd->readdir_sz = sz;
+	}
+
+	fake_request.recv.buf = fd->readdir_buf;
+	fake_request.recv.size = fd->readdir_sz;
+	fake_request.recv.offset = fd->readdir_off;
+	fake_request.state = UK_9PREQ_RECEIVED;
+	rc = uk_9preq_readdirent(&fake_request, &dirent);
+	if (rc) {
+		/* Entries are never split across replies. */
+		fd->readdir_off = fd->readdir_sz;
+		return EIO;
+	}
+
+	fd->readdir_off = fake_request.recv.offset;
+	fp->f_offset = dirent.offset;
+
+	dir->d_type = dirent.type;
+	dir->d_ino = dirent.qid.path;
+	dir->d_off = dirent.offset;
+	strlcpy((char *) &dir->d_name, dirent.name.data,
+			MIN(sizeof(dir->d_name), dirent.name.size + 1U));
+
+	return 0;
+}
+
 static int uk_9pfs_readdir(struct vnode *vp, struct vfscore_file *fp,
 		struct dirent *dir)
 {
@@ -352,6 +600,9 @@ static int uk_9pfs_readdir(struct vnode *vp, struct vfscore_file *fp,
 	struct uk_9p_stat stat;
 	struct uk_9preq fake_request;
 
+	if (UK_9PFS_DOTL(vp->v_mount))
+		return uk_9pfs_readdir_dotl(vp, fp, dir);
+
 again:
 	if (!fd->readdir_buf) {
 		fd->readdir_buf = malloc(UK_9PFS_READDIR_BUFSZ);
@@ -431,9 +682,6 @@ static int uk_9pfs_read(struct vnode *vp, struct vfscore_file *fp,
 			struct uio *uio, int ioflag __unused)
 {
 	struct uk_9pdev *dev = UK_9PFS_MD(vp->v_mount)->dev;
-	struct uk_9pfid *fid = UK_9PFS_FD(fp)->fid;
-	struct iovec *iov;
-	int rc;
 
 	if (vp->v_type == VDIR)
 		return EISDIR;
@@ -447,30 +695,16 @@ static int uk_9pfs_read(struct vnode *vp, struct vfscore_file *fp,
 	if (!uio->uio_resid)
 		return 0;
 
-	iov = uio->uio_iov;
-	while (!iov->iov_len) {
-		uio->uio_iov++;
-		uio->uio_iovcnt--;
-	}
-
-	rc = uk_9p_read(dev, fid, uio->uio_offset,
-			   iov->iov_len, iov->iov_base);
-	if (rc < 0)
-		return -rc;
+	if (vfscore_pcache_enabled(vp))
+		return vfscore_pcache_read(vp, fp, uio);
 
-	iov->iov_base = (char *)iov->iov_base + rc;
-	iov->iov_len -= rc;
-	uio->uio_resid -= rc;
-	uio->uio_offset += rc;
-
-	return 0;
+	return uk_9pfs_fid_io(dev, UK_9PFS_FD(fp)->fid, uio);
 }
 
 static int uk_9pfs_write(struct vnode *vp, struct uio *uio, int ioflag)
 {
 	struct uk_9pdev *dev = UK_9PFS_MD(vp->v_mount)->dev;
 	struct uk_9pfid *fid;
-	struct iovec *iov;
 	int rc;
 
 	if (vp->v_type == VDIR)
@@ -484,41 +718,17 @@ static int uk_9pfs_write(struct vnode *vp, struct uio *uio, int ioflag)
 	if (uio->uio_resid == 0)
 		return 0;
 
+	if (vfscore_pcache_enabled(vp))
+		return vfscore_pcache_write(vp, uio, ioflag);
+
 	if (ioflag & IO_APPEND)
 		uio->uio_offset = vp->v_size;
 
-	/* Clone vnode fid. */
-	fid = uk_9p_walk(dev, UK_9PFS_VFID(vp), NULL);
+	fid = uk_9pfs_io_fid(vp, 1);
 	if (PTRISERR(fid))
 		return -PTR2ERR(fid);
 
-	rc = uk_9p_open(dev, fid, UK_9P_OWRITE);
-	if (rc < 0)
-		goto out;
-
-	if (!uio->uio_resid)
-		return 0;
-
-	iov = uio->uio_iov;
-	while (!iov->iov_len) {
-		uio->uio_iov++;
-		uio->uio_iovcnt--;
-	}
-
-	rc = uk_9p_write(dev, fid, uio->uio_offset,
-			    iov->iov_len, iov->iov_base);
-	if (rc < 0)
-		return -rc;
-
-	iov->iov_base = (char *)iov->iov_base + rc;
-	iov->iov_len -= rc;
-	uio->uio_resid -= rc;
-	uio->uio_offset += rc;
-
-	if (rc < 0)
-		goto out;
-
-	rc = 0;
+	rc = uk_9pfs_fid_io(dev, fid, uio);
 
 	/*
 	 * If the uio offset after completion of the write requests is bigger
@@ -528,9 +738,37 @@ static int uk_9pfs_write(struct vnode *vp, struct uio *uio, int ioflag)
 	if (uio->uio_offset > vp->v_size)
 		vp->v_size = uio->uio_offset;
 
-out:
-	uk_9pfid_put(fid);
-	return -rc;
+	return rc;
+}
+
+static int uk_9pfs_getattr_dotl(struct vnode *vp, struct vattr *attr)
+{
+	struct uk_9pdev *dev = UK_9PFS_MD(vp->v_mount)->dev;
+	struct uk_9p_attr l_attr;
+	int rc;
+
+	rc = uk_9pfs_stat_dotl(dev, UK_9PFS_VFID(vp), &l_attr);
+	if (rc)
+		return -rc;
+
+	attr->va_type = uk_9pfs_vtype_from_posix_mode(l_attr.mode);
+	attr->va_mode = l_attr.mode;
+	attr->va_nodeid = vp->v_ino;
+	attr->va_nlink = l_attr.nlink;
+	attr->va_uid = l_attr.uid;
+	attr->va_gid = l_attr.gid;
+	attr->va_rdev = l_attr.rdev;
+	attr->va_size = l_attr.size;
+	attr->va_nblocks = l_attr.blocks;
+
+	attr->va_atime.tv_sec = l_attr.atime_sec;
+	attr->va_atime.tv_nsec = l_attr.atime_nsec;
+	attr->va_mtime.tv_sec = l_attr.mtime_sec;
+	attr->va_mtime.tv_nsec = l_attr.mtime_nsec;
+	attr->va_ctime.tv_sec = l_attr.ctime_sec;
+	attr->va_ctime.tv_nsec = l_attr.ctime_nsec;
+
+	return 0;
 }
 
 static int uk_9pfs_getattr(struct vnode *vp, struct vattr *attr)
@@ -541,6 +779,9 @@ static int uk_9pfs_getattr(struct vnode *vp, struct vattr *attr)
 	struct uk_9preq *stat_req;
 	int rc = 0;
 
+	if (UK_9PFS_DOTL(vp->v_mount))
+		return uk_9pfs_getattr_dotl(vp, attr);
+
 	stat_req = uk_9p_stat(dev, fid, &stat);
 	if (PTRISERR(stat_req)) {
 		rc = PTR2ERR(stat_req);
@@ -566,11 +807,75 @@ out:
 	return -rc;
 }
 
+/* The following operations are only supported with 9P2000.L. */
+
+static int uk_9pfs_setattr(struct vnode *vp, struct vattr *attr)
+{
+	struct uk_9pdev *dev = UK_9PFS_MD(vp->v_mount)->dev;
+	struct uk_9p_iattr iattr;
+
+	if (!UK_9PFS_DOTL(vp->v_mount))
+		return 0;
+
+	memset(&iattr, 0, sizeof(iattr));
+	if (attr->va_mask & AT_MODE) {
+		iattr.valid |= UK_9P_SETATTR_MODE;
+		iattr.mode = attr->va_mode & 07777;
+	}
+	if (attr->va_mask & AT_ATIME) {
+		iattr.valid |= UK_9P_SETATTR_ATIME;
+		if (attr->va_atime.tv_nsec != UTIME_NOW) {
+			iattr.valid |= UK_9P_SETATTR_ATIME_SET;
+			iattr.atime_sec = attr->va_atime.tv_sec;
+			iattr.atime_nsec = attr->va_atime.tv_nsec;
+		}
+	}
+	if (attr->va_mask & AT_MTIME) {
+		iattr.valid |= UK_9P_SETATTR_MTIME;
+		if (attr->va_mtime.tv_nsec != UTIME_NOW) {
+			iattr.valid |= UK_9P_SETATTR_MTIME_SET;
+			iattr.mtime_sec = attr->va_mtime.tv_sec;
+			iattr.mtime_nsec = attr->va_mtime.tv_nsec;
+		}
+	}
+	if (!iattr.valid)
+		return 0;
+
+	return -uk_9p_setattr(dev, UK_9PFS_VFID(vp), &iattr);
+}
+
+static int uk_9pfs_truncate(struct vnode *vp, off_t length)
+{
+	struct uk_9pdev *dev = UK_9PFS_MD(vp->v_mount)->dev;
+	struct uk_9p_iattr iattr;
+	int rc;
+
+	if (!UK_9PFS_DOTL(vp->v_mount))
+		return 0;
+
+	memset(&iattr, 0, sizeof(iattr));
+	iattr.valid = UK_9P_SETATTR_SIZE;
+	iattr.size = length;
+	rc = uk_9p_setattr(dev, UK_9PFS_VFID(vp), &iattr);
+	if (rc)
+		return -rc;
+
+	vp->v_size = length;
+	return 0;
+}
+
+static int uk_9pfs_fsync(struct vnode *vp, struct vfscore_file *fp)
+{
+	struct uk_9pdev *dev = UK_9PFS_MD(vp->v_mount)->dev;
+
+	if (!UK_9PFS_DOTL(vp->v_mount))
+		return 0;
+
+	return -uk_9p_fsync(dev, UK_9PFS_FD(fp)->fid, 0);
+}
+
 #define uk_9pfs_seek		((vnop_seek_t)vfscore_vop_nullop)
 #define uk_9pfs_ioctl		((vnop_ioctl_t)vfscore_vop_einval)
-#define uk_9pfs_fsync		((vnop_fsync_t)vfscore_vop_nullop)
-#define uk_9pfs_setattr		((vnop_setattr_t)vfscore_vop_nullop)
-#define uk_9pfs_truncate	((vnop_truncate_t)vfscore_vop_nullop)
 #define uk_9pfs_link		((vnop_link_t)vfscore_vop_eperm)
 #define uk_9pfs_cache		((vnop_cache_t)NULL)
 #define uk_9pfs_readlink	((vnop_readlink_t)vfscore_vop_einval)
@@ -0,0 +1,268 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * arm64 implementations of the hot mem*() and str*() functions.
+ *
+ * Two variants are provided:
+ *  - "word": 8-byte word-wide loops from string_word.c; the compiler
+ *            turns the paired accesses into ldp/stp;
+ *  - "neon": 16-byte Advanced SIMD loops. They are only built with
+ *            CONFIG_FPSIMD, since the kernel is otherwise compiled with
+ *            -mgeneral-regs-only and the SIMD registers are not preserved
+ *            across context switches. The variant is picked if
+ *            ID_AA64PFR0_EL1 reports Advanced SIMD support.
+ *
+ * Forward copies are safe for overlapping buffers with dst < src: every
+ * block is loaded before it is stored and the tail block is loaded up
+ * front. memmove() relies on this.
+ *
+ * Note that the NEON variant uses FP/SIMD registers, which the interrupt
+ * path does not save. Interrupt handlers must use the isrlib variants
+ * (e.g., memcpy_isr()) instead.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <uk/config.h>
+#include <uk/arch/types.h>
+#include <uk/essentials.h>
+#include "../../string_arch.h"
+
+#if CONFIG_FPSIMD
+/* ID_AA64PFR0_EL1.AdvSIMD, 0xf means not implemented */
+#define ID_AA64PFR0_ADVSIMD_SHIFT	20
+#define ID_AA64PFR0_ADVSIMD_MASK	0xfUL
+#define ID_AA64PFR0_ADVSIMD_NI		0xfUL
+
+typedef __u8 v16u8 __attribute__((vector_size(16), may_alias));
+typedef __u8 v16u8_u __attribute__((vector_size(16), may_alias, aligned(1)));
+typedef __u64 v2u64 __attribute__((vector_size(16), may_alias));
+
+#define V16_LOAD(p)		(*(const v16u8_u *)(p))
+#define V16_STORE(p, v)		(*(v16u8_u *)(p) = (v))
+#define V16_SPLAT(c)		((v16u8){ c, c, c, c, c, c, c, c, \
+					  c, c, c, c, c, c, c, c })
+
+/* Returns the index of the first byte at or after `from` that is set in a
+ * compare result (all-ones or all-zeros bytes), or 16 if there is none.
+ * arm64 is little-endian, so byte 0 is in the low bits of the first word.
+ */
+static inline unsigned int v16_first(v2u64 cmp, unsigned int from)
+{
+	__u64 lo = cmp[0];
+	__u64 hi = cmp[1];
+
+	if (from >= 8) {
+		lo = 0;
+		hi &= ~0ULL << ((from - 8) * 8);
+	} else {
+		lo &= ~0ULL << (from * 8);
+	}
+
+	if (lo)
+		return __builtin_ctzll(lo) >> 3;
+	if (hi)
+		return 8 + (__builtin_ctzll(hi) >> 3);
+	return 16;
+}
+
+static void *memcpy_neon(void *dst, const void *src, size_t len)
+{
+	__u8 *d = dst;
+	const __u8 *s = src;
+	v16u8 a, b, c, e, tail;
+
+	if (len < 16) {
+		__nolibc_copy_small(d, s, len);
+		return dst;
+	}
+	if (len <= 32) {
+		a = V16_LOAD(s);
+		b = V16_LOAD(s + len - 16);
+		V16_STORE(d, a);
+		V16_STORE(d + len - 16, b);
+		return dst;
+	}
+
+	tail = V16_LOAD(s + len - 16);
+	for (; len > 64; len -= 64, d += 64, s += 64) {
+		a = V16_LOAD(s);
+		b = V16_LOAD(s + 16);
+		c = V16_LOAD(s + 32);
+		e = V16_LOAD(s + 48);
+		V16_STORE(d, a);
+		V16_STORE(d + 16, b);
+		V16_STORE(d + 32, c);
+		V16_STORE(d + 48, e);
+	}
+	for (; len > 16; len -= 16, d += 16, s += 16)
+		V16_STORE(d, V16_LOAD(s));
+	V16_STORE(d + len - 16, tail);
+
+	return dst;
+}
+
+static void *memmove_neon(void *dst, const void *src, size_t len)
+{
+	__u8 *d = dst;
+	const __u8 *s = src;
+	v16u8 head;
+
+	/* Forward copy is fine if dst is below src or there is no overlap */
+	if ((__uptr)dst - (__uptr)src >= len || len <= 32)
+		return memcpy_neon(dst, src, len);
+
+	head = V16_LOAD(s);
+	for (; len > 16; len -= 16)
+		V16_STORE(d + len - 16, V16_LOAD(s + len - 16));
+	V16_STORE(d, head);
+
+	return dst;
+}
+
+static void *memset_neon(void *ptr, int val, size_t len)
+{
+	__u8 *d = ptr;
+	__u8 c = (__u8)val;
+	v16u8 v = V16_SPLAT(c);
+
+	if (len < 16) {
+		__nolibc_set_small(d, __NOLIBC_ONES * c, len);
+		return ptr;
+	}
+
+	V16_STORE(d + len - 16, v);
+	for (; len > 64; len -= 64, d += 64) {
+		V16_STORE(d, v);
+		V16_STORE(d + 16, v);
+		V16_STORE(d + 32, v);
+		V16_STORE(d + 48, v);
+	}
+	for (; len > 16; len -= 16, d += 16)
+		V16_STORE(d, v);
+
+	return ptr;
+}
+
+/* Searches with aligned loads only, so we never touch a page that does
+ * not contain at least one byte of the buffer.
+ */
+static void *memchr_neon(const void *ptr, int val, size_t len)
+{
+	const __u8 *s = ptr;
+	__u8 c = (__u8)val;
+	v16u8 needle = V16_SPLAT(c);
+	unsigned int off = (__uptr)s & 15;
+	const v16u8 *p = (const v16u8 *)(s - off);
+	unsigned int idx;
+	size_t pos;
+
+	if (!len)
+		return NULL;
+
+	idx = v16_first((v2u64)(*p == needle), off);
+	pos = idx - off;
+	for (;;) {
+		if (idx < 16)
+			return pos < len ? (void *)(s + pos) : NULL;
+		if (pos >= len)
+			return NULL;
+		idx = v16_first((v2u64)(*++p == needle), 0);
+		pos += idx;
+	}
+}
+
+static int memcmp_neon(const void *ptr1, const void *ptr2, size_t len)
+{
+	const __u8 *c1 = ptr1;
+	const __u8 *c2 = ptr2;
+	unsigned int idx;
+
+	for (; len >= 16; c1 += 16, c2 += 16, len -= 16) {
+		idx = v16_first((v2u64)(V16_LOAD(c1) != V16_LOAD(c2)), 0);
+		if (idx < 16)
+			return c1[idx] - c2[idx];
+	}
+
+	return __nolibc_memcmp_word(c1, c2, len);
+}
+
+static size_t strlen_neon(const char *str)
+{
+	unsigned int off = (__uptr)str & 15;
+	const v16u8 *p = (const v16u8 *)(str - off);
+	v16u8 zero = V16_SPLAT(0);
+	unsigned int idx;
+
+	idx = v16_first((v2u64)(*p == zero), off);
+	while (idx == 16)
+		idx = v16_first((v2u64)(*++p == zero), 0);
+
+	return (const char *)p + idx - str;
+}
+
+static int supported_neon(void)
+{
+	__u64 pfr0;
+
+	__asm__ __volatile__("mrs %0, id_aa64pfr0_el1" : "=r"(pfr0));
+	return ((pfr0 >> ID_AA64PFR0_ADVSIMD_SHIFT) & ID_AA64PFR0_ADVSIMD_MASK)
+		!= ID_AA64PFR0_ADVSIMD_NI;
+}
+#endif /* CONFIG_FPSIMD */
+
+const struct __nolibc_string_ops __nolibc_string_variants[] = {
+	{
+		.name      = "word",
+		.supported = __nolibc_supported_word,
+		.memcpy    = __nolibc_memcpy_word,
+		.memmove   = __nolibc_memmove_word,
+		.memset    = __nolibc_memset_word,
+		.memchr    = __nolibc_memchr_word,
+		.memcmp    = __nolibc_memcmp_word,
+		.strlen    = __nolibc_strlen_word,
+	},
+#if CONFIG_FPSIMD
+	{
+		.name      = "neon",
+		.supported = supported_neon,
+		.memcpy    = memcpy_neon,
+		.memmove   = memmove_neon,
+		.memset    = memset_neon,
+		.memchr    = memchr_neon,
+		.memcmp    = memcmp_neon,
+		.strlen    = strlen_neon,
+	},
+#endif /* CONFIG_FPSIMD */
+};
+
+const size_t __nolibc_string_variants_count =
+	ARRAY_SIZE(__nolibc_string_variants);
@@ -0,0 +1,521 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * x86_64 implementations of the hot mem*() and str*() functions.
+ *
+ * Three variants are provided and selected at runtime by CPUID:
+ *  - "word": 8-byte word-wide loops from string_word.c;
+ *  - "sse2": 16-byte vector loops (SSE2 is part of the x86_64 baseline
+ *            but we only build this variant if the compiler may use it);
+ *  - "avx2": 32-byte vector loops; only picked if the CPU supports AVX2
+ *            and the kernel enabled the AVX state in XCR0.
+ * The vector variants switch to `rep movsb`/`rep stosb` for large buffers
+ * on CPUs with Enhanced REP MOVSB/STOSB (ERMS).
+ *
+ * Forward copies are safe for overlapping buffers with dst < src: every
+ * block is loaded before it is stored and the tail block is loaded up
+ * front. memmove() relies on this.
+ *
+ * Note that these functions use extended registers, which the interrupt
+ * path does not save. Interrupt handlers must use the isrlib variants
+ * (e.g., memcpy_isr()) instead, like the virtio 9P receive path does.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <uk/arch/types.h>
+#include <uk/arch/lcpu.h>
+#include <uk/essentials.h>
+#include "../../string_arch.h"
+
+/* CPUID.01H:ECX */
+#define CPUID1_ECX_OSXSAVE	(1 << 27)
+#define CPUID1_ECX_AVX		(1 << 28)
+/* CPUID.01H:EDX */
+#define CPUID1_EDX_SSE2		(1 << 26)
+/* CPUID.(EAX=07H,ECX=0):EBX */
+#define CPUID7_EBX_AVX2		(1 << 5)
+#define CPUID7_EBX_ERMS		(1 << 9)
+/* XCR0 state components that must be enabled for AVX */
+#define XCR0_SSE_AVX		((1 << 1) | (1 << 2))
+
+/* Buffers of at least this size are handled with `rep movsb/stosb` on
+ * CPUs with ERMS. Below, the vector loops are faster because of the
+ * startup cost of the string instructions.
+ */
+#define ERMS_THRESHOLD		2048
+
+static int has_erms;
+
+static int cpu_has_erms(void)
+{
+	__u32 eax, ebx, ecx, edx;
+
+	ukarch_x86_cpuid(0, 0, &eax, &ebx, &ecx, &edx);
+	if (eax < 7)
+		return 0;
+
+	ukarch_x86_cpuid(7, 0, &eax, &ebx, &ecx, &edx);
+	return !!(ebx & CPUID7_EBX_ERMS);
+}
+
+static inline void rep_movsb(void *dst, const void *src, size_t len)
+{
+	__asm__ __volatile__("rep movsb"
+			     : "+D"(dst), "+S"(src), "+c"(len)
+			     :
+			     : "memory");
+}
+
+static inline void rep_stosb(void *ptr, int val, size_t len)
+{
+	__asm__ __volatile__("rep stosb"
+			     : "+D"(ptr), "+c"(len)
+			     : "a"(val)
+			     : "memory");
+}
+
+#if __SSE2__
+/*
+ * SSE2 variant
+ */
+typedef char v16qi __attribute__((vector_size(16), may_alias));
+typedef char v16qi_u __attribute__((vector_size(16), may_alias, aligned(1)));
+
+#define V16_LOAD(p)		(*(const v16qi_u *)(p))
+#define V16_STORE(p, v)		(*(v16qi_u *)(p) = (v))
+#define V16_MASK(v)		\
+	((unsigned int)__builtin_ia32_pmovmskb128((v16qi)(v)))
+#define V16_SPLAT(c)		((v16qi){ c, c, c, c, c, c, c, c, \
+					  c, c, c, c, c, c, c, c })
+
+static void *memcpy_sse2(void *dst, const void *src, size_t len)
+{
+	__u8 *d = dst;
+	const __u8 *s = src;
+	v16qi a, b, c, e, tail;
+
+	if (len < 16) {
+		__nolibc_copy_small(d, s, len);
+		return dst;
+	}
+	if (len <= 32) {
+		a = V16_LOAD(s);
+		b = V16_LOAD(s + len - 16);
+		V16_STORE(d, a);
+		V16_STORE(d + len - 16, b);
+		return dst;
+	}
+	if (len >= ERMS_THRESHOLD && has_erms) {
+		rep_movsb(d, s, len);
+		return dst;
+	}
+
+	tail = V16_LOAD(s + len - 16);
+	for (; len > 64; len -= 64, d += 64, s += 64) {
+		a = V16_LOAD(s);
+		b = V16_LOAD(s + 16);
+		c = V16_LOAD(s + 32);
+		e = V16_LOAD(s + 48);
+		V16_STORE(d, a);
+		V16_STORE(d + 16, b);
+		V16_STORE(d + 32, c);
+		V16_STORE(d + 48, e);
+	}
+	for (; len > 16; len -= 16, d += 16, s += 16)
+		V16_STORE(d, V16_LOAD(s));
+	V16_STORE(d + len - 16, tail);
+
+	return dst;
+}
+
+static void *memmove_sse2(void *dst, const void *src, size_t len)
+{
+	__u8 *d = dst;
+	const __u8 *s = src;
+	v16qi head;
+
+	/* Forward copy is fine if dst is below src or there is no overlap */
+	if ((__uptr)dst - (__uptr)src >= len)
+		return memcpy_sse2(dst, src, len);
+
+	if (len <= 32)
+		return memcpy_sse2(dst, src, len);
+
+	head = V16_LOAD(s);
+	for (; len > 16; len -= 16)
+		V16_STORE(d + len - 16, V16_LOAD(s + len - 16));
+	V16_STORE(d, head);
+
+	return dst;
+}
+
+static void *memset_sse2(void *ptr, int val, size_t len)
+{
+	__u8 *d = ptr;
+	char c = (char)val;
+	v16qi v = V16_SPLAT(c);
+
+	if (len < 16) {
+		__nolibc_set_small(d, __NOLIBC_ONES * (__u8)val, len);
+		return ptr;
+	}
+	if (len >= ERMS_THRESHOLD && has_erms) {
+		rep_stosb(d, val, len);
+		return ptr;
+	}
+
+	V16_STORE(d + len - 16, v);
+	for (; len > 64; len -= 64, d += 64) {
+		V16_STORE(d, v);
+		V16_STORE(d + 16, v);
+		V16_STORE(d + 32, v);
+		V16_STORE(d + 48, v);
+	}
+	for (; len > 16; len -= 16, d += 16)
+		V16_STORE(d, v);
+
+	return ptr;
+}
+
+/* Searches with aligned loads only, so we never touch a page that does
+ * not contain at least one byte of the buffer.
+ */
+static void *memchr_sse2(const void *ptr, int val, size_t len)
+{
+	const __u8 *s = ptr;
+	char c = (char)val;
+	v16qi needle = V16_SPLAT(c);
+	__uptr off = (__uptr)s & 15;
+	const v16qi *p = (const v16qi *)(s - off);
+	unsigned int mask;
+	size_t pos;
+
+	if (!len)
+		return NULL;
+
+	mask = V16_MASK(*p == needle) >> off;
+	pos = 0;
+	for (;;) {
+		if (mask) {
+			pos += __builtin_ctz(mask);
+			return pos < len ? (void *)(s + pos) : NULL;
+		}
+		pos += 16 - (pos ? 0 : off);
+		if (pos >= len)
+			return NULL;
+		mask = V16_MASK(*++p == needle);
+	}
+}
+
+static int memcmp_sse2(const void *ptr1, const void *ptr2, size_t len)
+{
+	const __u8 *c1 = ptr1;
+	const __u8 *c2 = ptr2;
+	unsigned int mask;
+
+	for (; len >= 16; c1 += 16, c2 += 16, len -= 16) {
+		mask = V16_MASK(V16_LOAD(c1) == V16_LOAD(c2)) ^ 0xffff;
+		if (mask) {
+			mask = __builtin_ctz(mask);
+			return c1[mask] - c2[mask];
+		}
+	}
+
+	return __nolibc_memcmp_word(c1, c2, len);
+}
+
+static size_t strlen_sse2(const char *str)
+{
+	__uptr off = (__uptr)str & 15;
+	const v16qi *p = (const v16qi *)(str - off);
+	v16qi zero = V16_SPLAT(0);
+	unsigned int mask;
+
+	mask = V16_MASK(*p == zero) >> off;
+	if (mask)
+		return __builtin_ctz(mask);
+
+	do {
+		mask = V16_MASK(*++p == zero);
+	} while (!mask);
+
+	return (const char *)p + __builtin_ctz(mask) - str;
+}
+
+static int supported_sse2(void)
+{
+	__u32 eax, ebx, ecx, edx;
+
+	ukarch_x86_cpuid(1, 0, &eax, &ebx, &ecx, &edx);
+	if (!(edx & CPUID1_EDX_SSE2))
+		return 0;
+
+	has_erms = cpu_has_erms();
+	return 1;
+}
+
+/*
+ * AVX2 variant
+ */
+#define __avx2 __attribute__((target("avx2")))
+
+typedef char v32qi __attribute__((vector_size(32), may_alias));
+typedef char v32qi_u __attribute__((vector_size(32), may_alias, aligned(1)));
+
+#define V32_LOAD(p)		(*(const v32qi_u *)(p))
+#define V32_STORE(p, v)		(*(v32qi_u *)(p) = (v))
+#define V32_MASK(v)		\
+	((__u32)__builtin_ia32_pmovmskb256((v32qi)(v)))
+#define V32_SPLAT(c)		((v32qi){ c, c, c, c, c, c, c, c, \
+					  c, c, c, c, c, c, c, c, \
+					  c, c, c, c, c, c, c, c, \
+					  c, c, c, c, c, c, c, c })
+
+static __avx2 void *memcpy_avx2(void *dst, const void *src, size_t len)
+{
+	__u8 *d = dst;
+	const __u8 *s = src;
+	v32qi a, b, c, e, tail;
+
+	if (len <= 32)
+		return memcpy_sse2(dst, src, len);
+	if (len <= 64) {
+		a = V32_LOAD(s);
+		b = V32_LOAD(s + len - 32);
+		V32_STORE(d, a);
+		V32_STORE(d + len - 32, b);
+		return dst;
+	}
+	if (len >= ERMS_THRESHOLD && has_erms) {
+		rep_movsb(d, s, len);
+		return dst;
+	}
+
+	tail = V32_LOAD(s + len - 32);
+	for (; len > 128; len -= 128, d += 128, s += 128) {
+		a = V32_LOAD(s);
+		b = V32_LOAD(s + 32);
+		c = V32_LOAD(s + 64);
+		e = V32_LOAD(s + 96);
+		V32_STORE(d, a);
+		V32_STORE(d + 32, b);
+		V32_STORE(d + 64, c);
+		V32_STORE(d + 96, e);
+	}
+	for (; len > 32; len -= 32, d += 32, s += 32)
+		V32_STORE(d, V32_LOAD(s));
+	V32_STORE(d + len - 32, tail);
+
+	return dst;
+}
+
+static __avx2 void *memmove_avx2(void *dst, const void *src, size_t len)
+{
+	__u8 *d = dst;
+	const __u8 *s = src;
+	v32qi head;
+
+	if ((__uptr)dst - (__uptr)src >= len)
+		return memcpy_avx2(dst, src, len);
+
+	if (len <= 64)
+		return memmove_sse2(dst, src, len);
+
+	head = V32_LOAD(s);
+	for (; len > 32; len -= 32)
+		V32_STORE(d + len - 32, V32_LOAD(s + len - 32));
+	V32_STORE(d, head);
+
+	return dst;
+}
+
+static __avx2 void *memset_avx2(void *ptr, int val, size_t len)
+{
+	__u8 *d = ptr;
+	char c = (char)val;
+	v32qi v;
+
+	if (len <= 32)
+		return memset_sse2(ptr, val, len);
+	if (len >= ERMS_THRESHOLD && has_erms) {
+		rep_stosb(d, val, len);
+		return ptr;
+	}
+
+	v = V32_SPLAT(c);
+	V32_STORE(d + len - 32, v);
+	for (; len > 128; len -= 128, d += 128) {
+		V32_STORE(d, v);
+		V32_STORE(d + 32, v);
+		V32_STORE(d + 64, v);
+		V32_STORE(d + 96, v);
+	}
+	for (; len > 32; len -= 32, d += 32)
+		V32_STORE(d, v);
+
+	return ptr;
+}
+
+static __avx2 void *memchr_avx2(const void *ptr, int val, size_t len)
+{
+	const __u8 *s = ptr;
+	char c = (char)val;
+	v32qi needle = V32_SPLAT(c);
+	__uptr off = (__uptr)s & 31;
+	const v32qi *p = (const v32qi *)(s - off);
+	__u32 mask;
+	size_t pos;
+
+	if (!len)
+		return NULL;
+
+	mask = V32_MASK(*p == needle) >> off;
+	pos = 0;
+	for (;;) {
+		if (mask) {
+			pos += __builtin_ctz(mask);
+			return pos < len ? (void *)(s + pos) : NULL;
+		}
+		pos += 32 - (pos ? 0 : off);
+		if (pos >= len)
+			return NULL;
+		mask = V32_MASK(*++p == needle);
+	}
+}
+
+static __avx2 int memcmp_avx2(const void *ptr1, const void *ptr2, size_t len)
+{
+	const __u8 *c1 = ptr1;
+	const __u8 *c2 = ptr2;
+	__u32 mask;
+
+	for (; len >= 32; c1 += 32, c2 += 32, len -= 32) {
+		mask = ~V32_MASK(V32_LOAD(c1) == V32_LOAD(c2));
+		if (mask) {
+			mask = __builtin_ctz(mask);
+			return c1[mask] - c2[mask];
+		}
+	}
+
+	return memcmp_sse2(c1, c2, len);
+}
+
+static __avx2 size_t strlen_avx2(const char *str)
+{
+	__uptr off = (__uptr)str & 31;
+	const v32qi *p = (const v32qi *)(str - off);
+	v32qi zero = V32_SPLAT(0);
+	__u32 mask;
+
+	mask = V32_MASK(*p == zero) >> off;
+	if (mask)
+		return __builtin_ctz(mask);
+
+	do {
+		mask = V32_MASK(*++p == zero);
+	} while (!mask);
+
+	return (const char *)p + __builtin_ctz(mask) - str;
+}
+
+static __u64 xgetbv(__u32 idx)
+{
+	__u32 lo, hi;
+
+	__asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(idx));
+	return ((__u64)hi << 32) | lo;
+}
+
+static int supported_avx2(void)
+{
+	__u32 eax, ebx, ecx, edx;
+
+	ukarch_x86_cpuid(1, 0, &eax, &ebx, &ecx, &edx);
+	if (!(ecx & CPUID1_ECX_OSXSAVE) || !(ecx & CPUID1_ECX_AVX))
+		return 0;
+
+	/* The kernel must have enabled the AVX state, otherwise the upper
+	 * halves of the registers are neither usable nor preserved across
+	 * context switches.
+	 */
+	if ((xgetbv(0) & XCR0_SSE_AVX) != XCR0_SSE_AVX)
+		return 0;
+
+	ukarch_x86_cpuid(0, 0, &eax, &ebx, &ecx, &edx);
+	if (eax < 7)
+		return 0;
+	ukarch_x86_cpuid(7, 0, &eax, &ebx, &ecx, &edx);
+	if (!(ebx & CPUID7_EBX_AVX2))
+		return 0;
+
+	has_erms = !!(ebx & CPUID7_EBX_ERMS);
+	return 1;
+}
+#endif /* __SSE2__ */
+
+const struct __nolibc_string_ops __nolibc_string_variants[] = {
+	{
+		.name      = "word",
+		.supported = __nolibc_supported_word,
+		.memcpy    = __nolibc_memcpy_word,
+		.memmove   = __nolibc_memmove_word,
+		.memset    = __nolibc_memset_word,
+		.memchr    = __nolibc_memchr_word,
+		.memcmp    = __nolibc_memcmp_word,
+		.strlen    = __nolibc_strlen_word,
+	},
+#if __SSE2__
+	{
+		.name      = "sse2",
+		.supported = supported_sse2,
+		.memcpy    = memcpy_sse2,
+		.memmove   = memmove_sse2,
+		.memset    = memset_sse2,
+		.memchr    = memchr_sse2,
+		.memcmp    = memcmp_sse2,
+		.strlen    = strlen_sse2,
+	},
+	{
+		.name      = "avx2",
+		.supported = supported_avx2,
+		.memcpy    = memcpy_avx2,
+		.memmove   = memmove_avx2,
+		.memset    = memset_avx2,
+		.memchr    = memchr_avx2,
+		.memcmp    = memcmp_avx2,
+		.strlen    = strlen_avx2,
+	},
+#endif /* __SSE2__ */
+};
+
+const size_t __nolibc_string_variants_count =
+	ARRAY_SIZE(__nolibc_string_variants);
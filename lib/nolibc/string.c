@@ -61,7 +61,50 @@
 #include <limits.h>
 #include <errno.h>
 #include <stdio.h>
+#include <uk/config.h>
+#include <uk/arch/lcpu.h>
+
+#if CONFIG_LIBNOLIBC_STRING_ARCH
+#include "string_arch.h"
+
+static const struct __nolibc_string_ops *string_ops;
+
+const struct __nolibc_string_ops *__nolibc_string_ops_get(void)
+{
+	const struct __nolibc_string_ops *ops;
+	size_t i;
+
+	if (likely(string_ops))
+		return string_ops;
+
+	/* The first entry is the generic fallback, which is always usable.
+	 * Concurrent first calls race benignly: all of them probe the same
+	 * CPU and store the same pointer.
+	 */
+	ops = &__nolibc_string_variants[0];
+	for (i = 1; i < __nolibc_string_variants_count; ++i)
+		if (__nolibc_string_variants[i].supported())
+			ops = &__nolibc_string_variants[i];
+
+	string_ops = ops;
+	return ops;
+}
 
+void *memcpy(void *dst, const void *src, size_t len)
+{
+	return __nolibc_string_ops_get()->memcpy(dst, src, len);
+}
+
+void *memset(void *ptr, int val, size_t len)
+{
+	return __nolibc_string_ops_get()->memset(ptr, val, len);
+}
+
+void *memchr(const void *ptr, int val, size_t len)
+{
+	return __nolibc_string_ops_get()->memchr(ptr, val, len);
+}
+#else /* !CONFIG_LIBNOLIBC_STRING_ARCH */
 void *memcpy(void *dst, const void *src, size_t len)
 {
 	size_t p;
@@ -92,6 +135,7 @@ void *memchr(const void *ptr, int val, size_t len)
 
 	return NULL; /* did not find val */
 }
+#endif /* !CONFIG_LIBNOLIBC_STRING_ARCH */
 
 void *memrchr(const void *m, int c, size_t n)
 {
@@ -104,6 +148,22 @@ void *memrchr(const void *m, int c, size_t n)
 	return 0;
 }
 
+#if CONFIG_LIBNOLIBC_STRING_ARCH
+void *memmove(void *dst, const void *src, size_t len)
+{
+	return __nolibc_string_ops_get()->memmove(dst, src, len);
+}
+
+int memcmp(const void *ptr1, const void *ptr2, size_t len)
+{
+	return __nolibc_string_ops_get()->memcmp(ptr1, ptr2, len);
+}
+
+size_t strlen(const char *str)
+{
+	return __nolibc_string_ops_get()->strlen(str);
+}
+#else /* !CONFIG_LIBNOLIBC_STRING_ARCH */
 void *memmove(void *dst, const void *src, size_t len)
 {
 	uint8_t *d = dst;
@@ -140,6 +200,7 @@ size_t strlen(const char *str)
 {
 	return strnlen(str, SIZE_MAX);
 }
+#endif /* !CONFIG_LIBNOLIBC_STRING_ARCH */
 
 size_t strnlen(const char *str, size_t len)
 {
@@ -0,0 +1,135 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __NOLIBC_STRING_ARCH_H__
+#define __NOLIBC_STRING_ARCH_H__
+
+#include <stddef.h>
+#include <uk/arch/types.h>
+
+/*
+ * Architecture-specific implementations of the hot mem*() and str*()
+ * functions. Every architecture that enables CONFIG_LIBNOLIBC_STRING_ARCH
+ * provides a table of variants (e.g., word-wide, SSE2, AVX2, NEON),
+ * ordered from the most generic to the most specialized one. The first
+ * call to any of the functions probes the CPU and selects the last variant
+ * in the table that is supported.
+ */
+struct __nolibc_string_ops {
+	const char *name;
+	/* Returns non-zero if the variant can be used on this CPU */
+	int (*supported)(void);
+
+	void *(*memcpy)(void *dst, const void *src, size_t len);
+	void *(*memmove)(void *dst, const void *src, size_t len);
+	void *(*memset)(void *ptr, int val, size_t len);
+	void *(*memchr)(const void *ptr, int val, size_t len);
+	int (*memcmp)(const void *ptr1, const void *ptr2, size_t len);
+	size_t (*strlen)(const char *str);
+};
+
+extern const struct __nolibc_string_ops __nolibc_string_variants[];
+extern const size_t __nolibc_string_variants_count;
+
+/* Returns the variant that is used by memcpy() and friends */
+const struct __nolibc_string_ops *__nolibc_string_ops_get(void);
+
+/*
+ * Word-wide implementations that only use general purpose registers.
+ * They serve as the first entry of every variant table. Forward copies
+ * load each word before storing it and the tail before anything else, so
+ * they are also safe for overlapping buffers with dst < src.
+ */
+void *__nolibc_memcpy_word(void *dst, const void *src, size_t len);
+void *__nolibc_memmove_word(void *dst, const void *src, size_t len);
+void *__nolibc_memset_word(void *ptr, int val, size_t len);
+void *__nolibc_memchr_word(const void *ptr, int val, size_t len);
+int __nolibc_memcmp_word(const void *ptr1, const void *ptr2, size_t len);
+size_t __nolibc_strlen_word(const char *str);
+int __nolibc_supported_word(void);
+
+typedef __u64 __attribute__((may_alias, aligned(1))) __nolibc_u64_u;
+typedef __u32 __attribute__((may_alias, aligned(1))) __nolibc_u32_u;
+typedef __u16 __attribute__((may_alias, aligned(1))) __nolibc_u16_u;
+
+/* Word-at-a-time zero byte detection, see musl's HASZERO() */
+#define __NOLIBC_ONES		0x0101010101010101ULL
+#define __NOLIBC_HIGHS		0x8080808080808080ULL
+#define __NOLIBC_HASZERO(x)	\
+	(((x) - __NOLIBC_ONES) & ~(x) & __NOLIBC_HIGHS)
+
+/* Copies less than 16 bytes. All loads are done before the stores so
+ * that overlapping buffers are handled in both directions.
+ */
+static inline __attribute__((always_inline))
+void __nolibc_copy_small(__u8 *d, const __u8 *s, size_t len)
+{
+	if (len >= 8) {
+		__u64 a = *(const __nolibc_u64_u *)s;
+		__u64 b = *(const __nolibc_u64_u *)(s + len - 8);
+
+		*(__nolibc_u64_u *)d = a;
+		*(__nolibc_u64_u *)(d + len - 8) = b;
+	} else if (len >= 4) {
+		__u32 a = *(const __nolibc_u32_u *)s;
+		__u32 b = *(const __nolibc_u32_u *)(s + len - 4);
+
+		*(__nolibc_u32_u *)d = a;
+		*(__nolibc_u32_u *)(d + len - 4) = b;
+	} else if (len >= 2) {
+		__u16 a = *(const __nolibc_u16_u *)s;
+		__u16 b = *(const __nolibc_u16_u *)(s + len - 2);
+
+		*(__nolibc_u16_u *)d = a;
+		*(__nolibc_u16_u *)(d + len - 2) = b;
+	} else if (len) {
+		*d = *s;
+	}
+}
+
+/* Fills less than 16 bytes with the byte pattern in `pat` */
+static inline __attribute__((always_inline))
+void __nolibc_set_small(__u8 *d, __u64 pat, size_t len)
+{
+	if (len >= 8) {
+		*(__nolibc_u64_u *)d = pat;
+		*(__nolibc_u64_u *)(d + len - 8) = pat;
+	} else if (len >= 4) {
+		*(__nolibc_u32_u *)d = (__u32)pat;
+		*(__nolibc_u32_u *)(d + len - 4) = (__u32)pat;
+	} else if (len >= 2) {
+		*(__nolibc_u16_u *)d = (__u16)pat;
+		*(__nolibc_u16_u *)(d + len - 2) = (__u16)pat;
+	} else if (len) {
+		*d = (__u8)pat;
+	}
+}
+
+#endif /* __NOLIBC_STRING_ARCH_H__ */
@@ -0,0 +1,157 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Word-wide mem*() and str*() implementations that are shared by all
+ * architectures with CONFIG_LIBNOLIBC_STRING_ARCH. They assume that
+ * unaligned 8-byte accesses to normal memory are allowed.
+ */
+
+#include <stddef.h>
+#include <uk/arch/types.h>
+#include "string_arch.h"
+
+void *__nolibc_memcpy_word(void *dst, const void *src, size_t len)
+{
+	__u8 *d = dst;
+	const __u8 *s = src;
+	__u64 tail;
+
+	if (len < 16) {
+		__nolibc_copy_small(d, s, len);
+		return dst;
+	}
+
+	tail = *(const __nolibc_u64_u *)(s + len - 8);
+	for (; len > 8; len -= 8, d += 8, s += 8)
+		*(__nolibc_u64_u *)d = *(const __nolibc_u64_u *)s;
+	*(__nolibc_u64_u *)(d + len - 8) = tail;
+
+	return dst;
+}
+
+void *__nolibc_memmove_word(void *dst, const void *src, size_t len)
+{
+	__u8 *d = dst;
+	const __u8 *s = src;
+	__u64 head;
+
+	/* Forward copy is fine if dst is below src or there is no overlap */
+	if ((__uptr)dst - (__uptr)src >= len || len < 16)
+		return __nolibc_memcpy_word(dst, src, len);
+
+	head = *(const __nolibc_u64_u *)s;
+	for (; len > 8; len -= 8)
+		*(__nolibc_u64_u *)(d + len - 8) =
+			*(const __nolibc_u64_u *)(s + len - 8);
+	*(__nolibc_u64_u *)d = head;
+
+	return dst;
+}
+
+void *__nolibc_memset_word(void *ptr, int val, size_t len)
+{
+	__u8 *d = ptr;
+	__u64 pat = __NOLIBC_ONES * (__u8)val;
+
+	if (len < 16) {
+		__nolibc_set_small(d, pat, len);
+		return ptr;
+	}
+
+	*(__nolibc_u64_u *)(d + len - 8) = pat;
+	for (; len > 8; len -= 8, d += 8)
+		*(__nolibc_u64_u *)d = pat;
+
+	return ptr;
+}
+
+void *__nolibc_memchr_word(const void *ptr, int val, size_t len)
+{
+	const __u8 *s = ptr;
+	__u8 c = (__u8)val;
+	__u64 pat = __NOLIBC_ONES * c;
+	__u64 w;
+
+	for (; ((__uptr)s & 7) && len; s++, len--)
+		if (*s == c)
+			return (void *)s;
+
+	for (; len >= 8; s += 8, len -= 8) {
+		w = *(const __nolibc_u64_u *)s ^ pat;
+		if (__NOLIBC_HASZERO(w))
+			break;
+	}
+
+	for (; len; s++, len--)
+		if (*s == c)
+			return (void *)s;
+
+	return NULL;
+}
+
+int __nolibc_memcmp_word(const void *ptr1, const void *ptr2, size_t len)
+{
+	const __u8 *c1 = ptr1;
+	const __u8 *c2 = ptr2;
+
+	for (; len >= 8; c1 += 8, c2 += 8, len -= 8)
+		if (*(const __nolibc_u64_u *)c1 != *(const __nolibc_u64_u *)c2)
+			break;
+
+	for (; len; c1++, c2++, len--)
+		if (*c1 != *c2)
+			return *c1 - *c2;
+
+	return 0;
+}
+
+size_t __nolibc_strlen_word(const char *str)
+{
+	const char *s = str;
+
+	for (; (__uptr)s & 7; s++)
+		if (!*s)
+			return s - str;
+
+	/* Aligned loads never cross a page boundary */
+	while (!__NOLIBC_HASZERO(*(const __nolibc_u64_u *)s))
+		s += 8;
+
+	for (; *s; s++)
+		;
+
+	return s - str;
+}
+
+int __nolibc_supported_word(void)
+{
+	return 1;
+}
@@ -0,0 +1,438 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <uk/test.h>
+#include <uk/config.h>
+#include <uk/essentials.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#if CONFIG_LIBNOLIBC_STRING_ARCH
+#include "../string_arch.h"
+#endif /* CONFIG_LIBNOLIBC_STRING_ARCH */
+#if CONFIG_LIBNOLIBC_TEST_BENCH
+#include <uk/plat/time.h>
+#endif /* CONFIG_LIBNOLIBC_TEST_BENCH */
+
+#define BUF_SIZE	16384
+/* Lengths beyond the small-size loops hit the vector and ERMS paths */
+#define MAX_SMALL_LEN	300
+
+static const size_t large_lens[] = { 511, 1024, 2047, 2048, 2049, 4095,
+				     4096 + 7 };
+
+static __u8 buf_src[BUF_SIZE] __align(64);
+static __u8 buf_dst[BUF_SIZE] __align(64);
+static __u8 buf_ref[BUF_SIZE] __align(64);
+
+struct string_ops {
+	const char *name;
+	void *(*memcpy)(void *dst, const void *src, size_t len);
+	void *(*memmove)(void *dst, const void *src, size_t len);
+	void *(*memset)(void *ptr, int val, size_t len);
+	void *(*memchr)(const void *ptr, int val, size_t len);
+	int (*memcmp)(const void *ptr1, const void *ptr2, size_t len);
+	size_t (*strlen)(const char *str);
+};
+
+static void fill_pattern(__u8 *buf, size_t len, unsigned int seed)
+{
+	size_t i;
+
+	/* Never produce 0 so that buffers can be used as strings */
+	for (i = 0; i < len; ++i)
+		buf[i] = (__u8)((i * 7 + seed) % 251 + 1);
+}
+
+static void ref_memmove(__u8 *dst, const __u8 *src, size_t len)
+{
+	size_t i;
+
+	if (dst < src) {
+		for (i = 0; i < len; ++i)
+			dst[i] = src[i];
+	} else {
+		for (i = len; i > 0; --i)
+			dst[i - 1] = src[i - 1];
+	}
+}
+
+static int bytes_differ(const __u8 *a, const __u8 *b, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; ++i)
+		if (a[i] != b[i])
+			return 1;
+	return 0;
+}
+
+static int check_memcpy_one(const struct string_ops *ops, size_t doff,
+			    size_t soff, size_t len)
+{
+	size_t window = doff + len + 64;
+	void *ret;
+
+	/* Bytes around the destination must stay untouched */
+	fill_pattern(buf_dst, window, 3);
+	fill_pattern(buf_ref, window, 3);
+	ref_memmove(buf_ref + doff, buf_src + soff, len);
+
+	ret = ops->memcpy(buf_dst + doff, buf_src + soff, len);
+	return ret != buf_dst + doff || bytes_differ(buf_dst, buf_ref, window);
+}
+
+static int check_memcpy(const struct string_ops *ops)
+{
+	size_t doff, soff, len, i;
+	int fails = 0;
+
+	fill_pattern(buf_src, BUF_SIZE, 1);
+	for (doff = 0; doff < 16; ++doff)
+		for (soff = 0; soff < 16; ++soff)
+			for (len = 0; len <= MAX_SMALL_LEN; ++len)
+				fails += check_memcpy_one(ops, doff, soff, len);
+
+	for (i = 0; i < ARRAY_SIZE(large_lens); ++i)
+		for (doff = 0; doff < 64; doff += 13)
+			fails += check_memcpy_one(ops, doff, 64 - doff,
+						  large_lens[i]);
+	return fails;
+}
+
+static int check_memmove_one(const struct string_ops *ops, size_t doff,
+			     size_t soff, size_t len)
+{
+	size_t window = MAX(doff, soff) + len + 64;
+	void *ret;
+
+	fill_pattern(buf_dst, window, 5);
+	fill_pattern(buf_ref, window, 5);
+	ref_memmove(buf_ref + doff, buf_ref + soff, len);
+
+	ret = ops->memmove(buf_dst + doff, buf_dst + soff, len);
+	return ret != buf_dst + doff || bytes_differ(buf_dst, buf_ref, window);
+}
+
+static int check_memmove(const struct string_ops *ops)
+{
+	size_t len, i;
+	int fails = 0;
+	int delta;
+
+	/* Overlapping in both directions, including delta 0 */
+	for (delta = -70; delta <= 70; ++delta)
+		for (len = 0; len <= MAX_SMALL_LEN; len += 7)
+			fails += check_memmove_one(ops, 80 + delta, 80, len);
+
+	for (i = 0; i < ARRAY_SIZE(large_lens); ++i) {
+		fails += check_memmove_one(ops, 1, 40, large_lens[i]);
+		fails += check_memmove_one(ops, 40, 1, large_lens[i]);
+		fails += check_memmove_one(ops, 3, 3 + large_lens[i],
+					   large_lens[i]);
+	}
+	return fails;
+}
+
+static int check_memset_one(const struct string_ops *ops, size_t off,
+			    size_t len, int val)
+{
+	size_t window = off + len + 64;
+	void *ret;
+	size_t i;
+
+	fill_pattern(buf_dst, window, 7);
+	fill_pattern(buf_ref, window, 7);
+	for (i = 0; i < len; ++i)
+		buf_ref[off + i] = (__u8)val;
+
+	ret = ops->memset(buf_dst + off, val, len);
+	return ret != buf_dst + off || bytes_differ(buf_dst, buf_ref, window);
+}
+
+static int check_memset(const struct string_ops *ops)
+{
+	size_t off, len, i;
+	int fails = 0;
+
+	for (off = 0; off < 32; ++off)
+		for (len = 0; len <= MAX_SMALL_LEN; ++len)
+			fails += check_memset_one(ops, off, len,
+						  (len & 1) ? 0 : 0x1a5);
+
+	for (i = 0; i < ARRAY_SIZE(large_lens); ++i) {
+		fails += check_memset_one(ops, 0, large_lens[i], 0);
+		fails += check_memset_one(ops, 5, large_lens[i], 0xc3);
+	}
+	return fails;
+}
+
+static int check_memchr(const struct string_ops *ops)
+{
+	size_t off, len, pos;
+	int fails = 0;
+
+	fill_pattern(buf_src, BUF_SIZE, 1);
+	for (off = 0; off < 64; ++off) {
+		for (len = 0; len <= 160; ++len) {
+			__u8 *s = buf_src + off;
+
+			/* Not found, while the bytes just past the end and
+			 * in front of the buffer would match
+			 */
+			s[len] = 0;
+			s[len + 1] = 0;
+			if (off)
+				s[-1] = 0;
+			fails += ops->memchr(s, 0, len) != NULL;
+			for (pos = 0; pos < len; pos += 5) {
+				__u8 saved = s[pos];
+
+				s[pos] = 0;
+				fails += ops->memchr(s, 0, len) != s + pos;
+				fails += ops->memchr(s, 0x100, len) != s + pos;
+				s[pos] = saved;
+			}
+			fill_pattern(buf_src, off + len + 2, 1);
+		}
+	}
+
+	/* Only the first occurrence counts */
+	memset(buf_src, 0x11, 4096);
+	buf_src[3000] = 0x22;
+	buf_src[3001] = 0x22;
+	fails += ops->memchr(buf_src, 0x22, 4096) != buf_src + 3000;
+	fails += ops->memchr(buf_src, 0x22, 3000) != NULL;
+	fill_pattern(buf_src, BUF_SIZE, 1);
+	return fails;
+}
+
+static int sign(int v)
+{
+	return (v > 0) - (v < 0);
+}
+
+static int check_memcmp(const struct string_ops *ops)
+{
+	size_t off, len, pos;
+	int fails = 0;
+
+	fill_pattern(buf_src, BUF_SIZE, 1);
+	fill_pattern(buf_dst, BUF_SIZE, 1);
+	for (off = 0; off < 16; ++off) {
+		for (len = 0; len <= 200; ++len) {
+			fails += ops->memcmp(buf_src + off, buf_dst + off,
+					     len) != 0;
+			fails += ops->memcmp(buf_src + off, buf_dst + off + 1,
+					     len) == 0 && len;
+			for (pos = 0; pos < len; pos += 3) {
+				/* Bytes are compared as unsigned char */
+				buf_dst[off + pos] = 0xff;
+				fails += sign(ops->memcmp(buf_src + off,
+							  buf_dst + off,
+							  len)) != -1;
+				fails += sign(ops->memcmp(buf_dst + off,
+							  buf_src + off,
+							  len)) != 1;
+				buf_dst[off + pos] = buf_src[off + pos];
+			}
+		}
+	}
+	return fails;
+}
+
+static int check_strlen(const struct string_ops *ops)
+{
+	size_t off, len;
+	int fails = 0;
+
+	__u8 saved;
+
+	fill_pattern(buf_src, BUF_SIZE, 1);
+	for (off = 0; off < 64; ++off) {
+		for (len = 0; len <= MAX_SMALL_LEN; ++len) {
+			saved = buf_src[off + len];
+			buf_src[off + len] = '\0';
+			fails += ops->strlen((char *)buf_src + off) != len;
+			buf_src[off + len] = saved;
+		}
+	}
+	return fails;
+}
+
+/* Returns the number of functions that do not match the reference */
+static int check_ops(const struct string_ops *ops)
+{
+	static const struct {
+		const char *name;
+		int (*check)(const struct string_ops *ops);
+	} checks[] = {
+		{ "memcpy",  check_memcpy },
+		{ "memmove", check_memmove },
+		{ "memset",  check_memset },
+		{ "memchr",  check_memchr },
+		{ "memcmp",  check_memcmp },
+		{ "strlen",  check_strlen },
+	};
+	int fails = 0;
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(checks); ++i) {
+		if (checks[i].check(ops)) {
+			uk_test_printf("%s: %s() produces wrong results\n",
+				       ops->name, checks[i].name);
+			fails++;
+		}
+	}
+	return fails;
+}
+
+static const struct string_ops libc_ops = {
+	.name    = "libc",
+	.memcpy  = memcpy,
+	.memmove = memmove,
+	.memset  = memset,
+	.memchr  = memchr,
+	.memcmp  = memcmp,
+	.strlen  = strlen,
+};
+
+UK_TESTCASE(nolibc_string, libc_functions)
+{
+	UK_TEST_ASSERTF(check_ops(&libc_ops) == 0,
+			"%s: functions match the reference", libc_ops.name);
+}
+
+#if CONFIG_LIBNOLIBC_STRING_ARCH
+static void ops_from_variant(struct string_ops *ops,
+			     const struct __nolibc_string_ops *v)
+{
+	ops->name    = v->name;
+	ops->memcpy  = v->memcpy;
+	ops->memmove = v->memmove;
+	ops->memset  = v->memset;
+	ops->memchr  = v->memchr;
+	ops->memcmp  = v->memcmp;
+	ops->strlen  = v->strlen;
+}
+
+/* Exercise every variant that the CPU supports, not only the selected one */
+UK_TESTCASE(nolibc_string, arch_variants)
+{
+	const struct __nolibc_string_ops *v;
+	struct string_ops ops;
+	size_t i;
+
+	v = __nolibc_string_ops_get();
+	uk_test_printf("selected variant: %s\n", v->name);
+
+	for (i = 0; i < __nolibc_string_variants_count; ++i) {
+		v = &__nolibc_string_variants[i];
+		if (!v->supported())
+			continue;
+
+		ops_from_variant(&ops, v);
+		UK_TEST_ASSERTF(check_ops(&ops) == 0,
+				"%s: functions match the reference", ops.name);
+	}
+}
+#endif /* CONFIG_LIBNOLIBC_STRING_ARCH */
+
+#if CONFIG_LIBNOLIBC_TEST_BENCH
+#define BENCH_BYTES	(64UL << 20)
+
+static const size_t bench_lens[] = { 16, 64, 256, 1024, 4096 };
+
+/* Returns MiB/s */
+static __u64 bench_one(const struct string_ops *ops, int fn, size_t len)
+{
+	__nsec start, elapsed;
+	size_t i, iters = BENCH_BYTES / len;
+
+	start = ukplat_monotonic_clock();
+	for (i = 0; i < iters; ++i) {
+		switch (fn) {
+		case 0:
+			ops->memcpy(buf_dst, buf_src, len);
+			break;
+		case 1:
+			ops->memset(buf_dst, (int)i, len);
+			break;
+		default:
+			ops->memchr(buf_src, 0, len);
+			break;
+		}
+		/* Keep the compiler from hoisting the calls */
+		__asm__ __volatile__("" : : : "memory");
+	}
+	elapsed = ukplat_monotonic_clock() - start;
+
+	return elapsed ? (BENCH_BYTES * 1000000000ULL / elapsed) >> 20 : 0;
+}
+
+static void bench_ops(const struct string_ops *ops)
+{
+	static const char * const fn_names[] = { "memcpy", "memset", "memchr" };
+	size_t i;
+	int fn;
+
+	fill_pattern(buf_src, BUF_SIZE, 1);
+	for (fn = 0; fn < (int)ARRAY_SIZE(fn_names); ++fn)
+		for (i = 0; i < ARRAY_SIZE(bench_lens); ++i)
+			uk_test_printf("%s %s(%5lu): %8lu MiB/s\n",
+				       ops->name, fn_names[fn],
+				       (unsigned long)bench_lens[i],
+				       (unsigned long)bench_one(ops, fn,
+								bench_lens[i]));
+}
+
+UK_TESTCASE(nolibc_string, throughput)
+{
+#if CONFIG_LIBNOLIBC_STRING_ARCH
+	const struct __nolibc_string_ops *v;
+	struct string_ops ops;
+	size_t i;
+
+	for (i = 0; i < __nolibc_string_variants_count; ++i) {
+		v = &__nolibc_string_variants[i];
+		if (!v->supported())
+			continue;
+
+		ops_from_variant(&ops, v);
+		bench_ops(&ops);
+	}
+#else /* !CONFIG_LIBNOLIBC_STRING_ARCH */
+	bench_ops(&libc_ops);
+#endif /* !CONFIG_LIBNOLIBC_STRING_ARCH */
+	UK_TEST_EXPECT(1);
+}
+#endif /* CONFIG_LIBNOLIBC_TEST_BENCH */
+
+uk_testsuite_register(nolibc_string, NULL);
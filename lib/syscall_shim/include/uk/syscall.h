@@ -41,6 +41,7 @@
 #include <errno.h>
 #include <stdarg.h>
 #include <uk/print.h>
+#include <uk/preempt.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -153,6 +154,9 @@ typedef long uk_syscall_arg_t;
 /*
  * UK_LLSYSCALL_DEFINE()
  * Low-level variant, does not provide a libc-style wrapper
+ * NOTE: Returning from the raw variant is a safe point for preemption
+ *       (see uk/preempt.h). The errno variant is none because errno
+ *       is not per thread.
  */
 #define __UK_LLSYSCALL_DEFINE(x, rtype, name, ename, rname, ...)	\
 	long ename(UK_ARG_MAPx(x, UK_S_ARG_LONG, __VA_ARGS__));		\
@@ -167,6 +171,7 @@ typedef long uk_syscall_arg_t;
 		if (ret == -1)						\
 			ret = errno ? -errno : -EFAULT;			\
 		errno = _errno;						\
+		uk_preempt_point();					\
 		return ret;						\
 	}								\
 	static inline rtype __##ename(UK_ARG_MAPx(x,			\
@@ -228,6 +233,8 @@ typedef long uk_syscall_arg_t;
 /*
  * UK_LLSYSCALL_R_DEFINE()
  * Low-level variant, does not provide a libc-style wrapper
+ * NOTE: Returning from the raw variant is a safe point for preemption
+ *       (see uk/preempt.h).
  */
 #define __UK_LLSYSCALL_R_DEFINE(x, rtype, name, ename, rname, ...)	\
 	long rname(UK_ARG_MAPx(x, UK_S_ARG_LONG, __VA_ARGS__));		\
@@ -245,9 +252,13 @@ typedef long uk_syscall_arg_t;
 						 __VA_ARGS__));		\
 	long rname(UK_ARG_MAPx(x, UK_S_ARG_LONG, __VA_ARGS__))		\
 	{								\
+		long ret;						\
+									\
 		__UK_SYSCALL_PRINTD(x, rtype, rname, __VA_ARGS__);	\
-		return (long) __##rname(				\
+		ret = (long) __##rname(					\
 			UK_ARG_MAPx(x, UK_S_ARG_CAST_ACTUAL, __VA_ARGS__)); \
+		uk_preempt_point();					\
+		return ret;						\
 	}								\
 	static inline rtype __##rname(UK_ARG_MAPx(x,			\
 						  UK_S_ARG_ACTUAL_MAYBE_UNUSED,\
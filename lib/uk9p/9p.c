@@ -374,70 +374,220 @@ out:
 	return rc;
 }
 
-int64_t uk_9p_read(struct uk_9pdev *dev, struct uk_9pfid *fid,
-		uint64_t offset, uint32_t count, char *buf)
+/* Sizes of the Tread and Twrite messages without the data */
+#define UK_9P_TREAD_HDRSIZE	11U
+#define UK_9P_TWRITE_HDRSIZE	23U
+
+#if CONFIG_LIBUK9P_IO_INFLIGHT
+#define UK_9P_IO_INFLIGHT	CONFIG_LIBUK9P_IO_INFLIGHT
+#else
+#define UK_9P_IO_INFLIGHT	1
+#endif
+
+/* Maximum number of bytes that a single Tread/Twrite can transfer */
+static inline uint32_t io_count_max(struct uk_9pdev *dev,
+		struct uk_9pfid *fid, uint32_t hdrsize)
 {
-	struct uk_9preq *req;
-	int64_t rc;
+	uint32_t count = dev->msize - hdrsize;
 
 	if (fid->iounit != 0)
 		count = MIN(count, fid->iounit);
-	count = MIN(count, dev->msize - 11);
+	return count;
+}
 
-	uk_pr_debug("TREAD fid %u offset %lu count %u\n", fid->fid,
-			offset, count);
+/*
+ * Sends a Tread or Twrite for count bytes at offset, without waiting for
+ * the reply. The request must be completed with io_complete().
+ */
+static struct uk_9preq *io_submit(struct uk_9pdev *dev, struct uk_9pfid *fid,
+		uint8_t type, uint64_t offset, uint32_t count, void *buf)
+{
+	struct uk_9preq *req;
+	int rc;
 
-	req = request_create(dev, UK_9P_TREAD);
+	uk_pr_debug("%s fid %u offset %lu count %u\n",
+			type == UK_9P_TREAD ? "TREAD" : "TWRITE",
+			fid->fid, offset, count);
+
+	req = request_create(dev, type);
 	if (PTRISERR(req))
-		return PTR2ERR(req);
+		return req;
 
 	if ((rc = uk_9preq_write32(req, fid->fid)) ||
 		(rc = uk_9preq_write64(req, offset)) ||
-		(rc = uk_9preq_write32(req, count)) ||
-		(rc = send_and_wait_zc(dev, req, UK_9PREQ_ZCDIR_READ, buf,
-				       count, 11)) ||
-		(rc = uk_9preq_read32(req, &count)))
+		(rc = uk_9preq_write32(req, count)))
+		goto err;
+
+	if (type == UK_9P_TREAD)
+		rc = uk_9preq_ready(req, UK_9PREQ_ZCDIR_READ, buf, count,
+				    UK_9P_TREAD_HDRSIZE);
+	else
+		rc = uk_9preq_ready(req, UK_9PREQ_ZCDIR_WRITE, buf, count, 0);
+	if (rc)
+		goto err;
+	uk_9p_trace_ready(req->tag);
+
+	if ((rc = uk_9pdev_request(dev, req)))
+		goto err;
+	uk_9p_trace_sent(req->tag);
+
+	return req;
+
+err:
+	uk_9pdev_req_remove(dev, req);
+	return ERR2PTR(rc);
+}
+
+/*
+ * Waits for the reply to a request sent with io_submit() and removes it.
+ * Returns the number of bytes transferred, which is never more than count.
+ */
+static int64_t io_complete(struct uk_9pdev *dev, struct uk_9preq *req,
+		uint32_t count)
+{
+	uint32_t done;
+	int64_t rc;
+
+	if ((rc = uk_9preq_waitreply(req)))
 		goto out;
+	uk_9p_trace_received(req->tag);
 
-	uk_pr_debug("RREAD count %u\n", count);
+	if ((rc = uk_9preq_read32(req, &done)))
+		goto out;
 
-	rc = count;
+	uk_pr_debug("%s count %u\n",
+			req->recv.type == UK_9P_RREAD ? "RREAD" : "RWRITE",
+			done);
+
+	rc = (done <= count) ? (int64_t)done : -EIO;
 
 out:
 	uk_9pdev_req_remove(dev, req);
 	return rc;
 }
 
+int64_t uk_9p_read(struct uk_9pdev *dev, struct uk_9pfid *fid,
+		uint64_t offset, uint32_t count, char *buf)
+{
+	struct uk_9preq *req;
+
+	count = MIN(count, io_count_max(dev, fid, UK_9P_TREAD_HDRSIZE));
+
+	req = io_submit(dev, fid, UK_9P_TREAD, offset, count, buf);
+	if (PTRISERR(req))
+		return PTR2ERR(req);
+
+	return io_complete(dev, req, count);
+}
+
 int64_t uk_9p_write(struct uk_9pdev *dev, struct uk_9pfid *fid,
 		uint64_t offset, uint32_t count, const char *buf)
 {
 	struct uk_9preq *req;
-	int64_t rc;
 
-	count = MIN(count, fid->iounit);
-	count = MIN(count, dev->msize - 23);
+	count = MIN(count, io_count_max(dev, fid, UK_9P_TWRITE_HDRSIZE));
 
-	uk_pr_debug("TWRITE fid %u offset %lu count %u\n", fid->fid,
-			offset, count);
-	req = request_create(dev, UK_9P_TWRITE);
+	req = io_submit(dev, fid, UK_9P_TWRITE, offset, count, (void *)buf);
 	if (PTRISERR(req))
 		return PTR2ERR(req);
 
-	if ((rc = uk_9preq_write32(req, fid->fid)) ||
-		(rc = uk_9preq_write64(req, offset)) ||
-		(rc = uk_9preq_write32(req, count)) ||
-		(rc = send_and_wait_zc(dev, req, UK_9PREQ_ZCDIR_WRITE,
-				(void *)buf, count, 23)) ||
-		(rc = uk_9preq_read32(req, &count)))
-		goto out;
+	return io_complete(dev, req, count);
+}
 
-	uk_pr_debug("RWRITE count %u\n", count);
+/*
+ * Splits the iovecs into requests of at most one message each and keeps up
+ * to UK_9P_IO_INFLIGHT of them in flight. Replies are consumed in order, so
+ * that the transfer stops at the first short or failed one; the requests
+ * that were sent after it are still waited for, but their results are
+ * dropped.
+ * Writes are sent one at a time: a Twrite that was sent after a short or
+ * failed one would still modify the file beyond the returned count.
+ */
+static int64_t io_pipelined(struct uk_9pdev *dev, struct uk_9pfid *fid,
+		uint8_t type, uint64_t offset, const struct iovec *iov,
+		int iovcnt)
+{
+	struct uk_9preq *reqs[UK_9P_IO_INFLIGHT];
+	uint32_t counts[UK_9P_IO_INFLIGHT];
+	unsigned int head = 0, nr = 0, slot;
+	uint32_t count, count_max;
+	struct uk_9preq *req;
+	size_t iov_off = 0;
+	int64_t done = 0, rc = 0, ret;
+	unsigned int window;
+	bool stop = false;
+	int i = 0;
+
+	if (type == UK_9P_TREAD) {
+		count_max = io_count_max(dev, fid, UK_9P_TREAD_HDRSIZE);
+		window = UK_9P_IO_INFLIGHT;
+	} else {
+		count_max = io_count_max(dev, fid, UK_9P_TWRITE_HDRSIZE);
+		window = 1;
+	}
 
-	rc = count;
+	for (;;) {
+		/* Fill the window */
+		while (!stop && nr < window && i < iovcnt) {
+			if (iov_off == iov[i].iov_len) {
+				i++;
+				iov_off = 0;
+				continue;
+			}
+
+			count = MIN(iov[i].iov_len - iov_off,
+				    (size_t)count_max);
+			req = io_submit(dev, fid, type, offset, count,
+					(char *)iov[i].iov_base + iov_off);
+			if (PTRISERR(req)) {
+				rc = PTR2ERR(req);
+				stop = true;
+				break;
+			}
+
+			slot = (head + nr) % UK_9P_IO_INFLIGHT;
+			reqs[slot] = req;
+			counts[slot] = count;
+			nr++;
+			offset += count;
+			iov_off += count;
+		}
+
+		if (!nr)
+			break;
+
+		/* Complete the oldest request */
+		ret = io_complete(dev, reqs[head], counts[head]);
+		count = counts[head];
+		head = (head + 1) % UK_9P_IO_INFLIGHT;
+		nr--;
+
+		if (stop)
+			continue;
+		if (ret < 0) {
+			rc = ret;
+			stop = true;
+			continue;
+		}
+
+		done += ret;
+		if ((uint32_t)ret < count)
+			stop = true;
+	}
 
-out:
-	uk_9pdev_req_remove(dev, req);
-	return rc;
+	return done ? done : rc;
+}
+
+int64_t uk_9p_readv(struct uk_9pdev *dev, struct uk_9pfid *fid,
+		uint64_t offset, const struct iovec *iov, int iovcnt)
+{
+	return io_pipelined(dev, fid, UK_9P_TREAD, offset, iov, iovcnt);
+}
+
+int64_t uk_9p_writev(struct uk_9pdev *dev, struct uk_9pfid *fid,
+		uint64_t offset, const struct iovec *iov, int iovcnt)
+{
+	return io_pipelined(dev, fid, UK_9P_TWRITE, offset, iov, iovcnt);
 }
 
 struct uk_9preq *uk_9p_stat(struct uk_9pdev *dev, struct uk_9pfid *fid,
@@ -499,3 +649,313 @@ out:
 	uk_9pdev_req_remove(dev, req);
 	return rc;
 }
+
+int uk_9p_lopen(struct uk_9pdev *dev, struct uk_9pfid *fid, uint32_t flags)
+{
+	struct uk_9preq *req;
+	int rc = 0;
+
+	req = request_create(dev, UK_9P_TLOPEN);
+	if (PTRISERR(req))
+		return PTR2ERR(req);
+
+	uk_pr_debug("TLOPEN fid %u flags %o\n", fid->fid, flags);
+
+	if ((rc = uk_9preq_write32(req, fid->fid)) ||
+		(rc = uk_9preq_write32(req, flags)) ||
+		(rc = send_and_wait_no_zc(dev, req)) ||
+		(rc = uk_9preq_readqid(req, &fid->qid)) ||
+		(rc = uk_9preq_read32(req, &fid->iounit)))
+		goto out;
+
+	uk_pr_debug("RLOPEN qid type %u version %u path %lu iounit %u\n",
+			fid->qid.type, fid->qid.version, fid->qid.path,
+			fid->iounit);
+
+out:
+	uk_9pdev_req_remove(dev, req);
+	return rc;
+}
+
+int uk_9p_lcreate(struct uk_9pdev *dev, struct uk_9pfid *fid,
+		const char *name, uint32_t flags, uint32_t mode, uint32_t gid)
+{
+	struct uk_9preq *req;
+	struct uk_9p_str name_str;
+	int rc = 0;
+
+	uk_9p_str_init(&name_str, name);
+
+	req = request_create(dev, UK_9P_TLCREATE);
+	if (PTRISERR(req))
+		return PTR2ERR(req);
+
+	uk_pr_debug("TLCREATE fid %u name %s flags %o mode %o gid %u\n",
+			fid->fid, name, flags, mode, gid);
+
+	if ((rc = uk_9preq_write32(req, fid->fid)) ||
+		(rc = uk_9preq_writestr(req, &name_str)) ||
+		(rc = uk_9preq_write32(req, flags)) ||
+		(rc = uk_9preq_write32(req, mode)) ||
+		(rc = uk_9preq_write32(req, gid)) ||
+		(rc = send_and_wait_no_zc(dev, req)) ||
+		(rc = uk_9preq_readqid(req, &fid->qid)) ||
+		(rc = uk_9preq_read32(req, &fid->iounit)))
+		goto out;
+
+	uk_pr_debug("RLCREATE qid type %u version %u path %lu iounit %u\n",
+			fid->qid.type, fid->qid.version, fid->qid.path,
+			fid->iounit);
+
+out:
+	uk_9pdev_req_remove(dev, req);
+	return rc;
+}
+
+int uk_9p_mkdir(struct uk_9pdev *dev, struct uk_9pfid *dfid,
+		const char *name, uint32_t mode, uint32_t gid,
+		struct uk_9p_qid *qid)
+{
+	struct uk_9preq *req;
+	struct uk_9p_str name_str;
+	int rc = 0;
+
+	uk_9p_str_init(&name_str, name);
+
+	req = request_create(dev, UK_9P_TMKDIR);
+	if (PTRISERR(req))
+		return PTR2ERR(req);
+
+	uk_pr_debug("TMKDIR dfid %u name %s mode %o gid %u\n",
+			dfid->fid, name, mode, gid);
+
+	if ((rc = uk_9preq_write32(req, dfid->fid)) ||
+		(rc = uk_9preq_writestr(req, &name_str)) ||
+		(rc = uk_9preq_write32(req, mode)) ||
+		(rc = uk_9preq_write32(req, gid)) ||
+		(rc = send_and_wait_no_zc(dev, req)) ||
+		(rc = uk_9preq_readqid(req, qid)))
+		goto out;
+
+	uk_pr_debug("RMKDIR qid type %u version %u path %lu\n",
+			qid->type, qid->version, qid->path);
+
+out:
+	uk_9pdev_req_remove(dev, req);
+	return rc;
+}
+
+int uk_9p_getattr(struct uk_9pdev *dev, struct uk_9pfid *fid,
+		uint64_t request_mask, struct uk_9p_attr *attr)
+{
+	struct uk_9preq *req;
+	int rc = 0;
+
+	req = request_create(dev, UK_9P_TGETATTR);
+	if (PTRISERR(req))
+		return PTR2ERR(req);
+
+	uk_pr_debug("TGETATTR fid %u request_mask 0x%lx\n", fid->fid,
+			request_mask);
+
+	if ((rc = uk_9preq_write32(req, fid->fid)) ||
+		(rc = uk_9preq_write64(req, request_mask)) ||
+		(rc = send_and_wait_no_zc(dev, req)) ||
+		(rc = uk_9preq_read64(req, &attr->valid)) ||
+		(rc = uk_9preq_readqid(req, &attr->qid)) ||
+		(rc = uk_9preq_read32(req, &attr->mode)) ||
+		(rc = uk_9preq_read32(req, &attr->uid)) ||
+		(rc = uk_9preq_read32(req, &attr->gid)) ||
+		(rc = uk_9preq_read64(req, &attr->nlink)) ||
+		(rc = uk_9preq_read64(req, &attr->rdev)) ||
+		(rc = uk_9preq_read64(req, &attr->size)) ||
+		(rc = uk_9preq_read64(req, &attr->blksize)) ||
+		(rc = uk_9preq_read64(req, &attr->blocks)) ||
+		(rc = uk_9preq_read64(req, &attr->atime_sec)) ||
+		(rc = uk_9preq_read64(req, &attr->atime_nsec)) ||
+		(rc = uk_9preq_read64(req, &attr->mtime_sec)) ||
+		(rc = uk_9preq_read64(req, &attr->mtime_nsec)) ||
+		(rc = uk_9preq_read64(req, &attr->ctime_sec)) ||
+		(rc = uk_9preq_read64(req, &attr->ctime_nsec)) ||
+		(rc = uk_9preq_read64(req, &attr->btime_sec)) ||
+		(rc = uk_9preq_read64(req, &attr->btime_nsec)) ||
+		(rc = uk_9preq_read64(req, &attr->gen)) ||
+		(rc = uk_9preq_read64(req, &attr->data_version)))
+		goto out;
+
+	uk_pr_debug("RGETATTR valid 0x%lx mode %o size %lu\n",
+			attr->valid, attr->mode, attr->size);
+
+out:
+	uk_9pdev_req_remove(dev, req);
+	return rc;
+}
+
+int uk_9p_setattr(struct uk_9pdev *dev, struct uk_9pfid *fid,
+		struct uk_9p_iattr *iattr)
+{
+	struct uk_9preq *req;
+	int rc = 0;
+
+	req = request_create(dev, UK_9P_TSETATTR);
+	if (PTRISERR(req))
+		return PTR2ERR(req);
+
+	uk_pr_debug("TSETATTR fid %u valid 0x%x\n", fid->fid, iattr->valid);
+
+	if ((rc = uk_9preq_write32(req, fid->fid)) ||
+		(rc = uk_9preq_write32(req, iattr->valid)) ||
+		(rc = uk_9preq_write32(req, iattr->mode)) ||
+		(rc = uk_9preq_write32(req, iattr->uid)) ||
+		(rc = uk_9preq_write32(req, iattr->gid)) ||
+		(rc = uk_9preq_write64(req, iattr->size)) ||
+		(rc = uk_9preq_write64(req, iattr->atime_sec)) ||
+		(rc = uk_9preq_write64(req, iattr->atime_nsec)) ||
+		(rc = uk_9preq_write64(req, iattr->mtime_sec)) ||
+		(rc = uk_9preq_write64(req, iattr->mtime_nsec)) ||
+		(rc = send_and_wait_no_zc(dev, req)))
+		goto out;
+
+	uk_pr_debug("RSETATTR\n");
+
+out:
+	uk_9pdev_req_remove(dev, req);
+	return rc;
+}
+
+int64_t uk_9p_readdir(struct uk_9pdev *dev, struct uk_9pfid *fid,
+		uint64_t offset, uint32_t count, char *buf)
+{
+	struct uk_9preq *req;
+	int64_t rc;
+
+	if (fid->iounit != 0)
+		count = MIN(count, fid->iounit);
+	count = MIN(count, dev->msize - 11);
+
+	uk_pr_debug("TREADDIR fid %u offset %lu count %u\n", fid->fid,
+			offset, count);
+
+	req = request_create(dev, UK_9P_TREADDIR);
+	if (PTRISERR(req))
+		return PTR2ERR(req);
+
+	if ((rc = uk_9preq_write32(req, fid->fid)) ||
+		(rc = uk_9preq_write64(req, offset)) ||
+		(rc = uk_9preq_write32(req, count)) ||
+		(rc = send_and_wait_zc(dev, req, UK_9PREQ_ZCDIR_READ, buf,
+				       count, 11)) ||
+		(rc = uk_9preq_read32(req, &count)))
+		goto out;
+
+	uk_pr_debug("RREADDIR count %u\n", count);
+
+	rc = count;
+
+out:
+	uk_9pdev_req_remove(dev, req);
+	return rc;
+}
+
+int uk_9p_fsync(struct uk_9pdev *dev, struct uk_9pfid *fid, int datasync)
+{
+	struct uk_9preq *req;
+	int rc = 0;
+
+	req = request_create(dev, UK_9P_TFSYNC);
+	if (PTRISERR(req))
+		return PTR2ERR(req);
+
+	uk_pr_debug("TFSYNC fid %u datasync %d\n", fid->fid, datasync);
+	if ((rc = uk_9preq_write32(req, fid->fid)) ||
+		(rc = uk_9preq_write32(req, datasync ? 1 : 0)) ||
+		(rc = send_and_wait_no_zc(dev, req)))
+		goto out;
+	uk_pr_debug("RFSYNC\n");
+
+out:
+	uk_9pdev_req_remove(dev, req);
+	return rc;
+}
+
+int uk_9p_statfs(struct uk_9pdev *dev, struct uk_9pfid *fid,
+		struct uk_9p_statfs *statfs)
+{
+	struct uk_9preq *req;
+	int rc = 0;
+
+	req = request_create(dev, UK_9P_TSTATFS);
+	if (PTRISERR(req))
+		return PTR2ERR(req);
+
+	uk_pr_debug("TSTATFS fid %u\n", fid->fid);
+
+	if ((rc = uk_9preq_write32(req, fid->fid)) ||
+		(rc = send_and_wait_no_zc(dev, req)) ||
+		(rc = uk_9preq_read32(req, &statfs->type)) ||
+		(rc = uk_9preq_read32(req, &statfs->bsize)) ||
+		(rc = uk_9preq_read64(req, &statfs->blocks)) ||
+		(rc = uk_9preq_read64(req, &statfs->bfree)) ||
+		(rc = uk_9preq_read64(req, &statfs->bavail)) ||
+		(rc = uk_9preq_read64(req, &statfs->files)) ||
+		(rc = uk_9preq_read64(req, &statfs->ffree)) ||
+		(rc = uk_9preq_read64(req, &statfs->fsid)) ||
+		(rc = uk_9preq_read32(req, &statfs->namelen)))
+		goto out;
+
+	uk_pr_debug("RSTATFS type 0x%x bsize %u blocks %lu\n",
+			statfs->type, statfs->bsize, statfs->blocks);
+
+out:
+	uk_9pdev_req_remove(dev, req);
+	return rc;
+}
+
+struct uk_9pfid *uk_9p_xattrwalk(struct uk_9pdev *dev, struct uk_9pfid *fid,
+		const char *name, uint64_t *size)
+{
+	struct uk_9preq *req;
+	struct uk_9pfid *newfid;
+	struct uk_9p_str name_str;
+	int rc = 0;
+
+	uk_9p_str_init(&name_str, name);
+
+	newfid = uk_9pdev_fid_create(dev);
+	if (PTRISERR(newfid))
+		return newfid;
+
+	req = request_create(dev, UK_9P_TXATTRWALK);
+	if (PTRISERR(req)) {
+		uk_9pdev_fid_release(newfid);
+		return (void *)req;
+	}
+
+	uk_pr_debug("TXATTRWALK fid %u newfid %u name %s\n",
+			fid->fid, newfid->fid, name ? name : "<NULL>");
+
+	if ((rc = uk_9preq_write32(req, fid->fid)) ||
+		(rc = uk_9preq_write32(req, newfid->fid)) ||
+		(rc = uk_9preq_writestr(req, &name_str)))
+		goto out;
+
+	if ((rc = send_and_wait_no_zc(dev, req))) {
+		/* As for TWALK, the new fid is not valid after an error. */
+		newfid->was_removed = 1;
+		goto out;
+	}
+
+	if ((rc = uk_9preq_read64(req, size)))
+		goto out;
+
+	uk_pr_debug("RXATTRWALK size %lu\n", *size);
+
+out:
+	uk_9pdev_req_remove(dev, req);
+	if (rc) {
+		uk_9pdev_fid_release(newfid);
+		return ERR2PTR(rc);
+	}
+
+	return newfid;
+}
@@ -63,6 +63,8 @@ void uk_9preq_init(struct uk_9preq *req)
 
 	UK_INIT_LIST_HEAD(&req->_list);
 	uk_refcount_init(&req->refcount, 1);
+	req->cb = NULL;
+	req->cb_arg = NULL;
 #if CONFIG_LIBUKSCHED
 	uk_waitq_init(&req->wq);
 #endif
@@ -165,7 +167,8 @@ int uk_9preq_receive_cb(struct uk_9preq *req, uint32_t recv_size)
 		return -EIO;
 
 	/* Fix the receive size for zero-copy requests. */
-	if (req->recv.zc_buf && req->recv.type != UK_9P_RERROR)
+	if (req->recv.zc_buf && req->recv.type != UK_9P_RERROR &&
+			req->recv.type != UK_9P_RLERROR)
 		req->recv.size = req->recv.zc_offset;
 	else
 		req->recv.size = size;
@@ -173,6 +176,9 @@ int uk_9preq_receive_cb(struct uk_9preq *req, uint32_t recv_size)
 	/* Update the state. */
 	UK_WRITE_ONCE(req->state, UK_9PREQ_RECEIVED);
 
+	if (req->cb)
+		req->cb(req, req->cb_arg);
+
 #if CONFIG_LIBUKSCHED
 	/* Notify any waiting threads. */
 	uk_waitq_wake_up(&req->wq);
@@ -206,7 +212,8 @@ int uk_9preq_error(struct uk_9preq *req)
 
 	if (UK_READ_ONCE(req->state) != UK_9PREQ_RECEIVED)
 		return -EIO;
-	if (req->recv.type != UK_9P_RERROR)
+	if (req->recv.type != UK_9P_RERROR &&
+			req->recv.type != UK_9P_RLERROR)
 		return 0;
 
 	/*
@@ -215,6 +222,18 @@ int uk_9preq_error(struct uk_9preq *req)
 	 */
 	UK_BUGON(req->recv.offset != UK_9P_HEADER_SIZE);
 
+	/* 9P2000.L errors carry only the Linux errno. */
+	if (req->recv.type == UK_9P_RLERROR) {
+		if ((rc = uk_9preq_read32(req, &errcode)) < 0)
+			return rc;
+
+		uk_pr_debug("RLERROR %d\n", errcode);
+		if (errcode == 0 || errcode >= 512)
+			return -EIO;
+
+		return -errcode;
+	}
+
 	if ((rc = uk_9preq_readstr(req, &error)) < 0 ||
 		(rc = uk_9preq_read32(req, &errcode)) < 0)
 		return rc;
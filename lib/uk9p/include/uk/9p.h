@@ -35,6 +35,7 @@
 #include <stdarg.h>
 #include <stdint.h>
 #include <string.h>
+#include <sys/uio.h>
 #include <uk/config.h>
 #include <uk/9p_core.h>
 #include <uk/9pdev.h>
@@ -225,6 +226,52 @@ int64_t uk_9p_read(struct uk_9pdev *dev, struct uk_9pfid *fid,
 int64_t uk_9p_write(struct uk_9pdev *dev, struct uk_9pfid *fid,
 		uint64_t offset, uint32_t count, const char *buf);
 
+/**
+ * Reads from the fid into the given buffers, starting from the given offset.
+ * The transfer is split into as many Tread requests as needed, of which up
+ * to CONFIG_LIBUK9P_IO_INFLIGHT are kept in flight at the same time. As with
+ * uk_9p_read(), fewer bytes than requested are read only close to EOF.
+ *
+ * @param dev
+ *   The Unikraft 9P Device.
+ * @param fid
+ *   9P fid to read from.
+ * @param offset
+ *   Offset at which to start reading.
+ * @param iov
+ *   Buffers to read into.
+ * @param iovcnt
+ *   Number of buffers.
+ * @return
+ *   - (>= 0): Amount of bytes read, 0 indicates end of file.
+ *   - (< 0): An error occurred before any byte could be read.
+ */
+int64_t uk_9p_readv(struct uk_9pdev *dev, struct uk_9pfid *fid,
+		uint64_t offset, const struct iovec *iov, int iovcnt);
+
+/**
+ * Writes the given buffers to the fid, starting from the given offset. The
+ * transfer is split into as many Twrite requests as needed, which are sent
+ * one at a time. It stops at the first request that fails or is short, so
+ * that nothing is written beyond the returned count.
+ *
+ * @param dev
+ *   The Unikraft 9P Device.
+ * @param fid
+ *   9P fid to write to.
+ * @param offset
+ *   Offset at which to start writing.
+ * @param iov
+ *   Buffers to write.
+ * @param iovcnt
+ *   Number of buffers.
+ * @return
+ *   - (>= 0): Amount of bytes written.
+ *   - (< 0): An error occurred before any byte could be written.
+ */
+int64_t uk_9p_writev(struct uk_9pdev *dev, struct uk_9pfid *fid,
+		uint64_t offset, const struct iovec *iov, int iovcnt);
+
 /**
  * Stats the given fid and places the data into the given stat structure.
  *
@@ -256,6 +303,181 @@ struct uk_9preq *uk_9p_stat(struct uk_9pdev *dev, struct uk_9pfid *fid,
 int uk_9p_wstat(struct uk_9pdev *dev, struct uk_9pfid *fid,
 		struct uk_9p_stat *stat);
 
+/**
+ * Opens the file associated with the given fid (9P2000.L).
+ *
+ * @param dev
+ *   The Unikraft 9P Device.
+ * @param fid
+ *   9P fid to open.
+ * @param flags
+ *   Linux open flags (UK_9P_L_O_*).
+ * @return
+ *   - 0: Successful.
+ *   - (< 0): An error occurred.
+ */
+int uk_9p_lopen(struct uk_9pdev *dev, struct uk_9pfid *fid, uint32_t flags);
+
+/**
+ * Creates and opens a regular file in the directory associated with the given
+ * fid (9P2000.L). On success, the fid refers to the newly created file.
+ *
+ * @param dev
+ *   The Unikraft 9P Device.
+ * @param fid
+ *   9P fid of the parent directory.
+ * @param name
+ *   Name of the created file.
+ * @param flags
+ *   Linux open flags (UK_9P_L_O_*).
+ * @param mode
+ *   POSIX mode of the created file.
+ * @param gid
+ *   Numeric group id of the created file.
+ * @return
+ *   - 0: Successful.
+ *   - (< 0): An error occurred.
+ */
+int uk_9p_lcreate(struct uk_9pdev *dev, struct uk_9pfid *fid,
+		const char *name, uint32_t flags, uint32_t mode, uint32_t gid);
+
+/**
+ * Creates a directory in the directory associated with the given fid
+ * (9P2000.L).
+ *
+ * @param dev
+ *   The Unikraft 9P Device.
+ * @param dfid
+ *   9P fid of the parent directory.
+ * @param name
+ *   Name of the created directory.
+ * @param mode
+ *   POSIX mode of the created directory.
+ * @param gid
+ *   Numeric group id of the created directory.
+ * @param qid
+ *   Where to store the qid of the created directory.
+ * @return
+ *   - 0: Successful.
+ *   - (< 0): An error occurred.
+ */
+int uk_9p_mkdir(struct uk_9pdev *dev, struct uk_9pfid *dfid,
+		const char *name, uint32_t mode, uint32_t gid,
+		struct uk_9p_qid *qid);
+
+/**
+ * Gets the attributes of the file associated with the given fid (9P2000.L).
+ * Unlike uk_9p_stat(), the reply has a fixed size and carries no strings.
+ *
+ * @param dev
+ *   The Unikraft 9P Device.
+ * @param fid
+ *   9P fid to get the attributes of.
+ * @param request_mask
+ *   Attributes of interest (UK_9P_GETATTR_*). The server may return more,
+ *   the ones that are valid are reported in attr->valid.
+ * @param attr
+ *   Where to store the attributes.
+ * @return
+ *   - 0: Successful.
+ *   - (< 0): An error occurred.
+ */
+int uk_9p_getattr(struct uk_9pdev *dev, struct uk_9pfid *fid,
+		uint64_t request_mask, struct uk_9p_attr *attr);
+
+/**
+ * Changes the attributes of the file associated with the given fid
+ * (9P2000.L).
+ *
+ * @param dev
+ *   The Unikraft 9P Device.
+ * @param fid
+ *   9P fid to change the attributes of.
+ * @param iattr
+ *   New attributes, only the ones selected in iattr->valid are changed.
+ * @return
+ *   - 0: Successful.
+ *   - (< 0): An error occurred.
+ */
+int uk_9p_setattr(struct uk_9pdev *dev, struct uk_9pfid *fid,
+		struct uk_9p_iattr *iattr);
+
+/**
+ * Reads directory entries from an opened directory fid (9P2000.L). The
+ * buffer is filled with entries that can be parsed with
+ * uk_9preq_readdirent().
+ *
+ * @param dev
+ *   The Unikraft 9P Device.
+ * @param fid
+ *   Opened 9P fid of the directory.
+ * @param offset
+ *   0 to start at the beginning, otherwise the offset field of the last
+ *   entry that was consumed.
+ * @param count
+ *   Maximum number of bytes to read.
+ * @param buf
+ *   Buffer to read the entries into.
+ * @return
+ *   - (>= 0): Amount of bytes read, 0 at the end of the directory.
+ *   - (< 0): An error occurred.
+ */
+int64_t uk_9p_readdir(struct uk_9pdev *dev, struct uk_9pfid *fid,
+		uint64_t offset, uint32_t count, char *buf);
+
+/**
+ * Flushes the data of the file associated with the given fid to stable
+ * storage on the server (9P2000.L).
+ *
+ * @param dev
+ *   The Unikraft 9P Device.
+ * @param fid
+ *   Opened 9P fid of the file.
+ * @param datasync
+ *   Non-zero to flush only the data and the metadata required to read it.
+ * @return
+ *   - 0: Successful.
+ *   - (< 0): An error occurred.
+ */
+int uk_9p_fsync(struct uk_9pdev *dev, struct uk_9pfid *fid, int datasync);
+
+/**
+ * Gets information about the file system that contains the file associated
+ * with the given fid (9P2000.L).
+ *
+ * @param dev
+ *   The Unikraft 9P Device.
+ * @param fid
+ *   9P fid of a file in the file system.
+ * @param statfs
+ *   Where to store the file system information.
+ * @return
+ *   - 0: Successful.
+ *   - (< 0): An error occurred.
+ */
+int uk_9p_statfs(struct uk_9pdev *dev, struct uk_9pfid *fid,
+		struct uk_9p_statfs *statfs);
+
+/**
+ * Prepares the reading of an extended attribute of the file associated with
+ * the given fid (9P2000.L). The value is then read from the returned fid
+ * with uk_9p_read().
+ *
+ * @param dev
+ *   The Unikraft 9P Device.
+ * @param fid
+ *   9P fid of the file.
+ * @param name
+ *   Name of the extended attribute, NULL to read the list of names instead.
+ * @param size
+ *   Where to store the size of the attribute value.
+ * @return
+ *   - (!ERRPTR): The fid to read the attribute value from.
+ *   - ERRPTR: The error returned either by the API or by the remote server.
+ */
+struct uk_9pfid *uk_9p_xattrwalk(struct uk_9pdev *dev, struct uk_9pfid *fid,
+		const char *name, uint64_t *size);
+
 #ifdef __cplusplus
 }
 #endif
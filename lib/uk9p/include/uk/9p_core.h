@@ -50,9 +50,30 @@ extern "C" {
 /**
  * 9P request types.
  *
- * Source: https://github.com/9fans/plan9port/blob/master/include/fcall.h
+ * Sources: https://github.com/9fans/plan9port/blob/master/include/fcall.h,
+ * https://github.com/chaos/diod/blob/master/protocol.md (9P2000.L).
  */
 enum uk_9p_type {
+	UK_9P_TLERROR           = 6,
+	UK_9P_RLERROR,
+	UK_9P_TSTATFS           = 8,
+	UK_9P_RSTATFS,
+	UK_9P_TLOPEN            = 12,
+	UK_9P_RLOPEN,
+	UK_9P_TLCREATE          = 14,
+	UK_9P_RLCREATE,
+	UK_9P_TGETATTR          = 24,
+	UK_9P_RGETATTR,
+	UK_9P_TSETATTR          = 26,
+	UK_9P_RSETATTR,
+	UK_9P_TXATTRWALK        = 30,
+	UK_9P_RXATTRWALK,
+	UK_9P_TREADDIR          = 40,
+	UK_9P_RREADDIR,
+	UK_9P_TFSYNC            = 50,
+	UK_9P_RFSYNC,
+	UK_9P_TMKDIR            = 72,
+	UK_9P_RMKDIR,
 	UK_9P_TVERSION          = 100,
 	UK_9P_RVERSION,
 	UK_9P_TAUTH             = 102,
@@ -212,6 +233,123 @@ struct uk_9p_stat {
 	uint32_t                n_muid;
 };
 
+/**
+ * 9P2000.L open flags, used by TLOPEN and TLCREATE. These are the Linux
+ * open(2) flag values, independently of the ones of the guest libc.
+ */
+#define UK_9P_L_O_RDONLY          00000000
+#define UK_9P_L_O_WRONLY          00000001
+#define UK_9P_L_O_RDWR            00000002
+#define UK_9P_L_O_CREAT           00000100
+#define UK_9P_L_O_EXCL            00000200
+#define UK_9P_L_O_TRUNC           00001000
+#define UK_9P_L_O_APPEND          00002000
+#define UK_9P_L_O_DIRECTORY       00200000
+
+/**
+ * 9P2000.L TGETATTR request mask and RGETATTR valid bits.
+ */
+#define UK_9P_GETATTR_MODE          0x00000001ULL
+#define UK_9P_GETATTR_NLINK         0x00000002ULL
+#define UK_9P_GETATTR_UID           0x00000004ULL
+#define UK_9P_GETATTR_GID           0x00000008ULL
+#define UK_9P_GETATTR_RDEV          0x00000010ULL
+#define UK_9P_GETATTR_ATIME         0x00000020ULL
+#define UK_9P_GETATTR_MTIME         0x00000040ULL
+#define UK_9P_GETATTR_CTIME         0x00000080ULL
+#define UK_9P_GETATTR_INO           0x00000100ULL
+#define UK_9P_GETATTR_SIZE          0x00000200ULL
+#define UK_9P_GETATTR_BLOCKS        0x00000400ULL
+#define UK_9P_GETATTR_BTIME         0x00000800ULL
+#define UK_9P_GETATTR_GEN           0x00001000ULL
+#define UK_9P_GETATTR_DATA_VERSION  0x00002000ULL
+/* Fields that are also part of a POSIX stat structure. */
+#define UK_9P_GETATTR_BASIC         0x000007ffULL
+#define UK_9P_GETATTR_ALL           0x00003fffULL
+
+/**
+ * 9P2000.L attributes, as returned by RGETATTR.
+ */
+struct uk_9p_attr {
+	uint64_t                valid;
+	struct uk_9p_qid        qid;
+	uint32_t                mode;
+	uint32_t                uid;
+	uint32_t                gid;
+	uint64_t                nlink;
+	uint64_t                rdev;
+	uint64_t                size;
+	uint64_t                blksize;
+	uint64_t                blocks;
+	uint64_t                atime_sec;
+	uint64_t                atime_nsec;
+	uint64_t                mtime_sec;
+	uint64_t                mtime_nsec;
+	uint64_t                ctime_sec;
+	uint64_t                ctime_nsec;
+	uint64_t                btime_sec;
+	uint64_t                btime_nsec;
+	uint64_t                gen;
+	uint64_t                data_version;
+};
+
+/**
+ * 9P2000.L TSETATTR valid bits.
+ */
+#define UK_9P_SETATTR_MODE        0x00000001U
+#define UK_9P_SETATTR_UID         0x00000002U
+#define UK_9P_SETATTR_GID         0x00000004U
+#define UK_9P_SETATTR_SIZE        0x00000008U
+#define UK_9P_SETATTR_ATIME       0x00000010U
+#define UK_9P_SETATTR_MTIME       0x00000020U
+#define UK_9P_SETATTR_CTIME       0x00000040U
+/* Take atime/mtime from the request instead of the server's clock. */
+#define UK_9P_SETATTR_ATIME_SET   0x00000080U
+#define UK_9P_SETATTR_MTIME_SET   0x00000100U
+
+/**
+ * 9P2000.L attributes to change with TSETATTR. Only the fields selected by
+ * valid are applied.
+ */
+struct uk_9p_iattr {
+	uint32_t                valid;
+	uint32_t                mode;
+	uint32_t                uid;
+	uint32_t                gid;
+	uint64_t                size;
+	uint64_t                atime_sec;
+	uint64_t                atime_nsec;
+	uint64_t                mtime_sec;
+	uint64_t                mtime_nsec;
+};
+
+/**
+ * 9P2000.L file system information, as returned by RSTATFS.
+ */
+struct uk_9p_statfs {
+	uint32_t                type;
+	uint32_t                bsize;
+	uint64_t                blocks;
+	uint64_t                bfree;
+	uint64_t                bavail;
+	uint64_t                files;
+	uint64_t                ffree;
+	uint64_t                fsid;
+	uint32_t                namelen;
+};
+
+/**
+ * 9P2000.L directory entry, as found in the data of RREADDIR.
+ */
+struct uk_9p_dirent {
+	struct uk_9p_qid        qid;
+	/* Offset to pass to TREADDIR to continue after this entry. */
+	uint64_t                offset;
+	/* Linux dirent d_type (DT_*). */
+	uint8_t                 type;
+	struct uk_9p_str        name;
+};
+
 /*
  * TODO: The wire format is always little-endian. Add little-endian types and
  * cpu_to_le*() data to the required format.
@@ -126,6 +126,21 @@ enum uk_9preq_state {
 	UK_9PREQ_RECEIVED
 };
 
+struct uk_9preq;
+
+/**
+ * Function type of the completion callback of a request. It is called by
+ * the transport layer from its receive path (potentially in interrupt
+ * context) right after the request reached the RECEIVED state, so it must
+ * not block.
+ *
+ * @param req
+ *   The 9P request.
+ * @param arg
+ *   Argument given to uk_9preq_set_cb().
+ */
+typedef void (*uk_9preq_cb_t)(struct uk_9preq *req, void *arg);
+
 /**
  *  Describes a 9P request.
  *
@@ -166,6 +181,9 @@ struct uk_9preq {
 	struct uk_alloc                 *_a;
 	/* Tracks the number of references to this structure. */
 	__atomic                        refcount;
+	/* Completion callback, see uk_9preq_set_cb(). */
+	uk_9preq_cb_t                   cb;
+	void                            *cb_arg;
 #if CONFIG_LIBUKSCHED
 	/* Wait-queue for state changes. */
 	struct uk_waitq                 wq;
@@ -223,6 +241,26 @@ int uk_9preq_put(struct uk_9preq *req);
 int uk_9preq_ready(struct uk_9preq *req, enum uk_9preq_zcdir zc_dir,
 		void *zc_buf, uint32_t zc_size, uint32_t zc_offset);
 
+/**
+ * Sets a callback that is called when the reply to the request is received,
+ * so that the request can be submitted with uk_9pdev_request() without
+ * waiting for the reply in uk_9preq_waitreply(). Must be called before
+ * submitting the request.
+ *
+ * @param req
+ *   The 9P request.
+ * @param cb
+ *   Completion callback, or NULL.
+ * @param arg
+ *   Argument passed to the callback.
+ */
+static inline void uk_9preq_set_cb(struct uk_9preq *req, uk_9preq_cb_t cb,
+		void *arg)
+{
+	req->cb = cb;
+	req->cb_arg = arg;
+}
+
 /**
  * Function called from the transport layer when a request has been received.
  * Implements the transition from the SENT to the RECEIVED state.
@@ -442,6 +480,20 @@ static inline int uk_9preq_readstat(struct uk_9preq *req,
 	return 0;
 }
 
+static inline int uk_9preq_readdirent(struct uk_9preq *req,
+		struct uk_9p_dirent *val)
+{
+	int rc;
+
+	if ((rc = uk_9preq_readqid(req, &val->qid)) ||
+		(rc = uk_9preq_read64(req, &val->offset)) ||
+		(rc = uk_9preq_read8(req, &val->type)) ||
+		(rc = uk_9preq_readstr(req, &val->name)))
+		return rc;
+
+	return 0;
+}
+
 #ifdef __cplusplus
 }
 #endif
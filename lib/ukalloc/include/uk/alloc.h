@@ -38,6 +38,7 @@
 #include <uk/config.h>
 #include <uk/assert.h>
 #include <uk/essentials.h>
+#include <uk/preempt.h>
 #include <errno.h>
 
 #ifdef __cplusplus
@@ -138,11 +139,21 @@ static inline struct uk_alloc *uk_alloc_get_default(void)
 }
 #endif /* !CONFIG_LIBUKALLOC_IFSTATS_PERLIB */
 
-/* wrapper functions */
+/* wrapper functions
+ * NOTE: Allocators are not reentrant. The wrappers disable preemption
+ *       so that a nested call, e.g., an allocator requesting pages from
+ *       its backend, does not become a safe point at which another thread
+ *       enters the allocator.
+ */
 static inline void *uk_do_malloc(struct uk_alloc *a, __sz size)
 {
+	void *ptr;
+
 	UK_ASSERT(a);
-	return a->malloc(a, size);
+	uk_preempt_disable();
+	ptr = a->malloc(a, size);
+	uk_preempt_enable();
+	return ptr;
 }
 
 static inline void *uk_malloc(struct uk_alloc *a, __sz size)
@@ -157,8 +168,13 @@ static inline void *uk_malloc(struct uk_alloc *a, __sz size)
 static inline void *uk_do_calloc(struct uk_alloc *a,
 				 __sz nmemb, __sz size)
 {
+	void *ptr;
+
 	UK_ASSERT(a);
-	return a->calloc(a, nmemb, size);
+	uk_preempt_disable();
+	ptr = a->calloc(a, nmemb, size);
+	uk_preempt_enable();
+	return ptr;
 }
 
 static inline void *uk_calloc(struct uk_alloc *a,
@@ -177,8 +193,13 @@ static inline void *uk_calloc(struct uk_alloc *a,
 static inline void *uk_do_realloc(struct uk_alloc *a,
 				  void *ptr, __sz size)
 {
+	void *ret;
+
 	UK_ASSERT(a);
-	return a->realloc(a, ptr, size);
+	uk_preempt_disable();
+	ret = a->realloc(a, ptr, size);
+	uk_preempt_enable();
+	return ret;
 }
 
 static inline void *uk_realloc(struct uk_alloc *a, void *ptr, __sz size)
@@ -193,8 +214,13 @@ static inline void *uk_realloc(struct uk_alloc *a, void *ptr, __sz size)
 static inline int uk_do_posix_memalign(struct uk_alloc *a, void **memptr,
 				       __sz align, __sz size)
 {
+	int rc;
+
 	UK_ASSERT(a);
-	return a->posix_memalign(a, memptr, align, size);
+	uk_preempt_disable();
+	rc = a->posix_memalign(a, memptr, align, size);
+	uk_preempt_enable();
+	return rc;
 }
 
 static inline int uk_posix_memalign(struct uk_alloc *a, void **memptr,
@@ -210,8 +236,13 @@ static inline int uk_posix_memalign(struct uk_alloc *a, void **memptr,
 static inline void *uk_do_memalign(struct uk_alloc *a,
 				   __sz align, __sz size)
 {
+	void *ptr;
+
 	UK_ASSERT(a);
-	return a->memalign(a, align, size);
+	uk_preempt_disable();
+	ptr = a->memalign(a, align, size);
+	uk_preempt_enable();
+	return ptr;
 }
 
 static inline void *uk_memalign(struct uk_alloc *a,
@@ -225,7 +256,9 @@ static inline void *uk_memalign(struct uk_alloc *a,
 static inline void uk_do_free(struct uk_alloc *a, void *ptr)
 {
 	UK_ASSERT(a);
+	uk_preempt_disable();
 	a->free(a, ptr);
+	uk_preempt_enable();
 }
 
 static inline void uk_free(struct uk_alloc *a, void *ptr)
@@ -235,8 +268,13 @@ static inline void uk_free(struct uk_alloc *a, void *ptr)
 
 static inline void *uk_do_palloc(struct uk_alloc *a, unsigned long num_pages)
 {
+	void *ptr;
+
 	UK_ASSERT(a);
-	return a->palloc(a, num_pages);
+	uk_preempt_disable();
+	ptr = a->palloc(a, num_pages);
+	uk_preempt_enable();
+	return ptr;
 }
 
 static inline void *uk_palloc(struct uk_alloc *a, unsigned long num_pages)
@@ -250,7 +288,9 @@ static inline void uk_do_pfree(struct uk_alloc *a, void *ptr,
 			       unsigned long num_pages)
 {
 	UK_ASSERT(a);
+	uk_preempt_disable();
 	a->pfree(a, ptr, num_pages);
+	uk_preempt_enable();
 }
 
 static inline void uk_pfree(struct uk_alloc *a, void *ptr,
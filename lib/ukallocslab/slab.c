@@ -0,0 +1,515 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* ukallocslab is a size-class slab allocator for small objects.
+ *
+ * Requests of up to SLAB_MAX_SIZE bytes are rounded up to one of a few
+ * size classes. Each class keeps a list of partially used slabs; a slab is
+ * a single page that starts with a small header followed by equally sized
+ * objects. Released objects are put on a free list that is embedded in the
+ * objects themselves, and objects that were never handed out are carved
+ * off lazily, so both malloc() and free() are O(1). Every class caches one
+ * empty slab to avoid bouncing pages when an allocation pattern oscillates
+ * around a slab boundary.
+ *
+ * Larger requests and the page interface are forwarded to a binary buddy
+ * allocator (the backend), which manages the actual memory. Large objects
+ * get a header at the beginning of the page that precedes the returned
+ * pointer, just like slabs, so that free() can tell both apart by looking
+ * at the page of ptr - 1.
+ *
+ * Like the other allocators, this one does not do any locking.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <uk/allocslab.h>
+#include <uk/allocbbuddy.h>
+#include <uk/alloc_impl.h>
+#include <uk/essentials.h>
+#include <uk/assert.h>
+#include <uk/print.h>
+#include <uk/page.h>
+
+#define SLAB_MAGIC_SMALL	0x51ab5e11
+#define SLAB_MAGIC_LARGE	0x51ab1a46
+
+/* Space reserved for the header at the beginning of a slab or a large
+ * object. Keeps objects cache-line aligned at the start of a slab.
+ */
+#define SLAB_HDR_SIZE		64
+/* Alignment of all objects served from slabs */
+#define SLAB_ALIGN		16
+#define SLAB_MAX_SIZE		1024
+
+/* Pages that we leave at least to the backend, see uk_allocslab_init() */
+#define SLAB_BACKEND_MIN_PAGES	4
+
+static const __sz slab_class_size[] = {
+	16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024
+};
+
+#define SLAB_NR_CLASSES		ARRAY_SIZE(slab_class_size)
+
+/* Maps DIV_ROUND_UP(size, SLAB_ALIGN) to a size class */
+static __u8 slab_class_lut[SLAB_MAX_SIZE / SLAB_ALIGN + 1];
+
+struct slab {
+	__u32 magic;
+	__u16 class;
+	__u16 nr_inuse;
+	/* embedded list of released objects */
+	void *free;
+	/* first object that was never handed out */
+	__uptr unused;
+	/* list of slabs with free objects */
+	struct slab *next;
+	struct slab **pprev;
+};
+
+struct slab_large {
+	__u32 magic;
+	unsigned long num_pages;
+	void *base;
+};
+
+UK_CTASSERT(sizeof(struct slab) <= SLAB_HDR_SIZE);
+UK_CTASSERT(sizeof(struct slab_large) <= SLAB_HDR_SIZE);
+
+struct slab_class {
+	__sz size;
+	__u16 nr_objs;
+	struct slab *partial;
+	struct slab *spare;
+};
+
+struct uk_allocslab {
+	struct uk_alloc *backend;
+	struct slab_class classes[SLAB_NR_CLASSES];
+};
+
+#define allocslab_priv(a) ((struct uk_allocslab *)&(a)->priv)
+
+/* Returns the header of the slab or large object that contains ptr */
+static inline void *slab_hdr(const void *ptr)
+{
+	UK_ASSERT((__uptr)ptr > __PAGE_SIZE);
+
+	return (void *)ALIGN_DOWN((__uptr)ptr - 1, (__uptr)__PAGE_SIZE);
+}
+
+static inline unsigned int slab_class_of(__sz size)
+{
+	UK_ASSERT(size && size <= SLAB_MAX_SIZE);
+
+	return slab_class_lut[DIV_ROUND_UP(size, SLAB_ALIGN)];
+}
+
+static inline void slab_link(struct slab_class *c, struct slab *s)
+{
+	s->next = c->partial;
+	s->pprev = &c->partial;
+	if (s->next)
+		s->next->pprev = &s->next;
+	c->partial = s;
+}
+
+static inline void slab_unlink(struct slab *s)
+{
+	*s->pprev = s->next;
+	if (s->next)
+		s->next->pprev = s->pprev;
+}
+
+static struct slab *slab_new(struct uk_allocslab *b, unsigned int class)
+{
+	struct slab_class *c = &b->classes[class];
+	struct slab *s;
+
+	if (c->spare) {
+		s = c->spare;
+		c->spare = NULL;
+	} else {
+		s = uk_palloc(b->backend, 1);
+		if (unlikely(!s))
+			return NULL;
+	}
+
+	s->magic = SLAB_MAGIC_SMALL;
+	s->class = class;
+	s->nr_inuse = 0;
+	s->free = NULL;
+	s->unused = (__uptr)s + SLAB_HDR_SIZE;
+	slab_link(c, s);
+
+	return s;
+}
+
+static void *slab_obj_alloc(struct uk_allocslab *b, unsigned int class)
+{
+	struct slab_class *c = &b->classes[class];
+	struct slab *s;
+	void *obj;
+
+	s = c->partial;
+	if (!s) {
+		s = slab_new(b, class);
+		if (unlikely(!s))
+			return NULL;
+	}
+
+	if (s->free) {
+		obj = s->free;
+		s->free = *(void **)obj;
+	} else {
+		obj = (void *)s->unused;
+		s->unused += c->size;
+	}
+
+	if (++s->nr_inuse == c->nr_objs)
+		slab_unlink(s);
+
+	return obj;
+}
+
+static void slab_obj_free(struct uk_allocslab *b, struct slab *s, void *obj)
+{
+	struct slab_class *c = &b->classes[s->class];
+
+	UK_ASSERT(s->nr_inuse > 0);
+	UK_ASSERT(((__uptr)obj - (__uptr)s - SLAB_HDR_SIZE) % c->size == 0);
+
+	*(void **)obj = s->free;
+	s->free = obj;
+
+	/* A full slab is not on the partial list */
+	if (s->nr_inuse-- == c->nr_objs)
+		slab_link(c, s);
+
+	if (s->nr_inuse)
+		return;
+
+	slab_unlink(s);
+	if (!c->spare)
+		c->spare = s;
+	else
+		uk_pfree(b->backend, s, 1);
+}
+
+static void *slab_large_alloc(struct uk_allocslab *b, __sz size,
+			      __sz align)
+{
+	struct slab_large *hdr;
+	unsigned long num_pages;
+	__uptr base, ptr;
+	__sz realsize;
+
+	if (align < SLAB_HDR_SIZE)
+		align = SLAB_HDR_SIZE;
+
+	/* The pages are page-aligned, so for align <= __PAGE_SIZE the first
+	 * aligned pointer after the header is at base + align. For larger
+	 * alignments we may need up to align bytes more.
+	 */
+	if (align <= __PAGE_SIZE)
+		realsize = size + align;
+	else
+		realsize = size + align + SLAB_HDR_SIZE;
+	if (realsize < size)
+		return NULL;
+
+	num_pages = DIV_ROUND_UP(realsize, __PAGE_SIZE);
+	base = (__uptr)uk_palloc(b->backend, num_pages);
+	if (unlikely(!base))
+		return NULL;
+
+	ptr = ALIGN_UP(base + SLAB_HDR_SIZE, (__uptr)align);
+	hdr = slab_hdr((void *)ptr);
+	UK_ASSERT((__uptr)hdr >= base);
+	UK_ASSERT((__uptr)hdr + SLAB_HDR_SIZE <= ptr);
+
+	hdr->magic = SLAB_MAGIC_LARGE;
+	hdr->num_pages = num_pages;
+	hdr->base = (void *)base;
+
+	return (void *)ptr;
+}
+
+/* Returns the number of bytes that can be used at ptr */
+static __sz slab_usable_size(struct uk_allocslab *b, const void *ptr)
+{
+	struct slab_large *hdr = slab_hdr(ptr);
+
+	if (hdr->magic == SLAB_MAGIC_SMALL)
+		return b->classes[((struct slab *)hdr)->class].size;
+
+	UK_ASSERT(hdr->magic == SLAB_MAGIC_LARGE);
+	return (__uptr)hdr->base + (hdr->num_pages << __PAGE_SHIFT)
+	       - (__uptr)ptr;
+}
+
+static void *uk_allocslab_malloc(struct uk_alloc *a, __sz size)
+{
+	struct uk_allocslab *b;
+	void *ptr;
+
+	UK_ASSERT(a);
+	b = allocslab_priv(a);
+
+	if (unlikely(!size))
+		return NULL;
+
+	if (size <= SLAB_MAX_SIZE)
+		ptr = slab_obj_alloc(b, slab_class_of(size));
+	else
+		ptr = slab_large_alloc(b, size, SLAB_ALIGN);
+
+	if (unlikely(!ptr)) {
+		uk_alloc_stats_count_enomem(a, size);
+		return NULL;
+	}
+
+	uk_alloc_stats_count_alloc(a, ptr, slab_usable_size(b, ptr));
+	return ptr;
+}
+
+static void uk_allocslab_free(struct uk_alloc *a, void *ptr)
+{
+	struct uk_allocslab *b;
+	struct slab_large *hdr;
+
+	UK_ASSERT(a);
+	b = allocslab_priv(a);
+
+	if (!ptr)
+		return;
+
+	uk_alloc_stats_count_free(a, ptr, slab_usable_size(b, ptr));
+
+	hdr = slab_hdr(ptr);
+	if (hdr->magic == SLAB_MAGIC_SMALL) {
+		slab_obj_free(b, (struct slab *)hdr, ptr);
+		return;
+	}
+
+	UK_ASSERT(hdr->magic == SLAB_MAGIC_LARGE);
+	hdr->magic = 0;
+	uk_pfree(b->backend, hdr->base, hdr->num_pages);
+}
+
+static int uk_allocslab_posix_memalign(struct uk_alloc *a, void **memptr,
+				       __sz align, __sz size)
+{
+	struct uk_allocslab *b;
+	void *ptr;
+
+	UK_ASSERT(a);
+	b = allocslab_priv(a);
+
+	if (((align - 1) & align) != 0 || (align % sizeof(void *)) != 0)
+		return EINVAL;
+
+	/* See uk_posix_memalign_ifpages() */
+	if (!size)
+		return EINVAL;
+
+	if (align <= SLAB_ALIGN && size <= SLAB_MAX_SIZE)
+		ptr = slab_obj_alloc(b, slab_class_of(size));
+	else
+		ptr = slab_large_alloc(b, size, align);
+
+	if (unlikely(!ptr)) {
+		uk_alloc_stats_count_enomem(a, size);
+		return ENOMEM;
+	}
+
+	uk_alloc_stats_count_alloc(a, ptr, slab_usable_size(b, ptr));
+	*memptr = ptr;
+	return 0;
+}
+
+static void *uk_allocslab_realloc(struct uk_alloc *a, void *ptr, __sz size)
+{
+	struct uk_allocslab *b;
+	struct slab_large *hdr;
+	__sz cursize;
+	void *retptr;
+
+	UK_ASSERT(a);
+	b = allocslab_priv(a);
+
+	if (!ptr)
+		return uk_allocslab_malloc(a, size);
+
+	if (!size) {
+		uk_allocslab_free(a, ptr);
+		return NULL;
+	}
+
+	/* Stay in place if the object keeps its size class or if a large
+	 * object still fits and does not become small
+	 */
+	cursize = slab_usable_size(b, ptr);
+	hdr = slab_hdr(ptr);
+	if (hdr->magic == SLAB_MAGIC_SMALL) {
+		if (size <= SLAB_MAX_SIZE &&
+		    slab_class_of(size) == ((struct slab *)hdr)->class)
+			return ptr;
+	} else if (size <= cursize && size > SLAB_MAX_SIZE) {
+		return ptr;
+	}
+
+	retptr = uk_allocslab_malloc(a, size);
+	if (!retptr)
+		return NULL;
+
+	memcpy(retptr, ptr, MIN(size, cursize));
+	uk_allocslab_free(a, ptr);
+	return retptr;
+}
+
+static void *uk_allocslab_palloc(struct uk_alloc *a, unsigned long num_pages)
+{
+	void *ptr;
+
+	UK_ASSERT(a);
+
+	ptr = uk_palloc(allocslab_priv(a)->backend, num_pages);
+	uk_alloc_stats_count_palloc(a, ptr, num_pages);
+	return ptr;
+}
+
+static void uk_allocslab_pfree(struct uk_alloc *a, void *ptr,
+			       unsigned long num_pages)
+{
+	UK_ASSERT(a);
+
+	uk_alloc_stats_count_pfree(a, ptr, num_pages);
+	uk_pfree(allocslab_priv(a)->backend, ptr, num_pages);
+}
+
+static __ssz uk_allocslab_maxalloc(struct uk_alloc *a)
+{
+	long num_pages;
+
+	UK_ASSERT(a);
+
+	num_pages = uk_alloc_pmaxalloc(allocslab_priv(a)->backend);
+	if (num_pages <= 0)
+		return (__ssz) num_pages;
+
+	return (((__ssz) num_pages) << __PAGE_SHIFT) - SLAB_HDR_SIZE;
+}
+
+static long uk_allocslab_pmaxalloc(struct uk_alloc *a)
+{
+	UK_ASSERT(a);
+
+	return uk_alloc_pmaxalloc(allocslab_priv(a)->backend);
+}
+
+static int uk_allocslab_addmem(struct uk_alloc *a, void *base, __sz len)
+{
+	UK_ASSERT(a);
+
+	return uk_alloc_addmem(allocslab_priv(a)->backend, base, len);
+}
+
+struct uk_alloc *uk_allocslab_init(void *base, size_t len)
+{
+	struct uk_alloc *a;
+	struct uk_allocslab *b;
+	size_t metalen;
+	uintptr_t min, max;
+	unsigned int i, class;
+
+	min = round_pgup((uintptr_t)base);
+	max = round_pgdown((uintptr_t)base + (uintptr_t)len);
+	metalen = round_pgup(sizeof(*a) + sizeof(*b));
+
+	/* enough space for allocator and backend available? */
+	if (max <= min ||
+	    min + metalen + SLAB_BACKEND_MIN_PAGES * __PAGE_SIZE > max) {
+		uk_pr_err("Not enough space for allocator: %"__PRIsz
+			  " B required but only %"__PRIuptr" B usable\n",
+			  (__sz)(metalen + SLAB_BACKEND_MIN_PAGES * __PAGE_SIZE),
+			  max > min ? max - min : 0);
+		return NULL;
+	}
+
+	a = (struct uk_alloc *)min;
+	uk_pr_info("Initialize slab allocator @ 0x%"__PRIuptr"\n",
+		   (uintptr_t)a);
+	memset(a, 0, metalen);
+	b = allocslab_priv(a);
+
+	for (i = 0, class = 0; i < ARRAY_SIZE(slab_class_lut); ++i) {
+		while (slab_class_size[class] < i * SLAB_ALIGN)
+			class++;
+		slab_class_lut[i] = class;
+	}
+
+	for (class = 0; class < SLAB_NR_CLASSES; ++class) {
+		b->classes[class].size = slab_class_size[class];
+		b->classes[class].nr_objs = (__PAGE_SIZE - SLAB_HDR_SIZE)
+					    / slab_class_size[class];
+	}
+
+	a->malloc         = uk_allocslab_malloc;
+	a->calloc         = uk_calloc_compat;
+	a->realloc        = uk_allocslab_realloc;
+	a->posix_memalign = uk_allocslab_posix_memalign;
+	a->memalign       = uk_memalign_compat;
+	a->free           = uk_allocslab_free;
+	a->palloc         = uk_allocslab_palloc;
+	a->pfree          = uk_allocslab_pfree;
+	a->maxalloc       = uk_allocslab_maxalloc;
+	a->pmaxalloc      = uk_allocslab_pmaxalloc;
+	a->addmem         = uk_allocslab_addmem;
+	/* availmem and pavailmem are left unimplemented on purpose: the
+	 * backend is registered as well, so uk_alloc_availmem_total() would
+	 * count its free memory twice
+	 */
+
+	/* Register before the backend, so that we become the default
+	 * allocator
+	 */
+	uk_alloc_stats_reset(a);
+	uk_alloc_register(a);
+
+	b->backend = uk_allocbbuddy_init((void *)(min + metalen),
+					 (size_t)(max - min - metalen));
+	if (unlikely(!b->backend))
+		UK_CRASH("Failed to initialize backend page allocator\n");
+
+	return a;
+}
@@ -0,0 +1,196 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <string.h>
+#include <uk/test.h>
+#include <uk/essentials.h>
+#include <uk/arch/limits.h>
+#include <uk/alloc.h>
+#include <uk/allocslab.h>
+
+#define TEST_PAGES		32
+
+/*
+ * Sets up a slab allocator on pages of the default allocator. Allocators
+ * cannot be unregistered, so the pages stay with the instance. The
+ * backend page allocator is registered right after the slab allocator.
+ */
+static struct uk_alloc *slab_test_init(struct uk_alloc **backend)
+{
+	struct uk_alloc *a;
+	void *base;
+
+	base = uk_palloc(uk_alloc_get_default(), TEST_PAGES);
+	if (!base)
+		return NULL;
+
+	a = uk_allocslab_init(base, TEST_PAGES * __PAGE_SIZE);
+	if (!a)
+		return NULL;
+
+	*backend = a->next;
+	return a;
+}
+
+UK_TESTCASE(ukallocslab, size_classes)
+{
+	static const struct {
+		__sz size;
+		__sz class_size;
+	} t[] = {
+		{ 1, 16 }, { 16, 16 }, { 17, 32 }, { 33, 48 }, { 100, 128 },
+		{ 129, 192 }, { 700, 768 }, { 1000, 1024 }, { 1024, 1024 }
+	};
+	struct uk_alloc *a, *backend;
+	char *p1, *p2, *p3;
+	unsigned int i;
+
+	a = slab_test_init(&backend);
+	UK_TEST_EXPECT_NOT_NULL(a);
+	if (!a)
+		return;
+
+	for (i = 0; i < ARRAY_SIZE(t); i++) {
+		/* A fresh slab hands out its objects one after another */
+		p1 = uk_malloc(a, t[i].size);
+		p2 = uk_malloc(a, t[i].size);
+		UK_TEST_EXPECT_NOT_NULL(p1);
+		UK_TEST_EXPECT_NOT_NULL(p2);
+		UK_TEST_EXPECT_ZERO((__uptr)p1 % 16);
+		UK_TEST_EXPECT_SNUM_EQ(p2 - p1, t[i].class_size);
+
+		/* The last released object is handed out first */
+		uk_free(a, p1);
+		p3 = uk_malloc(a, t[i].class_size);
+		UK_TEST_EXPECT_PTR_EQ(p3, p1);
+
+		uk_free(a, p2);
+		uk_free(a, p3);
+	}
+}
+
+UK_TESTCASE(ukallocslab, large_fallback)
+{
+	struct uk_alloc *a, *backend;
+	long avail;
+	void *p, *q;
+
+	a = slab_test_init(&backend);
+	UK_TEST_EXPECT_NOT_NULL(a);
+	if (!a)
+		return;
+
+	avail = uk_alloc_pavailmem(backend);
+	UK_TEST_EXPECT(avail > 0);
+
+	/* Larger objects get their own pages, including the header */
+	p = uk_malloc(a, 2 * __PAGE_SIZE - 64);
+	UK_TEST_EXPECT_NOT_NULL(p);
+	UK_TEST_EXPECT_SNUM_EQ(uk_alloc_pavailmem(backend), avail - 2);
+	memset(p, 0xa5, 2 * __PAGE_SIZE - 64);
+
+	q = uk_malloc(a, 1025);
+	UK_TEST_EXPECT_NOT_NULL(q);
+	UK_TEST_EXPECT_SNUM_EQ(uk_alloc_pavailmem(backend), avail - 3);
+
+	uk_free(a, p);
+	uk_free(a, q);
+	UK_TEST_EXPECT_SNUM_EQ(uk_alloc_pavailmem(backend), avail);
+
+	/* Alignments beyond the slab alignment are served from pages */
+	UK_TEST_EXPECT_ZERO(uk_posix_memalign(a, &p, __PAGE_SIZE, 100));
+	UK_TEST_EXPECT_ZERO((__uptr)p % __PAGE_SIZE);
+	UK_TEST_EXPECT(uk_alloc_pavailmem(backend) < avail);
+	uk_free(a, p);
+	UK_TEST_EXPECT_SNUM_EQ(uk_alloc_pavailmem(backend), avail);
+
+	/* Requests that the backend cannot serve fail */
+	UK_TEST_EXPECT_NULL(uk_malloc(a, TEST_PAGES * __PAGE_SIZE));
+}
+
+static int slab_test_check(const char *p, __sz len)
+{
+	__sz i;
+
+	for (i = 0; i < len; i++)
+		if (p[i] != (char)i)
+			return 0;
+	return 1;
+}
+
+UK_TESTCASE(ukallocslab, realloc_classes)
+{
+	struct uk_alloc *a, *backend;
+	char *p, *q;
+	__sz i;
+
+	a = slab_test_init(&backend);
+	UK_TEST_EXPECT_NOT_NULL(a);
+	if (!a)
+		return;
+
+	p = uk_malloc(a, 20);
+	UK_TEST_EXPECT_NOT_NULL(p);
+	if (!p)
+		return;
+	for (i = 0; i < 20; i++)
+		p[i] = (char)i;
+
+	/* Within the size class the object stays in place */
+	UK_TEST_EXPECT_PTR_EQ(uk_realloc(a, p, 32), p);
+
+	/* Into the next size class */
+	q = uk_realloc(a, p, 40);
+	UK_TEST_EXPECT_NOT_NULL(q);
+	UK_TEST_EXPECT(q != p);
+	UK_TEST_EXPECT(slab_test_check(q, 20));
+	for (i = 20; i < 40; i++)
+		q[i] = (char)i;
+
+	/* From a slab to own pages */
+	p = uk_realloc(a, q, 3 * __PAGE_SIZE);
+	UK_TEST_EXPECT_NOT_NULL(p);
+	UK_TEST_EXPECT(slab_test_check(p, 40));
+	for (i = 40; i < 2000; i++)
+		p[i] = (char)i;
+
+	/* A large object that still fits stays in place */
+	UK_TEST_EXPECT_PTR_EQ(uk_realloc(a, p, 2000), p);
+
+	/* From own pages back to a slab */
+	q = uk_realloc(a, p, 100);
+	UK_TEST_EXPECT_NOT_NULL(q);
+	UK_TEST_EXPECT(slab_test_check(q, 100));
+
+	UK_TEST_EXPECT_NULL(uk_realloc(a, q, 0));
+}
+
+uk_testsuite_register(ukallocslab, NULL);
@@ -227,6 +227,10 @@ static int _create_event_handler(uk_blkdev_queue_event_t callback,
 #endif
 		struct uk_blkdev_event_handler *event_handler)
 {
+#if CONFIG_LIBUKBLKDEV_DISPATCHERTHREADS
+	uk_thread_attr_t attr;
+#endif
+
 	UK_ASSERT(event_handler);
 	UK_ASSERT(callback || (!callback && !cookie));
 
@@ -252,10 +256,14 @@ static int _create_event_handler(uk_blkdev_queue_event_t callback,
 		event_handler->dispatcher_name = NULL;
 	}
 
-	/* Create thread */
+	/* Create thread, ahead of application threads on a priority
+	 * scheduler
+	 */
+	uk_thread_attr_init(&attr);
+	uk_thread_attr_set_prio(&attr, UK_THREAD_ATTR_PRIO_IO);
 	event_handler->dispatcher = uk_sched_thread_create(
 			event_handler->dispatcher_s,
-			event_handler->dispatcher_name, NULL,
+			event_handler->dispatcher_name, &attr,
 			_dispatcher, (void *)event_handler);
 	if (event_handler->dispatcher == NULL) {
 		if (event_handler->dispatcher_name) {
@@ -43,6 +43,8 @@
 #include <uk/allocbbuddy.h>
 #elif CONFIG_LIBUKBOOT_INITREGION
 #include <uk/allocregion.h>
+#elif CONFIG_LIBUKBOOT_INITSLAB
+#include <uk/allocslab.h>
 #elif CONFIG_LIBUKBOOT_INITMIMALLOC
 #include <uk/mimalloc.h>
 #elif CONFIG_LIBUKBOOT_INITTLSF
@@ -300,6 +302,8 @@ void ukplat_entry(int argc, char *argv[])
 			a = uk_allocbbuddy_init(md.base, md.len);
 #elif CONFIG_LIBUKBOOT_INITREGION
 			a = uk_allocregion_init(md.base, md.len);
+#elif CONFIG_LIBUKBOOT_INITSLAB
+			a = uk_allocslab_init(md.base, md.len);
 #elif CONFIG_LIBUKBOOT_INITMIMALLOC
 			a = uk_mimalloc_init(md.base, md.len);
 #elif CONFIG_LIBUKBOOT_INITTLSF
@@ -53,23 +53,50 @@ void uk_console_register_device(struct uk_console_device *uk_cdev)
 void uk_console_putc(char ch)
 {
 	UK_ASSERT(dev);
-	UK_ASSERT(dev->ops.putc);
 
-	dev->ops.putc(dev, ch);
+	if (dev->ops.putc)
+		dev->ops.putc(dev, ch);
+	else
+		uk_console_write(&ch, 1);
 }
 
 void uk_console_puts(char *str, int len)
 {
-	int i;
+	UK_ASSERT(len >= 0);
+
+	/* Stop at the first NUL character like before */
+	uk_console_write(str, strnlen(str, len));
+}
 
+int uk_console_write(const char *buf, int len)
+{
+	int i, rc;
+
+	UK_ASSERT(dev);
 	UK_ASSERT(len >= 0);
 
-	for (i = 0; i < len; i++) {
-		if (str[i] == '\0') {
-			break;
-		}
-		uk_console_putc(str[i]);
+	if (!dev->ops.write) {
+		UK_ASSERT(dev->ops.putc);
+		for (i = 0; i < len; i++)
+			dev->ops.putc(dev, buf[i]);
+		return len;
 	}
+
+	/* Devices may take less than requested while their buffer is full */
+	for (i = 0; i < len; i += rc) {
+		rc = dev->ops.write(dev, buf + i, len - i);
+		if (unlikely(rc < 0))
+			return rc;
+	}
+	return len;
+}
+
+void uk_console_flush(void)
+{
+	UK_ASSERT(dev);
+
+	if (dev->ops.flush)
+		dev->ops.flush(dev);
 }
 
 char *uk_console_get_buf()
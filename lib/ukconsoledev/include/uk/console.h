@@ -15,6 +15,11 @@ struct uk_console_device;
 
 typedef char (*uk_console_getc_t)(struct uk_console_device *);
 typedef void (*uk_console_putc_t)(struct uk_console_device *, char);
+/* Queue up to len bytes for output, returns the number of bytes taken */
+typedef int (*uk_console_write_t)(struct uk_console_device *,
+				  const char *, int);
+/* Wait until all queued output was consumed by the device */
+typedef void (*uk_console_flush_t)(struct uk_console_device *);
 
 struct uk_console_data {
 	struct uk_console_device *uk_cdev;
@@ -35,6 +40,8 @@ struct uk_console_events {
 struct uk_console_device_ops {
 	uk_console_getc_t getc;
 	uk_console_putc_t putc;
+	uk_console_write_t write;	/**< optional, preferred over putc */
+	uk_console_flush_t flush;	/**< optional */
 };
 
 struct uk_console_device {
@@ -47,6 +54,8 @@ struct uk_console_device *uk_console_get_dev();
 void uk_console_register_device(struct uk_console_device *);
 void uk_console_putc(char);
 void uk_console_puts(char *, int);
+int uk_console_write(const char *, int);
+void uk_console_flush(void);
 char *uk_console_get_buf();
 int uk_console_put_buffer(struct uk_console_device *cdev, char *buf, int len);
 
@@ -38,13 +38,13 @@
 #if CONFIG_LIBUKLOCK_MUTEX
 #include <uk/assert.h>
 #include <uk/plat/lcpu.h>
+#include <uk/plat/spinlock.h>
 #include <uk/thread.h>
 #include <uk/wait.h>
 #include <uk/wait_types.h>
 #include <uk/plat/time.h>
 
 #ifdef CONFIG_LIBUKLOCK_MUTEX_METRICS
-#include <uk/plat/spinlock.h>
 #include <string.h>
 #endif /* CONFIG_LIBUKLOCK_MUTEX_METRICS */
 
@@ -59,6 +59,8 @@ extern "C" {
 struct uk_mutex {
 	int lock_count;
 	struct uk_thread *owner;
+	/* Protects lock_count and owner against other logical CPUs */
+	__spinlock lock;
 	struct uk_waitq wait;
 };
 
@@ -90,7 +92,8 @@ extern __spinlock              _uk_mutex_metrics_lock;
 #endif /* CONFIG_LIBUKLOCK_MUTEX_METRICS */
 
 #define	UK_MUTEX_INITIALIZER(name)				\
-	{ 0, NULL, __WAIT_QUEUE_INITIALIZER((name).wait) }
+	{ 0, NULL, UKARCH_SPINLOCK_INITIALIZER(),		\
+	  __WAIT_QUEUE_INITIALIZER((name).wait) }
 
 void uk_mutex_init(struct uk_mutex *m);
 void uk_mutex_get_metrics(struct uk_mutex_metrics *dst);
@@ -107,10 +110,10 @@ static inline void uk_mutex_lock(struct uk_mutex *m)
 	for (;;) {
 		uk_waitq_wait_event(&m->wait,
 			m->lock_count == 0 || m->owner == current);
-		irqf = ukplat_lcpu_save_irqf();
+		ukplat_spin_lock_irqsave(&m->lock, irqf);
 		if (m->lock_count == 0 || m->owner == current)
 			break;
-		ukplat_lcpu_restore_irqf(irqf);
+		ukplat_spin_unlock_irqrestore(&m->lock, irqf);
 	}
 #ifdef CONFIG_LIBUKLOCK_MUTEX_METRICS
 	ukarch_spin_lock(&_uk_mutex_metrics_lock);
@@ -126,7 +129,7 @@ static inline void uk_mutex_lock(struct uk_mutex *m)
 
 	ukarch_spin_unlock(&_uk_mutex_metrics_lock);
 #endif /* CONFIG_LIBUKLOCK_MUTEX_METRICS */
-	ukplat_lcpu_restore_irqf(irqf);
+	ukplat_spin_unlock_irqrestore(&m->lock, irqf);
 }
 
 static inline int uk_mutex_trylock(struct uk_mutex *m)
@@ -139,7 +142,7 @@ static inline int uk_mutex_trylock(struct uk_mutex *m)
 
 	current = uk_thread_current();
 
-	irqf = ukplat_lcpu_save_irqf();
+	ukplat_spin_lock_irqsave(&m->lock, irqf);
 	if (m->lock_count == 0 || m->owner == current) {
 		ret = 1;
 		m->lock_count++;
@@ -153,7 +156,7 @@ static inline int uk_mutex_trylock(struct uk_mutex *m)
 	_uk_mutex_metrics.total_failed_trylocks += !ret;
 #endif /* CONFIG_LIBUKLOCK_MUTEX_METRICS */
 
-	ukplat_lcpu_restore_irqf(irqf);
+	ukplat_spin_unlock_irqrestore(&m->lock, irqf);
 	return ret;
 }
 
@@ -165,10 +168,11 @@ static inline int uk_mutex_is_locked(struct uk_mutex *m)
 static inline void uk_mutex_unlock(struct uk_mutex *m)
 {
 	unsigned long irqf;
+	int wake = 0;
 
 	UK_ASSERT(m);
 
-	irqf = ukplat_lcpu_save_irqf();
+	ukplat_spin_lock_irqsave(&m->lock, irqf);
 
 #ifdef CONFIG_LIBUKLOCK_MUTEX_METRICS
 	ukarch_spin_lock(&_uk_mutex_metrics_lock);
@@ -177,7 +181,7 @@ static inline void uk_mutex_unlock(struct uk_mutex *m)
 	UK_ASSERT(m->lock_count > 0);
 	if (--m->lock_count == 0) {
 		m->owner = NULL;
-		uk_waitq_wake_up(&m->wait);
+		wake = 1;
 	}
 
 #ifdef CONFIG_LIBUKLOCK_MUTEX_METRICS
@@ -188,7 +192,9 @@ static inline void uk_mutex_unlock(struct uk_mutex *m)
 	ukarch_spin_unlock(&_uk_mutex_metrics_lock);
 #endif /* CONFIG_LIBUKLOCK_MUTEX_METRICS */
 
-	ukplat_lcpu_restore_irqf(irqf);
+	ukplat_spin_unlock_irqrestore(&m->lock, irqf);
+	if (wake)
+		uk_waitq_wake_up(&m->wait);
 }
 
 #define uk_waitq_wait_event_mutex(wq, condition, mutex) \
@@ -31,6 +31,7 @@
 #include <uk/print.h>
 #include <uk/assert.h>
 #include <uk/plat/lcpu.h>
+#include <uk/plat/spinlock.h>
 #include <uk/thread.h>
 #include <uk/wait.h>
 #include <uk/wait_types.h>
@@ -46,6 +47,8 @@ extern "C" {
  */
 struct uk_semaphore {
 	long count;
+	/* Protects count against other logical CPUs */
+	__spinlock lock;
 	struct uk_waitq wait;
 };
 
@@ -59,16 +62,16 @@ static inline void uk_semaphore_down(struct uk_semaphore *s)
 
 	for (;;) {
 		uk_waitq_wait_event(&s->wait, s->count > 0);
-		irqf = ukplat_lcpu_save_irqf();
+		ukplat_spin_lock_irqsave(&s->lock, irqf);
 		if (s->count > 0)
 			break;
-		ukplat_lcpu_restore_irqf(irqf);
+		ukplat_spin_unlock_irqrestore(&s->lock, irqf);
 	}
 	--s->count;
 #ifdef UK_SEMAPHORE_DEBUG
 	uk_pr_debug("Decreased semaphore %p to %ld\n", s, s->count);
 #endif
-	ukplat_lcpu_restore_irqf(irqf);
+	ukplat_spin_unlock_irqrestore(&s->lock, irqf);
 }
 
 static inline int uk_semaphore_down_try(struct uk_semaphore *s)
@@ -78,7 +81,7 @@ static inline int uk_semaphore_down_try(struct uk_semaphore *s)
 
 	UK_ASSERT(s);
 
-	irqf = ukplat_lcpu_save_irqf();
+	ukplat_spin_lock_irqsave(&s->lock, irqf);
 	if (s->count > 0) {
 		ret = 1;
 		--s->count;
@@ -87,7 +90,7 @@ static inline int uk_semaphore_down_try(struct uk_semaphore *s)
 			    s, s->count);
 #endif
 	}
-	ukplat_lcpu_restore_irqf(irqf);
+	ukplat_spin_unlock_irqrestore(&s->lock, irqf);
 	return ret;
 }
 
@@ -105,11 +108,11 @@ static inline __nsec uk_semaphore_down_to(struct uk_semaphore *s,
 
 	for (;;) {
 		uk_waitq_wait_event_deadline(&s->wait, s->count > 0, deadline);
-		irqf = ukplat_lcpu_save_irqf();
+		ukplat_spin_lock_irqsave(&s->lock, irqf);
 		if (s->count > 0 || (deadline &&
 				     ukplat_monotonic_clock() >= deadline))
 			break;
-		ukplat_lcpu_restore_irqf(irqf);
+		ukplat_spin_unlock_irqrestore(&s->lock, irqf);
 	}
 	if (s->count > 0) {
 		s->count--;
@@ -117,11 +120,11 @@ static inline __nsec uk_semaphore_down_to(struct uk_semaphore *s,
 		uk_pr_debug("Decreased semaphore %p to %ld\n",
 			    s, s->count);
 #endif
-		ukplat_lcpu_restore_irqf(irqf);
+		ukplat_spin_unlock_irqrestore(&s->lock, irqf);
 		return ukplat_monotonic_clock() - then;
 	}
 
-	ukplat_lcpu_restore_irqf(irqf);
+	ukplat_spin_unlock_irqrestore(&s->lock, irqf);
 #ifdef UK_SEMAPHORE_DEBUG
 	uk_pr_debug("Timed out while waiting for semaphore %p\n", s);
 #endif
@@ -134,14 +137,14 @@ static inline void uk_semaphore_up(struct uk_semaphore *s)
 
 	UK_ASSERT(s);
 
-	irqf = ukplat_lcpu_save_irqf();
+	ukplat_spin_lock_irqsave(&s->lock, irqf);
 	++s->count;
 #ifdef UK_SEMAPHORE_DEBUG
 	uk_pr_debug("Increased semaphore %p to %ld\n",
 		    s, s->count);
 #endif
+	ukplat_spin_unlock_irqrestore(&s->lock, irqf);
 	uk_waitq_wake_up(&s->wait);
-	ukplat_lcpu_restore_irqf(irqf);
 }
 
 #ifdef __cplusplus
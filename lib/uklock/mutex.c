@@ -12,6 +12,7 @@ void uk_mutex_init(struct uk_mutex *m)
 {
 	m->lock_count = 0;
 	m->owner = NULL;
+	ukarch_spin_init(&m->lock);
 	uk_waitq_init(&m->wait);
 
 #ifdef CONFIG_LIBUKLOCK_MUTEX_METRICS
@@ -0,0 +1,285 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <uk/test.h>
+#include <uk/syscall.h>
+#include <uk/errptr.h>
+#include <uk/arch/limits.h>
+
+/* The raw system calls report errors as negative return values */
+UK_SYSCALL_R_PROTO(6, mmap);
+UK_SYSCALL_R_PROTO(2, munmap);
+UK_SYSCALL_R_PROTO(3, mprotect);
+UK_SYSCALL_R_PROTO(5, mremap);
+UK_SYSCALL_R_PROTO(3, madvise);
+
+#define TEST_PAGES	4
+#define TEST_LEN	(TEST_PAGES * __PAGE_SIZE)
+
+static char *map(void *addr, long len, int prot, int flags)
+{
+	return (char *)uk_syscall_r_mmap((long)addr, len, prot,
+					 flags | MAP_PRIVATE | MAP_ANONYMOUS,
+					 -1, 0);
+}
+
+static long unmap(void *addr, long len)
+{
+	return uk_syscall_r_munmap((long)addr, len);
+}
+
+static void fill(char *p, long len, char seed)
+{
+	long i;
+
+	for (i = 0; i < len; i++)
+		p[i] = (char)(seed + i);
+}
+
+/* Returns 1 if the memory holds the pattern written by fill() */
+static int check(const char *p, long len, char seed)
+{
+	long i;
+
+	for (i = 0; i < len; i++)
+		if (p[i] != (char)(seed + i))
+			return 0;
+	return 1;
+}
+
+static int is_zero(const char *p, long len)
+{
+	long i;
+
+	for (i = 0; i < len; i++)
+		if (p[i])
+			return 0;
+	return 1;
+}
+
+UK_TESTCASE(ukmmap, fault_zero_fill)
+{
+	char *p;
+
+	p = map(NULL, TEST_LEN, PROT_READ | PROT_WRITE, 0);
+	UK_TEST_EXPECT_ZERO(PTRISERR(p));
+	if (PTRISERR(p))
+		return;
+
+	/* Every page is populated with a zeroed frame on first access */
+	UK_TEST_EXPECT_SNUM_EQ(is_zero(p, TEST_LEN), 1);
+
+	fill(p, TEST_LEN, 3);
+	UK_TEST_EXPECT_SNUM_EQ(check(p, TEST_LEN, 3), 1);
+
+	UK_TEST_EXPECT_ZERO(unmap(p, TEST_LEN));
+
+	/* A new mapping at the same place does not see the old contents */
+	p = map(p, TEST_LEN, PROT_READ | PROT_WRITE, MAP_FIXED);
+	UK_TEST_EXPECT_ZERO(PTRISERR(p));
+	if (PTRISERR(p))
+		return;
+
+	UK_TEST_EXPECT_SNUM_EQ(is_zero(p, TEST_LEN), 1);
+	UK_TEST_EXPECT_ZERO(unmap(p, TEST_LEN));
+}
+
+UK_TESTCASE(ukmmap, populate)
+{
+	char *p;
+
+	p = map(NULL, TEST_LEN, PROT_READ, MAP_POPULATE);
+	UK_TEST_EXPECT_ZERO(PTRISERR(p));
+	if (PTRISERR(p))
+		return;
+
+	UK_TEST_EXPECT_SNUM_EQ(is_zero(p, TEST_LEN), 1);
+	UK_TEST_EXPECT_ZERO(unmap(p, TEST_LEN));
+}
+
+UK_TESTCASE(ukmmap, invalid)
+{
+	char *p, *q;
+
+	UK_TEST_EXPECT_PTR_EQ(map(NULL, 0, PROT_READ, 0), ERR2PTR(-EINVAL));
+
+	p = map(NULL, TEST_LEN, PROT_READ | PROT_WRITE, 0);
+	UK_TEST_EXPECT_ZERO(PTRISERR(p));
+	if (PTRISERR(p))
+		return;
+
+	q = map(p, __PAGE_SIZE, PROT_READ, MAP_FIXED_NOREPLACE);
+	UK_TEST_EXPECT_PTR_EQ(q, ERR2PTR(-EEXIST));
+
+	UK_TEST_EXPECT_SNUM_EQ(unmap(p + 1, __PAGE_SIZE), -EINVAL);
+	UK_TEST_EXPECT_ZERO(unmap(p, TEST_LEN));
+
+	/* Remapping an unmapped range fails */
+	q = (char *)uk_syscall_r_mremap((long)p, TEST_LEN, 2 * TEST_LEN,
+					MREMAP_MAYMOVE, 0);
+	UK_TEST_EXPECT_PTR_EQ(q, ERR2PTR(-EFAULT));
+
+	/* Unmapping twice is not an error */
+	UK_TEST_EXPECT_ZERO(unmap(p, TEST_LEN));
+}
+
+UK_TESTCASE(ukmmap, munmap_hole)
+{
+	char *p;
+
+	p = map(NULL, TEST_LEN, PROT_READ | PROT_WRITE, 0);
+	UK_TEST_EXPECT_ZERO(PTRISERR(p));
+	if (PTRISERR(p))
+		return;
+
+	fill(p, TEST_LEN, 5);
+
+	/* Punch a hole into the middle of the mapping */
+	UK_TEST_EXPECT_ZERO(unmap(p + __PAGE_SIZE, __PAGE_SIZE));
+	UK_TEST_EXPECT_SNUM_EQ(check(p, __PAGE_SIZE, 5), 1);
+	UK_TEST_EXPECT_SNUM_EQ(check(p + 2 * __PAGE_SIZE,
+				     TEST_LEN - 2 * __PAGE_SIZE,
+				     (char)(5 + 2 * __PAGE_SIZE)), 1);
+
+	/* The hole is free again */
+	UK_TEST_EXPECT_PTR_EQ(map(p + __PAGE_SIZE, __PAGE_SIZE,
+				  PROT_READ, MAP_FIXED_NOREPLACE),
+			      p + __PAGE_SIZE);
+
+	UK_TEST_EXPECT_ZERO(unmap(p, TEST_LEN));
+}
+
+UK_TESTCASE(ukmmap, mremap)
+{
+	char *p, *q, *r;
+
+	p = map(NULL, TEST_LEN, PROT_READ | PROT_WRITE, 0);
+	UK_TEST_EXPECT_ZERO(PTRISERR(p));
+	if (PTRISERR(p))
+		return;
+
+	fill(p, TEST_LEN, 7);
+
+	/* Shrink in place */
+	q = (char *)uk_syscall_r_mremap((long)p, TEST_LEN, TEST_LEN / 2,
+					0, 0);
+	UK_TEST_EXPECT_PTR_EQ(q, p);
+	UK_TEST_EXPECT_SNUM_EQ(check(p, TEST_LEN / 2, 7), 1);
+
+	/* Block growing in place with a mapping right behind */
+	r = map(p + TEST_LEN / 2, __PAGE_SIZE, PROT_READ,
+		MAP_FIXED_NOREPLACE);
+	UK_TEST_EXPECT_PTR_EQ(r, p + TEST_LEN / 2);
+
+	q = (char *)uk_syscall_r_mremap((long)p, TEST_LEN / 2, TEST_LEN,
+					0, 0);
+	UK_TEST_EXPECT_PTR_EQ(q, ERR2PTR(-ENOMEM));
+
+	/* Moving keeps the contents and populates the rest on demand */
+	q = (char *)uk_syscall_r_mremap((long)p, TEST_LEN / 2, TEST_LEN,
+					MREMAP_MAYMOVE, 0);
+	UK_TEST_EXPECT_ZERO(PTRISERR(q));
+	if (PTRISERR(q))
+		return;
+
+	UK_TEST_EXPECT(q != p);
+	UK_TEST_EXPECT_SNUM_EQ(check(q, TEST_LEN / 2, 7), 1);
+	UK_TEST_EXPECT_SNUM_EQ(is_zero(q + TEST_LEN / 2, TEST_LEN / 2), 1);
+
+	/* The old range is gone */
+	UK_TEST_EXPECT_PTR_EQ(map(p, TEST_LEN / 2, PROT_READ,
+				  MAP_FIXED_NOREPLACE), p);
+
+	UK_TEST_EXPECT_ZERO(unmap(p, TEST_LEN / 2));
+	UK_TEST_EXPECT_ZERO(unmap(r, __PAGE_SIZE));
+	UK_TEST_EXPECT_ZERO(unmap(q, TEST_LEN));
+}
+
+UK_TESTCASE(ukmmap, mprotect_none)
+{
+	char *p;
+
+	p = map(NULL, TEST_LEN, PROT_READ | PROT_WRITE, 0);
+	UK_TEST_EXPECT_ZERO(PTRISERR(p));
+	if (PTRISERR(p))
+		return;
+
+	fill(p, TEST_LEN, 11);
+
+	/* Hidden pages keep their frames and come back with their data */
+	UK_TEST_EXPECT_ZERO(uk_syscall_r_mprotect((long)p, TEST_LEN,
+						  PROT_NONE));
+	UK_TEST_EXPECT_ZERO(uk_syscall_r_mprotect((long)p, TEST_LEN,
+						  PROT_READ | PROT_WRITE));
+	UK_TEST_EXPECT_SNUM_EQ(check(p, TEST_LEN, 11), 1);
+
+	/* Moving hidden pages keeps them as well */
+	UK_TEST_EXPECT_ZERO(uk_syscall_r_mprotect((long)p, TEST_LEN,
+						  PROT_NONE));
+	p = (char *)uk_syscall_r_mremap((long)p, TEST_LEN, 2 * TEST_LEN,
+					MREMAP_MAYMOVE, 0);
+	UK_TEST_EXPECT_ZERO(PTRISERR(p));
+	if (PTRISERR(p))
+		return;
+
+	UK_TEST_EXPECT_ZERO(uk_syscall_r_mprotect((long)p, 2 * TEST_LEN,
+						  PROT_READ));
+	UK_TEST_EXPECT_SNUM_EQ(check(p, TEST_LEN, 11), 1);
+
+	/* Only mapped ranges can be protected */
+	UK_TEST_EXPECT_SNUM_EQ(uk_syscall_r_mprotect((long)p, 3 * TEST_LEN,
+						     PROT_READ), -ENOMEM);
+
+	UK_TEST_EXPECT_ZERO(unmap(p, 2 * TEST_LEN));
+}
+
+UK_TESTCASE(ukmmap, madvise_dontneed)
+{
+	char *p;
+
+	p = map(NULL, TEST_LEN, PROT_READ | PROT_WRITE, 0);
+	UK_TEST_EXPECT_ZERO(PTRISERR(p));
+	if (PTRISERR(p))
+		return;
+
+	fill(p, TEST_LEN, 13);
+	UK_TEST_EXPECT_ZERO(uk_syscall_r_madvise((long)p, TEST_LEN,
+						 MADV_DONTNEED));
+	UK_TEST_EXPECT_SNUM_EQ(is_zero(p, TEST_LEN), 1);
+
+	UK_TEST_EXPECT_ZERO(unmap(p, TEST_LEN));
+}
+
+uk_testsuite_register(ukmmap, NULL);
@@ -0,0 +1,315 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stddef.h>
+#include <uk/essentials.h>
+#include <uk/assert.h>
+#include "vma.h"
+
+static inline int avl_height(struct uk_vma *n)
+{
+	return n ? n->height : 0;
+}
+
+static inline __sz avl_max_gap(struct uk_vma *n)
+{
+	return n ? n->max_gap : 0;
+}
+
+/* Recomputes the height and the largest gap of a node from its children */
+static inline void avl_refresh(struct uk_vma *n)
+{
+	n->height = MAX(avl_height(n->left), avl_height(n->right)) + 1;
+	n->max_gap = MAX(n->gap, MAX(avl_max_gap(n->left),
+				     avl_max_gap(n->right)));
+}
+
+static struct uk_vma *avl_rotate_right(struct uk_vma *n)
+{
+	struct uk_vma *l = n->left;
+
+	n->left = l->right;
+	l->right = n;
+	avl_refresh(n);
+	avl_refresh(l);
+	return l;
+}
+
+static struct uk_vma *avl_rotate_left(struct uk_vma *n)
+{
+	struct uk_vma *r = n->right;
+
+	n->right = r->left;
+	r->left = n;
+	avl_refresh(n);
+	avl_refresh(r);
+	return r;
+}
+
+static struct uk_vma *avl_balance(struct uk_vma *n)
+{
+	int balance;
+
+	avl_refresh(n);
+	balance = avl_height(n->left) - avl_height(n->right);
+
+	if (balance > 1) {
+		if (avl_height(n->left->left) < avl_height(n->left->right))
+			n->left = avl_rotate_left(n->left);
+		return avl_rotate_right(n);
+	}
+
+	if (balance < -1) {
+		if (avl_height(n->right->right) < avl_height(n->right->left))
+			n->right = avl_rotate_right(n->right);
+		return avl_rotate_left(n);
+	}
+
+	return n;
+}
+
+static struct uk_vma *avl_insert(struct uk_vma *n, struct uk_vma *vma)
+{
+	if (!n) {
+		vma->left = NULL;
+		vma->right = NULL;
+		avl_refresh(vma);
+		return vma;
+	}
+
+	if (vma->start < n->start)
+		n->left = avl_insert(n->left, vma);
+	else
+		n->right = avl_insert(n->right, vma);
+
+	return avl_balance(n);
+}
+
+static struct uk_vma *avl_remove_min(struct uk_vma *n, struct uk_vma **min)
+{
+	if (!n->left) {
+		*min = n;
+		return n->right;
+	}
+
+	n->left = avl_remove_min(n->left, min);
+	return avl_balance(n);
+}
+
+static struct uk_vma *avl_remove(struct uk_vma *n, struct uk_vma *vma)
+{
+	struct uk_vma *min;
+
+	UK_ASSERT(n);
+
+	if (vma->start < n->start) {
+		n->left = avl_remove(n->left, vma);
+	} else if (vma->start > n->start) {
+		n->right = avl_remove(n->right, vma);
+	} else {
+		UK_ASSERT(n == vma);
+
+		if (!n->left)
+			return n->right;
+		if (!n->right)
+			return n->left;
+
+		/* Replace the node with its successor */
+		n->right = avl_remove_min(n->right, &min);
+		min->left = n->left;
+		min->right = n->right;
+		n = min;
+	}
+
+	return avl_balance(n);
+}
+
+/* Refreshes the augmented data on the path from the root to vma */
+static void avl_fixup(struct uk_vma *n, struct uk_vma *vma)
+{
+	UK_ASSERT(n);
+
+	if (vma->start < n->start)
+		avl_fixup(n->left, vma);
+	else if (vma->start > n->start)
+		avl_fixup(n->right, vma);
+	else
+		UK_ASSERT(n == vma);
+
+	avl_refresh(n);
+}
+
+static inline void vma_set_gap(struct uk_vmaspace *vs, struct uk_vma *vma)
+{
+	vma->gap = vma->start - (vma->prev ? vma->prev->end : vs->start);
+}
+
+struct uk_vma *vma_find(struct uk_vmaspace *vs, __vaddr_t vaddr)
+{
+	struct uk_vma *n = vs->root;
+
+	while (n) {
+		if (vaddr < n->start)
+			n = n->left;
+		else if (vaddr >= n->end)
+			n = n->right;
+		else
+			return n;
+	}
+
+	return NULL;
+}
+
+struct uk_vma *vma_find_next(struct uk_vmaspace *vs, __vaddr_t vaddr)
+{
+	struct uk_vma *n = vs->root;
+	struct uk_vma *next = NULL;
+
+	while (n) {
+		if (vaddr < n->end) {
+			next = n;
+			n = n->left;
+		} else {
+			n = n->right;
+		}
+	}
+
+	return next;
+}
+
+__vaddr_t vma_find_gap(struct uk_vmaspace *vs, __sz len)
+{
+	struct uk_vma *n = vs->root;
+	__vaddr_t tail;
+
+	UK_ASSERT(len > 0);
+
+	if (n && n->max_gap >= len) {
+		do {
+			if (avl_max_gap(n->left) >= len)
+				n = n->left;
+			else if (n->gap >= len)
+				return n->start - n->gap;
+			else
+				n = n->right;
+		} while (n);
+
+		/* The gaps are inconsistent */
+		UK_ASSERT(0);
+	}
+
+	tail = vs->last ? vs->last->end : vs->start;
+	if (vs->end - tail >= len)
+		return tail;
+
+	return __VADDR_INV;
+}
+
+int vma_range_isfree(struct uk_vmaspace *vs, __vaddr_t vaddr, __sz len)
+{
+	struct uk_vma *next;
+
+	if (vaddr < vs->start || vaddr >= vs->end || len > vs->end - vaddr)
+		return 0;
+
+	next = vma_find_next(vs, vaddr);
+	return !next || next->start >= vaddr + len;
+}
+
+void vma_insert(struct uk_vmaspace *vs, struct uk_vma *vma)
+{
+	struct uk_vma *next;
+
+	UK_ASSERT(vma->start < vma->end);
+	UK_ASSERT(vma_range_isfree(vs, vma->start, vma->end - vma->start));
+
+	next = vma_find_next(vs, vma->start);
+	vma->next = next;
+	vma->prev = next ? next->prev : vs->last;
+
+	if (vma->prev)
+		vma->prev->next = vma;
+	else
+		vs->first = vma;
+
+	if (next)
+		next->prev = vma;
+	else
+		vs->last = vma;
+
+	vma_set_gap(vs, vma);
+	vs->root = avl_insert(vs->root, vma);
+
+	if (next) {
+		vma_set_gap(vs, next);
+		avl_fixup(vs->root, next);
+	}
+}
+
+void vma_remove(struct uk_vmaspace *vs, struct uk_vma *vma)
+{
+	struct uk_vma *next = vma->next;
+
+	if (vma->prev)
+		vma->prev->next = next;
+	else
+		vs->first = next;
+
+	if (next)
+		next->prev = vma->prev;
+	else
+		vs->last = vma->prev;
+
+	vs->root = avl_remove(vs->root, vma);
+
+	if (next) {
+		vma_set_gap(vs, next);
+		avl_fixup(vs->root, next);
+	}
+}
+
+void vma_update(struct uk_vmaspace *vs, struct uk_vma *vma)
+{
+	UK_ASSERT(vma->start < vma->end);
+	UK_ASSERT(!vma->prev || vma->prev->end <= vma->start);
+	UK_ASSERT(!vma->next || vma->next->start >= vma->end);
+	UK_ASSERT(vma->start >= vs->start && vma->end <= vs->end);
+
+	/* The order of the VMAs does not change, so it is sufficient to
+	 * refresh the gaps of the VMA and its successor
+	 */
+	vma_set_gap(vs, vma);
+	avl_fixup(vs->root, vma);
+
+	if (vma->next) {
+		vma_set_gap(vs, vma->next);
+		avl_fixup(vs->root, vma->next);
+	}
+}
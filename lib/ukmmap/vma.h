@@ -0,0 +1,119 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __UKMMAP_VMA_H__
+#define __UKMMAP_VMA_H__
+
+#include <uk/arch/types.h>
+#include <uk/arch/paging.h>
+#include <uk/arch/spinlock.h>
+
+/* The VMA may contain pages that have been made inaccessible with
+ * PROT_NONE but still keep their frame in a non-present PTE
+ */
+#define VMA_F_HIDDEN		0x01
+
+struct uk_vma {
+	__vaddr_t start;
+	__vaddr_t end;
+	int prot;
+	int flags;
+
+	/* Address-ordered list of all VMAs */
+	struct uk_vma *prev;
+	struct uk_vma *next;
+
+	/* AVL tree keyed by start address. Every node also knows the size of
+	 * the free space in front of it and the largest such gap in its
+	 * subtree, so that free address ranges can be found in O(log n).
+	 */
+	struct uk_vma *left;
+	struct uk_vma *right;
+	int height;
+	__sz gap;
+	__sz max_gap;
+};
+
+struct uk_vmaspace {
+	__vaddr_t start;
+	__vaddr_t end;
+
+	struct uk_vma *root;
+	struct uk_vma *first;
+	struct uk_vma *last;
+
+	/* Protects the index. The VMA functions below do not take it. */
+	__spinlock lock;
+};
+
+#define UK_VMASPACE_INITIALIZER(vstart, vend)				\
+	{ .start = (vstart), .end = (vend), .root = __NULL,		\
+	  .first = __NULL, .last = __NULL,				\
+	  .lock = UKARCH_SPINLOCK_INITIALIZER() }
+
+/**
+ * Returns the VMA that contains vaddr or NULL
+ */
+struct uk_vma *vma_find(struct uk_vmaspace *vs, __vaddr_t vaddr);
+
+/**
+ * Returns the first VMA that ends after vaddr (i.e., that contains vaddr or
+ * that follows it) or NULL
+ */
+struct uk_vma *vma_find_next(struct uk_vmaspace *vs, __vaddr_t vaddr);
+
+/**
+ * Returns the lowest address of a free range of len bytes or __VADDR_INV
+ */
+__vaddr_t vma_find_gap(struct uk_vmaspace *vs, __sz len);
+
+/**
+ * Returns 1 if [vaddr, vaddr + len) is within the VMA space and not covered
+ * by any VMA, 0 otherwise
+ */
+int vma_range_isfree(struct uk_vmaspace *vs, __vaddr_t vaddr, __sz len);
+
+/**
+ * Adds a VMA to the index. The address range must be free.
+ */
+void vma_insert(struct uk_vmaspace *vs, struct uk_vma *vma);
+
+/**
+ * Removes a VMA from the index
+ */
+void vma_remove(struct uk_vmaspace *vs, struct uk_vma *vma);
+
+/**
+ * Must be called after the start or end of a VMA changed in place. The
+ * VMA must not overlap its neighbors.
+ */
+void vma_update(struct uk_vmaspace *vs, struct uk_vma *vma);
+
+#endif /* __UKMMAP_VMA_H__ */
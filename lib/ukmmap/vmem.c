@@ -0,0 +1,823 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Anonymous memory mappings on top of the paging API.
+ *
+ * mmap() only reserves an address range in a dedicated virtual address
+ * window by adding a VMA to the index. Frames are assigned on the first
+ * access to a page by the page fault handler, which maps a zeroed frame with
+ * the protection of the VMA. munmap(), mprotect() and mremap() work on
+ * page granularity and may split, trim, or extend VMAs.
+ *
+ * On x86, PROT_NONE cannot be expressed with a present PTE. Populated pages
+ * that become PROT_NONE are therefore unmapped with their PTE and frame kept
+ * (VMA_F_HIDDEN), so that a later mprotect() can bring them back.
+ *
+ * The page fault handler runs with interrupts disabled and must not sleep.
+ * The VMA space is therefore protected by a spinlock that is always taken
+ * with interrupts disabled, which also keeps its holder from being preempted.
+ * Nothing accesses the window while holding the lock without mapping the
+ * pages first, so the lock is never taken recursively by a fault.
+ */
+
+#define _GNU_SOURCE
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <uk/alloc.h>
+#include <uk/arch/limits.h>
+#include <uk/assert.h>
+#include <uk/essentials.h>
+#include <uk/errptr.h>
+#include <uk/event.h>
+#include <uk/print.h>
+#include <uk/syscall.h>
+#include <uk/arch/traps.h>
+#include <uk/plat/paging.h>
+#include <uk/plat/spinlock.h>
+#include "vma.h"
+
+#if UK_LIBC_SYSCALLS
+#include <stdarg.h>
+#endif /* UK_LIBC_SYSCALLS */
+
+#define VMEM_PAGE_FLAGS	(PAGE_FLAG_FORCE_SIZE | PAGE_FLAG_SIZE(PAGE_LEVEL))
+
+static struct uk_vmaspace vmem_space =
+	UK_VMASPACE_INITIALIZER(CONFIG_LIBUKMMAP_VA_BASE,
+				CONFIG_LIBUKMMAP_VA_BASE +
+				CONFIG_LIBUKMMAP_VA_SIZE);
+
+static inline unsigned long vmem_prot_to_attr(int prot)
+{
+	unsigned long attr = PAGE_ATTR_PROT_NONE;
+
+	if (prot & PROT_READ)
+		attr |= PAGE_ATTR_PROT_READ;
+	if (prot & PROT_WRITE)
+		attr |= PAGE_ATTR_PROT_WRITE;
+	if (prot & PROT_EXEC)
+		attr |= PAGE_ATTR_PROT_EXEC;
+
+	return attr;
+}
+
+/* Returns the first page in [vaddr, end) with a valid PTE (present or
+ * hidden), or end. Skips unpopulated page tables as a whole.
+ */
+static __vaddr_t vmem_next_pte(struct uk_pagetable *pt, __vaddr_t vaddr,
+			       __vaddr_t end, __pte_t *pte)
+{
+	unsigned int lvl;
+	int rc;
+
+	while (vaddr < end) {
+		lvl = PAGE_LEVEL;
+		rc = ukplat_pt_walk(pt, vaddr, &lvl, NULL, pte);
+		if (unlikely(rc))
+			return end;
+
+		if (lvl == PAGE_LEVEL) {
+			if (*pte != PT_Lx_PTE_INVALID(PAGE_LEVEL))
+				return vaddr;
+
+			vaddr += PAGE_SIZE;
+			continue;
+		}
+
+		/* We never map large pages into the window */
+		UK_ASSERT(!PT_Lx_PTE_PRESENT(*pte, lvl));
+
+		vaddr = PAGE_Lx_ALIGN_DOWN(vaddr, lvl) + PAGE_Lx_SIZE(lvl);
+	}
+
+	return end;
+}
+
+/* Maps zeroed frames to [vaddr, vaddr + len) */
+static int vmem_map_zero(struct uk_pagetable *pt, __vaddr_t vaddr, __sz len,
+			 int prot)
+{
+	unsigned long attr = vmem_prot_to_attr(prot);
+	unsigned long pages = len >> PAGE_SHIFT;
+	int rc;
+
+	UK_ASSERT(prot != PROT_NONE);
+
+	rc = ukplat_page_map(pt, vaddr, __PADDR_ANY, pages, PAGE_ATTR_PROT_RW,
+			     VMEM_PAGE_FLAGS);
+	if (unlikely(rc)) {
+		ukplat_page_unmap(pt, vaddr, pages, 0);
+		return rc;
+	}
+
+	memset((void *)vaddr, 0, len);
+
+	if (attr != PAGE_ATTR_PROT_RW)
+		ukplat_page_set_attr(pt, vaddr, pages, attr, 0);
+
+	return 0;
+}
+
+/* Makes the hidden pages in [start, end) accessible again with prot */
+static int vmem_unhide(struct uk_pagetable *pt, __vaddr_t start,
+		       __vaddr_t end, int prot)
+{
+	unsigned long attr = vmem_prot_to_attr(prot);
+	__vaddr_t vaddr = start;
+	__pte_t pte;
+	int rc;
+
+	while ((vaddr = vmem_next_pte(pt, vaddr, end, &pte)) < end) {
+		if (!PT_Lx_PTE_PRESENT(pte, PAGE_LEVEL)) {
+			rc = ukplat_page_map(pt, vaddr,
+					     PT_Lx_PTE_PADDR(pte, PAGE_LEVEL),
+					     1, attr, VMEM_PAGE_FLAGS);
+			if (unlikely(rc))
+				return rc;
+		}
+		vaddr += PAGE_SIZE;
+	}
+
+	return 0;
+}
+
+/* Releases the pages and frames in [start, end) of a VMA */
+static void vmem_release(struct uk_pagetable *pt, struct uk_vma *vma,
+			 __vaddr_t start, __vaddr_t end)
+{
+	int rc;
+
+	UK_ASSERT(start >= vma->start && end <= vma->end);
+
+	/* Hidden pages are not present and would be skipped by the unmap.
+	 * Restoring them does not need new page tables, so this cannot fail.
+	 */
+	if (vma->flags & VMA_F_HIDDEN) {
+		rc = vmem_unhide(pt, start, end, PROT_READ);
+		UK_ASSERT(rc == 0);
+	}
+
+	rc = ukplat_page_unmap(pt, start, (end - start) >> PAGE_SHIFT, 0);
+	UK_ASSERT(rc == 0);
+}
+
+static struct uk_vma *vmem_vma_alloc(void)
+{
+	return uk_calloc(uk_alloc_get_default(), 1, sizeof(struct uk_vma));
+}
+
+static void vmem_vma_free(struct uk_vma *vma)
+{
+	uk_free(uk_alloc_get_default(), vma);
+}
+
+/* Splits a VMA at vaddr. Returns the new VMA for [vaddr, end) */
+static struct uk_vma *vmem_split(struct uk_vmaspace *vs, struct uk_vma *vma,
+				 __vaddr_t vaddr)
+{
+	struct uk_vma *tail;
+
+	UK_ASSERT(vaddr > vma->start && vaddr < vma->end);
+	UK_ASSERT(PAGE_ALIGNED(vaddr));
+
+	tail = vmem_vma_alloc();
+	if (unlikely(!tail))
+		return NULL;
+
+	tail->start = vaddr;
+	tail->end = vma->end;
+	tail->prot = vma->prot;
+	tail->flags = vma->flags;
+
+	vma->end = vaddr;
+	vma_update(vs, vma);
+	vma_insert(vs, tail);
+
+	return tail;
+}
+
+/* Merges a VMA with compatible neighbors. Returns the merged VMA. */
+static struct uk_vma *vmem_merge(struct uk_vmaspace *vs, struct uk_vma *vma)
+{
+	struct uk_vma *prev = vma->prev;
+	struct uk_vma *next = vma->next;
+
+	if (next && next->start == vma->end && next->prot == vma->prot &&
+	    next->flags == vma->flags) {
+		vma_remove(vs, next);
+		vma->end = next->end;
+		vma_update(vs, vma);
+		vmem_vma_free(next);
+	}
+
+	if (prev && prev->end == vma->start && prev->prot == vma->prot &&
+	    prev->flags == vma->flags) {
+		vma_remove(vs, vma);
+		prev->end = vma->end;
+		vma_update(vs, prev);
+		vmem_vma_free(vma);
+		vma = prev;
+	}
+
+	return vma;
+}
+
+/* Removes [start, end) from the VMA space */
+static int vmem_unmap(struct uk_vmaspace *vs, __vaddr_t start, __vaddr_t end)
+{
+	struct uk_pagetable *pt = ukplat_pt_get_active();
+	struct uk_vma *vma, *next;
+	__vaddr_t s, e;
+
+	vma = vma_find_next(vs, start);
+	if (!vma)
+		return 0;
+
+	/* Punching a hole needs a new VMA for the part behind the hole. Do
+	 * this first, so that we do not fail halfway.
+	 */
+	if (vma->start < start && vma->end > end) {
+		if (unlikely(!vmem_split(vs, vma, end)))
+			return -ENOMEM;
+	}
+
+	while (vma && vma->start < end) {
+		next = vma->next;
+		s = MAX(vma->start, start);
+		e = MIN(vma->end, end);
+
+		vmem_release(pt, vma, s, e);
+
+		if (s == vma->start && e == vma->end) {
+			vma_remove(vs, vma);
+			vmem_vma_free(vma);
+		} else if (s == vma->start) {
+			vma->start = e;
+			vma_update(vs, vma);
+		} else {
+			UK_ASSERT(e == vma->end);
+			vma->end = s;
+			vma_update(vs, vma);
+		}
+
+		vma = next;
+	}
+
+	return 0;
+}
+
+/* Changes the protection of all pages of a VMA */
+static int vmem_protect(struct uk_pagetable *pt, struct uk_vma *vma, int prot)
+{
+	unsigned long attr = vmem_prot_to_attr(prot);
+	__vaddr_t vaddr = vma->start;
+	__pte_t pte;
+	int rc;
+
+	if (prot == vma->prot)
+		return 0;
+
+	if (prot == PROT_NONE) {
+		rc = ukplat_page_unmap(pt, vma->start,
+				       (vma->end - vma->start) >> PAGE_SHIFT,
+				       PAGE_FLAG_KEEP_PTES |
+				       PAGE_FLAG_KEEP_FRAMES);
+		if (unlikely(rc))
+			return rc;
+
+		vma->flags |= VMA_F_HIDDEN;
+		return 0;
+	}
+
+	if (vma->prot == PROT_NONE) {
+		if (vma->flags & VMA_F_HIDDEN) {
+			rc = vmem_unhide(pt, vma->start, vma->end, prot);
+			if (unlikely(rc))
+				return rc;
+
+			vma->flags &= ~VMA_F_HIDDEN;
+		}
+		return 0;
+	}
+
+	while ((vaddr = vmem_next_pte(pt, vaddr, vma->end, &pte)) <
+	       vma->end) {
+		rc = ukplat_page_set_attr(pt, vaddr, 1, attr, 0);
+		if (unlikely(rc))
+			return rc;
+
+		vaddr += PAGE_SIZE;
+	}
+
+	return 0;
+}
+
+/* Moves the first MIN(old_size, new_size) bytes of [old, old + old_size) to
+ * a new VMA at dst and removes the old range. The destination range must be
+ * free and the old range must be within vma.
+ */
+static int vmem_move(struct uk_vmaspace *vs, struct uk_vma *vma,
+		      __vaddr_t old, __sz old_size, __vaddr_t dst,
+		      __sz new_size)
+{
+	struct uk_pagetable *pt = ukplat_pt_get_active();
+	unsigned long attr = vmem_prot_to_attr(vma->prot);
+	__sz len = MIN(old_size, new_size);
+	struct uk_vma *nvma;
+	__vaddr_t vaddr;
+	__pte_t pte;
+	int prot = vma->prot;
+	int rc;
+
+	UK_ASSERT(old >= vma->start && old + old_size <= vma->end);
+	UK_ASSERT(vma_range_isfree(vs, dst, new_size));
+
+	nvma = vmem_vma_alloc();
+	if (unlikely(!nvma))
+		return -ENOMEM;
+
+	/* Make sure that removing the old range cannot fail */
+	if (old > vma->start && old + old_size < vma->end) {
+		if (unlikely(!vmem_split(vs, vma, old + old_size))) {
+			vmem_vma_free(nvma);
+			return -ENOMEM;
+		}
+	}
+
+	if (vma->flags & VMA_F_HIDDEN) {
+		rc = vmem_unhide(pt, old, old + old_size, PROT_READ);
+		UK_ASSERT(rc == 0);
+		attr = PAGE_ATTR_PROT_READ;
+	}
+
+	/* Map the frames at the destination first, so that we can roll back
+	 * easily if we run out of memory for page tables
+	 */
+	vaddr = old;
+	while ((vaddr = vmem_next_pte(pt, vaddr, old + len, &pte)) <
+	       old + len) {
+		rc = ukplat_page_map(pt, dst + (vaddr - old),
+				     PT_Lx_PTE_PADDR(pte, PAGE_LEVEL), 1,
+				     attr, VMEM_PAGE_FLAGS);
+		if (unlikely(rc)) {
+			ukplat_page_unmap(pt, dst, len >> PAGE_SHIFT,
+					  PAGE_FLAG_KEEP_FRAMES);
+			if (vma->flags & VMA_F_HIDDEN)
+				ukplat_page_unmap(pt, old,
+						  old_size >> PAGE_SHIFT,
+						  PAGE_FLAG_KEEP_PTES |
+						  PAGE_FLAG_KEEP_FRAMES);
+			vmem_vma_free(nvma);
+			return -ENOMEM;
+		}
+
+		vaddr += PAGE_SIZE;
+	}
+
+	rc = ukplat_page_unmap(pt, old, len >> PAGE_SHIFT,
+			       PAGE_FLAG_KEEP_FRAMES);
+	UK_ASSERT(rc == 0);
+
+	rc = vmem_unmap(vs, old, old + old_size);
+	UK_ASSERT(rc == 0);
+
+	nvma->start = dst;
+	nvma->end = dst + new_size;
+	nvma->prot = prot;
+	vma_insert(vs, nvma);
+
+	if (prot == PROT_NONE) {
+		ukplat_page_unmap(pt, dst, len >> PAGE_SHIFT,
+				  PAGE_FLAG_KEEP_PTES | PAGE_FLAG_KEEP_FRAMES);
+		nvma->flags |= VMA_F_HIDDEN;
+	}
+
+	return 0;
+}
+
+static int vmem_fault(void *data)
+{
+	struct ukarch_trap_ctx *ctx = (struct ukarch_trap_ctx *)data;
+	struct uk_pagetable *pt = ukplat_pt_get_active();
+	__vaddr_t vaddr = PAGE_ALIGN_DOWN(ctx->fault_address);
+	unsigned int lvl = PAGE_LEVEL;
+	int ret = UK_EVENT_NOT_HANDLED;
+	struct uk_vma *vma;
+	unsigned long irqf;
+	__pte_t pte;
+	int rc;
+
+	if (vaddr < vmem_space.start || vaddr >= vmem_space.end)
+		return UK_EVENT_NOT_HANDLED;
+
+	ukplat_spin_lock_irqsave(&vmem_space.lock, irqf);
+
+	vma = vma_find(&vmem_space, vaddr);
+	if (!vma || vma->prot == PROT_NONE)
+		goto out;
+
+	rc = ukplat_pt_walk(pt, vaddr, &lvl, NULL, &pte);
+	if (unlikely(rc))
+		goto out;
+
+	if (lvl == PAGE_LEVEL && pte != PT_Lx_PTE_INVALID(PAGE_LEVEL)) {
+		/* The page is present, so this is a protection violation */
+		if (PT_Lx_PTE_PRESENT(pte, PAGE_LEVEL))
+			goto out;
+
+		rc = ukplat_page_map(pt, vaddr,
+				     PT_Lx_PTE_PADDR(pte, PAGE_LEVEL), 1,
+				     vmem_prot_to_attr(vma->prot),
+				     VMEM_PAGE_FLAGS);
+	} else {
+		rc = vmem_map_zero(pt, vaddr, PAGE_SIZE, vma->prot);
+	}
+
+	if (unlikely(rc)) {
+		uk_pr_crit("Failed to map page at 0x%"__PRIvaddr": %d\n",
+			   vaddr, rc);
+		goto out;
+	}
+
+	ret = UK_EVENT_HANDLED;
+out:
+	ukplat_spin_unlock_irqrestore(&vmem_space.lock, irqf);
+	return ret;
+}
+
+UK_EVENT_HANDLER(UKARCH_TRAP_PAGE_FAULT, vmem_fault);
+
+UK_SYSCALL_R_DEFINE(void *, mmap, void *, addr, size_t, len, int, prot,
+		    int, flags, int, fildes, off_t, off)
+{
+	struct uk_vmaspace *vs = &vmem_space;
+	__vaddr_t vaddr = (__vaddr_t)addr;
+	struct uk_vma *vma;
+	unsigned long irqf;
+	void *ret;
+	int rc;
+
+	if (unlikely(!len))
+		return ERR2PTR(-EINVAL);
+
+	if (unlikely(prot & ~(PROT_READ | PROT_WRITE | PROT_EXEC)))
+		return ERR2PTR(-EINVAL);
+
+	if (unlikely(!(flags & (MAP_SHARED | MAP_PRIVATE))))
+		return ERR2PTR(-EINVAL);
+
+	/* There is only a single address space, so shared and private
+	 * anonymous mappings behave the same. Files are not supported.
+	 */
+	if (!(flags & MAP_ANONYMOUS) || fildes != -1 || off)
+		return ERR2PTR(-ENODEV);
+
+	if (len > vs->end - vs->start)
+		return ERR2PTR(-ENOMEM);
+	len = PAGE_ALIGN_UP(len);
+
+	if (flags & (MAP_FIXED | MAP_FIXED_NOREPLACE)) {
+		if (unlikely(!PAGE_ALIGNED(vaddr)))
+			return ERR2PTR(-EINVAL);
+
+		if (vaddr < vs->start || vaddr >= vs->end ||
+		    len > vs->end - vaddr)
+			return ERR2PTR(-ENOMEM);
+	}
+
+	vma = vmem_vma_alloc();
+	if (unlikely(!vma))
+		return ERR2PTR(-ENOMEM);
+
+	ukplat_spin_lock_irqsave(&vs->lock, irqf);
+
+	if (flags & (MAP_FIXED | MAP_FIXED_NOREPLACE)) {
+		if ((flags & MAP_FIXED_NOREPLACE) &&
+		    !vma_range_isfree(vs, vaddr, len)) {
+			ret = ERR2PTR(-EEXIST);
+			goto err_free;
+		}
+	} else if (!PAGE_ALIGNED(vaddr) ||
+		   !vma_range_isfree(vs, vaddr, len)) {
+		vaddr = vma_find_gap(vs, len);
+		if (unlikely(vaddr == __VADDR_INV)) {
+			ret = ERR2PTR(-ENOMEM);
+			goto err_free;
+		}
+	}
+
+	if (flags & MAP_FIXED) {
+		rc = vmem_unmap(vs, vaddr, vaddr + len);
+		if (unlikely(rc)) {
+			ret = ERR2PTR(rc);
+			goto err_free;
+		}
+	}
+
+	vma->start = vaddr;
+	vma->end = vaddr + len;
+	vma->prot = prot;
+	vma_insert(vs, vma);
+
+	if ((flags & MAP_POPULATE) && prot != PROT_NONE) {
+		rc = vmem_map_zero(ukplat_pt_get_active(), vaddr, len, prot);
+		if (unlikely(rc)) {
+			vmem_unmap(vs, vaddr, vaddr + len);
+			ret = ERR2PTR(-ENOMEM);
+			goto out;
+		}
+	}
+
+	vmem_merge(vs, vma);
+	ret = (void *)vaddr;
+out:
+	ukplat_spin_unlock_irqrestore(&vs->lock, irqf);
+	return ret;
+
+err_free:
+	ukplat_spin_unlock_irqrestore(&vs->lock, irqf);
+	vmem_vma_free(vma);
+	return ret;
+}
+
+UK_SYSCALL_R_DEFINE(int, munmap, void *, addr, size_t, len)
+{
+	struct uk_vmaspace *vs = &vmem_space;
+	__vaddr_t start = (__vaddr_t)addr;
+	unsigned long irqf;
+	__vaddr_t end;
+	int rc;
+
+	if (unlikely(!len || !PAGE_ALIGNED(start)))
+		return -EINVAL;
+
+	if (len > __VADDR_MAX - start)
+		return -EINVAL;
+	end = PAGE_ALIGN_UP(start + len);
+
+	/* There is nothing mapped outside of our window */
+	start = MAX(start, vs->start);
+	end = MIN(end, vs->end);
+	if (start >= end)
+		return 0;
+
+	ukplat_spin_lock_irqsave(&vs->lock, irqf);
+	rc = vmem_unmap(vs, start, end);
+	ukplat_spin_unlock_irqrestore(&vs->lock, irqf);
+
+	return rc;
+}
+
+UK_SYSCALL_R_DEFINE(int, mprotect, void *, addr, size_t, len, int, prot)
+{
+	struct uk_pagetable *pt = ukplat_pt_get_active();
+	struct uk_vmaspace *vs = &vmem_space;
+	__vaddr_t start = (__vaddr_t)addr;
+	struct uk_vma *vma, *first;
+	__vaddr_t end, vaddr;
+	unsigned long irqf;
+	int rc = 0;
+
+	if (unlikely(!PAGE_ALIGNED(start)))
+		return -EINVAL;
+
+	if (unlikely(prot & ~(PROT_READ | PROT_WRITE | PROT_EXEC)))
+		return -EINVAL;
+
+	if (!len)
+		return 0;
+
+	if (len > __VADDR_MAX - start)
+		return -ENOMEM;
+	end = PAGE_ALIGN_UP(start + len);
+
+	ukplat_spin_lock_irqsave(&vs->lock, irqf);
+
+	/* The whole range must be mapped */
+	first = vma_find(vs, start);
+	if (!first) {
+		rc = -ENOMEM;
+		goto out;
+	}
+
+	for (vma = first, vaddr = start; vaddr < end; vma = vma->next) {
+		if (!vma || vma->start > vaddr) {
+			rc = -ENOMEM;
+			goto out;
+		}
+		vaddr = vma->end;
+	}
+
+	vma = first;
+	if (vma->start < start) {
+		vma = vmem_split(vs, vma, start);
+		if (unlikely(!vma)) {
+			rc = -ENOMEM;
+			goto out;
+		}
+	}
+
+	while (vma && vma->start < end) {
+		if (vma->end > end) {
+			if (unlikely(!vmem_split(vs, vma, end))) {
+				rc = -ENOMEM;
+				goto out;
+			}
+		}
+
+		if (unlikely(vmem_protect(pt, vma, prot))) {
+			rc = -ENOMEM;
+			goto out;
+		}
+
+		vma->prot = prot;
+		vma = vmem_merge(vs, vma);
+		vma = vma->next;
+	}
+
+out:
+	ukplat_spin_unlock_irqrestore(&vs->lock, irqf);
+	return rc;
+}
+
+UK_LLSYSCALL_R_DEFINE(void *, mremap, void *, old_address, size_t, old_size,
+		      size_t, new_size, int, flags, void *, new_address)
+{
+	struct uk_vmaspace *vs = &vmem_space;
+	__vaddr_t old = (__vaddr_t)old_address;
+	__vaddr_t dst = (__vaddr_t)new_address;
+	struct uk_vma *vma;
+	unsigned long irqf;
+	__vaddr_t limit;
+	void *ret;
+	int rc;
+
+	if (unlikely(!PAGE_ALIGNED(old)))
+		return ERR2PTR(-EINVAL);
+
+	if (unlikely(flags & ~(MREMAP_MAYMOVE | MREMAP_FIXED)))
+		return ERR2PTR(-EINVAL);
+
+	if (unlikely((flags & MREMAP_FIXED) && !(flags & MREMAP_MAYMOVE)))
+		return ERR2PTR(-EINVAL);
+
+	/* Duplicating a shared mapping (old_size = 0) is not supported */
+	if (unlikely(!old_size || !new_size))
+		return ERR2PTR(-EINVAL);
+
+	if (old_size > vs->end - vs->start || new_size > vs->end - vs->start)
+		return ERR2PTR(-ENOMEM);
+	old_size = PAGE_ALIGN_UP(old_size);
+	new_size = PAGE_ALIGN_UP(new_size);
+
+	if (flags & MREMAP_FIXED) {
+		if (unlikely(!PAGE_ALIGNED(dst)))
+			return ERR2PTR(-EINVAL);
+
+		if (dst < vs->start || dst >= vs->end ||
+		    new_size > vs->end - dst)
+			return ERR2PTR(-ENOMEM);
+
+		if (dst < old + old_size && old < dst + new_size)
+			return ERR2PTR(-EINVAL);
+	}
+
+	ukplat_spin_lock_irqsave(&vs->lock, irqf);
+
+	vma = vma_find(vs, old);
+	if (!vma || old_size > vma->end - old) {
+		ret = ERR2PTR(-EFAULT);
+		goto out;
+	}
+
+	if (flags & MREMAP_FIXED) {
+		rc = vmem_unmap(vs, dst, dst + new_size);
+		if (unlikely(rc)) {
+			ret = ERR2PTR(rc);
+			goto out;
+		}
+
+		/* The unmap may have changed the VMA that we move from */
+		vma = vma_find(vs, old);
+		UK_ASSERT(vma);
+
+		rc = vmem_move(vs, vma, old, old_size, dst, new_size);
+		ret = unlikely(rc) ? ERR2PTR(rc) : (void *)dst;
+		goto out;
+	}
+
+	if (new_size <= old_size) {
+		rc = vmem_unmap(vs, old + new_size, old + old_size);
+		ret = unlikely(rc) ? ERR2PTR(rc) : (void *)old;
+		goto out;
+	}
+
+	/* Try to grow in place. The new pages are populated on demand. */
+	if (old + old_size == vma->end) {
+		limit = vma->next ? vma->next->start : vs->end;
+		if (new_size - old_size <= limit - vma->end) {
+			vma->end = old + new_size;
+			vma_update(vs, vma);
+			ret = (void *)old;
+			goto out;
+		}
+	}
+
+	if (!(flags & MREMAP_MAYMOVE)) {
+		ret = ERR2PTR(-ENOMEM);
+		goto out;
+	}
+
+	dst = vma_find_gap(vs, new_size);
+	if (unlikely(dst == __VADDR_INV)) {
+		ret = ERR2PTR(-ENOMEM);
+		goto out;
+	}
+
+	rc = vmem_move(vs, vma, old, old_size, dst, new_size);
+	ret = unlikely(rc) ? ERR2PTR(rc) : (void *)dst;
+out:
+	ukplat_spin_unlock_irqrestore(&vs->lock, irqf);
+	return ret;
+}
+
+#if UK_LIBC_SYSCALLS
+void *mremap(void *old_address, size_t old_size, size_t new_size, int flags,
+	     ...)
+{
+	void *new_address = NULL;
+	va_list ap;
+
+	if (flags & MREMAP_FIXED) {
+		va_start(ap, flags);
+		new_address = va_arg(ap, void *);
+		va_end(ap);
+	}
+
+	return (void *)uk_syscall_e_mremap((long)old_address, (long)old_size,
+					   (long)new_size, (long)flags,
+					   (long)new_address);
+}
+#endif /* UK_LIBC_SYSCALLS */
+
+UK_SYSCALL_R_DEFINE(int, madvise, void *, addr, size_t, length, int, advice)
+{
+	struct uk_pagetable *pt = ukplat_pt_get_active();
+	struct uk_vmaspace *vs = &vmem_space;
+	__vaddr_t start = (__vaddr_t)addr;
+	struct uk_vma *vma;
+	unsigned long irqf;
+	__vaddr_t end;
+
+	if (unlikely(!PAGE_ALIGNED(start)))
+		return -EINVAL;
+
+	if (length > __VADDR_MAX - start)
+		return -EINVAL;
+	end = PAGE_ALIGN_UP(start + length);
+
+	switch (advice) {
+	case MADV_DONTNEED:
+	case MADV_FREE:
+		/* Drop the frames. Pages read as zero on the next access. */
+		ukplat_spin_lock_irqsave(&vs->lock, irqf);
+		for (vma = vma_find_next(vs, start);
+		     vma && vma->start < end; vma = vma->next)
+			vmem_release(pt, vma, MAX(vma->start, start),
+				     MIN(vma->end, end));
+		ukplat_spin_unlock_irqrestore(&vs->lock, irqf);
+		return 0;
+	default:
+		/* All other advice are hints that we can ignore */
+		return 0;
+	}
+}
@@ -59,6 +59,26 @@ void uk_mbox_recv(struct uk_mbox *m, void **msg);
 int uk_mbox_recv_try(struct uk_mbox *m, void **msg);
 __nsec uk_mbox_recv_to(struct uk_mbox *m, void **msg, __nsec timeout);
 
+/**
+ * Receives up to `count` messages from the mailbox. Blocks the thread until
+ * at least one message is available.
+ *
+ * @return
+ *   Number of messages stored to `msgs`
+ */
+unsigned int uk_mbox_recv_batch(struct uk_mbox *m, void **msgs,
+				unsigned int count);
+
+/**
+ * Like uk_mbox_recv_batch(), but does not block the thread longer than
+ * `timeout` nanoseconds.
+ *
+ * @return
+ *   Number of messages stored to `msgs`, 0 on timeout
+ */
+unsigned int uk_mbox_recv_batch_to(struct uk_mbox *m, void **msgs,
+				   unsigned int count, __nsec timeout);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
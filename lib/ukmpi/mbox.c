@@ -6,20 +6,26 @@
 struct uk_mbox *uk_mbox_create(struct uk_alloc *a, size_t size)
 {
 	struct uk_mbox *m;
+	int count;
 
 	UK_ASSERT(size <= __L_MAX);
+	UK_ASSERT(size < (1UL << 30));
 
-	m = uk_malloc(a, sizeof(*m) + (sizeof(void *) * (size + 1)));
+	m = uk_malloc(a, sizeof(*m));
 	if (!m)
 		return NULL;
 
-	m->len = size + 1;
+	/* One ring slot always stays empty */
+	for (count = 2; count < (int) size + 1; count <<= 1)
+		;
+	m->ring = uk_ring_alloc(count, a);
+	if (!m->ring) {
+		uk_free(a, m);
+		return NULL;
+	}
 
 	uk_semaphore_init(&m->readsem, 0);
-	m->readpos = 0;
-
 	uk_semaphore_init(&m->writesem, (long) size);
-	m->writepos = 0;
 
 	uk_pr_debug("Created mailbox %p\n", m);
 	return m;
@@ -35,8 +41,9 @@ void uk_mbox_free(struct uk_alloc *a, struct uk_mbox *m)
 
 	UK_ASSERT(a);
 	UK_ASSERT(m);
-	UK_ASSERT(m->readpos == m->writepos);
+	UK_ASSERT(uk_ring_empty(m->ring));
 
+	uk_ring_free(m->ring, a);
 	uk_free(a, m);
 }
 
@@ -144,3 +151,36 @@ __nsec uk_mbox_recv_to(struct uk_mbox *m, void **msg, __nsec timeout)
 		*msg = rmsg;
 	return ret;
 }
+
+unsigned int uk_mbox_recv_batch(struct uk_mbox *m, void **msgs,
+				unsigned int count)
+{
+	unsigned int n = 1;
+
+	UK_ASSERT(m);
+	UK_ASSERT(msgs);
+	UK_ASSERT(count > 0);
+
+	uk_semaphore_down(&m->readsem);
+	while (n < count && uk_semaphore_down_try(&m->readsem))
+		n++;
+	_do_mbox_recv_n(m, msgs, n);
+	return n;
+}
+
+unsigned int uk_mbox_recv_batch_to(struct uk_mbox *m, void **msgs,
+				   unsigned int count, __nsec timeout)
+{
+	unsigned int n = 1;
+
+	UK_ASSERT(m);
+	UK_ASSERT(msgs);
+	UK_ASSERT(count > 0);
+
+	if (uk_semaphore_down_to(&m->readsem, timeout) == __NSEC_MAX)
+		return 0;
+	while (n < count && uk_semaphore_down_try(&m->readsem))
+		n++;
+	_do_mbox_recv_n(m, msgs, n);
+	return n;
+}
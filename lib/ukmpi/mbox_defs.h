@@ -2,7 +2,10 @@
 #define __MBOX_DEFS_H__
 
 #include <stddef.h>
+#include <uk/config.h>
 #include <uk/semaphore.h>
+#include <uk/ring.h>
+#include <uk/wait.h>
 
 /*
  * NOTE: The definitions below are included by both isr-safe and normal
@@ -10,34 +13,123 @@
  * requires special care.
  */
 
+#if CONFIG_LIBUKMPI_MBOX_LOCKFREE
+struct uk_mbox {
+	struct uk_ring *ring;
+	/* Number of threads that wait, or are about to wait, for a message
+	 * (readers) or for a free slot (writers). Wake-ups are skipped while
+	 * nobody waits.
+	 */
+	unsigned int readers;
+	unsigned int writers;
+	struct uk_waitq readq;
+	struct uk_waitq writeq;
+};
+
+/*
+ * Orders the ring operation before the load of the waiter count. A waiter
+ * increments the count with a full barrier before it checks the ring, so
+ * either we see the waiter, or the waiter sees our update of the ring.
+ * On a single CPU, program order already guarantees this.
+ */
+#ifdef CONFIG_HAVE_SMP
+#define _mbox_mb() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#define _mbox_mb() barrier()
+#endif
+
+static inline void _mbox_wake(unsigned int *waiters, struct uk_waitq *wq)
+{
+	_mbox_mb();
+	if (UK_READ_ONCE(*waiters))
+		uk_waitq_wake_up(wq);
+}
+
+/*
+ * Fetch up to `count` messages from a mailbox without blocking. Internal
+ * version that actually does the fetch.
+ */
+static inline unsigned int _do_mbox_recv_n(struct uk_mbox *m, void **msgs,
+					   unsigned int count)
+{
+	unsigned long irqf;
+	unsigned int n;
+
+	/* The ring serializes concurrent readers of other CPUs. Interrupts
+	 * are disabled nevertheless because an interrupt handler that reads
+	 * from the mailbox would spin forever on a dequeue that it interrupted
+	 * on this CPU.
+	 */
+	irqf = ukplat_lcpu_save_irqf();
+	n = uk_ring_dequeue_n_mc(m->ring, msgs, count);
+	ukplat_lcpu_restore_irqf(irqf);
+	if (n) {
+		uk_pr_debug("Received %u message(s) from mailbox %p\n", n, m);
+		_mbox_wake(&m->writers, &m->writeq);
+	}
+	return n;
+}
+
+/* Posts the "msg" to the mailbox without blocking, internal version that
+ * actually does the post.
+ */
+static inline int _do_mbox_post_try(struct uk_mbox *m, void *msg)
+{
+	unsigned long irqf;
+	unsigned int n;
+
+	/* Interrupts are disabled for the same reason as in _do_mbox_recv_n */
+	irqf = ukplat_lcpu_save_irqf();
+	n = uk_ring_enqueue_n(m->ring, &msg, 1);
+	ukplat_lcpu_restore_irqf(irqf);
+	if (!n)
+		return -ENOBUFS;
+	uk_pr_debug("Posted message %p to mailbox %p\n", msg, m);
+
+	_mbox_wake(&m->readers, &m->readq);
+	return 0;
+}
+#else /* !CONFIG_LIBUKMPI_MBOX_LOCKFREE */
 struct uk_mbox {
-	size_t len;
 	struct uk_semaphore readsem;
-	long readpos;
 	struct uk_semaphore writesem;
-	long writepos;
-
-	void *msgs[];
+	struct uk_ring *ring;
 };
 
 /*
- * Fetch a message from a mailbox. Internal version that actually does the
- * fetch.
+ * Fetch `count` messages from a mailbox, the caller got a semaphore token
+ * for each of them. Internal version that actually does the fetch.
  */
-static inline void *_do_mbox_recv(struct uk_mbox *m)
+static inline void _do_mbox_recv_n(struct uk_mbox *m, void **msgs,
+				   unsigned int count)
 {
 	unsigned long irqf;
-	void *ret;
+	unsigned int n __maybe_unused;
 
-	uk_pr_debug("Receive message from mailbox %p\n", m);
+	uk_pr_debug("Receive %u message(s) from mailbox %p\n", count, m);
+	/* The ring serializes concurrent readers of other CPUs. Interrupts
+	 * are disabled nevertheless because an interrupt handler that reads
+	 * from the mailbox would spin forever on a dequeue that it interrupted
+	 * on this CPU.
+	 */
 	irqf = ukplat_lcpu_save_irqf();
-	UK_ASSERT(m->readpos != m->writepos);
-	ret = m->msgs[m->readpos];
-	m->readpos = (m->readpos + 1) % m->len;
+	n = uk_ring_dequeue_n_mc(m->ring, msgs, count);
 	ukplat_lcpu_restore_irqf(irqf);
+	UK_ASSERT(n == count);
+
+	while (count--)
+		uk_semaphore_up(&m->writesem);
+}
 
-	uk_semaphore_up(&m->writesem);
+/*
+ * Fetch a message from a mailbox. Internal version that actually does the
+ * fetch.
+ */
+static inline void *_do_mbox_recv(struct uk_mbox *m)
+{
+	void *ret;
 
+	_do_mbox_recv_n(m, &ret, 1);
 	return ret;
 }
 
@@ -46,22 +138,23 @@ static inline void *_do_mbox_recv(struct uk_mbox *m)
  */
 static inline void _do_mbox_post(struct uk_mbox *m, void *msg)
 {
-	/* The caller got a semaphore token, so we are now allowed to increment
-	 * writer, but we still need to prevent concurrency between writers
-	 * (interrupt handler vs main)
+	/* The caller got a semaphore token, so there is a free slot in the
+	 * ring. Concurrent writers are serialized by the ring, interrupts are
+	 * disabled for the same reason as in _do_mbox_recv_n().
 	 */
 	unsigned long irqf;
+	unsigned int ret __maybe_unused;
 
 	UK_ASSERT(m);
 
 	irqf = ukplat_lcpu_save_irqf();
-	m->msgs[m->writepos] = msg;
-	m->writepos = (m->writepos + 1) % m->len;
-	UK_ASSERT(m->readpos != m->writepos);
+	ret = uk_ring_enqueue_n(m->ring, &msg, 1);
 	ukplat_lcpu_restore_irqf(irqf);
+	UK_ASSERT(ret == 1);
 	uk_pr_debug("Posted message %p to mailbox %p\n", msg, m);
 
 	uk_semaphore_up(&m->readsem);
 }
+#endif /* !CONFIG_LIBUKMPI_MBOX_LOCKFREE */
 
 #endif /* __MBOX_DEFS_H__ */
@@ -3,6 +3,27 @@
 #include <uk/isr/semaphore.h>
 #include "mbox_defs.h"
 
+#if CONFIG_LIBUKMPI_MBOX_LOCKFREE
+int uk_mbox_recv_try_isr(struct uk_mbox *m, void **msg)
+{
+	void *rmsg;
+
+	UK_ASSERT(m);
+
+	if (!_do_mbox_recv_n(m, &rmsg, 1))
+		return -ENOMSG;
+	if (msg)
+		*msg = rmsg;
+	return 0;
+}
+
+int uk_mbox_post_try_isr(struct uk_mbox *m, void *msg)
+{
+	UK_ASSERT(m);
+
+	return _do_mbox_post_try(m, msg);
+}
+#else /* !CONFIG_LIBUKMPI_MBOX_LOCKFREE */
 int uk_mbox_recv_try_isr(struct uk_mbox *m, void **msg)
 {
 	void *rmsg;
@@ -27,3 +48,4 @@ int uk_mbox_post_try_isr(struct uk_mbox *m, void *msg)
 	_do_mbox_post(m, msg);
 	return 0;
 }
+#endif /* !CONFIG_LIBUKMPI_MBOX_LOCKFREE */
@@ -0,0 +1,210 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <uk/mbox.h>
+#include <uk/assert.h>
+#include <uk/arch/atomic.h>
+#include <uk/plat/time.h>
+#include "mbox_defs.h"
+
+struct uk_mbox *uk_mbox_create(struct uk_alloc *a, size_t size)
+{
+	struct uk_mbox *m;
+	int count;
+
+	UK_ASSERT(size < (1UL << 30));
+
+	m = uk_malloc(a, sizeof(*m));
+	if (!m)
+		return NULL;
+
+	/* One ring slot always stays empty */
+	for (count = 2; count < (int) size + 1; count <<= 1)
+		;
+	m->ring = uk_ring_alloc(count, a);
+	if (!m->ring) {
+		uk_free(a, m);
+		return NULL;
+	}
+
+	m->readers = 0;
+	m->writers = 0;
+	uk_waitq_init(&m->readq);
+	uk_waitq_init(&m->writeq);
+
+	uk_pr_debug("Created mailbox %p\n", m);
+	return m;
+}
+
+/* Deallocates a mailbox. If there are messages still present in the
+ * mailbox when the mailbox is deallocated, it is an indication of a
+ * programming error in lwIP and the developer should be notified.
+ */
+void uk_mbox_free(struct uk_alloc *a, struct uk_mbox *m)
+{
+	uk_pr_debug("Release mailbox %p\n", m);
+
+	UK_ASSERT(a);
+	UK_ASSERT(m);
+	UK_ASSERT(uk_ring_empty(m->ring));
+	UK_ASSERT(!m->readers && !m->writers);
+
+	uk_ring_free(m->ring, a);
+	uk_free(a, m);
+}
+
+/* Posts "msg", waits for a free slot until "deadline" (0: forever).
+ * Returns 0 on success, -ETIMEDOUT on timeout.
+ */
+static int _mbox_post_deadline(struct uk_mbox *m, void *msg, __nsec deadline)
+{
+	for (;;) {
+		if (_do_mbox_post_try(m, msg) == 0)
+			return 0;
+		if (deadline && ukplat_monotonic_clock() >= deadline)
+			return -ETIMEDOUT;
+
+		/* Announce ourselves before the ring is checked again by the
+		 * wait condition, see _mbox_wake()
+		 */
+		ukarch_inc(&m->writers);
+		uk_waitq_wait_event_deadline(&m->writeq,
+					     !uk_ring_full(m->ring), deadline);
+		ukarch_dec(&m->writers);
+	}
+}
+
+/* Receives up to "count" messages, waits for the first one until
+ * "deadline" (0: forever). Returns the number of received messages.
+ */
+static unsigned int _mbox_recv_deadline(struct uk_mbox *m, void **msgs,
+					unsigned int count, __nsec deadline)
+{
+	unsigned int n;
+
+	for (;;) {
+		n = _do_mbox_recv_n(m, msgs, count);
+		if (n)
+			return n;
+		if (deadline && ukplat_monotonic_clock() >= deadline)
+			return 0;
+
+		ukarch_inc(&m->readers);
+		uk_waitq_wait_event_deadline(&m->readq,
+					     !uk_ring_empty(m->ring), deadline);
+		ukarch_dec(&m->readers);
+	}
+}
+
+void uk_mbox_post(struct uk_mbox *m, void *msg)
+{
+	UK_ASSERT(m);
+
+	_mbox_post_deadline(m, msg, 0);
+}
+
+int uk_mbox_post_try(struct uk_mbox *m, void *msg)
+{
+	UK_ASSERT(m);
+
+	return _do_mbox_post_try(m, msg);
+}
+
+__nsec uk_mbox_post_to(struct uk_mbox *m, void *msg, __nsec timeout)
+{
+	__nsec then = ukplat_monotonic_clock();
+
+	UK_ASSERT(m);
+
+	if (_mbox_post_deadline(m, msg, then + timeout))
+		return __NSEC_MAX;
+	return ukplat_monotonic_clock() - then;
+}
+
+void uk_mbox_recv(struct uk_mbox *m, void **msg)
+{
+	void *rmsg;
+
+	UK_ASSERT(m);
+
+	_mbox_recv_deadline(m, &rmsg, 1, 0);
+	if (msg)
+		*msg = rmsg;
+}
+
+int uk_mbox_recv_try(struct uk_mbox *m, void **msg)
+{
+	void *rmsg;
+
+	UK_ASSERT(m);
+
+	if (!_do_mbox_recv_n(m, &rmsg, 1))
+		return -ENOMSG;
+	if (msg)
+		*msg = rmsg;
+	return 0;
+}
+
+__nsec uk_mbox_recv_to(struct uk_mbox *m, void **msg, __nsec timeout)
+{
+	__nsec then = ukplat_monotonic_clock();
+	void *rmsg = NULL;
+	__nsec ret = __NSEC_MAX;
+
+	UK_ASSERT(m);
+
+	if (_mbox_recv_deadline(m, &rmsg, 1, then + timeout))
+		ret = ukplat_monotonic_clock() - then;
+	if (msg)
+		*msg = rmsg;
+	return ret;
+}
+
+unsigned int uk_mbox_recv_batch(struct uk_mbox *m, void **msgs,
+				unsigned int count)
+{
+	UK_ASSERT(m);
+	UK_ASSERT(msgs);
+	UK_ASSERT(count > 0);
+
+	return _mbox_recv_deadline(m, msgs, count, 0);
+}
+
+unsigned int uk_mbox_recv_batch_to(struct uk_mbox *m, void **msgs,
+				   unsigned int count, __nsec timeout)
+{
+	UK_ASSERT(m);
+	UK_ASSERT(msgs);
+	UK_ASSERT(count > 0);
+
+	return _mbox_recv_deadline(m, msgs, count,
+				   ukplat_monotonic_clock() + timeout);
+}
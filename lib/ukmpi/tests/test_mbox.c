@@ -0,0 +1,175 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <uk/test.h>
+#include <uk/config.h>
+#include <uk/essentials.h>
+#include <uk/alloc.h>
+#include <uk/mbox.h>
+#include <uk/sched.h>
+#include <uk/thread.h>
+#include <uk/arch/time.h>
+
+#define MBOX_SIZE		8
+
+/* Messages are never dereferenced, so we can use tagged integers */
+#define MSG(v)			((void *)(__uptr)(v))
+
+UK_TESTCASE(ukmpi_mbox, order)
+{
+	struct uk_mbox *m;
+	void *msg;
+	int i;
+
+	m = uk_mbox_create(uk_alloc_get_default(), MBOX_SIZE);
+	UK_TEST_EXPECT_NOT_NULL(m);
+	if (!m)
+		return;
+
+	for (i = 1; i <= MBOX_SIZE; i++)
+		UK_TEST_EXPECT_ZERO(uk_mbox_post_try(m, MSG(i)));
+	for (i = 1; i <= MBOX_SIZE / 2; i++) {
+		uk_mbox_recv(m, &msg);
+		UK_TEST_EXPECT_PTR_EQ(msg, MSG(i));
+	}
+
+	/* Continue behind the remaining messages */
+	uk_mbox_post(m, MSG(MBOX_SIZE + 1));
+	for (i = MBOX_SIZE / 2 + 1; i <= MBOX_SIZE + 1; i++) {
+		UK_TEST_EXPECT_ZERO(uk_mbox_recv_try(m, &msg));
+		UK_TEST_EXPECT_PTR_EQ(msg, MSG(i));
+	}
+	UK_TEST_EXPECT_SNUM_EQ(uk_mbox_recv_try(m, &msg), -ENOMSG);
+
+	uk_mbox_free(uk_alloc_get_default(), m);
+}
+
+UK_TESTCASE(ukmpi_mbox, recv_batch)
+{
+	void *msgs[MBOX_SIZE];
+	struct uk_mbox *m;
+	unsigned int n;
+	int i;
+
+	m = uk_mbox_create(uk_alloc_get_default(), MBOX_SIZE);
+	UK_TEST_EXPECT_NOT_NULL(m);
+	if (!m)
+		return;
+
+	/* Fewer messages than requested are returned right away */
+	for (i = 1; i <= 3; i++)
+		uk_mbox_post(m, MSG(i));
+	n = uk_mbox_recv_batch(m, msgs, MBOX_SIZE);
+	UK_TEST_EXPECT_SNUM_EQ(n, 3);
+	for (i = 0; i < 3; i++)
+		UK_TEST_EXPECT_PTR_EQ(msgs[i], MSG(i + 1));
+
+	/* More messages than requested stay in the mailbox */
+	for (i = 1; i <= 5; i++)
+		uk_mbox_post(m, MSG(i));
+	n = uk_mbox_recv_batch_to(m, msgs, 2, ukarch_time_msec_to_nsec(10));
+	UK_TEST_EXPECT_SNUM_EQ(n, 2);
+	UK_TEST_EXPECT_PTR_EQ(msgs[0], MSG(1));
+	UK_TEST_EXPECT_PTR_EQ(msgs[1], MSG(2));
+	n = uk_mbox_recv_batch(m, msgs, MBOX_SIZE);
+	UK_TEST_EXPECT_SNUM_EQ(n, 3);
+	UK_TEST_EXPECT_PTR_EQ(msgs[0], MSG(3));
+
+	/* An empty mailbox times out */
+	n = uk_mbox_recv_batch_to(m, msgs, MBOX_SIZE,
+				  ukarch_time_msec_to_nsec(10));
+	UK_TEST_EXPECT_ZERO(n);
+
+	uk_mbox_free(uk_alloc_get_default(), m);
+}
+
+struct mbox_poster {
+	struct uk_mbox *m;
+	void *msg;
+	volatile int posted;
+};
+
+static void mbox_poster(void *arg)
+{
+	struct mbox_poster *p = arg;
+
+	uk_mbox_post(p->m, p->msg);
+	p->posted = 1;
+}
+
+UK_TESTCASE(ukmpi_mbox, post_full)
+{
+	struct mbox_poster p;
+	struct uk_thread *t;
+	void *msgs[2 * MBOX_SIZE];
+	unsigned int n, i;
+	int full;
+
+	p.m = uk_mbox_create(uk_alloc_get_default(), MBOX_SIZE);
+	UK_TEST_EXPECT_NOT_NULL(p.m);
+	if (!p.m)
+		return;
+
+	/* The capacity may be rounded up */
+	for (full = 0; full < 2 * MBOX_SIZE; full++)
+		if (uk_mbox_post_try(p.m, MSG(full)))
+			break;
+	UK_TEST_EXPECT(full >= MBOX_SIZE && full < 2 * MBOX_SIZE);
+
+	p.msg = MSG(full);
+	p.posted = 0;
+	t = uk_thread_create("mbox-poster", mbox_poster, &p);
+	UK_TEST_EXPECT_NOT_NULL(t);
+	if (!t)
+		goto out;
+
+	/* The poster blocks on the full mailbox */
+	for (i = 0; i < 10; i++)
+		uk_sched_yield();
+	UK_TEST_EXPECT_ZERO(p.posted);
+
+	/* Receiving makes room and wakes it up */
+	n = uk_mbox_recv_batch(p.m, msgs, 1);
+	UK_TEST_EXPECT_SNUM_EQ(n, 1);
+	UK_TEST_EXPECT_PTR_EQ(msgs[0], MSG(0));
+	uk_thread_wait(t);
+	UK_TEST_EXPECT_SNUM_EQ(p.posted, 1);
+
+	n = uk_mbox_recv_batch(p.m, msgs, ARRAY_SIZE(msgs));
+	UK_TEST_EXPECT_SNUM_EQ(n, full);
+	for (i = 0; i < n; i++)
+		UK_TEST_EXPECT_PTR_EQ(msgs[i], MSG(i + 1));
+
+out:
+	uk_mbox_free(uk_alloc_get_default(), p.m);
+}
+
+uk_testsuite_register(ukmpi_mbox, NULL);
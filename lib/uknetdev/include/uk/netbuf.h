@@ -123,6 +123,34 @@ typedef void (*uk_netbuf_dtor_t)(struct uk_netbuf *);
 #define UK_NETBUF_F_PARTIAL_CSUM_BIT 1
 #define UK_NETBUF_F_PARTIAL_CSUM     (1 << UK_NETBUF_F_PARTIAL_CSUM_BIT)
 
+/* Indicates that the packet is a large TCP or UDP segment that is split
+ * into `gso_size` sized payload chunks by the device on transmit (TSO,
+ * UFO), or that was coalesced from such chunks by the host on receive.
+ * `header_len` is the length of the protocol headers (Ethernet, IP, and
+ * TCP/UDP) that are replicated in front of each chunk. Segmentation
+ * offloading requires UK_NETBUF_F_PARTIAL_CSUM to be set as well.
+ * The ECN flag marks TCP segments with the CWR bit set.
+ */
+#define UK_NETBUF_F_GSO_TCPV4_BIT    2
+#define UK_NETBUF_F_GSO_TCPV4        (1 << UK_NETBUF_F_GSO_TCPV4_BIT)
+#define UK_NETBUF_F_GSO_TCPV6_BIT    3
+#define UK_NETBUF_F_GSO_TCPV6        (1 << UK_NETBUF_F_GSO_TCPV6_BIT)
+#define UK_NETBUF_F_GSO_UDP_BIT      4
+#define UK_NETBUF_F_GSO_UDP          (1 << UK_NETBUF_F_GSO_UDP_BIT)
+#define UK_NETBUF_F_GSO_ECN_BIT      5
+#define UK_NETBUF_F_GSO_ECN          (1 << UK_NETBUF_F_GSO_ECN_BIT)
+
+#define UK_NETBUF_F_GSO_MASK         (UK_NETBUF_F_GSO_TCPV4 \
+				      | UK_NETBUF_F_GSO_TCPV6 \
+				      | UK_NETBUF_F_GSO_UDP)
+
+/* Indicates that `hash` holds the flow hash that the device computed for
+ * steering the received packet to a queue (e.g., RSS Toeplitz hash over
+ * the addresses and ports). Packets of the same flow carry the same hash.
+ */
+#define UK_NETBUF_F_HASH_BIT         6
+#define UK_NETBUF_F_HASH             (1 << UK_NETBUF_F_HASH_BIT)
+
 struct uk_netbuf {
 	struct uk_netbuf *next;
 	struct uk_netbuf *prev;
@@ -146,6 +174,16 @@ struct uk_netbuf {
 				 * Number of bytes starting from `csum_start`
 				 * pointing to the checksum field
 				 */
+	uint16_t gso_size;     /**< Used if one of UK_NETBUF_F_GSO_* is set;
+				 * Maximum payload size of a single segment
+				 */
+	uint16_t header_len;   /**< Used if one of UK_NETBUF_F_GSO_* is set;
+				 * Length of the protocol headers that are
+				 * replicated to each segment
+				 */
+	uint32_t hash;         /**< Used if UK_NETBUF_F_HASH is set;
+				 * Flow hash reported by the device
+				 */
 
 	uk_netbuf_dtor_t dtor; /**< Destructor callback */
 	struct uk_alloc *_a;   /**< @internal Allocator for free'ing */
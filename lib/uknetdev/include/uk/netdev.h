@@ -232,10 +232,12 @@ int uk_netdev_rxq_info_get(struct uk_netdev *dev, uint16_t queue_id,
  *   Its memory can be released after invoking this function. Please note that
  *   the receive buffer allocator (`rx_conf->alloc_rxpkts`) has to be
  *   interrupt-context-safe when `uk_netdev_rx_one` is going to be called from
- *   interrupt context.
+ *   interrupt context. With dispatcher threads, `rx_conf->lcpu` selects the
+ *   logical CPU that the dispatcher of the queue is pinned to.
  * @return
  *   - (0): Success, receive queue correctly set up.
  *   - (-ENOMEM): Unable to allocate the receive ring descriptors.
+ *   - (-EINVAL): `rx_conf->lcpu` is not a valid logical CPU.
  */
 int uk_netdev_rxq_configure(struct uk_netdev *dev, uint16_t queue_id,
 			    uint16_t nb_desc,
@@ -524,9 +526,95 @@ static inline int uk_netdev_tx_one(struct uk_netdev *dev, uint16_t queue_id,
 }
 
 /**
- * Tests for status flags returned by `uk_netdev_rx_one` or `uk_netdev_tx_one`.
- * When the functions returned an error code or one of the selected flags is
- * unset, this macro returns False.
+ * Receive a burst of packets and re-program used receive descriptors. The same
+ * interrupt rules as for uk_netdev_rx_one() apply. The receive ring is
+ * refilled and the device is notified once per burst instead of once per
+ * packet.
+ *
+ * @param dev
+ *   The Unikraft Network Device.
+ * @param queue_id
+ *   The index of the receive queue to receive from.
+ *   The value must be in the range [0, nb_rx_queue - 1] previously supplied
+ *   to uk_netdev_configure().
+ * @param pkts
+ *   Array of at least `*cnt` netbuf pointers that will be filled with the
+ *   received packets.
+ * @param cnt
+ *   On input, the maximum number of packets to receive. On output, the number
+ *   of packets stored to `pkts`. `cnt` has never to be `NULL`.
+ * @return
+ *   - (>=0): Positive value with status flags
+ *     - UK_NETDEV_STATUS_SUCCESS: At least one packet was received.
+ *     - UK_NETDEV_STATUS_MORE: The burst was cut by `*cnt`; more received
+ *        packets are available on the receive queue. When interrupts are
+ *        used, they are disabled until this flag is unset by a subsequent
+ *        call. This flag may only be set together with
+ *        UK_NETDEV_STATUS_SUCCESS.
+ *     - UK_NETDEV_STATUS_UNDERRUN: Informs that some available slots of the
+ *        receive queue could not be programmed with a receive buffer.
+ *   - (<0): Negative value with error code from driver, no packet is returned.
+ */
+static inline int uk_netdev_rx_burst(struct uk_netdev *dev, uint16_t queue_id,
+				     struct uk_netbuf **pkts, uint16_t *cnt)
+{
+	UK_ASSERT(dev);
+	UK_ASSERT(dev->rx_burst);
+	UK_ASSERT(queue_id < CONFIG_LIBUKNETDEV_MAXNBQUEUES);
+	UK_ASSERT(dev->_data->state == UK_NETDEV_RUNNING);
+	UK_ASSERT(!PTRISERR(dev->_rx_queue[queue_id]));
+	UK_ASSERT(pkts);
+	UK_ASSERT(cnt);
+
+	return dev->rx_burst(dev, dev->_rx_queue[queue_id], pkts, cnt);
+}
+
+/**
+ * Transmit a burst of packets. Packets are put to the transmit queue in order
+ * and the device is notified once for the whole burst.
+ *
+ * @param dev
+ *   The Unikraft Network Device.
+ * @param queue_id
+ *   The index of the transmit queue to send on.
+ *   The value must be in the range [0, nb_tx_queue - 1] previously supplied
+ *   to uk_netdev_configure().
+ * @param pkts
+ *   Array of `*cnt` netbufs to send. Sent packets are free'd by the driver
+ *   after sending was successfully finished by the device.
+ * @param cnt
+ *   On input, the number of packets in `pkts`. On output, the number of
+ *   packets that were put to the transmit queue; these are always the first
+ *   ones of `pkts`. The caller keeps the ownership of the remaining ones.
+ *   `cnt` has never to be `NULL`.
+ * @return
+ *   - (>=0): Positive value with status flags
+ *     - UK_NETDEV_STATUS_SUCCESS: At least one packet was put to the transmit
+ *        queue. Whenever this flag is not set, there was no space left on the
+ *        transmit queue.
+ *     - UK_NETDEV_STATUS_MORE: Indicates there is still at least one
+ *        descriptor available for a subsequent transmission.
+ *        This flag may only be set together with UK_NETDEV_STATUS_SUCCESS.
+ *   - (<0): Negative value with error code from driver, no packet was sent.
+ */
+static inline int uk_netdev_tx_burst(struct uk_netdev *dev, uint16_t queue_id,
+				     struct uk_netbuf **pkts, uint16_t *cnt)
+{
+	UK_ASSERT(dev);
+	UK_ASSERT(dev->tx_burst);
+	UK_ASSERT(queue_id < CONFIG_LIBUKNETDEV_MAXNBQUEUES);
+	UK_ASSERT(dev->_data->state == UK_NETDEV_RUNNING);
+	UK_ASSERT(!PTRISERR(dev->_tx_queue[queue_id]));
+	UK_ASSERT(pkts);
+	UK_ASSERT(cnt);
+
+	return dev->tx_burst(dev, dev->_tx_queue[queue_id], pkts, cnt);
+}
+
+/**
+ * Tests for status flags returned by `uk_netdev_rx_one`, `uk_netdev_tx_one`
+ * or their burst variants. When the functions returned an error code or one
+ * of the selected flags is unset, this macro returns False.
  *
  * @param status
  *   Return status (int)
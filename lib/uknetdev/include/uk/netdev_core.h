@@ -138,12 +138,46 @@ struct uk_hwaddr {
 #define UK_NETDEV_F_PARTIAL_CSUM_BIT	2
 #define UK_NETDEV_F_PARTIAL_CSUM	(1UL << UK_NETDEV_F_PARTIAL_CSUM_BIT)
 
+/* Indicates that the device segments netbufs that are marked with
+ * UK_NETBUF_F_GSO_TCPV4, UK_NETBUF_F_GSO_TCPV6, or UK_NETBUF_F_GSO_UDP
+ * on transmit
+ */
+#define UK_NETDEV_F_TSO4_BIT		3
+#define UK_NETDEV_F_TSO4		(1UL << UK_NETDEV_F_TSO4_BIT)
+#define UK_NETDEV_F_TSO6_BIT		4
+#define UK_NETDEV_F_TSO6		(1UL << UK_NETDEV_F_TSO6_BIT)
+#define UK_NETDEV_F_UFO_BIT		5
+#define UK_NETDEV_F_UFO			(1UL << UK_NETDEV_F_UFO_BIT)
+
+/* Indicates that the device may deliver coalesced packets of up to 64KiB
+ * on receive. Such packets are marked with UK_NETBUF_F_GSO_* and may be
+ * handed out as netbuf chains.
+ */
+#define UK_NETDEV_F_LRO_BIT		6
+#define UK_NETDEV_F_LRO			(1UL << UK_NETDEV_F_LRO_BIT)
+
+/* Indicates that the device spreads received flows over its receive queues
+ * and reports the flow hash with UK_NETBUF_F_HASH
+ */
+#define UK_NETDEV_F_RSS_BIT		7
+#define UK_NETDEV_F_RSS			(1UL << UK_NETDEV_F_RSS_BIT)
+
 #define uk_netdev_rxintr_supported(feature)	\
 	(feature & (UK_NETDEV_F_RXQ_INTR))
 #define uk_netdev_txintr_supported(feature)	\
 	(feature & (UK_NETDEV_F_TXQ_INTR))
 #define uk_netdev_partial_csum_supported(feature)	\
 	(feature & (UK_NETDEV_F_PARTIAL_CSUM))
+#define uk_netdev_tso4_supported(feature)	\
+	(feature & (UK_NETDEV_F_TSO4))
+#define uk_netdev_tso6_supported(feature)	\
+	(feature & (UK_NETDEV_F_TSO6))
+#define uk_netdev_ufo_supported(feature)	\
+	(feature & (UK_NETDEV_F_UFO))
+#define uk_netdev_lro_supported(feature)	\
+	(feature & (UK_NETDEV_F_LRO))
+#define uk_netdev_rss_supported(feature)	\
+	(feature & (UK_NETDEV_F_RSS))
 
 /**
  * A structure used to describe network device capabilities.
@@ -278,6 +312,9 @@ struct uk_netdev_rxqueue_conf {
 	void *alloc_rxpkts_argp;             /**< Argument for alloc_rxpkts */
 #ifdef CONFIG_LIBUKNETDEV_DISPATCHERTHREADS
 	struct uk_sched *s;               /**< Scheduler for dispatcher. */
+	int lcpu;                         /**< lcpu of dispatcher or
+					   *   UK_THREAD_ATTR_LCPU_ANY.
+					   */
 #endif
 };
 
@@ -383,6 +420,24 @@ typedef int (*uk_netdev_tx_one_t)(struct uk_netdev *dev,
 				  struct uk_netdev_tx_queue *queue,
 				  struct uk_netbuf *pkt);
 
+/**
+ * Driver callback type to retrieve up to `*cnt` packets from a RX queue.
+ * On return, `*cnt` is set to the number of packets stored to `pkts`.
+ */
+typedef int (*uk_netdev_rx_burst_t)(struct uk_netdev *dev,
+				    struct uk_netdev_rx_queue *queue,
+				    struct uk_netbuf **pkts,
+				    uint16_t *cnt);
+
+/**
+ * Driver callback type to submit up to `*cnt` packets to a TX queue.
+ * On return, `*cnt` is set to the number of packets taken from `pkts`.
+ */
+typedef int (*uk_netdev_tx_burst_t)(struct uk_netdev *dev,
+				    struct uk_netdev_tx_queue *queue,
+				    struct uk_netbuf **pkts,
+				    uint16_t *cnt);
+
 /**
  * A structure containing the functions exported by a driver.
  */
@@ -459,10 +514,12 @@ struct uk_netdev_einfo {
  * NETDEV
  * A structure used to interact with a network device.
  *
- * Function callbacks (tx_one, rx_one, ops) are registered by the driver before
- * registering the netdev. They change during device life time. Packet RX/TX
- * functions are added directly to this structure for performance reasons.
- * It prevents another indirection to ops.
+ * Function callbacks (tx_one, rx_one, tx_burst, rx_burst, ops) are registered
+ * by the driver before registering the netdev. They change during device life
+ * time. Packet RX/TX functions are added directly to this structure for
+ * performance reasons. It prevents another indirection to ops.
+ * When a driver does not provide burst functions, libuknetdev installs
+ * generic ones that are based on tx_one and rx_one.
  */
 struct uk_netdev {
 	/** Packet transmission. */
@@ -471,6 +528,12 @@ struct uk_netdev {
 	/** Packet reception. */
 	uk_netdev_rx_one_t          rx_one; /* by driver */
 
+	/** Burst packet transmission. */
+	uk_netdev_tx_burst_t        tx_burst; /* by driver, optional */
+
+	/** Burst packet reception. */
+	uk_netdev_rx_burst_t        rx_burst; /* by driver, optional */
+
 	/** Pointer to API-internal state data. */
 	struct uk_netdev_data       *_data;
 
@@ -132,6 +132,65 @@ static struct uk_netdev_einfo *_alloc_einfo(struct uk_alloc *a)
 	return _einfo;
 }
 
+/* Generic burst reception for drivers that only implement rx_one */
+static int _rx_burst_one(struct uk_netdev *dev,
+			 struct uk_netdev_rx_queue *queue,
+			 struct uk_netbuf **pkts, uint16_t *cnt)
+{
+	int status = 0x0;
+	uint16_t i;
+	int rc;
+
+	for (i = 0; i < *cnt; i++) {
+		rc = dev->rx_one(dev, queue, &pkts[i]);
+		if (unlikely(rc < 0)) {
+			if (i == 0)
+				return rc;
+			break;
+		}
+		status |= rc & UK_NETDEV_STATUS_UNDERRUN;
+		if (!(rc & UK_NETDEV_STATUS_SUCCESS))
+			break;
+		status = (status & ~UK_NETDEV_STATUS_MORE) | rc;
+		if (!(rc & UK_NETDEV_STATUS_MORE)) {
+			i++;
+			break;
+		}
+	}
+
+	*cnt = i;
+	return status;
+}
+
+/* Generic burst transmission for drivers that only implement tx_one */
+static int _tx_burst_one(struct uk_netdev *dev,
+			 struct uk_netdev_tx_queue *queue,
+			 struct uk_netbuf **pkts, uint16_t *cnt)
+{
+	int status = 0x0;
+	uint16_t i;
+	int rc;
+
+	for (i = 0; i < *cnt; i++) {
+		rc = dev->tx_one(dev, queue, pkts[i]);
+		if (unlikely(rc < 0)) {
+			if (i == 0)
+				return rc;
+			break;
+		}
+		if (!(rc & UK_NETDEV_STATUS_SUCCESS))
+			break;
+		status = rc;
+		if (!(rc & UK_NETDEV_STATUS_MORE)) {
+			i++;
+			break;
+		}
+	}
+
+	*cnt = i;
+	return status;
+}
+
 int uk_netdev_drv_register(struct uk_netdev *dev, struct uk_alloc *a,
 			   const char *drv_name)
 {
@@ -155,6 +214,11 @@ int uk_netdev_drv_register(struct uk_netdev *dev, struct uk_alloc *a,
 	UK_ASSERT(dev->rx_one);
 	UK_ASSERT(dev->tx_one);
 
+	if (!dev->rx_burst)
+		dev->rx_burst = _rx_burst_one;
+	if (!dev->tx_burst)
+		dev->tx_burst = _tx_burst_one;
+
 	dev->_data = _alloc_data(a, netdev_count,  drv_name);
 	if (!dev->_data)
 		return -ENOMEM;
@@ -374,10 +438,14 @@ static int _create_event_handler(uk_netdev_queue_event_t callback,
 #ifdef CONFIG_LIBUKNETDEV_DISPATCHERTHREADS
 				 struct uk_netdev *dev, uint16_t queue_id,
 				 const char *queue_type_str,
-				 struct uk_sched *s,
+				 struct uk_sched *s, int lcpu,
 #endif
 				 struct uk_netdev_event_handler *h)
 {
+#ifdef CONFIG_LIBUKNETDEV_DISPATCHERTHREADS
+	uk_thread_attr_t attr;
+#endif
+
 	UK_ASSERT(h);
 	UK_ASSERT(callback || (!callback && !callback_cookie));
 #ifdef CONFIG_LIBUKNETDEV_DISPATCHERTHREADS
@@ -406,8 +474,20 @@ static int _create_event_handler(uk_netdev_queue_event_t callback,
 		h->dispatcher_name = NULL;
 	}
 
+	/* Run ahead of application threads on a priority scheduler */
+	uk_thread_attr_init(&attr);
+	uk_thread_attr_set_prio(&attr, UK_THREAD_ATTR_PRIO_IO);
+	if (uk_thread_attr_set_lcpu(&attr, lcpu)) {
+		uk_pr_err("netdev%"PRIu16": Cannot pin dispatcher to lcpu %d\n",
+			  dev->_data->id, lcpu);
+		if (h->dispatcher_name)
+			free(h->dispatcher_name);
+		h->dispatcher_name = NULL;
+		return -EINVAL;
+	}
+
 	h->dispatcher = uk_sched_thread_create(h->dispatcher_s,
-					       h->dispatcher_name, NULL,
+					       h->dispatcher_name, &attr,
 					       _dispatcher, h);
 	if (!h->dispatcher) {
 		if (h->dispatcher_name)
@@ -468,6 +548,7 @@ int uk_netdev_rxq_configure(struct uk_netdev *dev, uint16_t queue_id,
 	err = _create_event_handler(rx_conf->callback, rx_conf->callback_cookie,
 #ifdef CONFIG_LIBUKNETDEV_DISPATCHERTHREADS
 				    dev, queue_id, "rxq", rx_conf->s,
+				    rx_conf->lcpu,
 #endif
 				    &dev->_data->rxq_handler[queue_id]);
 	if (err)
@@ -33,11 +33,14 @@
 #define __UK_RING_H__
 
 #include <errno.h>
+#include <stdint.h>
+#include <uk/alloc.h>
 #include <uk/mutex.h>
 #include <uk/print.h>
 #include <uk/config.h>
 #include <uk/assert.h>
 #include <uk/plat/lcpu.h>
+#include <uk/arch/lcpu.h>
 #include <uk/arch/atomic.h>
 #include <uk/essentials.h>
 #include <uk/preempt.h>
@@ -45,6 +48,23 @@
 #define critical_enter()  uk_preempt_disable()
 #define critical_exit()   uk_preempt_enable()
 
+/*
+ * Ordering of the head and tail indices. A tail is published with release
+ * semantics after the ring slots have been written (or read) and the
+ * opposite side loads it with acquire semantics before it touches these
+ * slots. On x86 these are plain moves, on ARM64 they become LDAR/STLR.
+ */
+#define __uk_ring_load_acq(ptr) \
+	__atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define __uk_ring_store_rel(ptr, v) \
+	__atomic_store_n(ptr, v, __ATOMIC_RELEASE)
+#define __uk_ring_cmpset_acq(ptr, old, new)				\
+	({								\
+		uint32_t __expected = (old);				\
+		__atomic_compare_exchange_n(ptr, &__expected, new, 0,	\
+					    __ATOMIC_ACQUIRE,		\
+					    __ATOMIC_RELAXED);		\
+	})
 
 struct uk_ring {
 	volatile uint32_t br_prod_head;
@@ -52,25 +72,65 @@ struct uk_ring {
 	int               br_prod_size;
 	int               br_prod_mask;
 	uint64_t          br_drops;
-	volatile uint32_t br_cons_head __aligned(CACHE_LINE_SIZE);
+	volatile uint32_t br_cons_head __align(CACHE_LINE_SIZE);
 	volatile uint32_t br_cons_tail;
 	int               br_cons_size;
 	int               br_cons_mask;
 #ifdef DEBUG_BUFRING
 	struct uk_mutex  *br_lock;
 #endif
-	void             *br_ring[0] __aligned(CACHE_LINE_SIZE);
+	void             *br_ring[0] __align(CACHE_LINE_SIZE);
 };
 
 /*
- * multi-producer safe lock-free ring buffer enqueue
+ * Copy `n` buffers into the ring, starting at slot `head`
+ */
+static __inline void
+__uk_ring_put(struct uk_ring *br, uint32_t head, void **bufs, unsigned int n)
+{
+	unsigned int i;
+
+	for (i = 0; i < n; i++) {
+#ifdef DEBUG_BUFRING
+		if (br->br_ring[(head + i) & br->br_prod_mask] != NULL)
+			UK_CRASH("dangling value in enqueue");
+#endif
+		br->br_ring[(head + i) & br->br_prod_mask] = bufs[i];
+	}
+}
+
+/*
+ * Copy `n` buffers out of the ring, starting at slot `head`
+ */
+static __inline void
+__uk_ring_get(struct uk_ring *br, uint32_t head, void **bufs, unsigned int n)
+{
+	unsigned int i;
+
+	for (i = 0; i < n; i++) {
+		bufs[i] = br->br_ring[(head + i) & br->br_cons_mask];
+#ifdef DEBUG_BUFRING
+		br->br_ring[(head + i) & br->br_cons_mask] = NULL;
+#endif
+	}
+}
+
+/*
+ * multi-producer safe lock-free ring buffer enqueue of up to `n` buffers
+ * One compare-and-swap reserves the slots for the whole batch.
+ * Returns the number of buffers enqueued, which is less than `n` if the
+ * ring is full.
  *
+ * A producer spins while producers that reserved slots before it have not
+ * completed yet. An interrupt handler must therefore not enqueue to a ring
+ * that threads of the same CPU enqueue to without disabling interrupts.
  */
-static __inline int
-uk_ring_enqueue(struct uk_ring *br, void *buf)
+static __inline unsigned int
+uk_ring_enqueue_n(struct uk_ring *br, void **bufs, unsigned int n)
 {
-	uint32_t prod_head, prod_next, cons_tail;
+	uint32_t prod_head, prod_next, cons_tail, free;
 #ifdef DEBUG_BUFRING
+	unsigned int j;
 	int i;
 
 	/*
@@ -78,74 +138,119 @@ uk_ring_enqueue(struct uk_ring *br, void *buf)
 	 * via drbr_peek(), and then re-added via drbr_putback() and
 	 * trigger a spurious panic.
 	 */
-	for (i = br->br_cons_head; i != br->br_prod_head;
-			 i = ((i + 1) & br->br_cons_mask))
-		if (br->br_ring[i] == buf)
-			UK_CRASH("buf=%p already enqueue at %d prod=%d cons=%d",
-					buf, i, br->br_prod_tail, br->br_cons_tail);
+	for (j = 0; j < n; j++)
+		for (i = br->br_cons_head; i != (int) br->br_prod_head;
+				 i = ((i + 1) & br->br_cons_mask))
+			if (br->br_ring[i] == bufs[j])
+				UK_CRASH("buf=%p already enqueue at %d prod=%d cons=%d",
+						bufs[j], i, br->br_prod_tail,
+						br->br_cons_tail);
 #endif
 	critical_enter();
 	do {
 		prod_head = br->br_prod_head;
-		prod_next = (prod_head + 1) & br->br_prod_mask;
-		cons_tail = br->br_cons_tail;
-
-		if (prod_next == cons_tail) {
-			rmb();
-			if (prod_head == br->br_prod_head && cons_tail == br->br_cons_tail) {
-				br->br_drops++;
-				critical_exit();
-				return -ENOBUFS;
-			}
-			continue;
+		cons_tail = __uk_ring_load_acq(&br->br_cons_tail);
+		free = (cons_tail - prod_head - 1) & br->br_prod_mask;
+
+		if (free == 0) {
+			br->br_drops += n;
+			critical_exit();
+			return 0;
 		}
-	} while (!ukarch_compare_exchange_sync((uint32_t *) &br->br_prod_head,
-			prod_head, prod_next));
+		if (n > free) {
+			br->br_drops += n - free;
+			n = free;
+		}
+		prod_next = (prod_head + n) & br->br_prod_mask;
+	} while (!__uk_ring_cmpset_acq(&br->br_prod_head,
+				       prod_head, prod_next));
 
-#ifdef DEBUG_BUFRING
-	if (br->br_ring[prod_head] != NULL)
-		UK_CRASH("dangling value in enqueue");
-#endif
-	br->br_ring[prod_head] = buf;
+	__uk_ring_put(br, prod_head, bufs, n);
 
 	/*
 	 * If there are other enqueues in progress
 	 * that preceded us, we need to wait for them
-	 * to complete 
+	 * to complete
 	 */
 	while (br->br_prod_tail != prod_head)
 		ukarch_spinwait();
-	ukarch_store_n(&br->br_prod_tail, prod_next);
+	__uk_ring_store_rel(&br->br_prod_tail, prod_next);
 	critical_exit();
-	return 0;
+	return n;
 }
 
 /*
- * multi-consumer safe dequeue 
+ * multi-producer safe lock-free ring buffer enqueue
  *
  */
-static __inline void *
-uk_ring_dequeue_mc(struct uk_ring *br)
+static __inline int
+uk_ring_enqueue(struct uk_ring *br, void *buf)
 {
-	uint32_t cons_head, cons_next;
-	void *buf;
+	return uk_ring_enqueue_n(br, &buf, 1) ? 0 : -ENOBUFS;
+}
+
+/*
+ * single-producer enqueue of up to `n` buffers
+ * use where enqueue is protected by a lock or only ever done by one
+ * thread. No atomic read-modify-write operation is involved.
+ */
+static __inline unsigned int
+uk_ring_enqueue_n_sp(struct uk_ring *br, void **bufs, unsigned int n)
+{
+	uint32_t prod_head, cons_tail, free;
+
+	prod_head = br->br_prod_head;
+	cons_tail = __uk_ring_load_acq(&br->br_cons_tail);
+	free = (cons_tail - prod_head - 1) & br->br_prod_mask;
+
+	if (n > free) {
+		br->br_drops += n - free;
+		n = free;
+	}
+	if (n == 0)
+		return 0;
+
+	__uk_ring_put(br, prod_head, bufs, n);
+	prod_head = (prod_head + n) & br->br_prod_mask;
+	br->br_prod_head = prod_head;
+	__uk_ring_store_rel(&br->br_prod_tail, prod_head);
+	return n;
+}
+
+static __inline int
+uk_ring_enqueue_sp(struct uk_ring *br, void *buf)
+{
+	return uk_ring_enqueue_n_sp(br, &buf, 1) ? 0 : -ENOBUFS;
+}
+
+/*
+ * multi-consumer safe dequeue of up to `n` buffers
+ * One compare-and-swap claims the slots for the whole batch.
+ * Returns the number of buffers stored to `bufs`.
+ */
+static __inline unsigned int
+uk_ring_dequeue_n_mc(struct uk_ring *br, void **bufs, unsigned int n)
+{
+	uint32_t cons_head, cons_next, avail;
 
 	critical_enter();
 	do {
 		cons_head = br->br_cons_head;
-		cons_next = (cons_head + 1) & br->br_cons_mask;
+		avail = (__uk_ring_load_acq(&br->br_prod_tail) - cons_head)
+			& br->br_cons_mask;
 
-		if (cons_head == br->br_prod_tail) {
+		if (avail == 0) {
 			critical_exit();
-			return NULL;
+			return 0;
 		}
-	} while (!ukarch_compare_exchange_sync((uint32_t *) &br->br_cons_head,
-			cons_head, cons_next));
+		if (n > avail)
+			n = avail;
+		cons_next = (cons_head + n) & br->br_cons_mask;
+	} while (!__uk_ring_cmpset_acq(&br->br_cons_head,
+				       cons_head, cons_next));
+
+	__uk_ring_get(br, cons_head, bufs, n);
 
-	buf = br->br_ring[cons_head];
-#ifdef DEBUG_BUFRING
-	br->br_ring[cons_head] = NULL;
-#endif
 	/*
 	 * If there are other dequeues in progress
 	 * that preceded us, we need to wait for them
@@ -154,85 +259,78 @@ uk_ring_dequeue_mc(struct uk_ring *br)
 	while (br->br_cons_tail != cons_head)
 		ukarch_spinwait();
 
-	ukarch_store_n(&br->br_cons_tail, cons_next);
+	__uk_ring_store_rel(&br->br_cons_tail, cons_next);
 	critical_exit();
 
+	return n;
+}
+
+/*
+ * multi-consumer safe dequeue
+ *
+ */
+static __inline void *
+uk_ring_dequeue_mc(struct uk_ring *br)
+{
+	void *buf;
+
+	if (!uk_ring_dequeue_n_mc(br, &buf, 1))
+		return NULL;
 	return buf;
 }
 
 /*
- * single-consumer dequeue 
+ * single-consumer dequeue of up to `n` buffers
  * use where dequeue is protected by a lock
  * e.g. a network driver's tx queue lock
+ * No atomic read-modify-write operation is involved.
  */
-static __inline void *
-uk_ring_dequeue_sc(struct uk_ring *br)
+static __inline unsigned int
+uk_ring_dequeue_n_sc(struct uk_ring *br, void **bufs, unsigned int n)
 {
-	uint32_t cons_head, cons_next;
-#ifdef PREFETCH_DEFINED
-	uint32_t cons_next_next;
-#endif
-	uint32_t prod_tail;
-	void *buf;
+	uint32_t cons_head, avail;
 
 	/*
-	 * This is a workaround to allow using uk_ring on ARM and ARM64.
-	 * ARM64TODO: Fix uk_ring in a generic way.
-	 * REMARKS: It is suspected that br_cons_head does not require
-	 *   load_acq operation, but this change was extensively tested
-	 *   and confirmed it's working. To be reviewed once again in
-	 *   FreeBSD-12.
-	 *
-	 * Preventing following situation:
-	 * Core(0) - uk_ring_enqueue()                                       Core(1) - uk_ring_dequeue_sc()
-	 * -----------------------------------------                                       ----------------------------------------------
-	 *
-	 *                                                                                cons_head = br->br_cons_head;
-	 * atomic_cmpset_acq_32(&br->br_prod_head, ...));
-	 *                                                                                buf = br->br_ring[cons_head];     <see <1>>
-	 * br->br_ring[prod_head] = buf;
-	 * atomic_store_rel_32(&br->br_prod_tail, ...);
-	 *                                                                                prod_tail = br->br_prod_tail;
-	 *                                                                                if (cons_head == prod_tail) 
-	 *                                                                                        return (NULL);
-	 *                                                                                <condition is false and code uses invalid(old) buf>`
-	 *
-	 * <1> Load (on core 1) from br->br_ring[cons_head] can be reordered (speculative readed) by CPU.
+	 * The acquire on br_prod_tail orders the loads from br_ring after
+	 * it. Otherwise, on ARM and ARM64, a slot may be read speculatively
+	 * before the producer has stored the buffer to it and published
+	 * br_prod_tail, so that an old buffer is returned.
 	 */
-#if defined(CONFIG_ARCH_ARM_32) || defined(CONFIG_ARCH_ARM_64)
-	cons_head = ukarch_load_n(&br->br_cons_head);
-#else
 	cons_head = br->br_cons_head;
-#endif
-	prod_tail = ukarch_load_n(&br->br_prod_tail);
-
-	cons_next = (cons_head + 1) & br->br_cons_mask;
-#ifdef PREFETCH_DEFINED
-	cons_next_next = (cons_head + 2) & br->br_cons_mask;
-#endif
+	avail = (__uk_ring_load_acq(&br->br_prod_tail) - cons_head)
+		& br->br_cons_mask;
 
-	if (cons_head == prod_tail)
-		return NULL;
-
-#ifdef PREFETCH_DEFINED
-	if (cons_next != prod_tail) {
-		prefetch(br->br_ring[cons_next]);
-		if (cons_next_next != prod_tail)
-			prefetch(br->br_ring[cons_next_next]);
-	}
-#endif
-	br->br_cons_head = cons_next;
-	buf = br->br_ring[cons_head];
+	if (n > avail)
+		n = avail;
+	if (n == 0)
+		return 0;
 
 #ifdef DEBUG_BUFRING
-	br->br_ring[cons_head] = NULL;
 	if (!uk_mutex_is_locked(br->br_lock))
 		UK_CRASH("lock not held on single consumer dequeue: %d", br->br_lock->lock_count);
 	if (br->br_cons_tail != cons_head)
 		UK_CRASH("inconsistent list cons_tail=%d cons_head=%d",
 				br->br_cons_tail, cons_head);
 #endif
-	br->br_cons_tail = cons_next;
+	__uk_ring_get(br, cons_head, bufs, n);
+	cons_head = (cons_head + n) & br->br_cons_mask;
+	br->br_cons_head = cons_head;
+	__uk_ring_store_rel(&br->br_cons_tail, cons_head);
+	return n;
+}
+
+/*
+ * single-consumer dequeue
+ * use where dequeue is protected by a lock
+ * e.g. a network driver's tx queue lock
+ */
+static __inline void *
+uk_ring_dequeue_sc(struct uk_ring *br)
+{
+	void *buf;
+
+	if (!uk_ring_dequeue_n_sc(br, &buf, 1))
+		return NULL;
 	return buf;
 }
 
@@ -248,7 +346,7 @@ uk_ring_advance_sc(struct uk_ring *br)
 	uint32_t prod_tail;
 
 	cons_head = br->br_cons_head;
-	prod_tail = br->br_prod_tail;
+	prod_tail = __uk_ring_load_acq(&br->br_prod_tail);
 
 	cons_next = (cons_head + 1) & br->br_cons_mask;
 	if (cons_head == prod_tail)
@@ -257,7 +355,7 @@ uk_ring_advance_sc(struct uk_ring *br)
 #ifdef DEBUG_BUFRING
 	br->br_ring[cons_head] = NULL;
 #endif
-	br->br_cons_tail = cons_next;
+	__uk_ring_store_rel(&br->br_cons_tail, cons_next);
 }
 
 /*
@@ -297,12 +395,11 @@ uk_ring_peek(struct uk_ring *br)
 		UK_CRASH("lock not held on single consumer dequeue");
 #endif
 	/*
-	 * I believe it is safe to not have a memory barrier
-	 * here because we control cons and tail is worst case
-	 * a lagging indicator so we worst case we might
-	 * return NULL immediately after a buffer has been enqueued
+	 * Since we control cons_head and tail is worst case a
+	 * lagging indicator, we might at worst return NULL
+	 * immediately after a buffer has been enqueued
 	 */
-	if (br->br_cons_head == br->br_prod_tail)
+	if (br->br_cons_head == __uk_ring_load_acq(&br->br_prod_tail))
 		return NULL;
 
 	return br->br_ring[br->br_cons_head];
@@ -318,23 +415,18 @@ uk_ring_peek_clear_sc(struct uk_ring *br)
 		UK_CRASH("lock not held on single consumer dequeue");
 #endif
 
-	if (br->br_cons_head == br->br_prod_tail)
-		return NULL;
-
-#if defined(CONFIG_ARCH_ARM_32) || defined(CONFIG_ARCH_ARM_64)
 	/*
-	 * The barrier is required there on ARM and ARM64 to ensure, that
-	 * br->br_ring[br->br_cons_head] will not be fetched before the above
+	 * The acquire is required on ARM and ARM64 to ensure, that
+	 * br->br_ring[br->br_cons_head] will not be fetched before the
 	 * condition is checked.
-	 * Without the barrier, it is possible, that buffer will be fetched
+	 * Without it, it is possible, that buffer will be fetched
 	 * before the enqueue will put mbuf into br, then, in the meantime, the
 	 * enqueue will update the array and the br_prod_tail, and the
 	 * conditional check will be true, so we will return previously fetched
 	 * (and invalid) buffer.
 	 */
-	#error "unsupported: atomic_thread_fence_acq()"
-	/* TODO atomic_thread_fence_acq(); */
-#endif
+	if (br->br_cons_head == __uk_ring_load_acq(&br->br_prod_tail))
+		return NULL;
 
 #ifdef DEBUG_BUFRING
 	/*
@@ -376,4 +468,3 @@ struct uk_ring *uk_ring_alloc(int count, struct uk_alloc *a
 void uk_ring_free(struct uk_ring *br, struct uk_alloc *a);
 
 #endif
-
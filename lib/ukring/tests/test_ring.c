@@ -0,0 +1,304 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <string.h>
+#include <uk/test.h>
+#include <uk/config.h>
+#include <uk/essentials.h>
+#include <uk/alloc.h>
+#include <uk/ring.h>
+#if CONFIG_LIBUKSCHED
+#include <uk/sched.h>
+#include <uk/thread.h>
+#endif
+#if CONFIG_LIBUKRING_TEST_BENCH
+#include <uk/plat/time.h>
+#endif
+
+#define RING_SIZE		16
+
+/* Buffers are never dereferenced, so we can use tagged integers */
+#define BUF(v)			((void *)(__uptr)(v))
+#define VAL(b)			((__uptr)(b))
+
+UK_TESTCASE(ukring, single)
+{
+	struct uk_ring *r;
+	int i;
+
+	r = uk_ring_alloc(RING_SIZE, uk_alloc_get_default());
+	UK_TEST_EXPECT_NOT_NULL(r);
+	if (!r)
+		return;
+
+	UK_TEST_EXPECT(uk_ring_empty(r));
+	UK_TEST_EXPECT_NULL(uk_ring_dequeue_mc(r));
+	UK_TEST_EXPECT_NULL(uk_ring_dequeue_sc(r));
+
+	/* One slot always stays empty */
+	for (i = 1; i < RING_SIZE; i++)
+		UK_TEST_EXPECT_ZERO(uk_ring_enqueue(r, BUF(i)));
+	UK_TEST_EXPECT(uk_ring_full(r));
+	UK_TEST_EXPECT_SNUM_EQ(uk_ring_enqueue(r, BUF(RING_SIZE)), -ENOBUFS);
+	UK_TEST_EXPECT_SNUM_EQ(uk_ring_enqueue_sp(r, BUF(RING_SIZE)),
+			       -ENOBUFS);
+	UK_TEST_EXPECT_SNUM_EQ(uk_ring_count(r), RING_SIZE - 1);
+
+	UK_TEST_EXPECT_PTR_EQ(uk_ring_peek(r), BUF(1));
+	UK_TEST_EXPECT_PTR_EQ(uk_ring_dequeue_mc(r), BUF(1));
+	UK_TEST_EXPECT_PTR_EQ(uk_ring_dequeue_sc(r), BUF(2));
+	UK_TEST_EXPECT_PTR_EQ(uk_ring_peek_clear_sc(r), BUF(3));
+	uk_ring_advance_sc(r);
+	for (i = 4; i < RING_SIZE; i++)
+		UK_TEST_EXPECT_PTR_EQ(uk_ring_dequeue_sc(r), BUF(i));
+	UK_TEST_EXPECT(uk_ring_empty(r));
+
+	uk_ring_free(r, uk_alloc_get_default());
+}
+
+UK_TESTCASE(ukring, bulk_wrap)
+{
+	void *in[RING_SIZE], *out[RING_SIZE];
+	struct uk_ring *r;
+	unsigned int i, n, round, next = 1, expect = 1;
+	int ok = 1;
+
+	r = uk_ring_alloc(RING_SIZE, uk_alloc_get_default());
+	UK_TEST_EXPECT_NOT_NULL(r);
+	if (!r)
+		return;
+
+	/* Move odd-sized batches so that they straddle the end of the ring */
+	for (round = 0; round < 4 * RING_SIZE; round++) {
+		if (round & 2)
+			n = uk_ring_dequeue_n_sc(r, out, 3);
+		else
+			n = uk_ring_dequeue_n_mc(r, out, 3);
+		for (i = 0; i < n; i++)
+			ok &= VAL(out[i]) == expect++;
+
+		for (i = 0; i < 5; i++)
+			in[i] = BUF(next + i);
+		if (round & 1)
+			n = uk_ring_enqueue_n_sp(r, in, 5);
+		else
+			n = uk_ring_enqueue_n(r, in, 5);
+		next += n;
+	}
+	UK_TEST_EXPECT(ok);
+
+	/* The ring ran full on the way: a batch is cut to the free slots */
+	UK_TEST_EXPECT(uk_ring_full(r));
+	UK_TEST_EXPECT_SNUM_EQ(uk_ring_count(r), RING_SIZE - 1);
+	UK_TEST_EXPECT_ZERO(uk_ring_enqueue_n(r, in, 1));
+
+	n = uk_ring_dequeue_n_mc(r, out, RING_SIZE);
+	UK_TEST_EXPECT_SNUM_EQ(n, RING_SIZE - 1);
+	for (i = 0; i < n; i++)
+		ok &= VAL(out[i]) == expect++;
+	UK_TEST_EXPECT(ok);
+	UK_TEST_EXPECT_SNUM_EQ(expect, next);
+	UK_TEST_EXPECT_ZERO(uk_ring_dequeue_n_sc(r, out, RING_SIZE));
+
+	uk_ring_free(r, uk_alloc_get_default());
+}
+
+#if CONFIG_LIBUKSCHED
+#define STRESS_PRODUCERS	4
+#define STRESS_CONSUMERS	2
+#define STRESS_ITEMS		20000
+#define STRESS_RING_SIZE	64
+#define STRESS_BATCH		8
+
+/* Producer index in the upper bits, sequence number (from 1) below */
+#define STRESS_SHIFT		24
+
+struct stress_consumer {
+	__uptr last[STRESS_PRODUCERS];
+	unsigned long count;
+	int ok;
+};
+
+static struct uk_ring *stress_ring;
+static volatile unsigned long stress_consumed;
+static struct stress_consumer stress_consumers[STRESS_CONSUMERS];
+
+static void stress_producer_fn(void *arg)
+{
+	__uptr p = (__uptr)arg;
+	void *batch[STRESS_BATCH];
+	unsigned int seq = 1, n, i, want;
+
+	while (seq <= STRESS_ITEMS) {
+		/* Vary the batch size between 1 and STRESS_BATCH */
+		want = MIN(1 + seq % STRESS_BATCH, STRESS_ITEMS - seq + 1);
+		for (i = 0; i < want; i++)
+			batch[i] = BUF((p << STRESS_SHIFT) | (seq + i));
+		n = uk_ring_enqueue_n(stress_ring, batch, want);
+		seq += n;
+		if (n < want)
+			uk_sched_yield();
+		else if (seq % 32 < STRESS_BATCH)
+			uk_sched_yield();
+	}
+}
+
+static void stress_consumer_fn(void *arg)
+{
+	struct stress_consumer *c = (struct stress_consumer *)arg;
+	void *batch[STRESS_BATCH];
+	unsigned int n, i;
+	__uptr p, seq;
+
+	while (ukarch_load_n(&stress_consumed) <
+	       STRESS_PRODUCERS * STRESS_ITEMS) {
+		n = uk_ring_dequeue_n_mc(stress_ring, batch, STRESS_BATCH);
+		if (!n) {
+			uk_sched_yield();
+			continue;
+		}
+		for (i = 0; i < n; i++) {
+			p = VAL(batch[i]) >> STRESS_SHIFT;
+			seq = VAL(batch[i]) & ((1UL << STRESS_SHIFT) - 1);
+			/* Each consumer sees a producer's items in order */
+			if (p >= STRESS_PRODUCERS || seq <= c->last[p]) {
+				c->ok = 0;
+				continue;
+			}
+			c->last[p] = seq;
+		}
+		c->count += n;
+		ukarch_fetch_add(&stress_consumed, n);
+	}
+}
+
+UK_TESTCASE(ukring, multi_producer_stress)
+{
+	struct uk_thread *producers[STRESS_PRODUCERS];
+	struct uk_thread *consumers[STRESS_CONSUMERS];
+	unsigned long total = 0;
+	unsigned int i;
+
+	stress_ring = uk_ring_alloc(STRESS_RING_SIZE, uk_alloc_get_default());
+	UK_TEST_EXPECT_NOT_NULL(stress_ring);
+	if (!stress_ring)
+		return;
+
+	stress_consumed = 0;
+	for (i = 0; i < STRESS_CONSUMERS; i++) {
+		memset(&stress_consumers[i], 0, sizeof(stress_consumers[i]));
+		stress_consumers[i].ok = 1;
+		consumers[i] = uk_thread_create("ring-consumer",
+						stress_consumer_fn,
+						&stress_consumers[i]);
+		UK_TEST_EXPECT_NOT_NULL(consumers[i]);
+		if (!consumers[i])
+			return;
+	}
+	for (i = 0; i < STRESS_PRODUCERS; i++) {
+		producers[i] = uk_thread_create("ring-producer",
+						stress_producer_fn,
+						(void *)(__uptr)i);
+		UK_TEST_EXPECT_NOT_NULL(producers[i]);
+		if (!producers[i])
+			return;
+	}
+
+	for (i = 0; i < STRESS_PRODUCERS; i++)
+		uk_thread_wait(producers[i]);
+	for (i = 0; i < STRESS_CONSUMERS; i++) {
+		uk_thread_wait(consumers[i]);
+		UK_TEST_EXPECT(stress_consumers[i].ok);
+		total += stress_consumers[i].count;
+	}
+
+	UK_TEST_EXPECT_SNUM_EQ(total, STRESS_PRODUCERS * STRESS_ITEMS);
+	UK_TEST_EXPECT(uk_ring_empty(stress_ring));
+	uk_ring_free(stress_ring, uk_alloc_get_default());
+}
+#endif /* CONFIG_LIBUKSCHED */
+
+#if CONFIG_LIBUKRING_TEST_BENCH
+#define BENCH_RING_SIZE		1024
+#define BENCH_ITEMS		(1 << 20)
+
+static const unsigned int bench_batches[] = { 1, 8, 32 };
+
+/* Returns the cost per buffer of an enqueue and a dequeue in nanoseconds */
+static __nsec bench_ring(struct uk_ring *r, unsigned int batch, int single)
+{
+	void *bufs[32];
+	unsigned int done;
+	__nsec start;
+
+	for (done = 0; done < batch; done++)
+		bufs[done] = BUF(done + 1);
+
+	start = ukplat_monotonic_clock();
+	for (done = 0; done < BENCH_ITEMS; done += batch) {
+		if (single) {
+			uk_ring_enqueue_n_sp(r, bufs, batch);
+			uk_ring_dequeue_n_sc(r, bufs, batch);
+		} else {
+			uk_ring_enqueue_n(r, bufs, batch);
+			uk_ring_dequeue_n_mc(r, bufs, batch);
+		}
+	}
+	return (ukplat_monotonic_clock() - start) * 1000 / BENCH_ITEMS;
+}
+
+UK_TESTCASE(ukring, throughput)
+{
+	struct uk_ring *r;
+	unsigned int i;
+	__nsec mp, sp;
+
+	r = uk_ring_alloc(BENCH_RING_SIZE, uk_alloc_get_default());
+	UK_TEST_EXPECT_NOT_NULL(r);
+	if (!r)
+		return;
+
+	for (i = 0; i < ARRAY_SIZE(bench_batches); i++) {
+		mp = bench_ring(r, bench_batches[i], 0);
+		sp = bench_ring(r, bench_batches[i], 1);
+		uk_test_printf("batch %2u: mp/mc %4lu.%03lu ns, sp/sc %4lu.%03lu ns per buffer\n",
+			       bench_batches[i],
+			       (unsigned long)mp / 1000,
+			       (unsigned long)mp % 1000,
+			       (unsigned long)sp / 1000,
+			       (unsigned long)sp % 1000);
+	}
+	UK_TEST_EXPECT(uk_ring_empty(r));
+	uk_ring_free(r, uk_alloc_get_default());
+}
+#endif /* CONFIG_LIBUKRING_TEST_BENCH */
+
+uk_testsuite_register(ukring, NULL);
@@ -96,6 +96,7 @@ struct uk_sched {
 	bool threads_started;
 	struct uk_thread idle;
 	struct uk_thread_list exited_threads;
+	__spinlock exited_lock;
 	struct ukplat_ctx_callbacks plat_ctx_cbs;
 	struct uk_alloc *allocator;
 	struct uk_sched *next;
@@ -207,6 +208,12 @@ struct uk_sched *uk_sched_create(struct uk_alloc *a, size_t prv_size);
 void uk_sched_idle_init(struct uk_sched *sched,
 		void *stack, void (*function)(void *));
 
+#ifdef CONFIG_HAVE_SMP
+/* Creates the idle thread of a secondary logical CPU */
+struct uk_thread *uk_sched_idle_create(struct uk_sched *sched,
+		__lcpuidx lcpu, void (*function)(void *));
+#endif /* CONFIG_HAVE_SMP */
+
 static inline struct uk_thread *uk_sched_get_idle(struct uk_sched *s)
 {
 	UK_ASSERT(s);
@@ -254,6 +261,7 @@ void uk_sched_thread_destroy(struct uk_sched *sched,
 		struct uk_thread *thread);
 void uk_sched_thread_kill(struct uk_sched *sched,
 		struct uk_thread *thread);
+void uk_sched_thread_reap(struct uk_sched *sched);
 
 static inline
 void uk_sched_thread_switch(struct uk_sched *sched,
@@ -0,0 +1,90 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __UK_SCHED_SLEEPQ_H__
+#define __UK_SCHED_SLEEPQ_H__
+
+#include <stddef.h>
+#include <uk/thread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Queue of threads that sleep until their wakeup_time, ordered by it.
+ *
+ * The queue is an intrusive pairing heap that is linked through the
+ * sleep_* fields of struct uk_thread, so it never allocates memory.
+ * Looking up the earliest deadline is O(1), adding a thread is O(1) and
+ * removing one is O(log n) amortized. Callers must serialize accesses,
+ * e.g., by disabling interrupts.
+ */
+struct uk_sleepq {
+	struct uk_thread *root;
+};
+
+#define UK_SLEEPQ_INITIALIZER { .root = NULL }
+
+static inline void uk_sleepq_init(struct uk_sleepq *q)
+{
+	q->root = NULL;
+}
+
+static inline int uk_sleepq_empty(const struct uk_sleepq *q)
+{
+	return q->root == NULL;
+}
+
+/**
+ * Returns the thread with the earliest wakeup_time, NULL if the queue is
+ * empty. The thread stays queued.
+ */
+static inline struct uk_thread *uk_sleepq_first(const struct uk_sleepq *q)
+{
+	return q->root;
+}
+
+/**
+ * Adds a thread to the queue. Its wakeup_time must not change while it is
+ * queued.
+ */
+void uk_sleepq_add(struct uk_sleepq *q, struct uk_thread *thread);
+
+/**
+ * Removes a queued thread from the queue.
+ */
+void uk_sleepq_remove(struct uk_sleepq *q, struct uk_thread *thread);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UK_SCHED_SLEEPQ_H__ */
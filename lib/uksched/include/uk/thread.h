@@ -44,6 +44,8 @@
 #include <uk/wait_types.h>
 #include <uk/list.h>
 #include <uk/prio.h>
+#include <uk/arch/spinlock.h>
+#include <uk/plat/lcpu.h>
 #include <uk/essentials.h>
 
 #ifdef __cplusplus
@@ -60,6 +62,20 @@ struct uk_thread {
 	UK_TAILQ_ENTRY(struct uk_thread) thread_list;
 	uint32_t flags;
 	__snsec wakeup_time;
+	/* Sleep queue links, see uk/sleepq.h */
+	struct uk_thread *sleep_child;
+	struct uk_thread *sleep_next;
+	struct uk_thread *sleep_prev;
+	/* Logical CPU whose run queue the thread is on */
+	__lcpuidx lcpu;
+	/* Logical CPU the thread is pinned to, UK_THREAD_ATTR_LCPU_ANY if
+	 * it may migrate
+	 */
+	int affinity;
+	/* Set while the context of the thread is in use on a logical CPU */
+	volatile int running;
+	/* Serializes blocking and waking up from different logical CPUs */
+	__spinlock lock;
 	bool detached;
 	struct uk_waitq waiting_threads;
 	struct uk_sched *sched;
@@ -47,9 +47,13 @@ extern "C" {
 #define UK_THREAD_ATTR_PRIO_MIN         0
 #define UK_THREAD_ATTR_PRIO_MAX         255
 #define UK_THREAD_ATTR_PRIO_DEFAULT     127
+/* Threads that dispatch device events */
+#define UK_THREAD_ATTR_PRIO_IO          191
 
 #define UK_THREAD_ATTR_TIMESLICE_NIL    0
 
+#define UK_THREAD_ATTR_LCPU_ANY         (-1)
+
 typedef int prio_t;
 
 typedef struct uk_thread_attr {
@@ -59,6 +63,8 @@ typedef struct uk_thread_attr {
 	prio_t prio;
 	/* Time slice in nanoseconds */
 	__nsec timeslice;
+	/* Logical CPU to pin the thread to */
+	int lcpu;
 } uk_thread_attr_t;
 
 int uk_thread_attr_init(uk_thread_attr_t *attr);
@@ -73,6 +79,9 @@ int uk_thread_attr_get_prio(const uk_thread_attr_t *attr, prio_t *prio);
 int uk_thread_attr_set_timeslice(uk_thread_attr_t *attr, __nsec timeslice);
 int uk_thread_attr_get_timeslice(const uk_thread_attr_t *attr, __nsec *timeslice);
 
+int uk_thread_attr_set_lcpu(uk_thread_attr_t *attr, int lcpu);
+int uk_thread_attr_get_lcpu(const uk_thread_attr_t *attr, int *lcpu);
+
 #ifdef __cplusplus
 }
 #endif
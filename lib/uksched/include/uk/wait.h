@@ -28,6 +28,7 @@
 
 #include <uk/essentials.h>
 #include <uk/plat/lcpu.h>
+#include <uk/plat/spinlock.h>
 #include <uk/plat/time.h>
 #include <uk/sched.h>
 #include <uk/wait_types.h>
@@ -39,7 +40,8 @@ extern "C" {
 static inline
 void uk_waitq_init(struct uk_waitq *wq)
 {
-	UK_STAILQ_INIT(wq);
+	UK_STAILQ_INIT(&wq->list);
+	ukarch_spin_init(&wq->lock);
 }
 
 static inline
@@ -53,7 +55,7 @@ void uk_waitq_entry_init(struct uk_waitq_entry *entry,
 static inline
 int uk_waitq_empty(struct uk_waitq *wq)
 {
-	return UK_STAILQ_EMPTY(wq);
+	return UK_STAILQ_EMPTY(&wq->list);
 }
 
 static inline
@@ -61,7 +63,7 @@ void uk_waitq_add(struct uk_waitq *wq,
 		struct uk_waitq_entry *entry)
 {
 	if (!entry->waiting) {
-		UK_STAILQ_INSERT_TAIL(wq, entry, thread_list);
+		UK_STAILQ_INSERT_TAIL(&wq->list, entry, thread_list);
 		entry->waiting = 1;
 	}
 }
@@ -71,7 +73,8 @@ void uk_waitq_remove(struct uk_waitq *wq,
 		struct uk_waitq_entry *entry)
 {
 	if (entry->waiting) {
-		UK_STAILQ_REMOVE(wq, entry, struct uk_waitq_entry, thread_list);
+		UK_STAILQ_REMOVE(&wq->list, entry, struct uk_waitq_entry,
+				 thread_list);
 		entry->waiting = 0;
 	}
 }
@@ -79,22 +82,22 @@ void uk_waitq_remove(struct uk_waitq *wq,
 #define uk_waitq_add_waiter(wq, w) \
 do { \
 	unsigned long flags; \
-	flags = ukplat_lcpu_save_irqf(); \
+	ukplat_spin_lock_irqsave(&(wq)->lock, flags); \
 	uk_waitq_add(wq, w); \
 	uk_thread_block(uk_thread_current()); \
-	ukplat_lcpu_restore_irqf(flags); \
+	ukplat_spin_unlock_irqrestore(&(wq)->lock, flags); \
 } while (0)
 
 #define uk_waitq_remove_waiter(wq, w) \
 do { \
 	unsigned long flags; \
-	flags = ukplat_lcpu_save_irqf(); \
+	ukplat_spin_lock_irqsave(&(wq)->lock, flags); \
 	uk_waitq_remove(wq, w); \
-	ukplat_lcpu_restore_irqf(flags); \
+	ukplat_spin_unlock_irqrestore(&(wq)->lock, flags); \
 } while (0)
 
 #define __wq_wait_event_deadline(wq, condition, deadline, deadline_condition, \
-				 lock_fn, unlock_fn, lock) \
+				 lock_fn, unlock_fn, lock_obj) \
 ({ \
 	struct uk_thread *__current; \
 	unsigned long flags; \
@@ -103,22 +106,23 @@ do { \
 	if (!(condition)) { \
 		__current = uk_thread_current(); \
 		for (;;) { \
-			/* protect the list */ \
-			flags = ukplat_lcpu_save_irqf(); \
+			/* a waker changes the condition before taking \
+			 * the lock to walk the list \
+			 */ \
+			ukplat_spin_lock_irqsave(&(wq)->lock, flags); \
 			if (condition) { \
-				ukplat_lcpu_restore_irqf(flags); \
+				ukplat_spin_unlock_irqrestore(&(wq)->lock, \
+							      flags); \
 				break; \
 			} \
 			uk_waitq_add(wq, &__wait); \
-			__current->wakeup_time = deadline; \
-			clear_runnable(__current); \
-			uk_sched_thread_blocked(__current->sched, __current); \
-			ukplat_lcpu_restore_irqf(flags); \
-			if (lock) \
-				unlock_fn(lock); \
+			uk_thread_block_until(__current, deadline); \
+			ukplat_spin_unlock_irqrestore(&(wq)->lock, flags); \
+			if (lock_obj) \
+				unlock_fn(lock_obj); \
 			uk_sched_yield(); \
-			if (lock) \
-				lock_fn(lock); \
+			if (lock_obj) \
+				lock_fn(lock_obj); \
 			if (condition) \
 				break; \
 			if (deadline_condition) { \
@@ -126,11 +130,11 @@ do { \
 				break; \
 			} \
 		} \
-		flags = ukplat_lcpu_save_irqf(); \
+		ukplat_spin_lock_irqsave(&(wq)->lock, flags); \
 		/* need to wake up */ \
 		uk_thread_wake(__current); \
 		uk_waitq_remove(wq, &__wait); \
-		ukplat_lcpu_restore_irqf(flags); \
+		ukplat_spin_unlock_irqrestore(&(wq)->lock, flags); \
 	} \
 	timedout; \
 })
@@ -164,10 +168,10 @@ void uk_waitq_wake_up(struct uk_waitq *wq)
 	unsigned long flags;
 	struct uk_waitq_entry *curr, *tmp;
 
-	flags = ukplat_lcpu_save_irqf();
-	UK_STAILQ_FOREACH_SAFE(curr, wq, thread_list, tmp)
+	ukplat_spin_lock_irqsave(&wq->lock, flags);
+	UK_STAILQ_FOREACH_SAFE(curr, &wq->list, thread_list, tmp)
 		uk_thread_wake(curr->thread);
-	ukplat_lcpu_restore_irqf(flags);
+	ukplat_spin_unlock_irqrestore(&wq->lock, flags);
 }
 
 #ifdef __cplusplus
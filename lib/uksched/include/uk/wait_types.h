@@ -27,6 +27,7 @@
 #define __UK_SCHED_WAIT_TYPES_H__
 
 #include <uk/list.h>
+#include <uk/arch/spinlock.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -38,10 +39,17 @@ struct uk_waitq_entry {
 	UK_STAILQ_ENTRY(struct uk_waitq_entry) thread_list;
 };
 
-/* TODO - lock required? */
-UK_STAILQ_HEAD(uk_waitq, struct uk_waitq_entry);
+UK_STAILQ_HEAD(uk_waitq_list, struct uk_waitq_entry);
 
-#define __WAIT_QUEUE_INITIALIZER(name) UK_STAILQ_HEAD_INITIALIZER(name)
+struct uk_waitq {
+	struct uk_waitq_list list;
+	/* Protects the list against other logical CPUs */
+	__spinlock lock;
+};
+
+#define __WAIT_QUEUE_INITIALIZER(name) \
+	{ UK_STAILQ_HEAD_INITIALIZER((name).list), \
+	  UKARCH_SPINLOCK_INITIALIZER() }
 
 #define DEFINE_WAIT_QUEUE(name) \
 	struct uk_waitq name = __WAIT_QUEUE_INITIALIZER(name)
@@ -34,9 +34,13 @@
 #include <string.h>
 #include <uk/plat/config.h>
 #include <uk/plat/thread.h>
+#include <uk/plat/spinlock.h>
 #include <uk/alloc.h>
 #include <uk/sched.h>
 #include <uk/arch/tls.h>
+#if CONFIG_LIBUKSCHEDPRIO
+#include <uk/schedprio.h>
+#endif
 #if CONFIG_LIBUKSCHEDCOOP
 #include <uk/schedcoop.h>
 #endif
@@ -56,7 +60,9 @@ struct uk_sched *uk_sched_default_init(struct uk_alloc *a)
 	uk_proc_sig_init(&uk_proc_sig);
 #endif
 
-#if CONFIG_LIBUKSCHEDCOOP
+#if CONFIG_LIBUKSCHEDPRIO
+	s = uk_schedprio_init(a);
+#elif CONFIG_LIBUKSCHEDCOOP
 	s = uk_schedcoop_init(a);
 #endif
 
@@ -134,6 +140,7 @@ struct uk_sched *uk_sched_create(struct uk_alloc *a, size_t prv_size)
 	sched->threads_started = false;
 	sched->allocator = a;
 	UK_TAILQ_INIT(&sched->exited_threads);
+	ukarch_spin_init(&sched->exited_lock);
 	sched->prv = (void *) sched + sizeof(struct uk_sched);
 
 	return sched;
@@ -201,6 +208,47 @@ out_crash:
 	UK_CRASH("Failed to initialize `idle` thread\n");
 }
 
+#ifdef CONFIG_HAVE_SMP
+struct uk_thread *uk_sched_idle_create(struct uk_sched *sched,
+		__lcpuidx lcpu, void (*function)(void *))
+{
+	struct uk_thread *idle;
+	void *stack = NULL;
+	void *tls = NULL;
+
+	UK_ASSERT(sched != NULL);
+
+	idle = uk_malloc(sched->allocator, sizeof(struct uk_thread));
+	if (idle == NULL)
+		goto err;
+	stack = create_stack(sched->allocator);
+	if (stack == NULL)
+		goto err;
+	if (have_tls_area() && !(tls = uk_thread_tls_create(sched->allocator)))
+		goto err;
+
+	if (uk_thread_init(idle,
+			   &sched->plat_ctx_cbs, sched->allocator,
+			   "Idle", stack, tls, function, NULL))
+		goto err;
+
+	idle->sched = sched;
+	idle->lcpu = lcpu;
+	idle->affinity = lcpu;
+	return idle;
+
+err:
+	uk_pr_err("Failed to create idle thread for lcpu %"__PRIu32"\n", lcpu);
+	if (tls)
+		uk_free(sched->allocator, tls);
+	if (stack)
+		uk_free(sched->allocator, stack);
+	if (idle)
+		uk_free(sched->allocator, idle);
+	return NULL;
+}
+#endif /* CONFIG_HAVE_SMP */
+
 struct uk_thread *uk_sched_thread_create(struct uk_sched *sched,
 		const char *name, const uk_thread_attr_t *attr,
 		void (*function)(void *), void *arg)
@@ -250,20 +298,59 @@ err:
 	return NULL;
 }
 
+static void thread_free(struct uk_sched *sched, struct uk_thread *thread)
+{
+	uk_thread_fini(thread, sched->allocator);
+	uk_free(sched->allocator, thread->stack);
+	if (thread->tls)
+		uk_free(sched->allocator, thread->tls);
+	uk_free(sched->allocator, thread);
+}
+
 void uk_sched_thread_destroy(struct uk_sched *sched, struct uk_thread *thread)
 {
+	unsigned long flags;
+
 	UK_ASSERT(sched != NULL);
 	UK_ASSERT(thread != NULL);
 	UK_ASSERT(thread->stack != NULL);
 	UK_ASSERT(!have_tls_area() || thread->tls != NULL);
 	UK_ASSERT(is_exited(thread));
 
+	ukplat_spin_lock_irqsave(&sched->exited_lock, flags);
 	UK_TAILQ_REMOVE(&sched->exited_threads, thread, thread_list);
-	uk_thread_fini(thread, sched->allocator);
-	uk_free(sched->allocator, thread->stack);
-	if (thread->tls)
-		uk_free(sched->allocator, thread->tls);
-	uk_free(sched->allocator, thread);
+	ukplat_spin_unlock_irqrestore(&sched->exited_lock, flags);
+
+	thread_free(sched, thread);
+}
+
+/* Destroys the detached threads that exited, as soon as no logical CPU
+ * runs on their stack anymore
+ */
+void uk_sched_thread_reap(struct uk_sched *sched)
+{
+	struct uk_thread *current = uk_thread_current();
+	struct uk_thread *thread;
+	unsigned long flags;
+
+	UK_ASSERT(sched != NULL);
+
+	for (;;) {
+		ukplat_spin_lock_irqsave(&sched->exited_lock, flags);
+		UK_TAILQ_FOREACH(thread, &sched->exited_threads, thread_list) {
+			if (thread->detached && !thread->running &&
+			    thread != current)
+				break;
+		}
+		if (thread)
+			UK_TAILQ_REMOVE(&sched->exited_threads, thread,
+					thread_list);
+		ukplat_spin_unlock_irqrestore(&sched->exited_lock, flags);
+
+		if (!thread)
+			break;
+		thread_free(sched, thread);
+	}
 }
 
 void uk_sched_thread_kill(struct uk_sched *sched, struct uk_thread *thread)
@@ -0,0 +1,134 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <uk/assert.h>
+#include <uk/sleepq.h>
+
+/* Links two heaps, the one with the later deadline becomes the first child
+ * of the other one.
+ */
+static struct uk_thread *sleepq_meld(struct uk_thread *a, struct uk_thread *b)
+{
+	struct uk_thread *tmp;
+
+	if (!a)
+		return b;
+	if (!b)
+		return a;
+
+	if (b->wakeup_time < a->wakeup_time) {
+		tmp = a;
+		a = b;
+		b = tmp;
+	}
+
+	/* The first child points back to its parent with sleep_prev */
+	b->sleep_prev = a;
+	b->sleep_next = a->sleep_child;
+	if (a->sleep_child)
+		a->sleep_child->sleep_prev = b;
+	a->sleep_child = b;
+	return a;
+}
+
+/* Two-pass pairing of a sibling list into a single heap */
+static struct uk_thread *sleepq_merge_pairs(struct uk_thread *first)
+{
+	struct uk_thread *a, *b, *pairs = NULL, *heap = NULL;
+
+	/* Meld pairs from left to right, keep them in a stack */
+	while (first) {
+		a = first;
+		b = a->sleep_next;
+		first = b ? b->sleep_next : NULL;
+
+		a->sleep_next = a->sleep_prev = NULL;
+		if (b)
+			b->sleep_next = b->sleep_prev = NULL;
+		a = sleepq_meld(a, b);
+
+		a->sleep_next = pairs;
+		pairs = a;
+	}
+
+	/* Meld the pairs from right to left */
+	while (pairs) {
+		a = pairs;
+		pairs = a->sleep_next;
+		a->sleep_next = NULL;
+		heap = sleepq_meld(heap, a);
+	}
+	return heap;
+}
+
+void uk_sleepq_add(struct uk_sleepq *q, struct uk_thread *thread)
+{
+	UK_ASSERT(q);
+	UK_ASSERT(thread);
+
+	thread->sleep_child = NULL;
+	thread->sleep_next = NULL;
+	thread->sleep_prev = NULL;
+	q->root = sleepq_meld(q->root, thread);
+}
+
+void uk_sleepq_remove(struct uk_sleepq *q, struct uk_thread *thread)
+{
+	struct uk_thread *sub;
+
+	UK_ASSERT(q);
+	UK_ASSERT(thread);
+	UK_ASSERT(q->root);
+
+	if (thread == q->root) {
+		q->root = sleepq_merge_pairs(thread->sleep_child);
+		if (q->root)
+			q->root->sleep_prev = NULL;
+		goto out;
+	}
+
+	/* Unlink the thread from its siblings */
+	UK_ASSERT(thread->sleep_prev);
+	if (thread->sleep_prev->sleep_child == thread)
+		thread->sleep_prev->sleep_child = thread->sleep_next;
+	else
+		thread->sleep_prev->sleep_next = thread->sleep_next;
+	if (thread->sleep_next)
+		thread->sleep_next->sleep_prev = thread->sleep_prev;
+
+	/* Its children become a heap of their own that joins the root */
+	sub = sleepq_merge_pairs(thread->sleep_child);
+	q->root = sleepq_meld(q->root, sub);
+
+out:
+	thread->sleep_child = NULL;
+	thread->sleep_next = NULL;
+	thread->sleep_prev = NULL;
+}
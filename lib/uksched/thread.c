@@ -142,6 +142,13 @@ int uk_thread_init(struct uk_thread *thread,
 	/* Not runnable, not exited, not sleeping */
 	thread->flags = 0;
 	thread->wakeup_time = 0LL;
+	thread->sleep_child = NULL;
+	thread->sleep_next = NULL;
+	thread->sleep_prev = NULL;
+	thread->lcpu = 0;
+	thread->affinity = UK_THREAD_ATTR_LCPU_ANY;
+	thread->running = 0;
+	ukarch_spin_init(&thread->lock);
 	thread->detached = false;
 	uk_waitq_init(&thread->waiting_threads);
 	thread->sched = NULL;
@@ -215,11 +222,11 @@ void uk_thread_block_until(struct uk_thread *thread, __snsec until)
 {
 	unsigned long flags;
 
-	flags = ukplat_lcpu_save_irqf();
+	ukplat_spin_lock_irqsave(&thread->lock, flags);
 	thread->wakeup_time = until;
 	clear_runnable(thread);
 	uk_sched_thread_blocked(thread->sched, thread);
-	ukplat_lcpu_restore_irqf(flags);
+	ukplat_spin_unlock_irqrestore(&thread->lock, flags);
 }
 
 void uk_thread_block_timeout(struct uk_thread *thread, __nsec nsec)
@@ -238,13 +245,13 @@ void uk_thread_wake(struct uk_thread *thread)
 {
 	unsigned long flags;
 
-	flags = ukplat_lcpu_save_irqf();
+	ukplat_spin_lock_irqsave(&thread->lock, flags);
 	if (!is_runnable(thread)) {
 		uk_sched_thread_woken(thread->sched, thread);
 		thread->wakeup_time = 0LL;
 		set_runnable(thread);
 	}
-	ukplat_lcpu_restore_irqf(flags);
+	ukplat_spin_unlock_irqrestore(&thread->lock, flags);
 }
 
 void uk_thread_exit(struct uk_thread *thread)
@@ -270,7 +277,9 @@ int uk_thread_wait(struct uk_thread *thread)
 
 	uk_waitq_wait_event(&thread->waiting_threads, is_exited(thread));
 
-	thread->detached = true;
+	/* The thread may still be switching away on another logical CPU */
+	while (thread->running)
+		uk_sched_yield();
 
 	uk_sched_thread_destroy(thread->sched, thread);
 
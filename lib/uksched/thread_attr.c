@@ -33,6 +33,7 @@
 #include <stdlib.h>
 #include <errno.h>
 #include <uk/plat/time.h>
+#include <uk/plat/lcpu.h>
 #include <uk/thread_attr.h>
 #include <uk/assert.h>
 
@@ -45,6 +46,7 @@ int uk_thread_attr_init(uk_thread_attr_t *attr)
 	attr->detached = false;
 	attr->prio = UK_THREAD_ATTR_PRIO_INVALID;
 	attr->timeslice = UK_THREAD_ATTR_TIMESLICE_NIL;
+	attr->lcpu = UK_THREAD_ATTR_LCPU_ANY;
 
 	return 0;
 }
@@ -135,3 +137,27 @@ int uk_thread_attr_get_timeslice(const uk_thread_attr_t *attr, __nsec *timeslice
 
 	return 0;
 }
+
+int uk_thread_attr_set_lcpu(uk_thread_attr_t *attr, int lcpu)
+{
+	if (attr == NULL)
+		return -EINVAL;
+
+	if (lcpu < UK_THREAD_ATTR_LCPU_ANY ||
+	    lcpu >= (int) ukplat_lcpu_count())
+		return -EINVAL;
+
+	attr->lcpu = lcpu;
+
+	return 0;
+}
+
+int uk_thread_attr_get_lcpu(const uk_thread_attr_t *attr, int *lcpu)
+{
+	if (attr == NULL || lcpu == NULL)
+		return -EINVAL;
+
+	*lcpu = attr->lcpu;
+
+	return 0;
+}
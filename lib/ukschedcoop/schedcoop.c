@@ -28,35 +28,162 @@
 /*
  * The scheduler is non-preemptive (cooperative), and schedules according
  * to Round Robin algorithm.
+ *
+ * With CONFIG_LIBUKSCHEDCOOP_SMP, every logical CPU has its own run queue
+ * and sleep queue. New threads are queued on the CPU that creates them (or
+ * the one they are pinned to) and stay there; a CPU that runs out of work
+ * steals runnable, unpinned threads from the others. Waking up a thread
+ * queued on another CPU kicks that CPU out of its halt with an IPI.
  */
+#include <string.h>
+#include <uk/plat/config.h>
 #include <uk/plat/lcpu.h>
 #include <uk/plat/memory.h>
+#include <uk/plat/spinlock.h>
 #include <uk/plat/time.h>
 #include <uk/sched.h>
+#include <uk/sleepq.h>
 #include <uk/schedcoop.h>
 
-struct schedcoop_private {
+#ifdef CONFIG_LIBUKSCHEDCOOP_SMP
+#define SCHEDCOOP_LCPU_MAX	CONFIG_UKPLAT_LCPU_MAXCOUNT
+#define schedcoop_lcpu_idx()	ukplat_lcpu_idx()
+#else
+#define SCHEDCOOP_LCPU_MAX	1
+#define schedcoop_lcpu_idx()	0
+#endif /* CONFIG_LIBUKSCHEDCOOP_SMP */
+
+struct schedcoop_lcpu {
+	/* Protects the queues and current */
+	__spinlock lock;
 	struct uk_thread_list thread_list;
-	struct uk_thread_list sleeping_threads;
+	struct uk_sleepq sleeping_threads;
+	/* Thread that runs on this lcpu */
+	struct uk_thread *current;
+	/* Thread that was switched away from; its context is in use until
+	 * the switch completed
+	 */
+	struct uk_thread *prev;
+#ifdef CONFIG_LIBUKSCHEDCOOP_SMP
+	unsigned int nr_queued;
+	struct uk_thread *idle;
+	void *boot_stack;
+#endif /* CONFIG_LIBUKSCHEDCOOP_SMP */
+} __align(CACHE_LINE_SIZE);
+
+struct schedcoop_private {
+	struct schedcoop_lcpu lcpu[SCHEDCOOP_LCPU_MAX];
 };
 
+#ifdef CONFIG_LIBUKSCHEDCOOP_SMP
+static struct uk_sched *schedcoop;
+
+#define schedcoop_rq_inc(rq)	((rq)->nr_queued++)
+#define schedcoop_rq_dec(rq)	((rq)->nr_queued--)
+#else
+#define schedcoop_rq_inc(rq)	do { } while (0)
+#define schedcoop_rq_dec(rq)	do { } while (0)
+#endif /* CONFIG_LIBUKSCHEDCOOP_SMP */
+
 #ifdef SCHED_DEBUG
 static void print_runqueue(struct uk_sched *s)
 {
-	struct schedcoop_private *prv = s->private;
+	struct schedcoop_private *prv = s->prv;
 	struct uk_thread *th;
 
-	UK_TAILQ_FOREACH(th, &prv->thread_list, thread_list) {
+	UK_TAILQ_FOREACH(th, &prv->lcpu[0].thread_list, thread_list) {
 		uk_pr_debug("   Thread \"%s\", runnable=%d\n",
 			    th->name, is_runnable(th));
 	}
 }
 #endif
 
+/* Locks the run queue of the lcpu that t is assigned to. The assignment of
+ * a queued thread changes when another lcpu steals it, so check again after
+ * taking the lock.
+ */
+static struct schedcoop_lcpu *schedcoop_lock_rq(struct schedcoop_private *prv,
+						struct uk_thread *t)
+{
+	struct schedcoop_lcpu *rq;
+
+	for (;;) {
+		rq = &prv->lcpu[t->lcpu];
+		ukarch_spin_lock(&rq->lock);
+		if (likely(rq == &prv->lcpu[t->lcpu]))
+			return rq;
+		ukarch_spin_unlock(&rq->lock);
+	}
+}
+
+/* Must be called with IRQs disabled after switching away from rq->prev */
+static inline void schedcoop_switch_done(struct schedcoop_lcpu *rq)
+{
+	struct uk_thread *prev = rq->prev;
+
+	if (prev) {
+		rq->prev = NULL;
+		wmb();
+		prev->running = 0;
+	}
+}
+
+#ifdef CONFIG_LIBUKSCHEDCOOP_SMP
+/* Interrupts the halt of another lcpu after queuing a thread on it */
+static void schedcoop_kick(__lcpuidx idx)
+{
+	unsigned int num = 1;
+
+	if (idx != ukplat_lcpu_idx())
+		ukplat_lcpu_wakeup(&idx, &num);
+}
+
+/* Takes a runnable thread from another lcpu. Threads that are pinned or
+ * whose context is still being saved stay where they are.
+ */
+static struct uk_thread *schedcoop_steal(struct schedcoop_private *prv,
+					 __lcpuidx self)
+{
+	__u32 count = ukplat_lcpu_count();
+	struct schedcoop_lcpu *victim;
+	struct uk_thread *t;
+	__u32 i;
+
+	for (i = 1; i < count; i++) {
+		victim = &prv->lcpu[(self + i) % count];
+		if (!victim->nr_queued)
+			continue;
+		/* Never wait for a remote lock while holding our own */
+		if (!ukarch_spin_trylock(&victim->lock))
+			continue;
+
+		UK_TAILQ_FOREACH(t, &victim->thread_list, thread_list) {
+			if (t->affinity == UK_THREAD_ATTR_LCPU_ANY &&
+			    !t->running)
+				break;
+		}
+		if (t) {
+			UK_TAILQ_REMOVE(&victim->thread_list, t, thread_list);
+			victim->nr_queued--;
+			t->lcpu = self;
+		}
+		ukarch_spin_unlock(&victim->lock);
+
+		if (t)
+			return t;
+	}
+	return NULL;
+}
+#else
+#define schedcoop_kick(idx)		do { } while (0)
+#define schedcoop_steal(prv, self)	NULL
+#endif /* CONFIG_LIBUKSCHEDCOOP_SMP */
+
 static void schedcoop_schedule(struct uk_sched *s)
 {
 	struct schedcoop_private *prv = s->prv;
-	struct uk_thread *prev, *next, *thread, *tmp;
+	struct schedcoop_lcpu *rq;
+	struct uk_thread *prev, *next, *thread;
 	unsigned long flags;
 
 	if (ukplat_lcpu_irqs_disabled())
@@ -65,51 +192,71 @@ static void schedcoop_schedule(struct uk_sched *s)
 	prev = uk_thread_current();
 	flags = ukplat_lcpu_save_irqf();
 
+	rq = &prv->lcpu[schedcoop_lcpu_idx()];
+	UK_ASSERT(rq->current == prev);
+	schedcoop_switch_done(rq);
+
 #if 0 //TODO
 	if (in_callback)
 		UK_CRASH("Must not call %s from a callback\n", __func__);
 #endif
 
 	do {
-		/* Examine all threads.
-		 * Find a runnable thread, but also wake up expired ones and
+		/* Find a runnable thread, but also wake up expired ones and
 		 * find the time when the next timeout expires, else use
-		 * 10 seconds.
+		 * 10 seconds. Sleeping threads are ordered by their wakeup
+		 * time, so only the expired ones are looked at.
 		 */
 		__snsec now = ukplat_monotonic_clock();
 		__snsec min_wakeup_time = now + ukarch_time_sec_to_nsec(10);
 
-		/* wake some sleeping threads */
-		UK_TAILQ_FOREACH_SAFE(thread, &prv->sleeping_threads,
-				      thread_list, tmp) {
+		ukarch_spin_lock(&rq->lock);
 
-			if (thread->wakeup_time && thread->wakeup_time <= now)
-				uk_thread_wake(thread);
+		/* wake some sleeping threads */
+		while ((thread = uk_sleepq_first(&rq->sleeping_threads))) {
+			if (thread->wakeup_time > now) {
+				if (thread->wakeup_time < min_wakeup_time)
+					min_wakeup_time = thread->wakeup_time;
+				break;
+			}
+			/* Removes the thread from the sleep queue, which
+			 * takes the lock again
+			 */
+			ukarch_spin_unlock(&rq->lock);
+			uk_thread_wake(thread);
+			ukarch_spin_lock(&rq->lock);
+		}
 
-			else if (thread->wakeup_time < min_wakeup_time)
-				min_wakeup_time = thread->wakeup_time;
+		next = UK_TAILQ_FIRST(&rq->thread_list);
+		if (next) {
+			UK_TAILQ_REMOVE(&rq->thread_list, next, thread_list);
+			schedcoop_rq_dec(rq);
+		} else if (!is_runnable(prev)) {
+			next = schedcoop_steal(prv, schedcoop_lcpu_idx());
 		}
 
-		next = UK_TAILQ_FIRST(&prv->thread_list);
 		if (next) {
 			UK_ASSERT(next != prev);
 			UK_ASSERT(is_runnable(next));
 			UK_ASSERT(!is_exited(next));
-			UK_TAILQ_REMOVE(&prv->thread_list, next,
-					thread_list);
 			/* Put previous thread on the end of the list */
-			if (is_runnable(prev))
-				UK_TAILQ_INSERT_TAIL(&prv->thread_list, prev,
-						thread_list);
-			else
-				set_queueable(prev);
-			clear_queueable(next);
+			if (is_runnable(prev)) {
+				UK_TAILQ_INSERT_TAIL(&rq->thread_list, prev,
+						     thread_list);
+				schedcoop_rq_inc(rq);
+			}
+			next->running = 1;
+			rq->current = next;
+			rq->prev = prev;
+			ukarch_spin_unlock(&rq->lock);
 			ukplat_stack_set_current_thread(next);
 			break;
 		} else if (is_runnable(prev)) {
+			ukarch_spin_unlock(&rq->lock);
 			next = prev;
 			break;
 		}
+		ukarch_spin_unlock(&rq->lock);
 
 		/* block until the next timeout expires, or for 10 secs,
 		 * whichever comes first
@@ -125,30 +272,49 @@ static void schedcoop_schedule(struct uk_sched *s)
 	/* Interrupting the switch is equivalent to having the next thread
 	 * interrupted at the return instruction. And therefore at safe point.
 	 */
-	if (prev != next)
+	if (prev != next) {
 		uk_sched_thread_switch(s, prev, next);
 
-	UK_TAILQ_FOREACH_SAFE(thread, &s->exited_threads, thread_list, tmp) {
-		if (!thread->detached)
-			/* someone will eventually wait for it */
-			continue;
-
-		if (thread != prev)
-			uk_sched_thread_destroy(s, thread);
+		/* We might be resumed on another lcpu */
+		flags = ukplat_lcpu_save_irqf();
+		schedcoop_switch_done(&prv->lcpu[schedcoop_lcpu_idx()]);
+		ukplat_lcpu_restore_irqf(flags);
 	}
+
+	uk_sched_thread_reap(s);
 }
 
 static int schedcoop_thread_add(struct uk_sched *s, struct uk_thread *t,
-	const uk_thread_attr_t *attr __unused)
+	const uk_thread_attr_t *attr)
 {
 	unsigned long flags;
 	struct schedcoop_private *prv = s->prv;
+	struct schedcoop_lcpu *rq;
+
+#ifdef CONFIG_LIBUKSCHEDCOOP_SMP
+	if (attr && attr->lcpu != UK_THREAD_ATTR_LCPU_ANY) {
+		if (attr->lcpu >= (int) ukplat_lcpu_count())
+			return -EINVAL;
+		t->affinity = attr->lcpu;
+		t->lcpu = attr->lcpu;
+	} else {
+		t->lcpu = ukplat_lcpu_idx();
+	}
+#else
+	if (attr && attr->lcpu > 0)
+		return -EINVAL;
+	t->lcpu = 0;
+#endif /* CONFIG_LIBUKSCHEDCOOP_SMP */
 
 	set_runnable(t);
 
-	flags = ukplat_lcpu_save_irqf();
-	UK_TAILQ_INSERT_TAIL(&prv->thread_list, t, thread_list);
-	ukplat_lcpu_restore_irqf(flags);
+	rq = &prv->lcpu[t->lcpu];
+	ukplat_spin_lock_irqsave(&rq->lock, flags);
+	UK_TAILQ_INSERT_TAIL(&rq->thread_list, t, thread_list);
+	schedcoop_rq_inc(rq);
+	ukplat_spin_unlock_irqrestore(&rq->lock, flags);
+
+	schedcoop_kick(t->lcpu);
 
 	return 0;
 }
@@ -157,18 +323,29 @@ static void schedcoop_thread_remove(struct uk_sched *s, struct uk_thread *t)
 {
 	unsigned long flags;
 	struct schedcoop_private *prv = s->prv;
+	struct schedcoop_lcpu *rq;
 
 	flags = ukplat_lcpu_save_irqf();
 
-	/* Remove from the thread list */
-	if (t != uk_thread_current())
-		UK_TAILQ_REMOVE(&prv->thread_list, t, thread_list);
+	/* Remove from the run or sleep queue */
+	rq = schedcoop_lock_rq(prv, t);
+	if (is_runnable(t) && t != rq->current) {
+		UK_TAILQ_REMOVE(&rq->thread_list, t, thread_list);
+		schedcoop_rq_dec(rq);
+	} else if (!is_runnable(t) && t->wakeup_time > 0) {
+		uk_sleepq_remove(&rq->sleeping_threads, t);
+	}
 	clear_runnable(t);
+	ukarch_spin_unlock(&rq->lock);
 
-	uk_thread_exit(t);
-
-	/* Put onto exited list */
+	/* Put onto exited list before anybody waiting for the thread
+	 * learns that it exited
+	 */
+	ukarch_spin_lock(&s->exited_lock);
 	UK_TAILQ_INSERT_HEAD(&s->exited_threads, t, thread_list);
+	ukarch_spin_unlock(&s->exited_lock);
+
+	uk_thread_exit(t);
 
 	ukplat_lcpu_restore_irqf(flags);
 
@@ -182,35 +359,118 @@ static void schedcoop_thread_remove(struct uk_sched *s, struct uk_thread *t)
 static void schedcoop_thread_blocked(struct uk_sched *s, struct uk_thread *t)
 {
 	struct schedcoop_private *prv = s->prv;
+	struct schedcoop_lcpu *rq;
 
 	UK_ASSERT(ukplat_lcpu_irqs_disabled());
 
-	if (t != uk_thread_current())
-		UK_TAILQ_REMOVE(&prv->thread_list, t, thread_list);
+	rq = schedcoop_lock_rq(prv, t);
+	if (t != rq->current) {
+		UK_TAILQ_REMOVE(&rq->thread_list, t, thread_list);
+		schedcoop_rq_dec(rq);
+	}
 	if (t->wakeup_time > 0)
-		UK_TAILQ_INSERT_TAIL(&prv->sleeping_threads, t, thread_list);
+		uk_sleepq_add(&rq->sleeping_threads, t);
+	ukarch_spin_unlock(&rq->lock);
 }
 
 static void schedcoop_thread_woken(struct uk_sched *s, struct uk_thread *t)
 {
 	struct schedcoop_private *prv = s->prv;
+	struct schedcoop_lcpu *rq;
+	bool queued = false;
 
 	UK_ASSERT(ukplat_lcpu_irqs_disabled());
 
+	rq = schedcoop_lock_rq(prv, t);
 	if (t->wakeup_time > 0)
-		UK_TAILQ_REMOVE(&prv->sleeping_threads, t, thread_list);
-	if (t != uk_thread_current() || is_queueable(t)) {
-		UK_TAILQ_INSERT_TAIL(&prv->thread_list, t, thread_list);
-		clear_queueable(t);
+		uk_sleepq_remove(&rq->sleeping_threads, t);
+	/* A thread that blocked but did not switch away yet just continues */
+	if (t != rq->current) {
+		UK_TAILQ_INSERT_TAIL(&rq->thread_list, t, thread_list);
+		schedcoop_rq_inc(rq);
+		queued = true;
+	}
+	ukarch_spin_unlock(&rq->lock);
+
+	if (queued)
+		schedcoop_kick(t->lcpu);
+}
+
+#ifdef CONFIG_LIBUKSCHEDCOOP_SMP
+static void __noreturn schedcoop_lcpu_entry(void)
+{
+	struct schedcoop_private *prv = schedcoop->prv;
+	struct uk_thread *idle = prv->lcpu[ukplat_lcpu_idx()].idle;
+
+	UK_ASSERT(idle);
+	ukplat_thread_ctx_start(&schedcoop->plat_ctx_cbs, idle->ctx);
+}
+
+/* Starts the secondary lcpus, each in its own idle thread */
+static void schedcoop_lcpu_start(struct uk_sched *s)
+{
+	struct schedcoop_private *prv = s->prv;
+	void *sp[SCHEDCOOP_LCPU_MAX];
+	ukplat_lcpu_entry_t entry[SCHEDCOOP_LCPU_MAX];
+	__lcpuidx idx[SCHEDCOOP_LCPU_MAX];
+	unsigned int num = 0;
+	__u32 i;
+	int rc;
+
+	for (i = 1; i < ukplat_lcpu_count(); i++) {
+		if (!prv->lcpu[i].idle)
+			continue;
+		idx[num] = i;
+		sp[num] = (__u8 *) prv->lcpu[i].boot_stack + STACK_SIZE;
+		entry[num] = schedcoop_lcpu_entry;
+		num++;
 	}
+	if (!num)
+		return;
+
+	rc = ukplat_lcpu_start(idx, &num, sp, entry, 0);
+	if (unlikely(rc))
+		uk_pr_err("Failed to start secondary lcpus (%d), %u running\n",
+			  rc, num);
 }
 
+static void schedcoop_lcpu_init(struct uk_sched *s, void (*idle_fn)(void *))
+{
+	struct schedcoop_private *prv = s->prv;
+	__u32 i;
+
+	schedcoop = s;
+	for (i = 1; i < ukplat_lcpu_count(); i++) {
+		if (uk_posix_memalign(s->allocator, &prv->lcpu[i].boot_stack,
+				      STACK_SIZE, STACK_SIZE) != 0)
+			break;
+		prv->lcpu[i].idle = uk_sched_idle_create(s, i, idle_fn);
+		if (!prv->lcpu[i].idle) {
+			uk_free(s->allocator, prv->lcpu[i].boot_stack);
+			break;
+		}
+	}
+	if (i < ukplat_lcpu_count())
+		uk_pr_warn("Scheduling on %"__PRIu32" of %"__PRIu32" lcpus\n",
+			   i, ukplat_lcpu_count());
+}
+#endif /* CONFIG_LIBUKSCHEDCOOP_SMP */
+
 static void idle_thread_fn(void *unused __unused)
 {
 	struct uk_thread *current = uk_thread_current();
 	struct uk_sched *s = current->sched;
+	struct schedcoop_private *prv = s->prv;
+
+	current->running = 1;
+	prv->lcpu[schedcoop_lcpu_idx()].current = current;
 
-	s->threads_started = true;
+	if (!s->threads_started) {
+		s->threads_started = true;
+#ifdef CONFIG_LIBUKSCHEDCOOP_SMP
+		schedcoop_lcpu_start(s);
+#endif /* CONFIG_LIBUKSCHEDCOOP_SMP */
+	}
 	ukplat_lcpu_enable_irq();
 
 	while (1) {
@@ -228,6 +488,7 @@ struct uk_sched *uk_schedcoop_init(struct uk_alloc *a)
 {
 	struct schedcoop_private *prv = NULL;
 	struct uk_sched *sched = NULL;
+	unsigned int i;
 
 	uk_pr_info("Initializing cooperative scheduler\n");
 
@@ -238,10 +499,17 @@ struct uk_sched *uk_schedcoop_init(struct uk_alloc *a)
 	ukplat_ctx_callbacks_init(&sched->plat_ctx_cbs, ukplat_ctx_sw);
 
 	prv = sched->prv;
-	UK_TAILQ_INIT(&prv->thread_list);
-	UK_TAILQ_INIT(&prv->sleeping_threads);
+	memset(prv, 0, sizeof(*prv));
+	for (i = 0; i < SCHEDCOOP_LCPU_MAX; i++) {
+		ukarch_spin_init(&prv->lcpu[i].lock);
+		UK_TAILQ_INIT(&prv->lcpu[i].thread_list);
+		uk_sleepq_init(&prv->lcpu[i].sleeping_threads);
+	}
 
 	uk_sched_idle_init(sched, NULL, idle_thread_fn);
+#ifdef CONFIG_LIBUKSCHEDCOOP_SMP
+	schedcoop_lcpu_init(sched, idle_thread_fn);
+#endif /* CONFIG_LIBUKSCHEDCOOP_SMP */
 
 	uk_sched_init(sched,
 			schedcoop_yield,
@@ -0,0 +1,167 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <uk/test.h>
+#include <uk/config.h>
+#include <uk/essentials.h>
+#include <uk/plat/time.h>
+#include <uk/sched.h>
+#include <uk/sleepq.h>
+#include <uk/thread.h>
+
+#define SLEEPERS_ORDER		5
+
+static struct uk_thread order_threads[SLEEPERS_ORDER];
+
+UK_TESTCASE(ukschedcoop_sleepq, heap_order)
+{
+	static const __snsec times[SLEEPERS_ORDER] = { 30, 10, 50, 20, 40 };
+	struct uk_sleepq q;
+	struct uk_thread *t;
+	__snsec last = 0;
+	int i;
+
+	uk_sleepq_init(&q);
+	for (i = 0; i < SLEEPERS_ORDER; i++) {
+		order_threads[i].wakeup_time = times[i];
+		uk_sleepq_add(&q, &order_threads[i]);
+	}
+
+	/* Remove one from the middle, the others come out in order */
+	uk_sleepq_remove(&q, &order_threads[3]);
+	for (i = 0; i < SLEEPERS_ORDER - 1; i++) {
+		t = uk_sleepq_first(&q);
+		UK_TEST_EXPECT_NOT_NULL(t);
+		if (!t)
+			return;
+		UK_TEST_EXPECT_SNUM_GT(t->wakeup_time, last);
+		last = t->wakeup_time;
+		uk_sleepq_remove(&q, t);
+	}
+	UK_TEST_EXPECT(uk_sleepq_empty(&q));
+}
+
+static int wake_order[3];
+static int wake_count;
+
+static void sleeper_fn(void *arg)
+{
+	int ms = (int)(__uptr)arg;
+
+	uk_sched_thread_sleep(ukarch_time_msec_to_nsec(ms));
+	wake_order[wake_count++] = ms;
+}
+
+UK_TESTCASE(ukschedcoop_sleepq, wake_order)
+{
+	static const int ms[] = { 30, 10, 20 };
+	struct uk_thread *threads[ARRAY_SIZE(ms)];
+	unsigned int i;
+
+	wake_count = 0;
+	for (i = 0; i < ARRAY_SIZE(ms); i++) {
+		threads[i] = uk_thread_create("sleeper", sleeper_fn,
+					      (void *)(__uptr)ms[i]);
+		UK_TEST_EXPECT_NOT_NULL(threads[i]);
+		if (!threads[i])
+			return;
+	}
+	for (i = 0; i < ARRAY_SIZE(ms); i++)
+		uk_thread_wait(threads[i]);
+
+	UK_TEST_EXPECT_SNUM_EQ(wake_count, 3);
+	UK_TEST_EXPECT_SNUM_EQ(wake_order[0], 10);
+	UK_TEST_EXPECT_SNUM_EQ(wake_order[1], 20);
+	UK_TEST_EXPECT_SNUM_EQ(wake_order[2], 30);
+}
+
+#if CONFIG_LIBUKSCHEDCOOP_TEST_BENCH
+#define BENCH_YIELDS		10000
+#define BENCH_MAX_SLEEPERS	4096
+
+static const unsigned int bench_sleepers[] = { 0, 16, 64, 256, 1024, 4096 };
+static struct uk_thread *bench_threads[BENCH_MAX_SLEEPERS];
+static volatile int bench_stop;
+
+static void bench_sleeper_fn(void *arg __unused)
+{
+	while (!bench_stop)
+		uk_sched_thread_sleep(ukarch_time_sec_to_nsec(3600));
+}
+
+/* Returns the average cost of a uk_sched_yield() in nanoseconds */
+static __nsec bench_yield(void)
+{
+	__nsec start;
+	int i;
+
+	start = ukplat_monotonic_clock();
+	for (i = 0; i < BENCH_YIELDS; i++)
+		uk_sched_yield();
+	return (ukplat_monotonic_clock() - start) / BENCH_YIELDS;
+}
+
+UK_TESTCASE(ukschedcoop_sleepq, schedule_latency)
+{
+	unsigned int i, n = 0, want;
+	__nsec ns;
+
+	bench_stop = 0;
+	for (i = 0; i < ARRAY_SIZE(bench_sleepers); i++) {
+		want = bench_sleepers[i];
+		for (; n < want; n++) {
+			bench_threads[n] = uk_thread_create("bench-sleeper",
+							    bench_sleeper_fn,
+							    NULL);
+			if (!bench_threads[n])
+				break;
+		}
+		if (n < want) {
+			uk_test_printf("out of memory after %u sleepers\n", n);
+			break;
+		}
+		/* Let the new threads go to sleep */
+		uk_sched_yield();
+
+		ns = bench_yield();
+		uk_test_printf("%5u sleepers: %6lu ns per schedule\n",
+			       n, (unsigned long)ns);
+	}
+
+	bench_stop = 1;
+	for (i = 0; i < n; i++)
+		uk_thread_wake(bench_threads[i]);
+	for (i = 0; i < n; i++)
+		uk_thread_wait(bench_threads[i]);
+	UK_TEST_EXPECT(1);
+}
+#endif /* CONFIG_LIBUKSCHEDCOOP_TEST_BENCH */
+
+uk_testsuite_register(ukschedcoop_sleepq, NULL);
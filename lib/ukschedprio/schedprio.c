@@ -0,0 +1,493 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Preemptive priority scheduler.
+ *
+ * Runnable threads are kept in one FIFO per priority. A bitmap of the
+ * non-empty queues lets the scheduler find the highest priority with a
+ * handful of bit scans, independent of the number of threads. Threads of
+ * equal priority are served round-robin, each for at most its time slice.
+ *
+ * Threads are only switched at safe points (see uk/preempt.h), never from
+ * an interrupt. uk_preempt_deadline is the end of the running thread's
+ * slice or the next wake-up of a sleeping thread, whichever comes first,
+ * and the platform's one-shot timer is armed for it. The timer interrupt
+ * raises uk_preempt_pending once it is reached, as does waking a thread
+ * with a higher priority. The running thread then gives way at its next
+ * safe point.
+ */
+#include <string.h>
+#include <uk/plat/lcpu.h>
+#include <uk/plat/memory.h>
+#include <uk/plat/time.h>
+#include <uk/arch/atomic.h>
+#include <uk/bitops.h>
+#include <uk/preempt.h>
+#include <uk/sched.h>
+#include <uk/sleepq.h>
+#include <uk/schedprio.h>
+
+#define SCHEDPRIO_NR_PRIO	(UK_THREAD_ATTR_PRIO_MAX + 1)
+#define SCHEDPRIO_TIMESLICE	\
+	ukarch_time_msec_to_nsec(CONFIG_LIBUKSCHEDPRIO_TIMESLICE)
+
+/* Per-thread scheduling parameters, referenced by uk_thread->prv */
+struct schedprio_thread {
+	prio_t prio;
+	__nsec timeslice;
+};
+
+struct schedprio_private {
+	unsigned long ready[UK_BITS_TO_LONGS(SCHEDPRIO_NR_PRIO)];
+	struct uk_thread_list runq[SCHEDPRIO_NR_PRIO];
+	struct uk_sleepq sleeping_threads;
+};
+
+unsigned int uk_preempt_count;
+volatile int uk_preempt_pending;
+__snsec uk_preempt_deadline = __SNSEC_MAX;
+
+/* End of the running thread's time slice */
+static __snsec schedprio_slice_end = __SNSEC_MAX;
+
+static struct uk_sched *schedprio;
+
+/* There is no current thread before the scheduler is started */
+static inline struct uk_thread *schedprio_current(struct uk_sched *s)
+{
+	return uk_sched_started(s) ? uk_thread_current() : NULL;
+}
+
+/* The idle thread and exiting threads have no parameters */
+static inline prio_t schedprio_prio(const struct uk_thread *t)
+{
+	const struct schedprio_thread *tp = t ? t->prv : NULL;
+
+	return tp ? tp->prio : UK_THREAD_ATTR_PRIO_INVALID;
+}
+
+static inline __nsec schedprio_timeslice(const struct uk_thread *t)
+{
+	const struct schedprio_thread *tp = t->prv;
+
+	return tp ? tp->timeslice : SCHEDPRIO_TIMESLICE;
+}
+
+static void schedprio_enqueue(struct schedprio_private *prv,
+			      struct uk_thread *t)
+{
+	prio_t prio = schedprio_prio(t);
+
+	UK_ASSERT(prio >= UK_THREAD_ATTR_PRIO_MIN);
+	UK_TAILQ_INSERT_TAIL(&prv->runq[prio], t, thread_list);
+	prv->ready[UK_BIT_WORD(prio)] |= UK_BIT_MASK(prio);
+}
+
+static void schedprio_dequeue(struct schedprio_private *prv,
+			      struct uk_thread *t)
+{
+	prio_t prio = schedprio_prio(t);
+
+	UK_TAILQ_REMOVE(&prv->runq[prio], t, thread_list);
+	if (UK_TAILQ_EMPTY(&prv->runq[prio]))
+		prv->ready[UK_BIT_WORD(prio)] &= ~UK_BIT_MASK(prio);
+}
+
+/* First thread of the highest non-empty run queue */
+static struct uk_thread *schedprio_peek(struct schedprio_private *prv)
+{
+	int i;
+
+	for (i = ARRAY_SIZE(prv->ready) - 1; i >= 0; i--) {
+		if (prv->ready[i])
+			return UK_TAILQ_FIRST(&prv->runq[i * UK_BITS_PER_LONG
+					      + ukarch_flsl(prv->ready[i])]);
+	}
+	return NULL;
+}
+
+/* A runnable thread sits in a run queue unless it is the one running */
+static inline bool schedprio_queued(struct uk_sched *s,
+				    const struct uk_thread *t)
+{
+	return t->prv && is_runnable(t) && t != schedprio_current(s);
+}
+
+/* Wakes the sleeping threads whose wake-up time has come */
+static void schedprio_wake_expired(struct schedprio_private *prv, __snsec now)
+{
+	struct uk_thread *thread;
+
+	/* They are ordered by wakeup time */
+	while ((thread = uk_sleepq_first(&prv->sleeping_threads))) {
+		if (thread->wakeup_time > now)
+			break;
+		/* Removes the thread from the sleep queue */
+		uk_thread_wake(thread);
+	}
+}
+
+/* Arms the timer for the end of the slice or the next wake-up */
+static void schedprio_set_alarm(struct schedprio_private *prv)
+{
+	struct uk_thread *first = uk_sleepq_first(&prv->sleeping_threads);
+	__snsec alarm = schedprio_slice_end;
+
+	if (first && first->wakeup_time < alarm)
+		alarm = first->wakeup_time;
+	uk_preempt_deadline = alarm;
+	ukplat_time_set_alarm(alarm);
+}
+
+/* Preempts the running thread at its next safe point */
+static inline void schedprio_preempt(void)
+{
+	uk_preempt_pending = 1;
+}
+
+/*
+ * Picks the thread that runs after prev and dequeues it. Returns NULL if
+ * no thread is runnable. Starts a new slice unless prev keeps running
+ * within its slice.
+ */
+static struct uk_thread *schedprio_pick(struct schedprio_private *prv,
+					struct uk_thread *prev, __snsec now)
+{
+	struct uk_thread *next;
+
+	UK_ASSERT(ukplat_lcpu_irqs_disabled());
+
+	schedprio_wake_expired(prv, now);
+
+	/* A running thread only gives way to threads of at least
+	 * its own priority
+	 */
+	next = schedprio_peek(prv);
+	if (next && (!is_runnable(prev) ||
+		     schedprio_prio(next) >= schedprio_prio(prev))) {
+		UK_ASSERT(next != prev);
+		UK_ASSERT(!is_exited(next));
+		schedprio_dequeue(prv, next);
+		if (is_runnable(prev))
+			schedprio_enqueue(prv, prev);
+		else
+			set_queueable(prev);
+		clear_queueable(next);
+		ukplat_stack_set_current_thread(next);
+	} else if (is_runnable(prev)) {
+		next = prev;
+	} else {
+		return NULL;
+	}
+
+	if (next != prev || now >= schedprio_slice_end)
+		schedprio_slice_end = now + schedprio_timeslice(next);
+	uk_preempt_pending = 0;
+	schedprio_set_alarm(prv);
+	return next;
+}
+
+static void schedprio_schedule(struct uk_sched *s)
+{
+	struct schedprio_private *prv = s->prv;
+	struct uk_thread *prev, *next, *thread;
+	unsigned long flags;
+
+	if (ukplat_lcpu_irqs_disabled())
+		UK_CRASH("Must not call %s with IRQs disabled\n", __func__);
+
+	prev = uk_thread_current();
+	flags = ukplat_lcpu_save_irqf();
+
+	do {
+		__snsec now, min_wakeup_time;
+
+		now = ukplat_monotonic_clock();
+		next = schedprio_pick(prv, prev, now);
+		if (next)
+			break;
+
+		min_wakeup_time = now + ukarch_time_sec_to_nsec(10);
+		thread = uk_sleepq_first(&prv->sleeping_threads);
+		if (thread && thread->wakeup_time < min_wakeup_time)
+			min_wakeup_time = thread->wakeup_time;
+
+		/* block until the next timeout expires, or for 10 secs,
+		 * whichever comes first
+		 */
+		ukplat_lcpu_halt_to(min_wakeup_time);
+		/* handle pending events if any */
+		ukplat_lcpu_irqs_handle_pending();
+
+	} while (1);
+
+	ukplat_lcpu_restore_irqf(flags);
+
+	if (prev != next)
+		uk_sched_thread_switch(s, prev, next);
+
+	uk_sched_thread_reap(s);
+}
+
+void uk_preempt_schedule(void)
+{
+	struct uk_thread *current;
+
+	/* Interrupt handlers and sections with IRQs disabled are not safe
+	 * points, the preemption stays pending
+	 */
+	if (!schedprio || !uk_sched_started(schedprio) ||
+	    ukplat_lcpu_irqs_disabled())
+		return;
+
+	/* A thread that is blocking or exiting is about to schedule anyway */
+	current = uk_thread_current();
+	if (current->sched != schedprio || !is_runnable(current))
+		return;
+
+	schedprio_schedule(schedprio);
+}
+
+static int schedprio_thread_add(struct uk_sched *s, struct uk_thread *t,
+	const uk_thread_attr_t *attr)
+{
+	struct schedprio_private *prv = s->prv;
+	struct schedprio_thread *tp;
+	unsigned long flags;
+
+	tp = uk_malloc(s->allocator, sizeof(*tp));
+	if (!tp)
+		return -ENOMEM;
+
+	tp->prio = UK_THREAD_ATTR_PRIO_DEFAULT;
+	tp->timeslice = SCHEDPRIO_TIMESLICE;
+	if (attr) {
+		if (attr->prio != UK_THREAD_ATTR_PRIO_INVALID)
+			tp->prio = attr->prio;
+		if (attr->timeslice != UK_THREAD_ATTR_TIMESLICE_NIL)
+			tp->timeslice = attr->timeslice;
+	}
+	t->prv = tp;
+
+	set_runnable(t);
+
+	flags = ukplat_lcpu_save_irqf();
+	schedprio_enqueue(prv, t);
+	if (tp->prio > schedprio_prio(schedprio_current(s)))
+		schedprio_preempt();
+	ukplat_lcpu_restore_irqf(flags);
+
+	return 0;
+}
+
+static void schedprio_thread_remove(struct uk_sched *s, struct uk_thread *t)
+{
+	struct schedprio_private *prv = s->prv;
+	unsigned long flags;
+	void *tp;
+
+	flags = ukplat_lcpu_save_irqf();
+
+	/* Remove from the run or sleep queue */
+	if (schedprio_queued(s, t))
+		schedprio_dequeue(prv, t);
+	else if (!is_runnable(t) && t->wakeup_time > 0)
+		uk_sleepq_remove(&prv->sleeping_threads, t);
+	clear_runnable(t);
+
+	/* Put onto exited list before anybody waiting for the thread
+	 * learns that it exited
+	 */
+	UK_TAILQ_INSERT_HEAD(&s->exited_threads, t, thread_list);
+
+	uk_thread_exit(t);
+
+	tp = t->prv;
+	t->prv = NULL;
+
+	ukplat_lcpu_restore_irqf(flags);
+
+	/* Not runnable anymore, so freeing is no safe point */
+	uk_free(s->allocator, tp);
+
+	/* Schedule only if current thread is exiting */
+	if (t == schedprio_current(s)) {
+		schedprio_schedule(s);
+		uk_pr_warn("schedule() returned! Trying again\n");
+	}
+}
+
+static void schedprio_thread_blocked(struct uk_sched *s, struct uk_thread *t)
+{
+	struct schedprio_private *prv = s->prv;
+
+	UK_ASSERT(ukplat_lcpu_irqs_disabled());
+
+	if (t != schedprio_current(s))
+		schedprio_dequeue(prv, t);
+	if (t->wakeup_time > 0)
+		uk_sleepq_add(&prv->sleeping_threads, t);
+}
+
+static void schedprio_thread_woken(struct uk_sched *s, struct uk_thread *t)
+{
+	struct schedprio_private *prv = s->prv;
+	struct uk_thread *current = schedprio_current(s);
+
+	UK_ASSERT(ukplat_lcpu_irqs_disabled());
+
+	if (t->wakeup_time > 0)
+		uk_sleepq_remove(&prv->sleeping_threads, t);
+	if (t != current || is_queueable(t)) {
+		schedprio_enqueue(prv, t);
+		clear_queueable(t);
+		if (schedprio_prio(t) > schedprio_prio(current))
+			schedprio_preempt();
+	}
+}
+
+static int schedprio_thread_set_prio(struct uk_sched *s, struct uk_thread *t,
+	prio_t prio)
+{
+	struct schedprio_private *prv = s->prv;
+	struct schedprio_thread *tp = t->prv;
+	struct uk_thread *current = schedprio_current(s);
+	struct uk_thread *first;
+	unsigned long flags;
+
+	if (!tp || prio < UK_THREAD_ATTR_PRIO_MIN ||
+	    prio > UK_THREAD_ATTR_PRIO_MAX)
+		return -EINVAL;
+
+	flags = ukplat_lcpu_save_irqf();
+	if (schedprio_queued(s, t)) {
+		schedprio_dequeue(prv, t);
+		tp->prio = prio;
+		schedprio_enqueue(prv, t);
+	} else {
+		tp->prio = prio;
+	}
+
+	first = schedprio_peek(prv);
+	if (first && schedprio_prio(first) > schedprio_prio(current))
+		schedprio_preempt();
+	ukplat_lcpu_restore_irqf(flags);
+
+	return 0;
+}
+
+static int schedprio_thread_get_prio(struct uk_sched *s __unused,
+	const struct uk_thread *t, prio_t *prio)
+{
+	if (!t->prv)
+		return -EINVAL;
+
+	*prio = schedprio_prio(t);
+	return 0;
+}
+
+static int schedprio_thread_set_tslice(struct uk_sched *s __unused,
+	struct uk_thread *t, int tslice)
+{
+	struct schedprio_thread *tp = t->prv;
+
+	if (!tp || tslice < (int) UKPLAT_TIME_TICK_NSEC)
+		return -EINVAL;
+
+	tp->timeslice = tslice;
+	return 0;
+}
+
+static int schedprio_thread_get_tslice(struct uk_sched *s __unused,
+	const struct uk_thread *t, int *tslice)
+{
+	if (!t->prv)
+		return -EINVAL;
+
+	*tslice = (int) schedprio_timeslice(t);
+	return 0;
+}
+
+static void idle_thread_fn(void *unused __unused)
+{
+	struct uk_thread *current = uk_thread_current();
+	struct uk_sched *s = current->sched;
+
+	s->threads_started = true;
+	ukplat_lcpu_enable_irq();
+
+	while (1) {
+		uk_thread_block(current);
+		schedprio_schedule(s);
+	}
+}
+
+static void schedprio_yield(struct uk_sched *s)
+{
+	schedprio_schedule(s);
+}
+
+struct uk_sched *uk_schedprio_init(struct uk_alloc *a)
+{
+	struct schedprio_private *prv = NULL;
+	struct uk_sched *sched = NULL;
+	int i;
+
+	uk_pr_info("Initializing priority scheduler\n");
+
+	sched = uk_sched_create(a, sizeof(struct schedprio_private));
+	if (sched == NULL)
+		return NULL;
+
+	ukplat_ctx_callbacks_init(&sched->plat_ctx_cbs, ukplat_ctx_sw);
+
+	prv = sched->prv;
+	memset(prv->ready, 0, sizeof(prv->ready));
+	for (i = 0; i < SCHEDPRIO_NR_PRIO; i++)
+		UK_TAILQ_INIT(&prv->runq[i]);
+	uk_sleepq_init(&prv->sleeping_threads);
+
+	uk_sched_idle_init(sched, NULL, idle_thread_fn);
+
+	uk_sched_init(sched,
+			schedprio_yield,
+			schedprio_thread_add,
+			schedprio_thread_remove,
+			schedprio_thread_blocked,
+			schedprio_thread_woken,
+			schedprio_thread_set_prio,
+			schedprio_thread_get_prio,
+			schedprio_thread_set_tslice,
+			schedprio_thread_get_tslice);
+
+	schedprio = sched;
+	return sched;
+}
@@ -0,0 +1,210 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <uk/test.h>
+#include <uk/config.h>
+#include <uk/essentials.h>
+#include <uk/plat/time.h>
+#include <uk/preempt.h>
+#include <uk/sched.h>
+#include <uk/thread.h>
+
+#define PRIO_THREADS		3
+
+static int run_order[PRIO_THREADS];
+static volatile int run_count;
+
+/* Passes a safe point without giving up the CPU */
+static void work(void)
+{
+	uk_preempt_disable();
+	uk_preempt_enable();
+}
+
+/* Works until *flag is set, for at most 1s */
+static void spin_until(volatile int *flag)
+{
+	__nsec end = ukplat_monotonic_clock() + ukarch_time_sec_to_nsec(1);
+
+	while (!*flag && ukplat_monotonic_clock() < end)
+		work();
+}
+
+static void prio_thread_fn(void *arg)
+{
+	run_order[run_count++] = (int)(long) arg;
+}
+
+static struct uk_thread *create_prio(const char *name, prio_t prio,
+				     void (*fn)(void *), void *arg)
+{
+	uk_thread_attr_t attr;
+
+	uk_thread_attr_init(&attr);
+	uk_thread_attr_set_prio(&attr, prio);
+	return uk_thread_create_attr(name, &attr, fn, arg);
+}
+
+UK_TESTCASE(ukschedprio, run_order)
+{
+	static const prio_t prios[PRIO_THREADS] = {
+		UK_THREAD_ATTR_PRIO_DEFAULT - 10,
+		UK_THREAD_ATTR_PRIO_DEFAULT + 20,
+		UK_THREAD_ATTR_PRIO_DEFAULT + 10,
+	};
+	struct uk_thread *t[PRIO_THREADS];
+	int i;
+
+	run_count = 0;
+	for (i = 0; i < PRIO_THREADS; i++) {
+		t[i] = create_prio("prio", prios[i], prio_thread_fn,
+				   (void *)(long) prios[i]);
+		UK_TEST_EXPECT_NOT_NULL(t[i]);
+	}
+
+	/* Threads of higher priority than ours preempt us at the next safe
+	 * point, the lower one only runs once we sleep
+	 */
+	work();
+	UK_TEST_EXPECT_SNUM_EQ(run_count, 2);
+	uk_sched_thread_sleep(ukarch_time_msec_to_nsec(1));
+	UK_TEST_EXPECT_SNUM_EQ(run_count, 3);
+
+	UK_TEST_EXPECT_SNUM_EQ(run_order[0], prios[1]);
+	UK_TEST_EXPECT_SNUM_EQ(run_order[1], prios[2]);
+	UK_TEST_EXPECT_SNUM_EQ(run_order[2], prios[0]);
+
+	for (i = 0; i < PRIO_THREADS; i++)
+		uk_thread_wait(t[i]);
+}
+
+UK_TESTCASE(ukschedprio, set_prio)
+{
+	struct uk_thread *self = uk_thread_current();
+	prio_t prio;
+	int tslice;
+
+	UK_TEST_EXPECT_ZERO(uk_thread_get_prio(self, &prio));
+	UK_TEST_EXPECT_SNUM_EQ(prio, UK_THREAD_ATTR_PRIO_DEFAULT);
+	UK_TEST_EXPECT_SNUM_EQ(uk_thread_set_prio(self,
+					UK_THREAD_ATTR_PRIO_MAX + 1), -EINVAL);
+
+	UK_TEST_EXPECT_ZERO(uk_thread_set_prio(self,
+					UK_THREAD_ATTR_PRIO_DEFAULT + 1));
+	UK_TEST_EXPECT_ZERO(uk_thread_get_prio(self, &prio));
+	UK_TEST_EXPECT_SNUM_EQ(prio, UK_THREAD_ATTR_PRIO_DEFAULT + 1);
+	UK_TEST_EXPECT_ZERO(uk_thread_set_prio(self,
+					UK_THREAD_ATTR_PRIO_DEFAULT));
+
+	UK_TEST_EXPECT_ZERO(uk_thread_get_timeslice(self, &tslice));
+	UK_TEST_EXPECT_SNUM_EQ(tslice, ukarch_time_msec_to_nsec(
+				       CONFIG_LIBUKSCHEDPRIO_TIMESLICE));
+	UK_TEST_EXPECT_SNUM_EQ(uk_thread_set_timeslice(self, 0), -EINVAL);
+}
+
+static volatile int spin_flag;
+static volatile int spin_stop;
+
+static void spin_fn(void *arg __unused)
+{
+	spin_flag = 1;
+	while (!spin_stop)
+		work();
+}
+
+/* Two threads of equal priority that never yield take turns */
+UK_TESTCASE(ukschedprio, timeslice)
+{
+	struct uk_thread *t;
+
+	spin_flag = 0;
+	spin_stop = 0;
+	t = create_prio("spin", UK_THREAD_ATTR_PRIO_DEFAULT, spin_fn, NULL);
+	UK_TEST_EXPECT_NOT_NULL(t);
+
+	spin_until(&spin_flag);
+	UK_TEST_EXPECT_SNUM_EQ(spin_flag, 1);
+
+	/* The spinning thread only stops if we get the CPU back */
+	spin_stop = 1;
+	uk_thread_wait(t);
+}
+
+static volatile int wake_flag;
+
+static void wake_fn(void *arg __unused)
+{
+	uk_sched_thread_sleep(ukarch_time_msec_to_nsec(5));
+	wake_flag = 1;
+}
+
+/* A sleeping thread of higher priority preempts a working thread */
+UK_TESTCASE(ukschedprio, wakeup)
+{
+	struct uk_thread *t;
+
+	wake_flag = 0;
+	t = create_prio("wake", UK_THREAD_ATTR_PRIO_DEFAULT + 1, wake_fn,
+			NULL);
+	UK_TEST_EXPECT_NOT_NULL(t);
+
+	spin_until(&wake_flag);
+	UK_TEST_EXPECT_SNUM_EQ(wake_flag, 1);
+
+	uk_thread_wait(t);
+}
+
+/* A due preemption waits until preemption is enabled again */
+UK_TESTCASE(ukschedprio, disabled)
+{
+	struct uk_thread *t;
+	__nsec end;
+
+	wake_flag = 0;
+	t = create_prio("wake", UK_THREAD_ATTR_PRIO_DEFAULT + 1, wake_fn,
+			NULL);
+	UK_TEST_EXPECT_NOT_NULL(t);
+
+	/* Let it run until it sleeps */
+	work();
+	UK_TEST_EXPECT_SNUM_EQ(wake_flag, 0);
+
+	uk_preempt_disable();
+	end = ukplat_monotonic_clock() + ukarch_time_msec_to_nsec(20);
+	while (ukplat_monotonic_clock() < end)
+		;
+	UK_TEST_EXPECT_SNUM_EQ(wake_flag, 0);
+	uk_preempt_enable();
+	UK_TEST_EXPECT_SNUM_EQ(wake_flag, 1);
+
+	uk_thread_wait(t);
+}
+
+uk_testsuite_register(ukschedprio, NULL);
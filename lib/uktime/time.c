@@ -156,12 +156,25 @@ UK_SYSCALL_R_DEFINE(int, clock_gettime, clockid_t, clk_id, struct timespec*, tp)
 		goto out_error;
 	}
 
+	/* Both clocks are lock-free reads that do not leave the guest on
+	 * platforms with a paravirtual clock (e.g., kvmclock), so there is
+	 * nothing to gain from caching or coarser variants.
+	 */
 	switch (clk_id) {
 	case CLOCK_MONOTONIC:
 	case CLOCK_MONOTONIC_COARSE:
+#ifdef CLOCK_MONOTONIC_RAW
+	case CLOCK_MONOTONIC_RAW:
+#endif
+#ifdef CLOCK_BOOTTIME
+	case CLOCK_BOOTTIME:
+#endif
 		now = ukplat_monotonic_clock();
 		break;
 	case CLOCK_REALTIME:
+#ifdef CLOCK_REALTIME_COARSE
+	case CLOCK_REALTIME_COARSE:
+#endif
 		now = ukplat_wall_clock();
 		break;
 	default:
@@ -0,0 +1,243 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Allocator for the virtual region that holds programs loaded by ushell.
+ *
+ * The region [CONFIG_LIBUSHELL_CODE_BASE, +CONFIG_LIBUSHELL_CODE_SIZE) is
+ * managed with a sorted array of free ranges. Allocations are served
+ * first-fit so that loaded objects stay packed at the bottom of the region
+ * and keep reusing the same page tables; freed ranges are coalesced with
+ * their neighbours. Memory is handed out read-write and is switched to its
+ * final protection with ushell_protect_memory() once it has been filled,
+ * so that no page is ever writable and executable at the same time.
+ */
+
+#include <uk/plat/paging.h>
+#include <uk/assert.h>
+#include <uk/print.h>
+#include <uk/essentials.h>
+#include <uk/config.h>
+#include <string.h>
+
+#ifdef CONFIG_LIBUSHELL_MPK
+#include <uk/pku.h>
+#endif
+
+#include <ushell/ushell.h>
+#include "ushell_api.h"
+
+#define USHELL_CODE_BASE	((__vaddr_t)CONFIG_LIBUSHELL_CODE_BASE)
+#define USHELL_CODE_END		(USHELL_CODE_BASE + CONFIG_LIBUSHELL_CODE_SIZE)
+
+#define size_to_num_pages(size) \
+	(ALIGN_UP((unsigned long)(size), PAGE_SIZE) / PAGE_SIZE)
+
+/* There are never more free ranges than live allocations plus one, which
+ * stays far below this for USHELL_PROG_MAX_NUM programs. Should the index
+ * still overflow, the freed range is leaked (with a warning).
+ */
+#define USHELL_CODE_MAX_FREE	256
+
+struct ushell_code_range {
+	__vaddr_t start;
+	__vaddr_t end;
+};
+
+static struct ushell_code_range free_ranges[USHELL_CODE_MAX_FREE] = {
+	{ .start = USHELL_CODE_BASE, .end = USHELL_CODE_END },
+};
+static unsigned int free_ranges_cnt = 1;
+
+#ifdef CONFIG_LIBUSHELL_MPK
+extern unsigned long pbkey;
+
+#define PKEY_MASK (~(PAGE_PROT_PKEY0 | PAGE_PROT_PKEY1 | PAGE_PROT_PKEY2 | \
+		     PAGE_PROT_PKEY3))
+
+static unsigned long ushell_code_attr(unsigned long prot)
+{
+	return (prot & PKEY_MASK) | pbkey;
+}
+#else /* CONFIG_LIBUSHELL_MPK */
+#define ushell_code_attr(prot) (prot)
+#endif /* CONFIG_LIBUSHELL_MPK */
+
+/* Index of the first free range that ends after vaddr */
+static unsigned int ushell_code_lookup(__vaddr_t vaddr)
+{
+	unsigned int lo = 0, hi = free_ranges_cnt;
+
+	while (lo < hi) {
+		unsigned int mid = (lo + hi) / 2;
+
+		if (free_ranges[mid].end <= vaddr)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+static __vaddr_t ushell_code_take(__sz len)
+{
+	unsigned int i;
+	__vaddr_t vaddr;
+
+	for (i = 0; i < free_ranges_cnt; i++) {
+		if (free_ranges[i].end - free_ranges[i].start >= len)
+			break;
+	}
+	if (i == free_ranges_cnt)
+		return 0;
+
+	vaddr = free_ranges[i].start;
+	free_ranges[i].start += len;
+	if (free_ranges[i].start == free_ranges[i].end) {
+		memmove(&free_ranges[i], &free_ranges[i + 1],
+			(free_ranges_cnt - i - 1) * sizeof(free_ranges[0]));
+		free_ranges_cnt--;
+	}
+	return vaddr;
+}
+
+static void ushell_code_give(__vaddr_t vaddr, __sz len)
+{
+	__vaddr_t end = vaddr + len;
+	unsigned int i = ushell_code_lookup(vaddr);
+	int merge_prev, merge_next;
+
+	UK_ASSERT(i == free_ranges_cnt || free_ranges[i].start >= end);
+	UK_ASSERT(i == 0 || free_ranges[i - 1].end <= vaddr);
+
+	merge_prev = (i > 0 && free_ranges[i - 1].end == vaddr);
+	merge_next = (i < free_ranges_cnt && free_ranges[i].start == end);
+
+	if (merge_prev && merge_next) {
+		free_ranges[i - 1].end = free_ranges[i].end;
+		memmove(&free_ranges[i], &free_ranges[i + 1],
+			(free_ranges_cnt - i - 1) * sizeof(free_ranges[0]));
+		free_ranges_cnt--;
+	} else if (merge_prev) {
+		free_ranges[i - 1].end = end;
+	} else if (merge_next) {
+		free_ranges[i].start = vaddr;
+	} else if (free_ranges_cnt < USHELL_CODE_MAX_FREE) {
+		memmove(&free_ranges[i + 1], &free_ranges[i],
+			(free_ranges_cnt - i) * sizeof(free_ranges[0]));
+		free_ranges[i].start = vaddr;
+		free_ranges[i].end = end;
+		free_ranges_cnt++;
+	} else {
+		uk_pr_warn("ushell: code region too fragmented, leaking 0x%lx-0x%lx\n",
+			   vaddr, end);
+	}
+}
+
+void *ushell_alloc_memory(unsigned long size)
+{
+	struct uk_pagetable *pt;
+	unsigned long pages;
+	__vaddr_t vaddr;
+	int rc;
+
+	if (size == 0)
+		return USHELL_MAP_FAILED;
+	pages = size_to_num_pages(size);
+
+	unikraft_call_wrapper_ret(vaddr, ushell_code_take, pages * PAGE_SIZE);
+	if (unlikely(!vaddr)) {
+		uk_pr_err("ushell: code region exhausted (%lu pages requested)\n",
+			  pages);
+		return USHELL_MAP_FAILED;
+	}
+
+	unikraft_call_wrapper_ret(pt, ukplat_pt_get_active);
+	unikraft_call_wrapper_ret(rc, ukplat_page_map, pt, vaddr, __PADDR_ANY,
+				  pages, ushell_code_attr(PAGE_ATTR_PROT_RW),
+				  0);
+	if (unlikely(rc)) {
+		uk_pr_err("ushell: failed to map %lu pages: %d\n", pages, rc);
+		unikraft_call_wrapper(ushell_code_give, vaddr, pages * PAGE_SIZE);
+		return USHELL_MAP_FAILED;
+	}
+
+	return (void *)vaddr;
+}
+
+void ushell_free_memory(void *addr, unsigned long size)
+{
+	struct uk_pagetable *pt;
+	unsigned long pages;
+	__vaddr_t vaddr = (__vaddr_t)addr;
+	int rc;
+
+	if (!addr || addr == USHELL_MAP_FAILED || size == 0)
+		return;
+
+	UK_ASSERT(PAGE_ALIGNED(vaddr));
+	UK_ASSERT(vaddr >= USHELL_CODE_BASE && vaddr < USHELL_CODE_END);
+	pages = size_to_num_pages(size);
+
+	unikraft_call_wrapper_ret(pt, ukplat_pt_get_active);
+	unikraft_call_wrapper_ret(rc, ukplat_page_unmap, pt, vaddr, pages, 0);
+	if (unlikely(rc)) {
+		/* Do not hand out a range that may still be mapped */
+		uk_pr_err("ushell: failed to unmap 0x%lx: %d\n", vaddr, rc);
+		return;
+	}
+
+	unikraft_call_wrapper(ushell_code_give, vaddr, pages * PAGE_SIZE);
+}
+
+int ushell_protect_memory(void *addr, unsigned long size, int prot)
+{
+	struct uk_pagetable *pt;
+	unsigned long attr = 0;
+	int rc;
+
+	if (!addr || addr == USHELL_MAP_FAILED || size == 0)
+		return 0;
+
+	UK_ASSERT(!((prot & USHELL_PROT_WRITE) && (prot & USHELL_PROT_EXEC)));
+
+	if (prot & USHELL_PROT_READ)
+		attr |= PAGE_ATTR_PROT_READ;
+	if (prot & USHELL_PROT_WRITE)
+		attr |= PAGE_ATTR_PROT_WRITE;
+	if (prot & USHELL_PROT_EXEC)
+		attr |= PAGE_ATTR_PROT_EXEC;
+
+	unikraft_call_wrapper_ret(pt, ukplat_pt_get_active);
+	unikraft_call_wrapper_ret(rc, ukplat_page_set_attr, pt,
+				  (__vaddr_t)addr, size_to_num_pages(size),
+				  ushell_code_attr(attr), 0);
+	return rc;
+}
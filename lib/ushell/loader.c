@@ -26,13 +26,23 @@
 #define USHELL_PR_ERR printf
 #define USHELL_PR_WARN printf
 #define USHELL_MAP_FAILED MAP_FAILED
+#define USHELL_PROT_READ PROT_READ
+#define USHELL_PROT_WRITE PROT_WRITE
+#define USHELL_PROT_EXEC PROT_EXEC
 
 void *ushell_alloc_memory(unsigned long size)
 {
-	return mmap(NULL, size, PROT_WRITE | PROT_EXEC | PROT_READ,
+	return mmap(NULL, size, PROT_WRITE | PROT_READ,
 		    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
 }
 
+int ushell_protect_memory(void *addr, unsigned long size, int prot)
+{
+	if (!addr || size == 0)
+		return 0;
+	return mprotect(addr, size, prot);
+}
+
 void ushell_free_memory(void *addr, unsigned long size)
 {
 	munmap(addr, size);
@@ -54,7 +64,6 @@ void ushell_puts(char *str)
 #include "ushell_api.h"
 
 #define USHELL_ASSERT UK_ASSERT
-#define USHELL_MAP_FAILED (void *)-1
 #ifdef CONFIG_LIBUSHELL_MPK
 #define USHELL_PRINTF(...)                       \
 do {                                                            \
@@ -146,9 +155,38 @@ struct ushell_loader_ctx {
 	struct ushell_program *prog;
 };
 
+/* Hashed symbol index generated at build time by
+ * support/scripts/mkushsym.py (see there for the file layout)
+ */
+#define USHELL_SYMTAB_MAGIC "USYM"
+#define USHELL_SYMTAB_VERSION 1
+#define USHELL_SYMTAB_EMPTY 0xffffffffU
+
+struct ushell_symtab_hdr {
+	char magic[4];
+	uint32_t version;
+	uint32_t nbuckets;
+	uint32_t nsyms;
+	uint32_t strsz;
+	uint32_t pad;
+};
+
+struct ushell_symtab_sym {
+	uint64_t addr;
+	uint32_t name;
+	uint32_t pad;
+};
+
 struct ushell_symbol_table {
-	char name[120];
-	void *addr;
+	void *img;
+	size_t size;
+	uint32_t nbuckets;
+	uint32_t nsyms;
+	const uint32_t *buckets;
+	const uint32_t *hashes;
+	const struct ushell_symtab_sym *syms;
+	const char *strtab;
+	uint32_t strsz;
 };
 
 #ifdef CONFIG_LIBUSHELL_MPK
@@ -159,6 +197,8 @@ int ushell_alloc_ushell_programs_array()
 	struct ushell_program *ush_prog = NULL;
 
 	ush_prog = ushell_alloc_memory(USHELL_PROG_MAX_NUM*sizeof(struct ushell_program));
+	if (ush_prog == USHELL_MAP_FAILED)
+		ush_prog = NULL;
 	ushell_enable_write();
 	ushell_programs = ush_prog;
 	ushell_disable_write();
@@ -219,120 +259,140 @@ int ushell_loader_test_func(int n)
 	return n + ushell_loader_test_data;
 }
 
-int ushell_symtable_size = 0;
-struct ushell_symbol_table *ushell_symbol_table = NULL;
+struct ushell_symbol_table ushell_symbol_table;
 
-/* supported format:
- *  0000000000100050 t gdt64_ds // output of nm command
- * or
- *  0000000000100050 gdt64_ds
+static uint32_t ushell_symbol_hash(const char *name)
+{
+	uint32_t h = 5381;
+
+	for (; *name; name++)
+		h = h * 33 + (unsigned char)*name;
+	return h;
+}
+
+/* Validate the symbol index in img and fill st with pointers into it */
+static int ushell_symtab_parse(struct ushell_symbol_table *st, void *img,
+			       size_t size)
+{
+	struct ushell_symtab_hdr *hdr = img;
+	size_t off;
+
+	if (size < sizeof(*hdr)
+	    || memcmp(hdr->magic, USHELL_SYMTAB_MAGIC, sizeof(hdr->magic))) {
+		USHELL_PR_ERR("ushell: not a symbol index file\n");
+		return -1;
+	}
+	if (hdr->version != USHELL_SYMTAB_VERSION) {
+		USHELL_PR_ERR("ushell: unsupported symbol index version %u\n",
+			      hdr->version);
+		return -1;
+	}
+	/* symbol entries start at the next 8-byte boundary after hashes */
+	off = sizeof(*hdr) + (size_t)hdr->nbuckets * sizeof(uint32_t)
+	      + (size_t)hdr->nsyms * sizeof(uint32_t);
+	off = (off + 7) & ~(size_t)7;
+	if (hdr->nbuckets == 0
+	    || off + (size_t)hdr->nsyms * sizeof(struct ushell_symtab_sym)
+		       + hdr->strsz != size) {
+		USHELL_PR_ERR("ushell: corrupted symbol index\n");
+		return -1;
+	}
+
+	st->img = img;
+	st->size = size;
+	st->nbuckets = hdr->nbuckets;
+	st->nsyms = hdr->nsyms;
+	st->buckets = (const uint32_t *)(hdr + 1);
+	st->hashes = st->buckets + hdr->nbuckets;
+	st->syms = (const struct ushell_symtab_sym *)((char *)img + off);
+	st->strtab = (const char *)(st->syms + hdr->nsyms);
+	st->strsz = hdr->strsz;
+	return 0;
+}
+
+/* Load a symbol index generated by mkushsym.py (the .ushsym file next to
+ * the kernel image). The file is read in one go and queried in place.
  */
 int ushell_load_symbol(char *path)
 {
-	int i;
 	FILE *fp;
-	char buf[256];
-	char *tmpc;
-	int ush_sym_tbl_sz = 0;
-	struct ushell_symbol_table *ush_sym_tbl = NULL;
-
-	if (ushell_symbol_table) {
-		ushell_free_memory(ushell_symbol_table,
-				   ushell_symtable_size
-				       * sizeof(struct ushell_symbol_table));
-	}
+	long size;
+	size_t r;
+	void *img;
+	struct ushell_symbol_table st = {};
 
 	unikraft_call_wrapper_ret(fp, fopen, path, "r");
 	if (fp == NULL) {
-		goto load_sym_out;
-	}
-	unikraft_call_wrapper_ret(tmpc, fgets, buf, 256, fp);
-	while (tmpc != NULL) {
-		int i;
-		for (i = 0; i < 256; i++) {
-			if (buf[i] == '\n')
-				break;
-		}
-		if (i == 256) {
-			USHELL_PR_ERR(
-			    "ushell: symbol file contains a too long line\n");
-			unikraft_call_wrapper(fclose, fp);
-			ush_sym_tbl_sz = 0;
-			goto load_sym_out;
-		}
-		ush_sym_tbl_sz++;
-		unikraft_call_wrapper_ret(tmpc, fgets, buf, 256, fp);
+		USHELL_PR_ERR("cannot open file: %s\n", path);
+		return -1;
 	}
-	ush_sym_tbl = ushell_alloc_memory(
-	    sizeof(struct ushell_symbol_table) * ush_sym_tbl_sz);
-	if (!ush_sym_tbl) {
-		USHELL_PR_ERR("ushell: failed to alloc memory\n");
+	unikraft_call_wrapper(fseek, fp, 0, SEEK_END);
+	unikraft_call_wrapper_ret(size, ftell, fp);
+	unikraft_call_wrapper(fseek, fp, 0, SEEK_SET);
+	if (size <= 0) {
 		unikraft_call_wrapper(fclose, fp);
-		goto load_sym_out;
+		return -1;
 	}
 
-	unikraft_call_wrapper(fseek, fp, 0, SEEK_SET);
-	i = 0;
-	unikraft_call_wrapper_ret(tmpc, fgets, buf, 256, fp);
-	while (tmpc != NULL) {
-		char *p, *q;
-		/* TODO: it might need wrapping */
-		long long addr = strtoll(&buf[0], &p, 16);
-		if (p[0] == ' ' && p[1] != ' ' && p[2] == ' ') {
-			/* skip space, type (e.g., 't' or 'T'), and space */
-			q = p + 3;
-		} else {
-			q = p + 1;
-		}
-		for (p++; *p != '\n'; p++)
-			;
-		*p = '\0';
-		ush_sym_tbl[i].addr = (void *)addr;
-		/* TODO: it might need wrapping */
-		strcpy(&ush_sym_tbl[i].name[0], q);
-		i++;
-		unikraft_call_wrapper_ret(tmpc, fgets, buf, 256, fp);
+	img = ushell_alloc_memory(size);
+	if (img == USHELL_MAP_FAILED) {
+		USHELL_PR_ERR("ushell: failed to alloc memory\n");
+		unikraft_call_wrapper(fclose, fp);
+		return -1;
 	}
+	unikraft_call_wrapper_ret(r, fread, img, size, 1, fp);
 	unikraft_call_wrapper(fclose, fp);
-load_sym_out:
+	if (r != 1) {
+		USHELL_PR_ERR("ushell: failed to read file\n");
+		ushell_free_memory(img, size);
+		return -1;
+	}
+	if (ushell_symtab_parse(&st, img, size) < 0) {
+		ushell_free_memory(img, size);
+		return -1;
+	}
+
+	if (ushell_symbol_table.img)
+		ushell_free_memory(ushell_symbol_table.img,
+				   ushell_symbol_table.size);
 #ifdef CONFIG_LIBUSHELL_MPK
 	ushell_enable_write();
 #endif /* CONFIG_LIBUSHELL_MPK */
-	ushell_symbol_table = ush_sym_tbl;
-	ushell_symtable_size = ush_sym_tbl_sz;
+	ushell_symbol_table = st;
 #ifdef CONFIG_LIBUSHELL_MPK
 	ushell_disable_write();
 #endif /* CONFIG_LIBUSHELL_MPK */
-	if (ush_sym_tbl_sz == 0)
+	if (st.nsyms == 0)
 		return -1;
-	return ush_sym_tbl_sz;
+	return st.nsyms;
 }
 
 void *ushell_symbol_get(const char *symbol)
 {
-	int i;
-	void *addr = NULL;
+	const struct ushell_symbol_table *st = &ushell_symbol_table;
+	uint32_t h, i;
 
 	USHELL_ASSERT(symbol);
 
-#if 1
-	for (i = 0; i < ushell_symtable_size; i++) {
-		if (!strcmp(ushell_symbol_table[i].name, symbol)) {
-			addr = ushell_symbol_table[i].addr;
+	if (!st->img)
+		return NULL;
+
+	h = ushell_symbol_hash(symbol);
+	i = st->buckets[h % st->nbuckets];
+	if (i == USHELL_SYMTAB_EMPTY)
+		return NULL;
+
+	/* walk the chain; the lowest hash bit marks its last entry */
+	for (; i < st->nsyms; i++) {
+		uint32_t hi = st->hashes[i];
+
+		if ((hi | 1) == (h | 1) && st->syms[i].name < st->strsz
+		    && !strcmp(st->strtab + st->syms[i].name, symbol))
+			return (void *)(uintptr_t)st->syms[i].addr;
+		if (hi & 1)
 			break;
-		}
 	}
-#else // debug
-	if (!strcmp(symbol, "ushell_loader_test_func")) {
-		addr = (void *)ushell_loader_test_func;
-	} else if (!strcmp(symbol, "ushell_loader_test_data")) {
-		addr = (void *)&ushell_loader_test_data;
-	} else if (!strcmp(symbol, "ushell_puts")) {
-		addr = (void *)&ushell_puts;
-	}
-#endif
-
-	return addr;
+	return NULL;
 }
 
 static void ushell_program_free(struct ushell_program *prog)
@@ -792,7 +852,11 @@ static int ushell_loader_map_elf_image(struct ushell_loader_ctx *ctx,
 	USHELL_PR_DEBUG("ushell: file: %s, size: %d\n", path, size);
 	ctx->elf_size = size;
 	ctx->elf_img = ushell_alloc_memory(size);
-	USHELL_ASSERT(ctx->elf_img != USHELL_MAP_FAILED);
+	if (ctx->elf_img == USHELL_MAP_FAILED) {
+		ctx->elf_img = NULL;
+		unikraft_call_wrapper(fclose, fp);
+		return -1;
+	}
 	size_t r;
 	unikraft_call_wrapper_ret(r, fread, ctx->elf_img, size, 1, fp);
 	if (r != 1) {
@@ -964,6 +1028,26 @@ static int ushell_loader_elf_find_entry(struct ushell_loader_ctx *ctx)
 	return 0;
 }
 
+/* Drop write permission on sections that are not written at run time.
+ * Every section lives on its own pages, so each one gets exactly the
+ * permissions it needs and no page is writable and executable.
+ */
+static int ushell_loader_protect_sections(struct ushell_loader_ctx *ctx)
+{
+	struct ushell_program *prog = ctx->prog;
+	int r = 0;
+
+	r |= ushell_protect_memory(prog->text, prog->text_size,
+				   USHELL_PROT_READ | USHELL_PROT_EXEC);
+	r |= ushell_protect_memory(prog->plt, prog->plt_size,
+				   USHELL_PROT_READ | USHELL_PROT_EXEC);
+	r |= ushell_protect_memory(prog->rodata, prog->rodata_size,
+				   USHELL_PROT_READ);
+	r |= ushell_protect_memory(prog->got, prog->got_size,
+				   USHELL_PROT_READ);
+	return r ? -1 : 0;
+}
+
 int ushell_loader_load_elf(char *path)
 {
 	struct ushell_program *prog = ushell_program_find(path);
@@ -1017,6 +1101,12 @@ int ushell_loader_load_elf(char *path)
 	}
 	USHELL_PR_DEBUG("relocate_symbol ok\n");
 
+	r = ushell_loader_protect_sections(&ctx);
+	if (r != 0) {
+		USHELL_PR_ERR("ushell: failed to protect sections\n");
+		goto err;
+	}
+
 	r = ushell_loader_elf_find_entry(&ctx);
 	if (r != 0) {
 		USHELL_PR_ERR("ushell: failed to find main entry point\n");
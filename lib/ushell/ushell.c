@@ -24,16 +24,8 @@
 #include <string.h>
 #include <stdio.h>
 
-#define size_to_num_pages(size) \
-	        (ALIGN_UP((unsigned long)(size), __PAGE_SIZE) / __PAGE_SIZE)
-
 #ifdef CONFIG_LIBUSHELL_MPK
 
-#define PKEY_MASK (~(PAGE_PROT_PKEY0 | PAGE_PROT_PKEY1 | PAGE_PROT_PKEY2 | \
-                                                PAGE_PROT_PKEY3))
-#define CLEAR_PKEY(prot)                (prot & PKEY_MASK)
-#define INSTALL_PKEY(prot, pkey)        (prot | pkey)
-
 unsigned long pbkey = 0;
 int raw_key = 0;
 #else
@@ -88,75 +80,6 @@ int ushell_write_is_enabled()
 
 #endif
 
-// #define _USE_MMAP // use mmap()
-void *ushell_alloc_memory(unsigned long size)
-{
-	unsigned pages;
-	void *addr = NULL;
-	unsigned long attr = PAGE_ATTR_PROT_READ | PAGE_ATTR_PROT_WRITE
-				     | PAGE_ATTR_PROT_EXEC;
-
-	pages = size_to_num_pages(size);
-#ifdef _USE_MMAP
-	/* XXX: This does not work because mmap does not support allocating
-		exetuubale memory for now
-	*/
-	addr = mmap(NULL, size, PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANON,
-		    -1, 0);
-	if (code == MAP_FAILED || code == 0) {
-		unikraft_call_wrapper(uk_pr_info, "ushell: mmap failed: code=%ld\n", (long)code);
-		ushell_puts("Failed to run command\n");
-		return;
-	}
-#else
-#ifdef CONFIG_LIBUSHELL_MPK
-
-	/* clear current pkey */
-	attr = CLEAR_PKEY(attr);
-	/* install new pkey */
-	attr = INSTALL_PKEY(attr, pbkey);
-
-#endif /*CONFIG_LIBUSHELL_MPK */
-
-	struct uk_pagetable *pt;
-	int rc;
-	unikraft_call_wrapper_ret(pt, ukplat_pt_get_active);
-	// FIXME: find proper vaddr
-	static void *base_addr = (void *)0x80000000;
-	addr = base_addr;
-	unikraft_call_wrapper_ret(rc, ukplat_page_map, pt, (long long)addr, __PADDR_ANY, pages,
-				 attr, 0);
-	UK_ASSERT(rc == 0);
-#ifdef CONFIG_LIBUSHELL_MPK
-	/*
-	 * TODO: base_addr does not seem to be stored in the stack.
-	 * Therefore every write fails. Maybe it is stored in tls
-	 */
-	ushell_enable_write();
-#endif /*CONFIG_LIBUSHELL_MPK */
-	base_addr = (char *)addr + (pages * PAGE_SIZE);
-#ifdef CONFIG_LIBUSHELL_MPK
-	ushell_disable_write();
-#endif /*CONFIG_LIBUSHELL_MPK */
-#endif
-	UK_ASSERT(addr);
-	return addr;
-}
-
-void ushell_free_memory(void *addr, unsigned long size)
-{
-	unsigned pages;
-	pages = size_to_num_pages(size);
-
-#ifdef _USE_MMAP
-	munmap(code, size);
-#else
-	struct uk_pagetable *pt;
-	unikraft_call_wrapper_ret(pt, ukplat_pt_get_active);
-	unikraft_call_wrapper(ukplat_page_unmap, pt, (long long)addr, pages, 0);
-#endif
-}
-
 //-------------------------------------
 
 static void ushell_puts_n(char *str, size_t len)
@@ -5,8 +5,18 @@
 extern "C" {
 #endif
 
+#define USHELL_MAP_FAILED (void *)-1
+
+#define USHELL_PROT_READ  0x1
+#define USHELL_PROT_WRITE 0x2
+#define USHELL_PROT_EXEC  0x4
+
+/* Memory of the code region is returned read-write; use
+ * ushell_protect_memory() to make it executable or read-only once filled
+ */
 void *ushell_alloc_memory(unsigned long size);
 void ushell_free_memory(void *addr, unsigned long size);
+int ushell_protect_memory(void *addr, unsigned long size, int prot);
 
 int ushell_alloc_ushell_programs_array();
 int ushell_load_symbol(char *path);
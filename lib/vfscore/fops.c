@@ -35,6 +35,7 @@
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <vfscore/file.h>
+#include <vfscore/pagecache.h>
 #include "vfs.h"
 
 #include <uk/assert.h>
@@ -45,6 +46,8 @@ int vfs_close(struct vfscore_file *fp)
 	int error;
 
 	vn_lock(vp);
+	/* Pages that fail to be written back stay dirty until inactive */
+	vfscore_pcache_flush(vp);
 	error = VOP_CLOSE(vp, fp);
 	vn_unlock(vp);
 
@@ -100,6 +103,8 @@ int vfs_write(struct vfscore_file *fp, struct uio *uio, int flags)
 		ioflags |= IO_APPEND;
 	if (fp->f_flags & (O_DSYNC|O_SYNC))
 		ioflags |= IO_SYNC;
+	if (fp->f_flags & O_NONBLOCK)
+		ioflags |= IO_NDELAY;
 
 	if ((flags & FOF_OFFSET) == 0)
 		uio->uio_offset = fp->f_offset;
@@ -58,6 +58,8 @@ struct vfscore_file {
 	int		f_vfs_flags;    /* internal implementation flags */
 	struct dentry   *f_dentry;
 	struct uk_mutex f_lock;
+	off_t		f_ra_next;	/* offset of the next sequential read */
+	unsigned int	f_ra_pages;	/* page cache read-ahead window */
 };
 
 #define FD_LOCK(fp)       uk_mutex_lock(&(fp->f_lock))
@@ -0,0 +1,172 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __VFSCORE_PAGECACHE_H__
+#define __VFSCORE_PAGECACHE_H__
+
+#include <errno.h>
+#include <uk/config.h>
+#include <uk/essentials.h>
+#include <vfscore/vnode.h>
+#include <vfscore/file.h>
+#include <vfscore/uio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Backend of a cached vnode. Both operations are called with the vnode
+ * locked and transfer the whole uio unless they hit the end of the file
+ * (read) or fail. They return 0 or a positive errno.
+ */
+struct vfscore_pcache_ops {
+	int (*pco_read)(struct vnode *vp, struct uio *uio);
+	int (*pco_write)(struct vnode *vp, struct uio *uio);
+};
+
+#if CONFIG_LIBVFSCORE_PAGECACHE
+
+/**
+ * Serves reads and writes of the vnode from the page cache from now on. The
+ * filesystem then forwards its VOP_READ/VOP_WRITE to vfscore_pcache_read()
+ * and vfscore_pcache_write(). Dirty pages are written back by vfscore on
+ * close, fsync and when the vnode becomes inactive.
+ */
+static inline void vfscore_pcache_init(struct vnode *vp,
+				       const struct vfscore_pcache_ops *ops)
+{
+	vp->v_pcops = ops;
+}
+
+static inline int vfscore_pcache_enabled(struct vnode *vp)
+{
+	return vp->v_pcops != NULL;
+}
+
+/* Does the vnode have data that the backend has not seen yet? */
+static inline int vfscore_pcache_dirty(struct vnode *vp)
+{
+	return vp->v_pcops && !uk_list_empty(&vp->v_dirty);
+}
+
+/**
+ * Reads from the cache, filling missing pages from the backend. Sequential
+ * reads through the same file grow a read-ahead window.
+ */
+int vfscore_pcache_read(struct vnode *vp, struct vfscore_file *fp,
+			struct uio *uio);
+
+/**
+ * Writes into the cache. The data is written back later unless ioflag has
+ * IO_SYNC.
+ */
+int vfscore_pcache_write(struct vnode *vp, struct uio *uio, int ioflag);
+
+/**
+ * Writes all dirty pages of the vnode back.
+ */
+int vfscore_pcache_flush(struct vnode *vp);
+
+/**
+ * Drops cached data beyond length, without writing it back.
+ */
+void vfscore_pcache_truncate(struct vnode *vp, off_t length);
+
+/**
+ * Writes back and drops all pages of the vnode.
+ */
+void vfscore_pcache_release(struct vnode *vp);
+
+/**
+ * Evicts up to npages clean pages that are not in use, least recently used
+ * first, and returns their memory to the allocator. Can be called by code
+ * that runs out of memory. Returns the number of evicted pages.
+ */
+unsigned long vfscore_pcache_reclaim(unsigned long npages);
+
+#else /* !CONFIG_LIBVFSCORE_PAGECACHE */
+
+static inline void vfscore_pcache_init(struct vnode *vp __unused,
+			const struct vfscore_pcache_ops *ops __unused)
+{
+}
+
+static inline int vfscore_pcache_enabled(struct vnode *vp __unused)
+{
+	return 0;
+}
+
+static inline int vfscore_pcache_dirty(struct vnode *vp __unused)
+{
+	return 0;
+}
+
+static inline int vfscore_pcache_read(struct vnode *vp __unused,
+				      struct vfscore_file *fp __unused,
+				      struct uio *uio __unused)
+{
+	return EINVAL;
+}
+
+static inline int vfscore_pcache_write(struct vnode *vp __unused,
+				       struct uio *uio __unused,
+				       int ioflag __unused)
+{
+	return EINVAL;
+}
+
+static inline int vfscore_pcache_flush(struct vnode *vp __unused)
+{
+	return 0;
+}
+
+static inline void vfscore_pcache_truncate(struct vnode *vp __unused,
+					   off_t length __unused)
+{
+}
+
+static inline void vfscore_pcache_release(struct vnode *vp __unused)
+{
+}
+
+static inline unsigned long vfscore_pcache_reclaim(unsigned long npages
+						   __unused)
+{
+	return 0;
+}
+
+#endif /* !CONFIG_LIBVFSCORE_PAGECACHE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __VFSCORE_PAGECACHE_H__ */
@@ -46,6 +46,7 @@ struct vfsops;
 struct vnops;
 struct vnode;
 struct vfscore_file;
+struct vfscore_pcache_ops;
 
 /*
  * Vnode types.
@@ -79,6 +80,10 @@ struct vnode {
 	struct uk_mutex	v_lock;		/* lock for this vnode */
 	struct uk_list_head v_names;	/* directory entries pointing at this */
 	void		*v_data;	/* private data for fs */
+	const struct vfscore_pcache_ops *v_pcops; /* page cache backend */
+	struct uk_list_head v_pages;	/* cached pages */
+	struct uk_list_head v_dirty;	/* dirty cached pages */
+	unsigned long	v_ndirty;	/* number of dirty cached pages */
 };
 
 /* flags for vnode */
@@ -137,6 +142,7 @@ struct vattr {
 
 #define IO_APPEND	0x0001
 #define IO_SYNC		0x0002
+#define IO_NDELAY	0x0004
 
 /*
  * ARC actions
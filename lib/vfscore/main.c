@@ -1962,6 +1962,16 @@ UK_LLSYSCALL_R_DEFINE(int, fcntl, int, fd, unsigned int, cmd, int, arg)
 	case F_SETOWN:
 		uk_pr_warn_once("fcntl(F_SETOWN) stubbed\n");
 		break;
+	case F_SETPIPE_SZ:
+	case F_GETPIPE_SZ:
+		if (fp->f_dentry->d_vnode->v_type != VFIFO) {
+			error = EBADF;
+			break;
+		}
+		/* The pipe reports back the size it has now */
+		error = vfs_ioctl(fp, cmd, &arg);
+		ret = arg;
+		break;
 	default:
 		uk_pr_err("unsupported fcntl cmd 0x%x\n", cmd);
 		error = EINVAL;
@@ -1986,7 +1996,8 @@ int fcntl(int fd, int cmd, ...)
 
 	va_start(ap, cmd);
 	if (cmd == F_SETFD ||
-	    cmd == F_SETFL) {
+	    cmd == F_SETFL ||
+	    cmd == F_SETPIPE_SZ) {
 		arg = va_arg(ap, int);
 	}
 	va_end(ap);
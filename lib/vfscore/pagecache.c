@@ -0,0 +1,688 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Page cache for vnodes whose filesystem registered vfscore_pcache_ops.
+ *
+ * Pages are keyed by (vnode, page-aligned file offset) in a global hash
+ * table and hold the file data in one uk_palloc() page each. All pages are
+ * also on a global LRU list, from which clean and unreferenced pages are
+ * evicted when the cache reaches CONFIG_LIBVFSCORE_PAGECACHE_MAX_PAGES, when
+ * fewer than CONFIG_LIBVFSCORE_PAGECACHE_MIN_FREE pages are left to the
+ * rest of the system, or when vfscore_pcache_reclaim() asks for them.
+ *
+ * Every operation on the pages of a vnode runs with the vnode locked. The
+ * global lock only protects the hash table, the LRU list, the per-vnode
+ * page lists and counters and the reference counts, so that no backend I/O is done with
+ * it held. A page is only modified while referenced, which keeps eviction
+ * away from it; dirty pages are never evicted and are tracked on a per-vnode
+ * list that is only touched with the vnode locked.
+ *
+ * Misses are filled with a single backend request that covers the rest of
+ * the read and, for sequential readers, a read-ahead window that doubles
+ * with every sequential read up to CONFIG_LIBVFSCORE_PAGECACHE_CLUSTER
+ * pages. Writes are kept in the cache until the file is closed or synced,
+ * the vnode becomes inactive, or too many of its pages are dirty;
+ * contiguous dirty pages are then written back together.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <uk/alloc.h>
+#include <uk/assert.h>
+#include <uk/print.h>
+#include <uk/list.h>
+#include <uk/mutex.h>
+#include <uk/essentials.h>
+#include <uk/arch/limits.h>
+#include <vfscore/pagecache.h>
+
+#define PC_PAGE_SIZE		((size_t)__PAGE_SIZE)
+#define PC_PAGE_MASK		((off_t)__PAGE_SIZE - 1)
+#define PC_HASH_SIZE		1024
+#define PC_MAX_PAGES		CONFIG_LIBVFSCORE_PAGECACHE_MAX_PAGES
+#define PC_MIN_FREE		CONFIG_LIBVFSCORE_PAGECACHE_MIN_FREE
+#define PC_DIRTY_MAX		CONFIG_LIBVFSCORE_PAGECACHE_DIRTY_MAX
+#define PC_CLUSTER		((unsigned int)CONFIG_LIBVFSCORE_PAGECACHE_CLUSTER)
+/* Read-ahead window after the first sequential read */
+#define PC_RA_INIT		MIN(4U, PC_CLUSTER)
+/* Pages to evict at once when memory runs low */
+#define PC_EVICT_BATCH		32
+
+struct pc_page {
+	struct uk_hlist_node hash_link;
+	struct uk_list_head lru_link;
+	struct uk_list_head vnode_link;
+	struct uk_list_head dirty_link;
+	struct vnode *vp;
+	off_t off;
+	char *data;
+	/* [0, valid) holds file data, the rest of the page is zero. A page
+	 * of a file that is larger than valid ends in a hole.
+	 */
+	size_t valid;
+	/* [dirty_start, dirty_end) is not written back yet */
+	size_t dirty_start;
+	size_t dirty_end;
+	unsigned int ref;
+};
+
+static struct uk_mutex pc_lock = UK_MUTEX_INITIALIZER(pc_lock);
+static struct uk_hlist_head pc_hash[PC_HASH_SIZE];
+static UK_LIST_HEAD(pc_lru);
+static unsigned long pc_npages;
+
+static inline unsigned long pc_hashfn(struct vnode *vp, off_t off)
+{
+	return (((unsigned long)vp >> 6) ^ (unsigned long)(off >> __PAGE_SHIFT))
+		& (PC_HASH_SIZE - 1);
+}
+
+static inline int pc_is_dirty(struct pc_page *pg)
+{
+	return pg->dirty_start != pg->dirty_end;
+}
+
+/* Called with pc_lock held */
+static void pc_free_locked(struct pc_page *pg)
+{
+	UK_ASSERT(pg->ref == 0);
+
+	if (pc_is_dirty(pg)) {
+		uk_list_del(&pg->dirty_link);
+		pg->vp->v_ndirty--;
+	}
+	uk_hlist_del(&pg->hash_link);
+	uk_list_del(&pg->lru_link);
+	uk_list_del(&pg->vnode_link);
+	pc_npages--;
+
+	uk_pfree(uk_alloc_get_default(), pg->data, 1);
+	free(pg);
+}
+
+/* Called with pc_lock held, returns the number of evicted pages */
+static unsigned long pc_evict_locked(unsigned long num)
+{
+	struct pc_page *pg, *next;
+	unsigned long evicted = 0;
+
+	uk_list_for_each_entry_safe(pg, next, &pc_lru, lru_link) {
+		if (evicted == num)
+			break;
+		if (pg->ref || pc_is_dirty(pg))
+			continue;
+		pc_free_locked(pg);
+		evicted++;
+	}
+
+	return evicted;
+}
+
+/* Returns the cached page at off with a reference, or NULL */
+static struct pc_page *pc_lookup(struct vnode *vp, off_t off)
+{
+	struct pc_page *pg;
+
+	uk_mutex_lock(&pc_lock);
+	uk_hlist_for_each_entry(pg, &pc_hash[pc_hashfn(vp, off)], hash_link) {
+		if (pg->vp == vp && pg->off == off) {
+			pg->ref++;
+			uk_list_move_tail(&pg->lru_link, &pc_lru);
+			uk_mutex_unlock(&pc_lock);
+			return pg;
+		}
+	}
+	uk_mutex_unlock(&pc_lock);
+
+	return NULL;
+}
+
+static int pc_cached(struct vnode *vp, off_t off)
+{
+	struct pc_page *pg;
+	int found = 0;
+
+	uk_mutex_lock(&pc_lock);
+	uk_hlist_for_each_entry(pg, &pc_hash[pc_hashfn(vp, off)], hash_link) {
+		if (pg->vp == vp && pg->off == off) {
+			found = 1;
+			break;
+		}
+	}
+	uk_mutex_unlock(&pc_lock);
+
+	return found;
+}
+
+static void pc_get(struct pc_page *pg)
+{
+	uk_mutex_lock(&pc_lock);
+	pg->ref++;
+	uk_mutex_unlock(&pc_lock);
+}
+
+static void pc_put(struct pc_page *pg)
+{
+	uk_mutex_lock(&pc_lock);
+	UK_ASSERT(pg->ref > 0);
+	pg->ref--;
+	uk_mutex_unlock(&pc_lock);
+}
+
+/* Drops a referenced page that did not receive any data */
+static void pc_discard(struct pc_page *pg)
+{
+	uk_mutex_lock(&pc_lock);
+	UK_ASSERT(pg->ref == 1);
+	pg->ref = 0;
+	pc_free_locked(pg);
+	uk_mutex_unlock(&pc_lock);
+}
+
+/*
+ * Adds an empty page for off to the cache and returns it referenced, or
+ * NULL if the cache is full of pages that cannot be evicted or there is no
+ * memory left.
+ */
+static struct pc_page *pc_alloc(struct vnode *vp, off_t off)
+{
+	struct uk_alloc *a = uk_alloc_get_default();
+	struct pc_page *pg;
+	long avail;
+
+	pg = calloc(1, sizeof(*pg));
+	if (unlikely(!pg))
+		return NULL;
+
+	uk_mutex_lock(&pc_lock);
+	if (pc_npages >= PC_MAX_PAGES &&
+	    !pc_evict_locked(pc_npages - PC_MAX_PAGES + 1))
+		goto err_unlock;
+
+	/* Give memory back before the rest of the system runs out of it */
+	avail = uk_alloc_pavailmem(a);
+	if (avail >= 0 && avail < PC_MIN_FREE)
+		pc_evict_locked(PC_EVICT_BATCH);
+
+	pg->data = uk_palloc(a, 1);
+	if (unlikely(!pg->data)) {
+		if (!pc_evict_locked(PC_EVICT_BATCH))
+			goto err_unlock;
+		pg->data = uk_palloc(a, 1);
+		if (unlikely(!pg->data))
+			goto err_unlock;
+	}
+
+	pg->vp = vp;
+	pg->off = off;
+	pg->ref = 1;
+	uk_hlist_add_head(&pg->hash_link, &pc_hash[pc_hashfn(vp, off)]);
+	uk_list_add_tail(&pg->lru_link, &pc_lru);
+	uk_list_add_tail(&pg->vnode_link, &vp->v_pages);
+	pc_npages++;
+	uk_mutex_unlock(&pc_lock);
+
+	return pg;
+
+err_unlock:
+	uk_mutex_unlock(&pc_lock);
+	free(pg);
+	return NULL;
+}
+
+static void pc_set_valid(struct pc_page *pg, size_t valid)
+{
+	pg->valid = valid;
+	memset(pg->data + valid, 0, PC_PAGE_SIZE - valid);
+}
+
+static void pc_mark_dirty(struct pc_page *pg, size_t start, size_t end)
+{
+	UK_ASSERT(pg->ref > 0);
+
+	if (pc_is_dirty(pg)) {
+		pg->dirty_start = MIN(pg->dirty_start, start);
+		pg->dirty_end = MAX(pg->dirty_end, end);
+		return;
+	}
+
+	uk_mutex_lock(&pc_lock);
+	pg->dirty_start = start;
+	pg->dirty_end = end;
+	uk_list_add_tail(&pg->dirty_link, &pg->vp->v_dirty);
+	pg->vp->v_ndirty++;
+	uk_mutex_unlock(&pc_lock);
+}
+
+static void pc_mark_clean(struct pc_page *pg)
+{
+	UK_ASSERT(pg->ref > 0);
+
+	if (!pc_is_dirty(pg))
+		return;
+
+	uk_mutex_lock(&pc_lock);
+	pg->dirty_start = 0;
+	pg->dirty_end = 0;
+	uk_list_del(&pg->dirty_link);
+	pg->vp->v_ndirty--;
+	uk_mutex_unlock(&pc_lock);
+}
+
+static int pc_backend_read(struct vnode *vp, void *buf, size_t len, off_t off,
+			   size_t *got)
+{
+	struct iovec iov = { .iov_base = buf, .iov_len = len };
+	struct uio uio = {
+		.uio_iov = &iov,
+		.uio_iovcnt = 1,
+		.uio_offset = off,
+		.uio_resid = len,
+		.uio_rw = UIO_READ,
+	};
+	int rc;
+
+	rc = vp->v_pcops->pco_read(vp, &uio);
+	*got = len - uio.uio_resid;
+	return rc;
+}
+
+/*
+ * Reads up to npages pages starting at off with one backend request and
+ * adds them to the cache. The backend may know less of the file than
+ * v_size, e.g., after the file was extended by truncation: the rest up to
+ * v_size reads as zeros. Returns the first page referenced, or NULL at the
+ * end of the file or on error (*err).
+ */
+static struct pc_page *pc_fill(struct vnode *vp, off_t off,
+			       unsigned int npages, int *err)
+{
+	struct uk_alloc *a = uk_alloc_get_default();
+	struct pc_page *first, *pg;
+	unsigned int i;
+	size_t got, want;
+	char *buf;
+
+	*err = 0;
+	if (off >= vp->v_size)
+		return NULL;
+
+	/* Do not read past the end of the file or over cached pages */
+	npages = MIN(npages, (unsigned int)DIV_ROUND_UP(vp->v_size - off,
+							 PC_PAGE_SIZE));
+	npages = MAX(npages, 1U);
+	for (i = 1; i < npages; i++) {
+		if (pc_cached(vp, off + i * PC_PAGE_SIZE))
+			break;
+	}
+	npages = i;
+
+	first = pc_alloc(vp, off);
+	if (unlikely(!first)) {
+		*err = ENOMEM;
+		return NULL;
+	}
+
+	buf = first->data;
+	if (npages > 1) {
+		buf = uk_palloc(a, npages);
+		if (!buf) {
+			buf = first->data;
+			npages = 1;
+		}
+	}
+
+	*err = pc_backend_read(vp, buf, npages * PC_PAGE_SIZE, off, &got);
+	if (*err)
+		goto err_free;
+
+	/* Zero what the backend does not have, up to the end of the file */
+	want = MIN(npages * PC_PAGE_SIZE, (size_t)(vp->v_size - off));
+	if (got < want) {
+		memset(buf + got, 0, want - got);
+		got = want;
+	}
+
+	if (buf != first->data)
+		memcpy(first->data, buf, MIN(got, PC_PAGE_SIZE));
+	pc_set_valid(first, MIN(got, PC_PAGE_SIZE));
+
+	for (i = 1; i < npages && got > i * PC_PAGE_SIZE; i++) {
+		pg = pc_alloc(vp, off + i * PC_PAGE_SIZE);
+		if (!pg)
+			break;
+		memcpy(pg->data, buf + i * PC_PAGE_SIZE,
+		       MIN(got - i * PC_PAGE_SIZE, PC_PAGE_SIZE));
+		pc_set_valid(pg, MIN(got - i * PC_PAGE_SIZE, PC_PAGE_SIZE));
+		pc_put(pg);
+	}
+
+	if (buf != first->data)
+		uk_pfree(a, buf, npages);
+	return first;
+
+err_free:
+	if (buf != first->data)
+		uk_pfree(a, buf, npages);
+	pc_discard(first);
+	return NULL;
+}
+
+/* Updates the read-ahead state of fp and returns the window in pages */
+static unsigned int pc_readahead(struct vfscore_file *fp, off_t off)
+{
+	if (!fp)
+		return 0;
+
+	if (off != fp->f_ra_next)
+		fp->f_ra_pages = 0;
+	else if (!fp->f_ra_pages)
+		fp->f_ra_pages = PC_RA_INIT;
+	else
+		fp->f_ra_pages = MIN(fp->f_ra_pages * 2, PC_CLUSTER);
+
+	return fp->f_ra_pages;
+}
+
+int vfscore_pcache_read(struct vnode *vp, struct vfscore_file *fp,
+			struct uio *uio)
+{
+	struct pc_page *pg;
+	unsigned int ra, npages;
+	size_t inpage, n;
+	off_t poff;
+	int rc = 0;
+
+	UK_ASSERT(vp->v_pcops);
+
+	if (uio->uio_offset < 0)
+		return EINVAL;
+
+	ra = pc_readahead(fp, uio->uio_offset);
+
+	while (uio->uio_resid > 0 && uio->uio_offset < vp->v_size) {
+		poff = uio->uio_offset & ~PC_PAGE_MASK;
+		inpage = uio->uio_offset - poff;
+
+		pg = pc_lookup(vp, poff);
+		if (!pg) {
+			npages = DIV_ROUND_UP(inpage + uio->uio_resid,
+					      PC_PAGE_SIZE) + ra;
+			pg = pc_fill(vp, poff, MIN(npages, PC_CLUSTER), &rc);
+			if (!pg) {
+				/* Without memory for the cache, read around it */
+				if (rc == ENOMEM)
+					rc = vp->v_pcops->pco_read(vp, uio);
+				break;
+			}
+		}
+
+		/* The page is zero beyond valid, which reads as a hole */
+		n = MIN(PC_PAGE_SIZE - inpage, (size_t)uio->uio_resid);
+		n = MIN(n, (size_t)(vp->v_size - uio->uio_offset));
+		rc = vfscore_uiomove(pg->data + inpage, n, uio);
+		pc_put(pg);
+		if (rc)
+			break;
+	}
+
+	if (fp)
+		fp->f_ra_next = uio->uio_offset;
+
+	return rc;
+}
+
+int vfscore_pcache_write(struct vnode *vp, struct uio *uio, int ioflag)
+{
+	struct pc_page *pg;
+	ssize_t rest;
+	size_t inpage, n, got;
+	off_t poff;
+	int rc = 0;
+
+	UK_ASSERT(vp->v_pcops);
+
+	if (ioflag & IO_APPEND)
+		uio->uio_offset = vp->v_size;
+
+	while (uio->uio_resid > 0) {
+		poff = uio->uio_offset & ~PC_PAGE_MASK;
+		inpage = uio->uio_offset - poff;
+		n = MIN(PC_PAGE_SIZE - inpage, (size_t)uio->uio_resid);
+
+		pg = pc_lookup(vp, poff);
+		if (!pg) {
+			pg = pc_alloc(vp, poff);
+			if (!pg) {
+				/*
+				 * Without memory for the cache, write this
+				 * page through. No page is cached for it, so
+				 * nothing becomes stale.
+				 */
+				rest = uio->uio_resid - n;
+				uio->uio_resid = n;
+				rc = vp->v_pcops->pco_write(vp, uio);
+				uio->uio_resid += rest;
+				if (rc)
+					break;
+				goto next;
+			}
+
+			/* A partial page needs the data around the write */
+			if ((inpage || n < PC_PAGE_SIZE) && poff < vp->v_size) {
+				rc = pc_backend_read(vp, pg->data,
+						     PC_PAGE_SIZE, poff, &got);
+				if (rc) {
+					pc_discard(pg);
+					break;
+				}
+				pc_set_valid(pg, got);
+			} else {
+				pc_set_valid(pg, 0);
+			}
+		}
+
+		rc = vfscore_uiomove(pg->data + inpage, n, uio);
+		if (!rc) {
+			pg->valid = MAX(pg->valid, inpage + n);
+			pc_mark_dirty(pg, inpage, inpage + n);
+		}
+		pc_put(pg);
+		if (rc)
+			break;
+
+next:
+		if (uio->uio_offset > vp->v_size)
+			vp->v_size = uio->uio_offset;
+	}
+
+	if (!rc && ((ioflag & IO_SYNC) || vp->v_ndirty > PC_DIRTY_MAX))
+		rc = vfscore_pcache_flush(vp);
+
+	return rc;
+}
+
+/*
+ * Writes back the dirty range of first, which is referenced by the caller,
+ * together with the following pages as long as their dirty ranges are
+ * contiguous.
+ */
+static int pc_writeback(struct vnode *vp, struct pc_page *first)
+{
+	struct uk_alloc *a = uk_alloc_get_default();
+	struct pc_page *run[PC_CLUSTER];
+	struct iovec iov[PC_CLUSTER];
+	struct uio uio;
+	unsigned int n = 1, i;
+	size_t len = 0;
+	char *buf = NULL;
+	int rc;
+
+	run[0] = first;
+	while (n < PC_CLUSTER && run[n - 1]->dirty_end == PC_PAGE_SIZE) {
+		struct pc_page *pg;
+
+		pg = pc_lookup(vp, run[n - 1]->off + PC_PAGE_SIZE);
+		if (!pg)
+			break;
+		if (!pc_is_dirty(pg) || pg->dirty_start != 0) {
+			pc_put(pg);
+			break;
+		}
+		run[n++] = pg;
+	}
+
+	for (i = 0; i < n; i++) {
+		iov[i].iov_base = run[i]->data + run[i]->dirty_start;
+		iov[i].iov_len = run[i]->dirty_end - run[i]->dirty_start;
+		len += iov[i].iov_len;
+	}
+
+	/* Hand the run to the backend as one buffer if possible */
+	if (n > 1)
+		buf = uk_palloc(a, n);
+	if (buf) {
+		size_t copied = 0;
+
+		for (i = 0; i < n; i++) {
+			memcpy(buf + copied, iov[i].iov_base, iov[i].iov_len);
+			copied += iov[i].iov_len;
+		}
+		iov[0].iov_base = buf;
+		iov[0].iov_len = len;
+	}
+
+	uio.uio_iov = iov;
+	uio.uio_iovcnt = buf ? 1 : n;
+	uio.uio_offset = first->off + first->dirty_start;
+	uio.uio_resid = len;
+	uio.uio_rw = UIO_WRITE;
+	rc = vp->v_pcops->pco_write(vp, &uio);
+	if (!rc && uio.uio_resid)
+		rc = EIO;
+
+	if (buf)
+		uk_pfree(a, buf, n);
+
+	for (i = 0; i < n; i++) {
+		if (!rc)
+			pc_mark_clean(run[i]);
+		pc_put(run[i]);
+	}
+
+	return rc;
+}
+
+int vfscore_pcache_flush(struct vnode *vp)
+{
+	struct pc_page *pg;
+	int rc;
+
+	if (!vp->v_pcops)
+		return 0;
+
+	while (!uk_list_empty(&vp->v_dirty)) {
+		pg = uk_list_first_entry(&vp->v_dirty, struct pc_page,
+					 dirty_link);
+		pc_get(pg);
+		rc = pc_writeback(vp, pg);
+		if (rc) {
+			uk_pr_err("Failed to write back cached data: %d\n",
+				  rc);
+			return rc;
+		}
+	}
+
+	return 0;
+}
+
+void vfscore_pcache_truncate(struct vnode *vp, off_t length)
+{
+	struct pc_page *pg, *next;
+	size_t valid;
+
+	if (!vp->v_pcops)
+		return;
+
+	uk_mutex_lock(&pc_lock);
+	uk_list_for_each_entry_safe(pg, next, &vp->v_pages, vnode_link) {
+		if (pg->off >= length) {
+			pc_free_locked(pg);
+			continue;
+		}
+		if (pg->off + (off_t)pg->valid <= length)
+			continue;
+
+		valid = length - pg->off;
+		pc_set_valid(pg, valid);
+		if (pc_is_dirty(pg)) {
+			pg->dirty_end = MIN(pg->dirty_end, valid);
+			if (pg->dirty_start >= pg->dirty_end) {
+				pg->dirty_start = 0;
+				pg->dirty_end = 0;
+				uk_list_del(&pg->dirty_link);
+				vp->v_ndirty--;
+			}
+		}
+	}
+	uk_mutex_unlock(&pc_lock);
+}
+
+unsigned long vfscore_pcache_reclaim(unsigned long npages)
+{
+	unsigned long evicted;
+
+	uk_mutex_lock(&pc_lock);
+	evicted = pc_evict_locked(npages);
+	uk_mutex_unlock(&pc_lock);
+
+	return evicted;
+}
+
+void vfscore_pcache_release(struct vnode *vp)
+{
+	struct pc_page *pg, *next;
+
+	if (!vp->v_pcops)
+		return;
+
+	if (vfscore_pcache_flush(vp))
+		uk_pr_warn("Dropping unwritten cached data of inode %lu\n",
+			   (unsigned long)vp->v_ino);
+
+	uk_mutex_lock(&pc_lock);
+	uk_list_for_each_entry_safe(pg, next, &vp->v_pages, vnode_link)
+		pc_free_locked(pg);
+	uk_mutex_unlock(&pc_lock);
+
+	vp->v_pcops = NULL;
+}
@@ -31,6 +31,8 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#define _GNU_SOURCE
+
 #include <uk/config.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -38,39 +40,88 @@
 #include <vfscore/file.h>
 #include <vfscore/fs.h>
 #include <vfscore/mount.h>
+#include <vfscore/uio.h>
 #include <vfscore/vnode.h>
+#include <uk/arch/limits.h>
+#include <uk/alloc.h>
+#include <uk/refcount.h>
 #include <uk/wait.h>
 #include <uk/syscall.h>
 #include <sys/ioctl.h>
-#include <uk/syscall.h>
+#include <fcntl.h>
+#include "vfs.h"
 
-/* We use the default size in Linux kernel */
-#define PIPE_MAX_SIZE	(1 << CONFIG_LIBVFSCORE_PIPE_SIZE_ORDER)
+/*
+ * Pipe data is kept in pages that are referenced from a ring of slots.
+ * splice() and tee() between pipes move or share these references instead
+ * of copying the data.
+ */
+#define PIPE_PAGE_SIZE	__PAGE_SIZE
 
-struct pipe_buf {
-	/* The buffer */
+/* The default size in Linux kernel. Pipes that were not sized with
+ * F_SETPIPE_SZ grow up to PIPE_MAX_SIZE while the reader lags behind.
+ */
+#define PIPE_DEF_SIZE	(1UL << CONFIG_LIBVFSCORE_PIPE_SIZE_ORDER)
+#define PIPE_MAX_SIZE	(1UL << CONFIG_LIBVFSCORE_PIPE_MAX_SIZE_ORDER)
+
+/* Maximum number of slots that are spliced with one file operation */
+#define PIPE_SPLICE_IOV	16
+
+struct pipe_page {
+	/* Number of slots that reference the page */
+	__atomic refcnt;
+	/* One page from the page allocator */
 	char *data;
-	/* The buffer capacity, always a power of 2 */
-	unsigned long capacity;
-	/* Producer index */
-	unsigned long prod;
-	/* Consumer index */
-	unsigned long cons;
-
-	/* Read lock */
-	struct uk_mutex rdlock;
-	/* Write lock */
-	struct uk_mutex wrlock;
+};
+
+struct pipe_slot {
+	struct pipe_page *page;
+	/* Data of the slot within the page */
+	unsigned int off;
+	unsigned int len;
+};
 
+struct pipe_buf {
+	/* The slots, nr_slots is always a power of 2 */
+	struct pipe_slot *slots;
+	unsigned int nr_slots;
+	/* Producer slot index */
+	unsigned int head;
+	/* Consumer slot index */
+	unsigned int tail;
+	/* Number of bytes in the slots */
+	unsigned long bytes;
+	/* Free space in the page of the last slot, as of the last change of
+	 * the slots (see pipe_buf_update_tail_room())
+	 */
+	unsigned int tail_room;
+	/* The size was set with F_SETPIPE_SZ, do not grow */
+	bool size_fixed;
+	/* Released page that is reused by the next write */
+	struct pipe_page *spare;
+	/* A splice from or to a file is doing I/O without the lock on the
+	 * data at the front (rd_busy) or on pages that it will add to the
+	 * end (wr_busy). Other readers or writers wait until it is done.
+	 */
+	bool rd_busy;
+	bool wr_busy;
+
+	/* Protects the buffer */
+	struct uk_mutex lock;
+
+	/* Number of threads that wait on the readers and writers queue.
+	 * A peer is only woken up if it actually waits, i.e., on the
+	 * empty-to-non-empty and full-to-non-full transitions.
+	 */
+	unsigned int rd_waiting;
+	unsigned int wr_waiting;
 	/* Readers queue */
 	struct uk_waitq rdwq;
 	/* Writers queue */
 	struct uk_waitq wrwq;
 };
 
-#define PIPE_BUF_IDX(buf, n)    ((n) & ((buf)->capacity - 1))
-#define PIPE_BUF_PROD_IDX(buf)  PIPE_BUF_IDX((buf), (buf)->prod)
-#define PIPE_BUF_CONS_IDX(buf)  PIPE_BUF_IDX((buf), (buf)->cons)
+#define PIPE_BUF_SLOT(buf, n)	(&(buf)->slots[(n) & ((buf)->nr_slots - 1)])
 
 struct pipe_file {
 	/* Pipe buffer */
@@ -83,145 +134,336 @@ struct pipe_file {
 	int flags;
 };
 
+static unsigned int pipe_size_to_slots(unsigned long size)
+{
+	unsigned int nr_slots = 1;
+
+	while ((unsigned long) nr_slots * PIPE_PAGE_SIZE < size)
+		nr_slots <<= 1;
+	return nr_slots;
+}
 
-static struct pipe_buf *pipe_buf_alloc(int capacity)
+static struct pipe_buf *pipe_buf_alloc(unsigned long size)
 {
 	struct pipe_buf *pipe_buf;
 
-	UK_ASSERT(POWER_OF_2(capacity));
-
 	pipe_buf = malloc(sizeof(*pipe_buf));
 	if (!pipe_buf)
 		return NULL;
 
-	pipe_buf->data = malloc(capacity);
-	if (!pipe_buf->data) {
+	pipe_buf->nr_slots = pipe_size_to_slots(size);
+	pipe_buf->slots = calloc(pipe_buf->nr_slots, sizeof(struct pipe_slot));
+	if (!pipe_buf->slots) {
 		free(pipe_buf);
 		return NULL;
 	}
 
-	pipe_buf->capacity = capacity;
-	pipe_buf->cons = 0;
-	pipe_buf->prod = 0;
-	uk_mutex_init(&pipe_buf->rdlock);
-	uk_mutex_init(&pipe_buf->wrlock);
+	pipe_buf->head = 0;
+	pipe_buf->tail = 0;
+	pipe_buf->bytes = 0;
+	pipe_buf->tail_room = 0;
+	pipe_buf->size_fixed = false;
+	pipe_buf->spare = NULL;
+	pipe_buf->rd_busy = false;
+	pipe_buf->wr_busy = false;
+	uk_mutex_init(&pipe_buf->lock);
+	pipe_buf->rd_waiting = 0;
+	pipe_buf->wr_waiting = 0;
 	uk_waitq_init(&pipe_buf->rdwq);
 	uk_waitq_init(&pipe_buf->wrwq);
 
 	return pipe_buf;
 }
 
+static struct pipe_page *pipe_page_alloc(struct pipe_buf *pipe_buf)
+{
+	struct pipe_page *page;
+
+	if (pipe_buf->spare) {
+		page = pipe_buf->spare;
+		pipe_buf->spare = NULL;
+	} else {
+		page = malloc(sizeof(*page));
+		if (!page)
+			return NULL;
+		page->data = uk_palloc(uk_alloc_get_default(), 1);
+		if (!page->data) {
+			free(page);
+			return NULL;
+		}
+	}
+	uk_refcount_init(&page->refcnt, 1);
+	return page;
+}
+
+static void pipe_page_free(struct pipe_page *page)
+{
+	uk_pfree(uk_alloc_get_default(), page->data, 1);
+	free(page);
+}
+
+/* Drops a reference to a page, the last one keeps it as spare page */
+static void pipe_page_put(struct pipe_buf *pipe_buf, struct pipe_page *page)
+{
+	if (!uk_refcount_release(&page->refcnt))
+		return;
+	if (!pipe_buf->spare)
+		pipe_buf->spare = page;
+	else
+		pipe_page_free(page);
+}
+
 void pipe_buf_free(struct pipe_buf *pipe_buf)
 {
-	free(pipe_buf->data);
+	while (pipe_buf->tail != pipe_buf->head)
+		pipe_page_put(pipe_buf,
+			      PIPE_BUF_SLOT(pipe_buf, pipe_buf->tail++)->page);
+	if (pipe_buf->spare)
+		pipe_page_free(pipe_buf->spare);
+	free(pipe_buf->slots);
 	free(pipe_buf);
 }
 
-static unsigned long pipe_buf_get_available(const struct pipe_buf *pipe_buf)
+static unsigned int pipe_buf_get_used_slots(const struct pipe_buf *pipe_buf)
+{
+	return pipe_buf->head - pipe_buf->tail;
+}
+
+static int pipe_buf_has_free_slot(const struct pipe_buf *pipe_buf)
 {
-	return pipe_buf->prod - pipe_buf->cons;
+	return pipe_buf_get_used_slots(pipe_buf) < pipe_buf->nr_slots;
+}
+
+/* Free space in the page of the last slot. Pages that are shared with
+ * another pipe are never appended to.
+ */
+static unsigned long pipe_buf_get_tail_room(struct pipe_buf *pipe_buf)
+{
+	struct pipe_slot *slot;
+
+	if (!pipe_buf_get_used_slots(pipe_buf))
+		return 0;
+
+	slot = PIPE_BUF_SLOT(pipe_buf, pipe_buf->head - 1);
+	if (ukarch_load_n(&slot->page->refcnt.counter) != 1)
+		return 0;
+	return PIPE_PAGE_SIZE - (slot->off + slot->len);
 }
 
-static unsigned long pipe_buf_get_free_space(struct pipe_buf *pipe_buf)
+/*
+ * Caches the free space in the last page, so that waiters can check for it
+ * without the lock: the slots and pages may be freed under their feet. The
+ * cache misses space that becomes usable when another pipe drops its
+ * reference to the last page, which only costs a new page.
+ */
+static void pipe_buf_update_tail_room(struct pipe_buf *pipe_buf)
 {
-	return pipe_buf->capacity - pipe_buf_get_available(pipe_buf);
+	pipe_buf->tail_room = pipe_buf_get_tail_room(pipe_buf);
 }
 
+/*
+ * The checks below are also evaluated by waiters without the buffer lock,
+ * so they must only read scalar fields of the buffer
+ */
 static int pipe_buf_can_write(struct pipe_buf *pipe_buf)
 {
-	return pipe_buf_get_free_space(pipe_buf) > 0;
+	return pipe_buf_has_free_slot(pipe_buf) || pipe_buf->tail_room > 0;
 }
 
 static int pipe_buf_can_read(struct pipe_buf *pipe_buf)
 {
-	return pipe_buf_get_available(pipe_buf) > 0;
+	return pipe_buf->bytes > 0;
 }
 
 static int pipe_file_can_read(struct pipe_file *pipe_file)
 {
-	return pipe_buf_can_read(pipe_file->buf) || !(pipe_file->w_refcount);
+	return !pipe_file->buf->rd_busy &&
+	       (pipe_buf_can_read(pipe_file->buf) || !(pipe_file->w_refcount));
 }
 
-static unsigned long pipe_buf_write(struct pipe_buf *pipe_buf,
-		struct iovec *iovec, size_t iovec_off)
+static int pipe_file_can_write(struct pipe_file *pipe_file, bool need_slot)
 {
-	unsigned long prod_idx, to_write;
-	void *iovec_data = iovec->iov_base + iovec_off;
-	size_t iov_len = iovec->iov_len - iovec_off;
+	return (!pipe_file->buf->wr_busy &&
+		(need_slot ? pipe_buf_has_free_slot(pipe_file->buf)
+			   : pipe_buf_can_write(pipe_file->buf))) ||
+	       !(pipe_file->r_refcount);
+}
 
-	prod_idx = PIPE_BUF_PROD_IDX(pipe_buf);
-	to_write = MIN(pipe_buf_get_free_space(pipe_buf), iov_len);
-	if (to_write == 0)
-		goto out;
+/* Moves the used slots to a new array of `nr_slots` slots */
+static int pipe_buf_resize(struct pipe_buf *pipe_buf, unsigned int nr_slots)
+{
+	struct pipe_slot *slots;
+	unsigned int used, i;
+
+	UK_ASSERT(POWER_OF_2(nr_slots));
+
+	used = pipe_buf_get_used_slots(pipe_buf);
+	if (used > nr_slots)
+		return EBUSY;
+
+	slots = calloc(nr_slots, sizeof(*slots));
+	if (!slots)
+		return ENOMEM;
+
+	for (i = 0; i < used; i++)
+		slots[i] = *PIPE_BUF_SLOT(pipe_buf, pipe_buf->tail + i);
+	free(pipe_buf->slots);
+	pipe_buf->slots = slots;
+	pipe_buf->nr_slots = nr_slots;
+	pipe_buf->tail = 0;
+	pipe_buf->head = used;
+	return 0;
+}
 
-	/* Copy in one piece */
-	if (prod_idx + to_write <= pipe_buf->capacity)
-		memcpy(pipe_buf->data + prod_idx, iovec_data, to_write);
+static void pipe_buf_wake_readers(struct pipe_buf *pipe_buf)
+{
+	if (pipe_buf->rd_waiting)
+		uk_waitq_wake_up(&pipe_buf->rdwq);
+}
 
-	else {
-		int first_copy_bytes, second_copy_bytes;
+static void pipe_buf_wake_writers(struct pipe_buf *pipe_buf)
+{
+	if (pipe_buf->wr_waiting)
+		uk_waitq_wake_up(&pipe_buf->wrwq);
+}
 
-		/* Copy the first part */
-		first_copy_bytes = pipe_buf->capacity - prod_idx;
-		memcpy(pipe_buf->data + prod_idx,
-				iovec_data,
-				first_copy_bytes);
+/* Copies from `uio` into the pipe until it is full */
+static unsigned long pipe_buf_write(struct pipe_buf *pipe_buf,
+		struct uio *uio)
+{
+	unsigned long written = 0, to_write;
+	struct pipe_slot *slot;
+	struct pipe_page *page;
+
+	while (uio->uio_resid > 0) {
+		to_write = pipe_buf_get_tail_room(pipe_buf);
+		if (to_write == 0) {
+			if (!pipe_buf_has_free_slot(pipe_buf))
+				break;
+			page = pipe_page_alloc(pipe_buf);
+			if (!page)
+				break;
+			slot = PIPE_BUF_SLOT(pipe_buf, pipe_buf->head++);
+			slot->page = page;
+			slot->off = 0;
+			slot->len = 0;
+			continue;
+		}
 
-		/* Copy the second part */
-		second_copy_bytes = prod_idx + to_write - pipe_buf->capacity;
-		memcpy(pipe_buf->data,
-				iovec_data + first_copy_bytes,
-				second_copy_bytes);
+		slot = PIPE_BUF_SLOT(pipe_buf, pipe_buf->head - 1);
+		to_write = MIN(to_write, (unsigned long) uio->uio_resid);
+		vfscore_uiomove(slot->page->data + slot->off + slot->len,
+				to_write, uio);
+		slot->len += to_write;
+		pipe_buf->bytes += to_write;
+		written += to_write;
 	}
+	pipe_buf_update_tail_room(pipe_buf);
 
-	/* Update producer */
-	pipe_buf->prod += to_write;
+	return written;
+}
 
-out:
-	return to_write;
+/* Releases `len` bytes from the front of the pipe */
+static void pipe_buf_consume(struct pipe_buf *pipe_buf, unsigned long len)
+{
+	struct pipe_slot *slot;
+	unsigned long n;
+
+	UK_ASSERT(len <= pipe_buf->bytes);
+
+	while (len > 0) {
+		slot = PIPE_BUF_SLOT(pipe_buf, pipe_buf->tail);
+		n = MIN(len, (unsigned long) slot->len);
+		slot->off += n;
+		slot->len -= n;
+		pipe_buf->bytes -= n;
+		len -= n;
+		if (slot->len == 0) {
+			pipe_page_put(pipe_buf, slot->page);
+			pipe_buf->tail++;
+		}
+	}
+	pipe_buf_update_tail_room(pipe_buf);
 }
 
+/* Copies from the pipe to `uio` until it is empty */
 static unsigned long pipe_buf_read(struct pipe_buf *pipe_buf,
-		struct iovec *iovec, size_t iovec_off)
+		struct uio *uio)
 {
-	unsigned long cons_idx, to_read;
-	void *iovec_data = iovec->iov_base + iovec_off;
-	size_t iov_len = iovec->iov_len - iovec_off;
-
-	cons_idx = PIPE_BUF_CONS_IDX(pipe_buf);
-	to_read = MIN(pipe_buf_get_available(pipe_buf), iov_len);
-	if (to_read == 0)
-		goto out;
-
-	/* Copy in one piece */
-	if (cons_idx + to_read <= pipe_buf->capacity)
-		memcpy(iovec_data, pipe_buf->data + cons_idx, to_read);
-
-	else {
-		int first_copy_bytes;
-		int second_copy_bytes;
+	unsigned long read = 0, to_read;
+	struct pipe_slot *slot;
+
+	while (uio->uio_resid > 0 && pipe_buf->bytes > 0) {
+		slot = PIPE_BUF_SLOT(pipe_buf, pipe_buf->tail);
+		to_read = MIN((unsigned long) slot->len,
+			      (unsigned long) uio->uio_resid);
+		vfscore_uiomove(slot->page->data + slot->off, to_read, uio);
+		pipe_buf_consume(pipe_buf, to_read);
+		read += to_read;
+	}
 
-		/* Copy the first part */
-		first_copy_bytes = pipe_buf->capacity - pipe_buf->cons;
-		memcpy(iovec_data,
-				pipe_buf->data + cons_idx,
-				first_copy_bytes);
+	return read;
+}
 
-		/* Copy the second part */
-		second_copy_bytes = cons_idx + to_read - pipe_buf->capacity;
-		memcpy(iovec_data + first_copy_bytes,
-				pipe_buf->data,
-				second_copy_bytes);
+/* Fills `iov` with the data at the front of the pipe, up to `len` bytes */
+static int pipe_buf_get_iov(struct pipe_buf *pipe_buf, struct iovec *iov,
+		int iovcnt, size_t len)
+{
+	struct pipe_slot *slot;
+	unsigned int idx = pipe_buf->tail;
+	int n = 0;
+
+	while (n < iovcnt && len > 0 && idx != pipe_buf->head) {
+		slot = PIPE_BUF_SLOT(pipe_buf, idx++);
+		iov[n].iov_base = slot->page->data + slot->off;
+		iov[n].iov_len = MIN(len, (size_t) slot->len);
+		len -= iov[n].iov_len;
+		n++;
 	}
+	return n;
+}
 
-	/* Update consumer */
-	pipe_buf->cons += to_read;
+/*
+ * Moves (`move`) or shares up to `len` bytes from the front of `in` to the
+ * end of `out` by page reference.
+ */
+static unsigned long pipe_buf_splice(struct pipe_buf *in,
+		struct pipe_buf *out, size_t len, bool move)
+{
+	struct pipe_slot *src, *dst;
+	unsigned int idx = in->tail;
+	unsigned long spliced = 0;
+
+	while (len > 0 && idx != in->head && pipe_buf_has_free_slot(out)) {
+		src = PIPE_BUF_SLOT(in, idx);
+		dst = PIPE_BUF_SLOT(out, out->head++);
+		*dst = *src;
+		dst->len = MIN(len, (size_t) src->len);
+		out->bytes += dst->len;
+		spliced += dst->len;
+		len -= dst->len;
+
+		if (move && dst->len == src->len) {
+			/* Hand over the reference of the whole slot */
+			in->bytes -= src->len;
+			in->tail++;
+		} else {
+			uk_refcount_acquire(&src->page->refcnt);
+			if (move)
+				pipe_buf_consume(in, dst->len);
+		}
+		if (move)
+			idx = in->tail;
+		else
+			idx++;
+	}
+	pipe_buf_update_tail_room(in);
+	pipe_buf_update_tail_room(out);
 
-out:
-	return to_read;
+	return spliced;
 }
 
-struct pipe_file *pipe_file_alloc(int capacity, int flags)
+struct pipe_file *pipe_file_alloc(unsigned long size, int flags)
 {
 	struct pipe_file *pipe_file;
 
@@ -229,7 +471,7 @@ struct pipe_file *pipe_file_alloc(int capacity, int flags)
 	if (!pipe_file)
 		return NULL;
 
-	pipe_file->buf = pipe_buf_alloc(capacity);
+	pipe_file->buf = pipe_buf_alloc(size);
 	if (!pipe_file->buf) {
 		free(pipe_file);
 		return NULL;
@@ -248,140 +490,148 @@ void pipe_file_free(struct pipe_file *pipe_file)
 	free(pipe_file);
 }
 
-static int pipe_write(struct vnode *vnode,
-		struct uio *buf, int ioflag __unused)
+/*
+ * Waits until the pipe has data or no writers anymore (the caller finds it
+ * empty then), and no splice is reading its data. Called and returns with
+ * the buffer lock held.
+ */
+static int pipe_file_wait_read(struct pipe_file *pipe_file, bool nonblocking)
 {
-	struct pipe_file *pipe_file = vnode->v_data;
 	struct pipe_buf *pipe_buf = pipe_file->buf;
-	bool nonblocking = false; /* TODO handle nonblocking */
-	bool data_available = true;
-	int uio_idx = 0;
-
-	if (!pipe_file->r_refcount) {
-		/* TODO before returning the error, send a SIGPIPE signal */
-		return -EPIPE;
-	}
-
-	uk_mutex_lock(&pipe_buf->wrlock);
-	while (data_available && uio_idx < buf->uio_iovcnt) {
-		struct iovec *iovec = &buf->uio_iov[uio_idx];
-		unsigned long off = 0;
-
-		while (off < iovec->iov_len) {
-			unsigned long written_bytes;
-
-			written_bytes = pipe_buf_write(pipe_buf, iovec, off);
-			if (written_bytes == 0) {
-				/* No data */
-				if (nonblocking) {
-					data_available = false;
-					break;
-
-				} else {
-					/* Wait until data available */
-					while (!pipe_buf_can_write(pipe_buf)) {
-						uk_mutex_unlock(&pipe_buf->wrlock);
-						uk_waitq_wait_event(&pipe_buf->wrwq,
-							pipe_buf_can_write(pipe_buf));
-						uk_mutex_lock(&pipe_buf->wrlock);
-					}
-				}
-
-			} else {
-				/* Update bytes written_bytes. */
-				buf->uio_resid -= written_bytes;
-
-				off += written_bytes;
-
-				/* wake some readers */
-				uk_waitq_wake_up(&pipe_buf->rdwq);
-			}
-		}
 
-		uio_idx++;
-	}
-	uk_mutex_unlock(&pipe_buf->wrlock);
+	while (!pipe_file_can_read(pipe_file)) {
+		if (nonblocking)
+			return EAGAIN;
 
+		pipe_buf->rd_waiting++;
+		uk_mutex_unlock(&pipe_buf->lock);
+		uk_waitq_wait_event(&pipe_buf->rdwq,
+				    pipe_file_can_read(pipe_file));
+		uk_mutex_lock(&pipe_buf->lock);
+		pipe_buf->rd_waiting--;
+	}
 	return 0;
 }
 
-static int pipe_read(struct vnode *vnode,
-		struct vfscore_file *vfscore_file,
-		struct uio *buf, int ioflag __unused)
+/*
+ * Waits until data can be written to the pipe (`need_slot`: a whole slot
+ * is free) and no splice is filling pages for it. A full pipe grows
+ * instead as long as it is not larger than PIPE_MAX_SIZE. Called and
+ * returns with the buffer lock held.
+ */
+static int pipe_file_wait_write(struct pipe_file *pipe_file, bool nonblocking,
+		bool need_slot)
 {
-	struct pipe_file *pipe_file = vnode->v_data;
 	struct pipe_buf *pipe_buf = pipe_file->buf;
-	bool nonblocking = (vfscore_file->f_flags & O_NONBLOCK);
-	bool data_available = true;
-	int uio_idx = 0;
 
-	uk_mutex_lock(&pipe_buf->rdlock);
-	if (nonblocking && !pipe_buf_can_read(pipe_buf)) {
-		uk_mutex_unlock(&pipe_buf->rdlock);
-		return EAGAIN;
+	for (;;) {
+		if (!pipe_file->r_refcount) {
+			/* TODO before returning the error, send a SIGPIPE
+			 * signal
+			 */
+			return EPIPE;
+		}
+		if (pipe_file_can_write(pipe_file, need_slot))
+			return 0;
+
+		if (!pipe_buf->wr_busy && !pipe_buf->size_fixed &&
+		    pipe_buf->nr_slots < pipe_size_to_slots(PIPE_MAX_SIZE) &&
+		    !pipe_buf_resize(pipe_buf, pipe_buf->nr_slots << 1))
+			continue;
+
+		if (nonblocking)
+			return EAGAIN;
+
+		pipe_buf->wr_waiting++;
+		uk_mutex_unlock(&pipe_buf->lock);
+		uk_waitq_wait_event(&pipe_buf->wrwq,
+				    pipe_file_can_write(pipe_file, need_slot));
+		uk_mutex_lock(&pipe_buf->lock);
+		pipe_buf->wr_waiting--;
 	}
+}
 
-	while (data_available && uio_idx < buf->uio_iovcnt) {
-		struct iovec *iovec = &buf->uio_iov[uio_idx];
-		unsigned long off = 0;
-
-		while (off < iovec->iov_len) {
-			unsigned long read_bytes;
-
-			read_bytes = pipe_buf_read(pipe_buf, iovec, off);
-			if (read_bytes == 0) {
-				/* No data */
-				if (nonblocking) {
-					data_available = false;
-					break;
-
-				} else {
-					/* Wait until data available */
-					while (!pipe_buf_can_read(pipe_buf)) {
-						uk_mutex_unlock(&pipe_buf->rdlock);
-						uk_waitq_wait_event(&pipe_buf->rdwq,
-							pipe_file_can_read(pipe_file));
+static int pipe_file_write(struct pipe_file *pipe_file, struct uio *uio,
+		bool nonblocking)
+{
+	struct pipe_buf *pipe_buf = pipe_file->buf;
+	unsigned long total = 0, written;
+	int error = 0;
+
+	uk_mutex_lock(&pipe_buf->lock);
+	while (uio->uio_resid > 0) {
+		error = pipe_file_wait_write(pipe_file, nonblocking, false);
+		if (error)
+			break;
+
+		written = pipe_buf_write(pipe_buf, uio);
+		if (written == 0) {
+			/* No page available */
+			error = ENOMEM;
+			break;
+		}
+		total += written;
+		pipe_buf_wake_readers(pipe_buf);
+	}
+	uk_mutex_unlock(&pipe_buf->lock);
 
-						if (!pipe_file->w_refcount)
-							return 0;
+	/* Report a partial write */
+	return total ? 0 : error;
+}
 
-						uk_mutex_lock(&pipe_buf->rdlock);
-					}
-				}
+static int pipe_file_read(struct pipe_file *pipe_file, struct uio *uio,
+		bool nonblocking)
+{
+	struct pipe_buf *pipe_buf = pipe_file->buf;
+	int error;
 
-			} else {
-				/* Update bytes read */
-				buf->uio_resid -= read_bytes;
+	uk_mutex_lock(&pipe_buf->lock);
+	error = pipe_file_wait_read(pipe_file, nonblocking);
+	if (!error && pipe_buf_read(pipe_buf, uio))
+		pipe_buf_wake_writers(pipe_buf);
+	uk_mutex_unlock(&pipe_buf->lock);
 
-				off += read_bytes;
+	return error;
+}
 
-				/* wake some writers */
-				uk_waitq_wake_up(&pipe_buf->wrwq);
+static int pipe_write(struct vnode *vnode,
+		struct uio *buf, int ioflag)
+{
+	bool nonblocking = (ioflag & IO_NDELAY);
 
-				break;
-			}
-		}
+	return pipe_file_write(vnode->v_data, buf, nonblocking);
+}
 
-		uio_idx++;
-	}
-	uk_mutex_unlock(&pipe_buf->rdlock);
+static int pipe_read(struct vnode *vnode,
+		struct vfscore_file *vfscore_file,
+		struct uio *buf, int ioflag __unused)
+{
+	bool nonblocking = (vfscore_file->f_flags & O_NONBLOCK);
 
-	return 0;
+	return pipe_file_read(vnode->v_data, buf, nonblocking);
 }
 
 static int pipe_close(struct vnode *vnode,
 		struct vfscore_file *vfscore_file)
 {
 	struct pipe_file *pipe_file = vnode->v_data;
+	struct pipe_buf *pipe_buf = pipe_file->buf;
 
 	UK_ASSERT(vfscore_file->f_dentry->d_vnode == vnode);
 	UK_ASSERT(vnode->v_refcnt == 1);
 
-	if (vfscore_file->f_flags & UK_FREAD)
+	uk_mutex_lock(&pipe_buf->lock);
+	/* Readers see the end of file, writers a broken pipe */
+	if (vfscore_file->f_flags & UK_FREAD) {
 		pipe_file->r_refcount--;
+		pipe_buf_wake_writers(pipe_buf);
+	}
 
-	if (vfscore_file->f_flags & UK_FWRITE)
+	if (vfscore_file->f_flags & UK_FWRITE) {
 		pipe_file->w_refcount--;
+		pipe_buf_wake_readers(pipe_buf);
+	}
+	uk_mutex_unlock(&pipe_buf->lock);
 
 	if (!pipe_file->r_refcount && !pipe_file->w_refcount)
 		pipe_file_free(pipe_file);
@@ -397,22 +647,58 @@ static int pipe_seek(struct vnode *vnode __unused,
 	return -1;
 }
 
+static int pipe_set_size(struct pipe_buf *pipe_buf, int *size)
+{
+	unsigned int nr_slots;
+	int error;
+
+	if (*size < 0 || (unsigned long) *size > PIPE_MAX_SIZE)
+		return EPERM;
+	/* A splice relies on the slots that it found free */
+	if (pipe_buf->wr_busy)
+		return EBUSY;
+
+	nr_slots = pipe_size_to_slots(*size);
+	if (nr_slots != pipe_buf->nr_slots) {
+		error = pipe_buf_resize(pipe_buf, nr_slots);
+		if (error)
+			return error;
+	}
+	pipe_buf->size_fixed = true;
+	*size = nr_slots * PIPE_PAGE_SIZE;
+
+	/* A smaller pipe may still have room */
+	pipe_buf_wake_writers(pipe_buf);
+	return 0;
+}
+
 static int pipe_ioctl(struct vnode *vnode,
 		struct vfscore_file *vfscore_file __unused,
 		unsigned long com, void *data)
 {
 	struct pipe_file *pipe_file = vnode->v_data;
 	struct pipe_buf *pipe_buf = pipe_file->buf;
+	int error = 0;
 
+	uk_mutex_lock(&pipe_buf->lock);
 	switch (com) {
 	case FIONREAD:
-		uk_mutex_lock(&pipe_buf->rdlock);
-		*((int *) data) = pipe_buf_get_available(pipe_buf);
-		uk_mutex_unlock(&pipe_buf->rdlock);
-		return 0;
+		*((int *) data) = pipe_buf->bytes;
+		break;
+	/* Forwarded by fcntl() */
+	case F_GETPIPE_SZ:
+		*((int *) data) = pipe_buf->nr_slots * PIPE_PAGE_SIZE;
+		break;
+	case F_SETPIPE_SZ:
+		error = pipe_set_size(pipe_buf, (int *) data);
+		break;
 	default:
-		return -EINVAL;
+		error = EINVAL;
+		break;
 	}
+	uk_mutex_unlock(&pipe_buf->lock);
+
+	return error;
 }
 
 #define pipe_open        ((vnop_open_t) vfscore_vop_einval)
@@ -555,7 +841,7 @@ UK_SYSCALL_R_DEFINE(int, pipe, int*, pipefd)
 	struct pipe_file *pipe_file;
 
 	/* Allocate pipe internal structure. */
-	pipe_file = pipe_file_alloc(PIPE_MAX_SIZE, 0);
+	pipe_file = pipe_file_alloc(PIPE_DEF_SIZE, 0);
 	if (!pipe_file) {
 		ret = -ENOMEM;
 		goto ERR_EXIT;
@@ -611,3 +897,405 @@ int mkfifo(const char *path __unused, mode_t mode __unused)
 	errno = ENOTSUP;
 	return -1;
 }
+
+static struct pipe_file *pipe_file_get(struct vfscore_file *fp)
+{
+	struct vnode *vnode = fp->f_dentry->d_vnode;
+
+	if (vnode->v_op != &pipe_vnops)
+		return NULL;
+	return vnode->v_data;
+}
+
+static bool pipe_nonblocking(struct vfscore_file *fp, unsigned int flags)
+{
+	return (flags & SPLICE_F_NONBLOCK) || (fp->f_flags & O_NONBLOCK);
+}
+
+/*
+ * Moves (splice) or shares (tee) page references from one pipe to another.
+ * The pipes are locked one at a time while waiting and both in address
+ * order while the references are transferred.
+ */
+static ssize_t pipe_to_pipe(struct pipe_file *in, struct pipe_file *out,
+		size_t len, bool nonblocking, bool move)
+{
+	struct pipe_buf *first, *second;
+	unsigned long spliced;
+	int error;
+
+	if (in == out)
+		return -EINVAL;
+
+	for (;;) {
+		uk_mutex_lock(&in->buf->lock);
+		error = pipe_file_wait_read(in, nonblocking);
+		uk_mutex_unlock(&in->buf->lock);
+		if (error)
+			return -error;
+
+		uk_mutex_lock(&out->buf->lock);
+		error = pipe_file_wait_write(out, nonblocking, true);
+		uk_mutex_unlock(&out->buf->lock);
+		if (error)
+			return -error;
+
+		first = (in->buf < out->buf) ? in->buf : out->buf;
+		second = (in->buf < out->buf) ? out->buf : in->buf;
+		uk_mutex_lock(&first->lock);
+		uk_mutex_lock(&second->lock);
+		if (in->buf->rd_busy || out->buf->wr_busy) {
+			/* A splice from or to a file got in between */
+			uk_mutex_unlock(&second->lock);
+			uk_mutex_unlock(&first->lock);
+			continue;
+		}
+		if (!pipe_buf_can_read(in->buf) && !in->w_refcount) {
+			/* End of file */
+			spliced = 0;
+			break;
+		}
+		spliced = pipe_buf_splice(in->buf, out->buf, len, move);
+		if (spliced)
+			break;
+		if (!out->r_refcount) {
+			uk_mutex_unlock(&second->lock);
+			uk_mutex_unlock(&first->lock);
+			return -EPIPE;
+		}
+		/* A peer raced us, try again */
+		uk_mutex_unlock(&second->lock);
+		uk_mutex_unlock(&first->lock);
+	}
+
+	if (spliced) {
+		pipe_buf_wake_readers(out->buf);
+		if (move)
+			pipe_buf_wake_writers(in->buf);
+	}
+	uk_mutex_unlock(&second->lock);
+	uk_mutex_unlock(&first->lock);
+
+	return spliced;
+}
+
+/*
+ * Writes the data at the front of the pipe to a file or socket straight
+ * from the pipe pages. The data is reserved with rd_busy, so that the
+ * write is done without the buffer lock.
+ */
+static ssize_t pipe_to_file(struct pipe_file *in, struct vfscore_file *out,
+		off_t *off_out, size_t len, bool nonblocking)
+{
+	struct pipe_buf *pipe_buf = in->buf;
+	struct iovec iov[PIPE_SPLICE_IOV];
+	size_t count = 0;
+	off_t offset = -1;
+	int iovcnt;
+	int error;
+
+	if (off_out) {
+		if (out->f_vfs_flags & UK_VFSCORE_NOPOS)
+			return -ESPIPE;
+		if (*off_out < 0)
+			return -EINVAL;
+		offset = *off_out;
+	}
+
+	uk_mutex_lock(&pipe_buf->lock);
+	error = pipe_file_wait_read(in, nonblocking);
+	if (error)
+		goto out;
+
+	iovcnt = pipe_buf_get_iov(pipe_buf, iov, PIPE_SPLICE_IOV, len);
+	if (iovcnt == 0)
+		goto out; /* End of file */
+
+	pipe_buf->rd_busy = true;
+	uk_mutex_unlock(&pipe_buf->lock);
+	error = sys_write(out, iov, iovcnt, offset, &count);
+	uk_mutex_lock(&pipe_buf->lock);
+	pipe_buf->rd_busy = false;
+
+	if (count) {
+		/* Report a partial write */
+		error = 0;
+		pipe_buf_consume(pipe_buf, count);
+		pipe_buf_wake_writers(pipe_buf);
+		if (off_out)
+			*off_out += count;
+	}
+	/* Let the readers that waited for us in */
+	pipe_buf_wake_readers(pipe_buf);
+
+out:
+	uk_mutex_unlock(&pipe_buf->lock);
+	return error ? -error : (ssize_t) count;
+}
+
+/*
+ * Reads from a file or socket straight into new pipe pages. The free slots
+ * are reserved with wr_busy, so that the read is done without the buffer
+ * lock.
+ */
+static ssize_t file_to_pipe(struct vfscore_file *in, off_t *off_in,
+		struct pipe_file *out, size_t len, bool nonblocking)
+{
+	struct pipe_buf *pipe_buf = out->buf;
+	struct iovec iov[PIPE_SPLICE_IOV];
+	struct pipe_page *pages[PIPE_SPLICE_IOV];
+	struct pipe_slot *slot;
+	size_t count = 0, n;
+	off_t offset = -1;
+	int iovcnt = 0;
+	int error;
+	int i;
+
+	if (off_in) {
+		if (in->f_vfs_flags & UK_VFSCORE_NOPOS)
+			return -ESPIPE;
+		if (*off_in < 0)
+			return -EINVAL;
+		offset = *off_in;
+	}
+
+	uk_mutex_lock(&pipe_buf->lock);
+	error = pipe_file_wait_write(out, nonblocking, true);
+	if (error)
+		goto out;
+
+	/* Allocate a page for every slot to fill */
+	while (iovcnt < PIPE_SPLICE_IOV && len > 0 &&
+	       pipe_buf_get_used_slots(pipe_buf) + iovcnt <
+	       pipe_buf->nr_slots) {
+		pages[iovcnt] = pipe_page_alloc(pipe_buf);
+		if (!pages[iovcnt])
+			break;
+		iov[iovcnt].iov_base = pages[iovcnt]->data;
+		iov[iovcnt].iov_len = MIN(len, (size_t) PIPE_PAGE_SIZE);
+		len -= iov[iovcnt].iov_len;
+		iovcnt++;
+	}
+	if (iovcnt == 0) {
+		error = ENOMEM;
+		goto out;
+	}
+
+	pipe_buf->wr_busy = true;
+	uk_mutex_unlock(&pipe_buf->lock);
+	error = sys_read(in, iov, iovcnt, offset, &count);
+	uk_mutex_lock(&pipe_buf->lock);
+	pipe_buf->wr_busy = false;
+
+	if (count) {
+		/* Report a partial read */
+		error = 0;
+		if (off_in)
+			*off_in += count;
+	}
+
+	/* Publish the filled pages and return the others. Only readers ran
+	 * in the meantime, so the slots are still free.
+	 */
+	for (i = 0, n = count; i < iovcnt; i++) {
+		if (n == 0) {
+			pipe_page_put(pipe_buf, pages[i]);
+			continue;
+		}
+		UK_ASSERT(pipe_buf_has_free_slot(pipe_buf));
+		slot = PIPE_BUF_SLOT(pipe_buf, pipe_buf->head++);
+		slot->page = pages[i];
+		slot->off = 0;
+		slot->len = MIN(n, iov[i].iov_len);
+		pipe_buf->bytes += slot->len;
+		n -= slot->len;
+	}
+	pipe_buf_update_tail_room(pipe_buf);
+	if (count)
+		pipe_buf_wake_readers(pipe_buf);
+	/* Let the writers that waited for us in */
+	pipe_buf_wake_writers(pipe_buf);
+
+out:
+	uk_mutex_unlock(&pipe_buf->lock);
+	return error ? -error : (ssize_t) count;
+}
+
+UK_SYSCALL_R_DEFINE(ssize_t, splice, int, fd_in, off_t*, off_in,
+		    int, fd_out, off_t*, off_out, size_t, len,
+		    unsigned int, flags)
+{
+	struct vfscore_file *fp_in, *fp_out;
+	struct pipe_file *pipe_in, *pipe_out;
+	ssize_t ret;
+	int error;
+
+	error = fget(fd_in, &fp_in);
+	if (error)
+		return -error;
+	error = fget(fd_out, &fp_out);
+	if (error) {
+		ret = -error;
+		goto out_fdrop_in;
+	}
+
+	if (!(fp_in->f_flags & UK_FREAD) || !(fp_out->f_flags & UK_FWRITE)) {
+		ret = -EBADF;
+		goto out_fdrop;
+	}
+	if (len == 0) {
+		ret = 0;
+		goto out_fdrop;
+	}
+
+	pipe_in = pipe_file_get(fp_in);
+	pipe_out = pipe_file_get(fp_out);
+	if (pipe_in && pipe_out) {
+		if (off_in || off_out)
+			ret = -ESPIPE;
+		else
+			ret = pipe_to_pipe(pipe_in, pipe_out, len,
+					   pipe_nonblocking(fp_in, flags) ||
+					   pipe_nonblocking(fp_out, flags),
+					   true);
+	} else if (pipe_in) {
+		if (off_in)
+			ret = -ESPIPE;
+		else
+			ret = pipe_to_file(pipe_in, fp_out, off_out, len,
+					   pipe_nonblocking(fp_in, flags));
+	} else if (pipe_out) {
+		if (off_out)
+			ret = -ESPIPE;
+		else
+			ret = file_to_pipe(fp_in, off_in, pipe_out, len,
+					   pipe_nonblocking(fp_out, flags));
+	} else {
+		/* One of the descriptors has to refer to a pipe */
+		ret = -EINVAL;
+	}
+
+out_fdrop:
+	fdrop(fp_out);
+out_fdrop_in:
+	fdrop(fp_in);
+	return ret;
+}
+
+UK_SYSCALL_R_DEFINE(ssize_t, tee, int, fd_in, int, fd_out, size_t, len,
+		    unsigned int, flags)
+{
+	struct vfscore_file *fp_in, *fp_out;
+	struct pipe_file *pipe_in, *pipe_out;
+	ssize_t ret;
+	int error;
+
+	error = fget(fd_in, &fp_in);
+	if (error)
+		return -error;
+	error = fget(fd_out, &fp_out);
+	if (error) {
+		ret = -error;
+		goto out_fdrop_in;
+	}
+
+	if (!(fp_in->f_flags & UK_FREAD) || !(fp_out->f_flags & UK_FWRITE)) {
+		ret = -EBADF;
+		goto out_fdrop;
+	}
+
+	pipe_in = pipe_file_get(fp_in);
+	pipe_out = pipe_file_get(fp_out);
+	if (!pipe_in || !pipe_out) {
+		ret = -EINVAL;
+		goto out_fdrop;
+	}
+	if (len == 0) {
+		ret = 0;
+		goto out_fdrop;
+	}
+
+	ret = pipe_to_pipe(pipe_in, pipe_out, len,
+			   pipe_nonblocking(fp_in, flags) ||
+			   pipe_nonblocking(fp_out, flags),
+			   false);
+
+out_fdrop:
+	fdrop(fp_out);
+out_fdrop_in:
+	fdrop(fp_in);
+	return ret;
+}
+
+/*
+ * The pages of the caller cannot be pinned, so the data is copied like
+ * with readv()/writev() on the pipe.
+ */
+UK_SYSCALL_R_DEFINE(ssize_t, vmsplice, int, fd, const struct iovec*, iov,
+		    size_t, nr_segs, unsigned int, flags)
+{
+	struct vfscore_file *fp;
+	struct pipe_file *pipe_file;
+	struct iovec *copy_iov;
+	struct uio uio;
+	size_t bytes = 0;
+	ssize_t ret;
+	size_t i;
+	int error;
+
+	error = fget(fd, &fp);
+	if (error)
+		return -error;
+
+	pipe_file = pipe_file_get(fp);
+	if (!pipe_file) {
+		ret = -EBADF;
+		goto out_fdrop;
+	}
+
+	if (nr_segs > UIO_MAXIOV) {
+		ret = -EINVAL;
+		goto out_fdrop;
+	}
+	for (i = 0; i < nr_segs; i++) {
+		if (iov[i].iov_len > IOSIZE_MAX - bytes) {
+			ret = -EINVAL;
+			goto out_fdrop;
+		}
+		bytes += iov[i].iov_len;
+	}
+	if (bytes == 0) {
+		ret = 0;
+		goto out_fdrop;
+	}
+
+	/* The uio moves are advancing the vectors */
+	copy_iov = calloc(nr_segs, sizeof(*copy_iov));
+	if (!copy_iov) {
+		ret = -ENOMEM;
+		goto out_fdrop;
+	}
+	memcpy(copy_iov, iov, nr_segs * sizeof(*copy_iov));
+
+	uio.uio_iov = copy_iov;
+	uio.uio_iovcnt = nr_segs;
+	uio.uio_offset = 0;
+	uio.uio_resid = bytes;
+
+	/* The pipe end decides about the direction */
+	if (fp->f_flags & UK_FWRITE) {
+		uio.uio_rw = UIO_WRITE;
+		error = pipe_file_write(pipe_file, &uio,
+					pipe_nonblocking(fp, flags));
+	} else {
+		uio.uio_rw = UIO_READ;
+		error = pipe_file_read(pipe_file, &uio,
+				       pipe_nonblocking(fp, flags));
+	}
+	ret = error ? -error : (ssize_t) (bytes - uio.uio_resid);
+
+	free(copy_iov);
+out_fdrop:
+	fdrop(fp);
+	return ret;
+}
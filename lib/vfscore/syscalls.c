@@ -50,6 +50,7 @@
 #include <vfscore/prex.h>
 #include <vfscore/vnode.h>
 #include <vfscore/file.h>
+#include <vfscore/pagecache.h>
 
 #include "vfs.h"
 #include <vfscore/fs.h>
@@ -211,6 +212,7 @@ sys_open(char *path, int flags, mode_t mode, struct vfscore_file **fpp)
 		error = VOP_TRUNCATE(vp, 0);
 		if (error)
 			goto out_fp_free_unlock;
+		vfscore_pcache_truncate(vp, 0);
 	}
 
 	error = VOP_OPEN(vp, fp);
@@ -412,7 +414,9 @@ sys_fsync(struct vfscore_file *fp)
 
 	vp = fp->f_dentry->d_vnode;
 	vn_lock(vp);
-	error = VOP_FSYNC(vp, fp);
+	error = vfscore_pcache_flush(vp);
+	if (!error)
+		error = VOP_FSYNC(vp, fp);
 	vn_unlock(vp);
 	return error;
 }
@@ -1159,6 +1163,8 @@ sys_truncate(char *path, off_t length)
 
 	vn_lock(dp->d_vnode);
 	error = VOP_TRUNCATE(dp->d_vnode, length);
+	if (!error)
+		vfscore_pcache_truncate(dp->d_vnode, length);
 	vn_unlock(dp->d_vnode);
 
 	drele(dp);
@@ -1177,6 +1183,8 @@ sys_ftruncate(struct vfscore_file *fp, off_t length)
 	vp = fp->f_dentry->d_vnode;
 	vn_lock(vp);
 	error = VOP_TRUNCATE(vp, length);
+	if (!error)
+		vfscore_pcache_truncate(vp, length);
 	vn_unlock(vp);
 
 	return error;
@@ -0,0 +1,262 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <uk/config.h>
+#include <uk/test.h>
+#include <uk/syscall.h>
+#include <uk/arch/limits.h>
+#include <vfscore/uio.h>
+
+/* The raw system calls report errors as negative return values */
+UK_SYSCALL_R_PROTO(1, pipe);
+UK_SYSCALL_R_PROTO(1, close);
+UK_SYSCALL_R_PROTO(3, read);
+UK_SYSCALL_R_PROTO(3, write);
+UK_SYSCALL_R_PROTO(3, fcntl);
+UK_SYSCALL_R_PROTO(6, splice);
+UK_SYSCALL_R_PROTO(4, tee);
+UK_SYSCALL_R_PROTO(4, vmsplice);
+
+#define PIPE_DEF_SIZE	(1L << CONFIG_LIBVFSCORE_PIPE_SIZE_ORDER)
+#define PIPE_MAX_SIZE	(1L << CONFIG_LIBVFSCORE_PIPE_MAX_SIZE_ORDER)
+
+#define TEST_LEN	(2 * __PAGE_SIZE)
+
+static char wbuf[TEST_LEN];
+static char rbuf[TEST_LEN];
+
+static void fill(void)
+{
+	unsigned long i;
+
+	for (i = 0; i < TEST_LEN; i++)
+		wbuf[i] = (char)(i * 7);
+}
+
+static long pipe_write(int fd, const void *buf, long len)
+{
+	return uk_syscall_r_write(fd, (long)buf, len);
+}
+
+static long pipe_read(int fd, long len)
+{
+	return uk_syscall_r_read(fd, (long)rbuf, len);
+}
+
+static long pipe_splice(int in, int out, long len, unsigned int flags)
+{
+	return uk_syscall_r_splice(in, 0, out, 0, len, flags);
+}
+
+static void pipe_close(int *fds)
+{
+	uk_syscall_r_close(fds[0]);
+	uk_syscall_r_close(fds[1]);
+}
+
+UK_TESTCASE(vfscore_pipe, splice)
+{
+	int p[2], q[2];
+
+	fill();
+	UK_TEST_ASSERT(uk_syscall_r_pipe((long)p) == 0);
+	UK_TEST_ASSERT(uk_syscall_r_pipe((long)q) == 0);
+
+	/* Part of a slot */
+	UK_TEST_EXPECT_SNUM_EQ(pipe_write(p[1], wbuf, 100), 100);
+	UK_TEST_EXPECT_SNUM_EQ(pipe_splice(p[0], q[1], 30, 0), 30);
+	UK_TEST_EXPECT_SNUM_EQ(pipe_read(q[0], TEST_LEN), 30);
+	UK_TEST_EXPECT_ZERO(memcmp(rbuf, wbuf, 30));
+
+	/* The rest of the slot */
+	UK_TEST_EXPECT_SNUM_EQ(pipe_splice(p[0], q[1], TEST_LEN, 0), 70);
+	UK_TEST_EXPECT_SNUM_EQ(pipe_read(q[0], TEST_LEN), 70);
+	UK_TEST_EXPECT_ZERO(memcmp(rbuf, wbuf + 30, 70));
+
+	/* Whole slots across pages */
+	UK_TEST_EXPECT_SNUM_EQ(pipe_write(p[1], wbuf, TEST_LEN), TEST_LEN);
+	UK_TEST_EXPECT_SNUM_EQ(pipe_splice(p[0], q[1], TEST_LEN, 0),
+			       TEST_LEN);
+	UK_TEST_EXPECT_SNUM_EQ(pipe_read(q[0], TEST_LEN), TEST_LEN);
+	UK_TEST_EXPECT_ZERO(memcmp(rbuf, wbuf, TEST_LEN));
+
+	/* Appending to a page that was moved over */
+	UK_TEST_EXPECT_SNUM_EQ(pipe_write(p[1], wbuf, 10), 10);
+	UK_TEST_EXPECT_SNUM_EQ(pipe_splice(p[0], q[1], 10, 0), 10);
+	UK_TEST_EXPECT_SNUM_EQ(pipe_write(q[1], wbuf + 10, 10), 10);
+	UK_TEST_EXPECT_SNUM_EQ(pipe_read(q[0], TEST_LEN), 20);
+	UK_TEST_EXPECT_ZERO(memcmp(rbuf, wbuf, 20));
+
+	UK_TEST_EXPECT_SNUM_EQ(pipe_splice(p[0], p[1], 1, 0), -EINVAL);
+	UK_TEST_EXPECT_SNUM_EQ(pipe_splice(p[0], q[1], 1, SPLICE_F_NONBLOCK),
+			       -EAGAIN);
+	UK_TEST_EXPECT_SNUM_EQ(uk_syscall_r_splice(p[0], 0, q[1],
+						   (long)&(off_t){0}, 1, 0),
+			       -ESPIPE);
+
+	pipe_close(p);
+	pipe_close(q);
+}
+
+UK_TESTCASE(vfscore_pipe, tee)
+{
+	int p[2], q[2];
+
+	fill();
+	UK_TEST_ASSERT(uk_syscall_r_pipe((long)p) == 0);
+	UK_TEST_ASSERT(uk_syscall_r_pipe((long)q) == 0);
+
+	UK_TEST_EXPECT_SNUM_EQ(pipe_write(p[1], wbuf, 100), 100);
+	/* Part of a slot, then all of it */
+	UK_TEST_EXPECT_SNUM_EQ(uk_syscall_r_tee(p[0], q[1], 40, 0), 40);
+	UK_TEST_EXPECT_SNUM_EQ(uk_syscall_r_tee(p[0], q[1], TEST_LEN, 0),
+			       100);
+
+	/* Shared pages are not written to by either pipe */
+	UK_TEST_EXPECT_SNUM_EQ(pipe_write(p[1], wbuf + 100, 10), 10);
+	UK_TEST_EXPECT_SNUM_EQ(pipe_write(q[1], wbuf, 10), 10);
+
+	UK_TEST_EXPECT_SNUM_EQ(pipe_read(p[0], TEST_LEN), 110);
+	UK_TEST_EXPECT_ZERO(memcmp(rbuf, wbuf, 110));
+
+	UK_TEST_EXPECT_SNUM_EQ(pipe_read(q[0], TEST_LEN), 150);
+	UK_TEST_EXPECT_ZERO(memcmp(rbuf, wbuf, 40));
+	UK_TEST_EXPECT_ZERO(memcmp(rbuf + 40, wbuf, 100));
+	UK_TEST_EXPECT_ZERO(memcmp(rbuf + 140, wbuf, 10));
+
+	UK_TEST_EXPECT_SNUM_EQ(uk_syscall_r_tee(p[0], p[1], 1, 0), -EINVAL);
+
+	pipe_close(p);
+	pipe_close(q);
+}
+
+UK_TESTCASE(vfscore_pipe, close)
+{
+	int p[2], q[2];
+
+	fill();
+	UK_TEST_ASSERT(uk_syscall_r_pipe((long)p) == 0);
+	UK_TEST_ASSERT(uk_syscall_r_pipe((long)q) == 0);
+
+	/* Readers see the remaining data and then the end of file */
+	UK_TEST_EXPECT_SNUM_EQ(pipe_write(p[1], wbuf, 10), 10);
+	uk_syscall_r_close(p[1]);
+	UK_TEST_EXPECT_SNUM_EQ(pipe_read(p[0], TEST_LEN), 10);
+	UK_TEST_EXPECT_SNUM_EQ(pipe_read(p[0], TEST_LEN), 0);
+	UK_TEST_EXPECT_SNUM_EQ(pipe_splice(p[0], q[1], 1, 0), 0);
+	uk_syscall_r_close(p[0]);
+
+	/* Writers get a broken pipe */
+	uk_syscall_r_close(q[0]);
+	UK_TEST_EXPECT_SNUM_EQ(pipe_write(q[1], wbuf, 10), -EPIPE);
+	UK_TEST_ASSERT(uk_syscall_r_pipe((long)p) == 0);
+	UK_TEST_EXPECT_SNUM_EQ(pipe_write(p[1], wbuf, 10), 10);
+	UK_TEST_EXPECT_SNUM_EQ(pipe_splice(p[0], q[1], 10, 0), -EPIPE);
+	uk_syscall_r_close(q[1]);
+
+	pipe_close(p);
+}
+
+UK_TESTCASE(vfscore_pipe, setpipe_sz)
+{
+	struct iovec iov;
+	int p[2];
+
+	fill();
+	UK_TEST_ASSERT(uk_syscall_r_pipe((long)p) == 0);
+
+	UK_TEST_EXPECT_SNUM_EQ(uk_syscall_r_fcntl(p[0], F_GETPIPE_SZ, 0),
+			       PIPE_DEF_SIZE);
+	UK_TEST_EXPECT_SNUM_EQ(uk_syscall_r_fcntl(p[1], F_SETPIPE_SZ,
+						  PIPE_MAX_SIZE + 1),
+			       -EPERM);
+
+	/* Sizes are rounded up to a power of 2 of pages */
+	UK_TEST_EXPECT_SNUM_EQ(uk_syscall_r_fcntl(p[1], F_SETPIPE_SZ,
+						  3 * __PAGE_SIZE),
+			       4 * __PAGE_SIZE);
+
+	/* The pipe cannot shrink below the pages that are in use */
+	UK_TEST_EXPECT_SNUM_EQ(pipe_write(p[1], wbuf, TEST_LEN), TEST_LEN);
+	UK_TEST_EXPECT_SNUM_EQ(uk_syscall_r_fcntl(p[1], F_SETPIPE_SZ,
+						  __PAGE_SIZE),
+			       -EBUSY);
+	UK_TEST_EXPECT_SNUM_EQ(uk_syscall_r_fcntl(p[1], F_GETPIPE_SZ, 0),
+			       4 * __PAGE_SIZE);
+	UK_TEST_EXPECT_SNUM_EQ(pipe_read(p[0], TEST_LEN), TEST_LEN);
+
+	/* A pipe with a fixed size does not grow */
+	UK_TEST_EXPECT_SNUM_EQ(uk_syscall_r_fcntl(p[1], F_SETPIPE_SZ,
+						  __PAGE_SIZE),
+			       __PAGE_SIZE);
+	iov.iov_base = wbuf;
+	iov.iov_len = TEST_LEN;
+	UK_TEST_EXPECT_SNUM_EQ(uk_syscall_r_vmsplice(p[1], (long)&iov, 1,
+						     SPLICE_F_NONBLOCK),
+			       __PAGE_SIZE);
+	UK_TEST_EXPECT_SNUM_EQ(uk_syscall_r_vmsplice(p[1], (long)&iov, 1,
+						     SPLICE_F_NONBLOCK),
+			       -EAGAIN);
+	UK_TEST_EXPECT_SNUM_EQ(uk_syscall_r_vmsplice(p[1], (long)&iov,
+						     UIO_MAXIOV + 1, 0),
+			       -EINVAL);
+
+	pipe_close(p);
+}
+
+/* Writes to a full pipe with O_NONBLOCK fail instead of blocking */
+UK_TESTCASE(vfscore_pipe, nonblock)
+{
+	int p[2];
+
+	fill();
+	UK_TEST_ASSERT(uk_syscall_r_pipe((long)p) == 0);
+	UK_TEST_EXPECT_SNUM_EQ(uk_syscall_r_fcntl(p[1], F_SETPIPE_SZ,
+						  __PAGE_SIZE),
+			       __PAGE_SIZE);
+	UK_TEST_EXPECT_ZERO(uk_syscall_r_fcntl(p[1], F_SETFL, O_NONBLOCK));
+
+	UK_TEST_EXPECT_SNUM_EQ(pipe_write(p[1], wbuf, TEST_LEN), __PAGE_SIZE);
+	UK_TEST_EXPECT_SNUM_EQ(pipe_write(p[1], wbuf, TEST_LEN), -EAGAIN);
+
+	UK_TEST_EXPECT_SNUM_EQ(pipe_read(p[0], TEST_LEN), __PAGE_SIZE);
+	UK_TEST_EXPECT_ZERO(memcmp(rbuf, wbuf, __PAGE_SIZE));
+
+	pipe_close(p);
+}
+
+uk_testsuite_register(vfscore_pipe, NULL);
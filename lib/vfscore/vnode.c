@@ -47,6 +47,7 @@
 #include <vfscore/prex.h>
 #include <vfscore/dentry.h>
 #include <vfscore/vnode.h>
+#include <vfscore/pagecache.h>
 #include "vfs.h"
 
 #define __UK_S_BLKSIZE 512
@@ -198,6 +199,8 @@ vfscore_vget(struct mount *mp, uint64_t ino, struct vnode **vpp)
 	}
 
 	UK_INIT_LIST_HEAD(&vp->v_names);
+	UK_INIT_LIST_HEAD(&vp->v_pages);
+	UK_INIT_LIST_HEAD(&vp->v_dirty);
 	vp->v_ino = ino;
 	vp->v_mount = mp;
 	vp->v_refcnt = 1;
@@ -243,8 +246,9 @@ vput(struct vnode *vp)
 	VNODE_UNLOCK();
 
 	/*
-	 * Deallocate fs specific vnode data
+	 * Write back and drop cached pages, deallocate fs specific vnode data
 	 */
+	vfscore_pcache_release(vp);
 	if (vp->v_op->vop_inactive)
 		VOP_INACTIVE(vp);
 	vfs_unbusy(vp->v_mount);
@@ -290,8 +294,9 @@ vrele(struct vnode *vp)
 	VNODE_UNLOCK();
 
 	/*
-	 * Deallocate fs specific vnode data
+	 * Write back and drop cached pages, deallocate fs specific vnode data
 	 */
+	vfscore_pcache_release(vp);
 	VOP_INACTIVE(vp);
 	vfs_unbusy(vp->v_mount);
 	free(vp);
@@ -325,6 +330,9 @@ vn_stat(struct vnode *vp, struct stat *st)
 
 	st->st_ino = (ino_t)vap->va_nodeid;
 	st->st_size = vap->va_size;
+	/* The backend does not know about data that is not written back */
+	if (vfscore_pcache_dirty(vp) && vp->v_size > st->st_size)
+		st->st_size = vp->v_size;
 	mode = vap->va_mode;
 	switch (vp->v_type) {
 	case VREG:
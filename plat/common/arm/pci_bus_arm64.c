@@ -61,6 +61,28 @@
 #define DEVFN(dev, fn)   ((dev << PCI_FN_BIT_NBR) | fn)
 #define SIZE_PER_PCI_DEV 0x20	/* legacy pci device size, no msi */
 
+uint32_t arch_pci_conf_read(const struct pci_address *addr, uint8_t offset)
+{
+	uint32_t val;
+
+	pci_generic_config_read(addr->bus, DEVFN(addr->devid, addr->function),
+				offset & ~0x3, 4, &val);
+	return val;
+}
+
+void arch_pci_conf_write(const struct pci_address *addr, uint8_t offset,
+			 uint32_t val)
+{
+	pci_generic_config_write(addr->bus, DEVFN(addr->devid, addr->function),
+				 offset & ~0x3, 4, val);
+}
+
+void *arch_pci_mmio_map(uint64_t paddr)
+{
+	/* MMIO is identity mapped */
+	return (void *)paddr;
+}
+
 static int arch_pci_driver_add_device(struct pci_driver *drv,
 					struct pci_address *addr,
 					struct pci_device_id *devid,
@@ -152,6 +152,11 @@ struct pci_device {
 
 	unsigned long base;
 	unsigned long irq;
+
+	/* Set up by pci_msix_enable() */
+	uint8_t msix_cap;	/**< Offset of the MSI-X capability */
+	uint16_t msix_size;	/**< Number of MSI-X table entries */
+	volatile uint32_t *msix_table;
 };
 
 
@@ -285,6 +290,35 @@ static struct pci_bus_handler ph __unused;
 #define  PCI_COMMAND_INTX_DISABLE 0x400 /* INTx Emulation Disable */
 #define PCI_COMMAND_DECODE_ENABLE	(PCI_COMMAND_MEMORY | PCI_COMMAND_IO)
 
+#define PCI_STATUS		0x06	/* 16 bits */
+#define  PCI_STATUS_CAP_LIST	0x10	/* Support Capability List */
+
+#define PCI_CAP_LIST_ID		0	/* Capability ID */
+#define  PCI_CAP_ID_MSI		0x05	/* Message Signalled Interrupts */
+#define  PCI_CAP_ID_VNDR	0x09	/* Vendor-Specific */
+#define  PCI_CAP_ID_MSIX	0x11	/* MSI-X */
+#define PCI_CAP_LIST_NEXT	1	/* Next capability in the list */
+
+/* MSI-X capability registers and table entries */
+#define PCI_MSIX_FLAGS		2	/* Message Control */
+#define  PCI_MSIX_FLAGS_QSIZE	0x07ff	/* Table size - 1 */
+#define  PCI_MSIX_FLAGS_MASKALL	0x4000	/* Mask all vectors */
+#define  PCI_MSIX_FLAGS_ENABLE	0x8000	/* MSI-X enable */
+#define PCI_MSIX_TABLE		4	/* Table offset and BAR indicator */
+#define  PCI_MSIX_TABLE_BIR	0x00000007
+#define  PCI_MSIX_TABLE_OFFSET	0xfffffff8
+#define PCI_MSIX_ENTRY_SIZE		16
+#define PCI_MSIX_ENTRY_LOWER_ADDR	0
+#define PCI_MSIX_ENTRY_UPPER_ADDR	4
+#define PCI_MSIX_ENTRY_DATA		8
+#define PCI_MSIX_ENTRY_VECTOR_CTRL	12
+#define  PCI_MSIX_ENTRY_CTRL_MASKBIT	0x1
+
+#define PCI_BASE_ADDRESS_SPACE_IO	0x01
+#define PCI_BASE_ADDRESS_MEM_TYPE_MASK	0x06
+#define PCI_BASE_ADDRESS_MEM_TYPE_64	0x04
+#define PCI_BASE_ADDRESS_MEM_MASK	(~0x0fUL)
+
 /* 0x35-0x3b are reserved */
 #define PCI_INTERRUPT_LINE	0x3c	/* 8 bits */
 #define PCI_INTERRUPT_PIN	0x3d	/* 8 bits */
@@ -293,4 +327,67 @@ static struct pci_bus_handler ph __unused;
 
 struct pci_driver *pci_find_driver(struct pci_device_id *id);
 
+/* Config space accessors, offsets have to be aligned to the access size */
+uint8_t pci_conf_read8(struct pci_device *dev, uint8_t offset);
+uint16_t pci_conf_read16(struct pci_device *dev, uint8_t offset);
+uint32_t pci_conf_read32(struct pci_device *dev, uint8_t offset);
+void pci_conf_write16(struct pci_device *dev, uint8_t offset, uint16_t val);
+void pci_conf_write32(struct pci_device *dev, uint8_t offset, uint32_t val);
+
+/**
+ * Walks the capability list of a device.
+ *
+ * @param dev
+ *	The PCI device.
+ * @param cap_id
+ *	The capability ID (PCI_CAP_ID_*) to look for.
+ * @param start
+ *	0 to search from the head of the list, or the offset of a previously
+ *	found capability to continue the search after it.
+ * @return
+ *	The config space offset of the capability, 0 if there is none.
+ */
+uint8_t pci_find_capability(struct pci_device *dev, uint8_t cap_id,
+			    uint8_t start);
+
+/**
+ * Maps a memory BAR of a device.
+ *
+ * @param dev
+ *	The PCI device.
+ * @param bar
+ *	Index of the BAR (0-5). A 64-bit BAR takes up two indices.
+ * @return
+ *	The virtual address of the start of the BAR, NULL if the BAR is an
+ *	I/O BAR or has no address assigned.
+ */
+void *pci_map_bar(struct pci_device *dev, uint8_t bar);
+
+#ifdef CONFIG_KVM_PCI_MSIX
+/**
+ * Switches a device from INTx to MSI-X and allocates one IRQ for each of
+ * its first `num` MSI-X table entries. Register the handlers for the IRQs
+ * before the device gets a chance to raise them. Once enabled, MSI-X stays
+ * enabled for the lifetime of the device.
+ *
+ * @param dev
+ *	The PCI device.
+ * @param irqs
+ *	Receives the IRQ of table entry i in irqs[i].
+ * @param num
+ *	Number of table entries to enable.
+ * @return
+ *	0 on success, -ENOTSUP if the device has no (usable) MSI-X capability,
+ *	-ENOSPC if the table is smaller than `num` or not enough IRQs are left.
+ */
+int pci_msix_enable(struct pci_device *dev, unsigned long *irqs,
+		    uint16_t num);
+#endif /* CONFIG_KVM_PCI_MSIX */
+
+/* Provided by the architecture */
+uint32_t arch_pci_conf_read(const struct pci_address *addr, uint8_t offset);
+void arch_pci_conf_write(const struct pci_address *addr, uint8_t offset,
+			 uint32_t val);
+void *arch_pci_mmio_map(uint64_t paddr);
+
 #endif /* __UKPLAT_COMMON_PCI_BUS_H__ */
@@ -68,48 +68,59 @@ static inline void cpuid(__u32 fn, __u32 subfn,
 		     : "a"(fn), "c" (subfn));
 }
 
-static inline void save_extregs(struct sw_ctx *ctx)
+static inline void save_extregs_area(uintptr_t area)
 {
 	switch (x86_cpu_features.save) {
 	case X86_SAVE_NONE:
 		/* nothing to do */
 		break;
 	case X86_SAVE_FSAVE:
-		asm volatile("fsave (%0)" :: "r"(ctx->extregs) : "memory");
+		asm volatile("fsave (%0)" :: "r"(area) : "memory");
 		break;
 	case X86_SAVE_FXSAVE:
-		asm volatile("fxsave (%0)" :: "r"(ctx->extregs) : "memory");
+		asm volatile("fxsave (%0)" :: "r"(area) : "memory");
 		break;
 	case X86_SAVE_XSAVE:
-		asm volatile("xsave (%0)" :: "r"(ctx->extregs),
+		asm volatile("xsave (%0)" :: "r"(area),
 				"a"(0xffffffff), "d"(0xffffffff) : "memory");
 		break;
 	case X86_SAVE_XSAVEOPT:
-		asm volatile("xsaveopt (%0)" :: "r"(ctx->extregs),
+		asm volatile("xsaveopt (%0)" :: "r"(area),
 				"a"(0xffffffff), "d"(0xffffffff) : "memory");
 		break;
 	}
 }
-static inline void restore_extregs(struct sw_ctx *ctx)
+
+static inline void restore_extregs_area(uintptr_t area)
 {
 	switch (x86_cpu_features.save) {
 	case X86_SAVE_NONE:
 		/* nothing to do */
 		break;
 	case X86_SAVE_FSAVE:
-		asm volatile("frstor (%0)" :: "r"(ctx->extregs));
+		asm volatile("frstor (%0)" :: "r"(area));
 		break;
 	case X86_SAVE_FXSAVE:
-		asm volatile("fxrstor (%0)" :: "r"(ctx->extregs));
+		asm volatile("fxrstor (%0)" :: "r"(area));
 		break;
 	case X86_SAVE_XSAVE:
 	case X86_SAVE_XSAVEOPT:
-		asm volatile("xrstor (%0)" :: "r"(ctx->extregs),
+		asm volatile("xrstor (%0)" :: "r"(area),
 				"a"(0xffffffff), "d"(0xffffffff));
 		break;
 	}
 }
 
+static inline void save_extregs(struct sw_ctx *ctx)
+{
+	save_extregs_area(ctx->extregs);
+}
+
+static inline void restore_extregs(struct sw_ctx *ctx)
+{
+	restore_extregs_area(ctx->extregs);
+}
+
 static inline __sz arch_extregs_size(void)
 {
 	/* Make sure that _init_cpufeatures() was called before */
@@ -77,10 +77,13 @@
 #define X86_EFER_LME            (1 << 8)    /* Long mode enable (R/W) */
 
 /* CPUID feature bits in ECX and EDX when EAX=1 */
+#define X86_CPUID1_ECX_X2APIC   (1 << 21)
+#define X86_CPUID1_ECX_TSC_DEADLINE (1 << 24)
 #define X86_CPUID1_ECX_XSAVE    (1 << 26)
 #define X86_CPUID1_ECX_OSXSAVE  (1 << 27)
 #define X86_CPUID1_ECX_AVX      (1 << 28)
 #define X86_CPUID1_EDX_FPU      (1 << 0)
+#define X86_CPUID1_EDX_APIC     (1 << 9)
 #define X86_CPUID1_EDX_FXSR     (1 << 24)
 #define X86_CPUID1_EDX_SSE      (1 << 25)
 /* CPUID feature bits in EBX and ECX when EAX=7, ECX=0 */
@@ -29,6 +29,7 @@
 #ifndef __PLAT_CMN_X86_IRQ_H__
 #define __PLAT_CMN_X86_IRQ_H__
 
+#include <uk/config.h>
 #include <x86/cpu_defs.h>
 
 #ifdef __X64_32__
@@ -90,6 +91,14 @@ static inline int irqs_disabled(void)
 #define local_irq_enable()       __sti()
 #define local_irq_enable_halt()  __sti_hlt()
 
+#ifdef CONFIG_KVM_PCI_MSIX
+/* IRQs from X86_MSI_IRQ_BASE on are message-signalled interrupts. Like the
+ * remapped PIC IRQs below them, IRQ n is delivered on vector 32 + n.
+ */
+#define X86_MSI_IRQ_BASE	16
+#define __MAX_IRQ	48
+#else
 #define __MAX_IRQ	16
+#endif /* CONFIG_KVM_PCI_MSIX */
 
 #endif /* __PLAT_CMN_X86_IRQ_H__ */
@@ -984,6 +984,15 @@ static int pg_page_unmap(struct uk_pagetable *pt, __vaddr_t pt_vaddr,
 
 			if (!(flags & PAGE_FLAG_KEEP_FRAMES))
 				pg_ffree(pt, PT_Lx_PTE_PADDR(pte, lvl), lvl);
+		} else if (vaddr != __VADDR_ANY &&
+			   !PAGE_Lx_ALIGNED(vaddr, lvl)) {
+			/* Nothing is mapped in the range covered by this PTE.
+			 * Continue as if the range started at its beginning,
+			 * so that we advance to the start of the next PTE
+			 * below and do not skip over mapped pages.
+			 */
+			len += vaddr - PAGE_Lx_ALIGN_DOWN(vaddr, lvl);
+			vaddr = PAGE_Lx_ALIGN_DOWN(vaddr, lvl);
 		}
 
 		/* If this is not the last PTE and there are still pages to
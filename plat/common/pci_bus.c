@@ -52,9 +52,13 @@
  */
 
 #include <string.h>
+#include <errno.h>
 #include <uk/print.h>
 #include <uk/plat/common/cpu.h>
 #include <pci/pci_bus.h>
+#ifdef CONFIG_KVM_PCI_MSIX
+#include <kvm/irq.h>
+#endif /* CONFIG_KVM_PCI_MSIX */
 
 extern int arch_pci_probe(struct uk_alloc *pha);
 
@@ -117,6 +121,173 @@ struct pci_driver *pci_find_driver(struct pci_device_id *id)
 	return NULL; /* no driver found */
 }
 
+uint8_t pci_conf_read8(struct pci_device *dev, uint8_t offset)
+{
+	return arch_pci_conf_read(&dev->addr, offset) >> ((offset & 0x3) * 8);
+}
+
+uint16_t pci_conf_read16(struct pci_device *dev, uint8_t offset)
+{
+	UK_ASSERT(!(offset & 0x1));
+	return arch_pci_conf_read(&dev->addr, offset) >> ((offset & 0x2) * 8);
+}
+
+uint32_t pci_conf_read32(struct pci_device *dev, uint8_t offset)
+{
+	UK_ASSERT(!(offset & 0x3));
+	return arch_pci_conf_read(&dev->addr, offset);
+}
+
+void pci_conf_write16(struct pci_device *dev, uint8_t offset, uint16_t val)
+{
+	uint32_t dword;
+	unsigned int shift = (offset & 0x2) * 8;
+
+	UK_ASSERT(!(offset & 0x1));
+	/* Config space is accessed in dwords, keep the other half intact */
+	dword = arch_pci_conf_read(&dev->addr, offset);
+	dword = (dword & ~(0xffffU << shift)) | ((uint32_t)val << shift);
+	arch_pci_conf_write(&dev->addr, offset, dword);
+}
+
+void pci_conf_write32(struct pci_device *dev, uint8_t offset, uint32_t val)
+{
+	UK_ASSERT(!(offset & 0x3));
+	arch_pci_conf_write(&dev->addr, offset, val);
+}
+
+uint8_t pci_find_capability(struct pci_device *dev, uint8_t cap_id,
+			    uint8_t start)
+{
+	uint8_t pos;
+	/* Bounds the walk on a malformed (looping) list */
+	int ttl = (256 - 0x40) / 4;
+
+	UK_ASSERT(dev);
+
+	if (start) {
+		pos = pci_conf_read8(dev, start + PCI_CAP_LIST_NEXT);
+	} else {
+		if (!(pci_conf_read16(dev, PCI_STATUS) & PCI_STATUS_CAP_LIST))
+			return 0;
+		pos = pci_conf_read8(dev, PCI_CAPABILITIES_PTR);
+	}
+
+	while (pos >= 0x40 && ttl--) {
+		pos &= ~0x3;
+		if (pci_conf_read8(dev, pos + PCI_CAP_LIST_ID) == cap_id)
+			return pos;
+		pos = pci_conf_read8(dev, pos + PCI_CAP_LIST_NEXT);
+	}
+	return 0;
+}
+
+void *pci_map_bar(struct pci_device *dev, uint8_t bar)
+{
+	uint32_t val;
+	uint64_t paddr;
+
+	UK_ASSERT(dev);
+
+	if (bar > 5)
+		return NULL;
+
+	val = pci_conf_read32(dev, PCI_BASE_ADDRESS_0 + bar * 4);
+	if (val & PCI_BASE_ADDRESS_SPACE_IO)
+		return NULL;
+
+	paddr = val & PCI_BASE_ADDRESS_MEM_MASK;
+	if ((val & PCI_BASE_ADDRESS_MEM_TYPE_MASK) ==
+	    PCI_BASE_ADDRESS_MEM_TYPE_64) {
+		if (bar == 5)
+			return NULL;
+		paddr |= (uint64_t)pci_conf_read32(dev, PCI_BASE_ADDRESS_0
+						   + (bar + 1) * 4) << 32;
+	}
+	if (!paddr)
+		return NULL;
+
+	return arch_pci_mmio_map(paddr);
+}
+
+#ifdef CONFIG_KVM_PCI_MSIX
+int pci_msix_enable(struct pci_device *dev, unsigned long *irqs,
+		    uint16_t num)
+{
+	volatile uint32_t *entry;
+	uint32_t table;
+	uint16_t ctrl, cmd, i;
+	uint8_t *base;
+	__u64 msg_addr;
+	__u32 msg_data;
+	int rc;
+
+	UK_ASSERT(dev);
+	UK_ASSERT(irqs);
+
+	if (!dev->msix_cap) {
+		dev->msix_cap = pci_find_capability(dev, PCI_CAP_ID_MSIX, 0);
+		if (!dev->msix_cap)
+			return -ENOTSUP;
+		ctrl = pci_conf_read16(dev, dev->msix_cap + PCI_MSIX_FLAGS);
+		dev->msix_size = (ctrl & PCI_MSIX_FLAGS_QSIZE) + 1;
+	}
+	if (num == 0 || num > dev->msix_size)
+		return -ENOSPC;
+
+	ctrl = pci_conf_read16(dev, dev->msix_cap + PCI_MSIX_FLAGS);
+	if (ctrl & PCI_MSIX_FLAGS_ENABLE)
+		return -EBUSY;
+
+	if (!dev->msix_table) {
+		table = pci_conf_read32(dev, dev->msix_cap + PCI_MSIX_TABLE);
+		base = pci_map_bar(dev, table & PCI_MSIX_TABLE_BIR);
+		if (base)
+			dev->msix_table = (volatile uint32_t *)(base +
+					  (table & PCI_MSIX_TABLE_OFFSET));
+		if (!dev->msix_table) {
+			uk_pr_warn("PCI %02x:%02x.%02x: MSI-X table not in a memory BAR\n",
+				   (int) dev->addr.bus,
+				   (int) dev->addr.devid,
+				   (int) dev->addr.function);
+			return -ENOTSUP;
+		}
+	}
+
+	rc = irq_msi_alloc(num, &irqs[0]);
+	if (unlikely(rc))
+		return rc;
+
+	for (i = 0; i < num; i++) {
+		irqs[i] = irqs[0] + i;
+		irq_msi_compose(irqs[i], &msg_addr, &msg_data);
+
+		entry = dev->msix_table + i * (PCI_MSIX_ENTRY_SIZE / 4);
+		entry[PCI_MSIX_ENTRY_LOWER_ADDR / 4] = (uint32_t)msg_addr;
+		entry[PCI_MSIX_ENTRY_UPPER_ADDR / 4] = msg_addr >> 32;
+		entry[PCI_MSIX_ENTRY_DATA / 4] = msg_data;
+		entry[PCI_MSIX_ENTRY_VECTOR_CTRL / 4] &=
+			~PCI_MSIX_ENTRY_CTRL_MASKBIT;
+	}
+
+	/* Interrupt messages are memory writes issued by the device */
+	cmd = pci_conf_read16(dev, PCI_COMMAND);
+	pci_conf_write16(dev, PCI_COMMAND, cmd | PCI_COMMAND_MEMORY
+			 | PCI_COMMAND_MASTER | PCI_COMMAND_INTX_DISABLE);
+
+	ctrl &= ~PCI_MSIX_FLAGS_MASKALL;
+	pci_conf_write16(dev, dev->msix_cap + PCI_MSIX_FLAGS,
+			 ctrl | PCI_MSIX_FLAGS_ENABLE);
+
+	uk_pr_info("PCI %02x:%02x.%02x: MSI-X enabled with %u vectors\n",
+		   (int) dev->addr.bus,
+		   (int) dev->addr.devid,
+		   (int) dev->addr.function,
+		   (unsigned int) num);
+	return 0;
+}
+#endif /* CONFIG_KVM_PCI_MSIX */
+
 static int pci_probe(void)
 {
 	return arch_pci_probe(ph.a);
@@ -65,6 +65,39 @@
 		*(ret) = (type) _conf_data;				\
 	} while (0)
 
+/* MMIO is reached through the direct map area, which exists only with
+ * CONFIG_PAGING
+ */
+#define PCI_MMIO_DIRECTMAP_BASE	0xffffff8000000000UL
+
+static inline uint32_t pci_config_addr(const struct pci_address *addr,
+				       uint8_t offset)
+{
+	return (PCI_ENABLE_BIT)
+		| (addr->bus << PCI_BUS_SHIFT)
+		| (addr->devid << PCI_DEVICE_SHIFT)
+		| (addr->function << PCI_FUNCTION_SHIFT)
+		| (offset & ~0x3);
+}
+
+uint32_t arch_pci_conf_read(const struct pci_address *addr, uint8_t offset)
+{
+	outl(PCI_CONFIG_ADDR, pci_config_addr(addr, offset));
+	return inl(PCI_CONFIG_DATA);
+}
+
+void arch_pci_conf_write(const struct pci_address *addr, uint8_t offset,
+			 uint32_t val)
+{
+	outl(PCI_CONFIG_ADDR, pci_config_addr(addr, offset));
+	outl(PCI_CONFIG_DATA, val);
+}
+
+void *arch_pci_mmio_map(uint64_t paddr)
+{
+	return (void *)(PCI_MMIO_DIRECTMAP_BASE + paddr);
+}
+
 static inline int pci_driver_add_device(struct pci_driver *drv,
 					struct pci_address *addr,
 					struct pci_device_id *devid)
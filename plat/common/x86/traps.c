@@ -93,8 +93,19 @@ void do_page_fault(struct __regs *regs, unsigned long error_code)
 {
 	unsigned long vaddr = read_cr2();
 	struct ukarch_trap_ctx ctx = {regs, TRAP_page_fault, error_code, vaddr};
+	/* Page fault handlers (e.g., for demand paging) call into regular
+	 * kernel code that may use extended registers. We save them for the
+	 * interrupted context on the trap stack, which is per CPU.
+	 */
+	__u8 extregs[4096] __align(64);
+	int rc;
 
-	if (uk_raise_event(UKARCH_TRAP_PAGE_FAULT, &ctx))
+	UK_ASSERT(x86_cpu_features.extregs_size <= sizeof(extregs));
+
+	save_extregs_area((uintptr_t)extregs);
+	rc = uk_raise_event(UKARCH_TRAP_PAGE_FAULT, &ctx);
+	restore_extregs_area((uintptr_t)extregs);
+	if (rc)
 		return;
 
 	uk_pr_crit("page fault at %#016lx, error_code=%#016lx\n", vaddr,
@@ -0,0 +1,859 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Block device driver for the linuxu platform that exposes host files (or
+ * host block devices) as uk_blkdev.
+ *
+ * Every queue is backed by an io_uring instance of the host kernel, so
+ * requests complete asynchronously and many of them are handed to the host
+ * with a single system call. Completions are delivered as interrupts: each
+ * request is linked to a one-byte write to a pipe that is set up for
+ * signal-driven I/O, so the host raises FILEBLK_SIGNUM once the request is
+ * done, regardless of its outcome (IOSQE_IO_HARDLINK, Linux 5.5+).
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <uk/alloc.h>
+#include <uk/arch/types.h>
+#include <uk/arch/atomic.h>
+#include <uk/essentials.h>
+#include <uk/errptr.h>
+#include <uk/list.h>
+#include <uk/libparam.h>
+#include <uk/bus.h>
+#include <uk/print.h>
+#include <uk/plat/irq.h>
+#include <uk/plat/lcpu.h>
+#include <uk/blkdev_driver.h>
+
+#ifdef CONFIG_PLAT_LINUXU
+#include <linuxu/syscall.h>
+#include <linuxu/signal.h>
+#include <linuxu/io_uring.h>
+#else
+#error "The driver is supported on linuxu platform"
+#endif /* CONFIG_PLAT_LINUXU */
+
+#define DRIVER_NAME		"fileblk"
+
+#define FILEBLK_SECTOR_SIZE	512
+#define FILEBLK_MAX_REQ_SIZE	(1UL << 20)
+#define FILEBLK_NB_DESC_MAX	1024
+#define FILEBLK_SIGNUM		SIGUSR1
+
+#define FILEBLK_INTR_EN		(1 << 0)
+#define FILEBLK_INTR_USR_EN	(1 << 1)
+
+/* user_data of the completions of the linked notification writes */
+#define FILEBLK_NOTIFY_TAG	0
+
+#define to_fileblkdev(bdev) \
+	__containerof(bdev, struct fileblk_device, blkdev)
+
+struct fileblk_slot {
+	/* Request that occupies the slot */
+	struct uk_blkreq *req;
+	/* Data buffer of the request, read by the host on submission */
+	struct iovec iov;
+};
+
+struct uk_blkdev_queue {
+	/* Device of the queue */
+	struct fileblk_device *fbdev;
+	/* The libukblkdev queue identifier */
+	uint16_t queue_id;
+	/* Allocator */
+	struct uk_alloc *a;
+	/* The nr. of requests that can be in flight */
+	uint16_t nb_desc;
+	/* The flag to interrupt on the queue */
+	uint8_t intr_enabled;
+
+	/* io_uring file descriptor */
+	int ring_fd;
+	/* Mapping of the submission and completion rings */
+	void *ring;
+	__sz ring_len;
+	/* Mapping of the submission queue entries */
+	struct k_io_uring_sqe *sqes;
+	__sz sqes_len;
+	__u32 *sq_head;
+	__u32 *sq_tail;
+	__u32 *sq_array;
+	__u32 sq_mask;
+	__u32 *cq_head;
+	__u32 *cq_tail;
+	__u32 cq_mask;
+	struct k_io_uring_cqe *cqes;
+
+	/* Pipe written by the host on completion: read end, write end */
+	int notify_fd[2];
+
+	/* Requests in flight, indexed by user_data - 1 */
+	struct fileblk_slot *slots;
+	/* Stack of free slot indices */
+	uint16_t *free_slots;
+	uint16_t nb_free;
+};
+
+struct fileblk_device {
+	/* Unikraft block device */
+	struct uk_blkdev blkdev;
+	/* Index of the image in the fileblk.images parameter */
+	__u16 uid;
+	/* Path of the image on the host */
+	const char *path;
+	/* Host file descriptor of the image */
+	int fd;
+	/* Number of configured queues */
+	__u16 nb_queues;
+	/* Queues */
+	struct uk_blkdev_queue *qs;
+	/* Entry in the list of devices */
+	UK_TAILQ_ENTRY(struct fileblk_device) next;
+};
+
+static struct uk_alloc *a;
+static const char *drv_name = DRIVER_NAME;
+static UK_TAILQ_HEAD(fileblk_dev_list, struct fileblk_device) fileblk_devs =
+	UK_TAILQ_HEAD_INITIALIZER(fileblk_devs);
+
+/* Payload of the notification writes */
+static const char fileblk_notify_byte;
+static const struct iovec fileblk_notify_iov = {
+	.iov_base = (void *) &fileblk_notify_byte,
+	.iov_len = 1,
+};
+
+static char *images;
+
+/**
+ * fileblk.images="disk0.img disk1.img ... diskn.img"
+ */
+UK_LIB_PARAM_STR(images);
+
+static uint16_t fileblk_slot_get(struct uk_blkdev_queue *queue)
+{
+	unsigned long flags;
+	uint16_t idx = __U16_MAX;
+
+	flags = ukplat_lcpu_save_irqf();
+	if (queue->nb_free > 0)
+		idx = queue->free_slots[--queue->nb_free];
+	ukplat_lcpu_restore_irqf(flags);
+
+	return idx;
+}
+
+static void fileblk_slot_put(struct uk_blkdev_queue *queue, uint16_t idx)
+{
+	unsigned long flags;
+
+	flags = ukplat_lcpu_save_irqf();
+	UK_ASSERT(queue->nb_free < queue->nb_desc);
+	queue->slots[idx].req = NULL;
+	queue->free_slots[queue->nb_free++] = idx;
+	ukplat_lcpu_restore_irqf(flags);
+}
+
+static struct k_io_uring_sqe *fileblk_sqe_get(struct uk_blkdev_queue *queue,
+					      __u32 tail)
+{
+	__u32 idx = tail & queue->sq_mask;
+
+	queue->sq_array[idx] = idx;
+	memset(&queue->sqes[idx], 0, sizeof(queue->sqes[idx]));
+	return &queue->sqes[idx];
+}
+
+/**
+ * Hand all submission queue entries that the host did not consume yet over
+ * to the host.
+ */
+static int fileblk_ring_submit(struct uk_blkdev_queue *queue)
+{
+	__u32 pending;
+	int rc;
+
+	do {
+		pending = ukarch_load_n(queue->sq_tail)
+			  - ukarch_load_n(queue->sq_head);
+		if (!pending)
+			return 0;
+		rc = sys_io_uring_enter(queue->ring_fd, pending, 0, 0);
+	} while (rc == -EINTR);
+
+	/* The entries stay in the ring and are submitted with the next call
+	 * when the host is short on resources
+	 */
+	if (rc == -EAGAIN || rc == -EBUSY)
+		return 0;
+	return (rc < 0) ? rc : 0;
+}
+
+static int fileblk_request_check(struct fileblk_device *fbdev,
+				 struct uk_blkreq *req)
+{
+	struct uk_blkdev_cap *cap = &fbdev->blkdev.capabilities;
+
+	if (req->operation == UK_BLKREQ_FFLUSH)
+		return 0;
+	if (req->operation != UK_BLKREQ_READ &&
+	    req->operation != UK_BLKREQ_WRITE)
+		return -EINVAL;
+	if (req->operation == UK_BLKREQ_WRITE && cap->mode == O_RDONLY)
+		return -EPERM;
+	if (req->aio_buf == NULL || req->nb_sectors == 0)
+		return -EINVAL;
+	if (req->start_sector + req->nb_sectors > cap->sectors)
+		return -EINVAL;
+	if (req->nb_sectors > cap->max_sectors_per_req)
+		return -EINVAL;
+	return 0;
+}
+
+static int fileblk_submit_request(struct uk_blkdev *dev,
+				  struct uk_blkdev_queue *queue,
+				  struct uk_blkreq *req)
+{
+	struct fileblk_device *fbdev;
+	struct fileblk_slot *slot;
+	struct k_io_uring_sqe *sqe;
+	uint16_t idx;
+	__u32 tail;
+	int status = 0x0;
+	int rc;
+
+	UK_ASSERT(dev);
+	UK_ASSERT(queue);
+	UK_ASSERT(req);
+
+	fbdev = to_fileblkdev(dev);
+	rc = fileblk_request_check(fbdev, req);
+	if (unlikely(rc < 0))
+		return rc;
+
+	idx = fileblk_slot_get(queue);
+	if (idx == __U16_MAX) {
+		uk_pr_debug("The queue is full\n");
+		return -ENOSPC;
+	}
+	slot = &queue->slots[idx];
+	slot->req = req;
+	slot->iov.iov_base = req->aio_buf;
+	slot->iov.iov_len = req->nb_sectors * dev->capabilities.ssize;
+
+	/* Every request takes two entries that are linked with each other,
+	 * there are two entries for each slot.
+	 */
+	tail = *queue->sq_tail;
+	sqe = fileblk_sqe_get(queue, tail);
+	sqe->fd = fbdev->fd;
+	sqe->flags = K_IOSQE_IO_HARDLINK;
+	sqe->user_data = idx + 1;
+	if (req->operation == UK_BLKREQ_FFLUSH) {
+		sqe->opcode = K_IORING_OP_FSYNC;
+	} else {
+		sqe->opcode = (req->operation == UK_BLKREQ_WRITE)
+			      ? K_IORING_OP_WRITEV : K_IORING_OP_READV;
+		sqe->addr = (__u64) (__uptr) &slot->iov;
+		sqe->len = 1;
+		sqe->off = req->start_sector * dev->capabilities.ssize;
+	}
+
+	sqe = fileblk_sqe_get(queue, tail + 1);
+	sqe->opcode = K_IORING_OP_WRITEV;
+	sqe->fd = queue->notify_fd[1];
+	sqe->addr = (__u64) (__uptr) &fileblk_notify_iov;
+	sqe->len = 1;
+	sqe->user_data = FILEBLK_NOTIFY_TAG;
+
+	ukarch_store_n(queue->sq_tail, tail + 2);
+
+	rc = fileblk_ring_submit(queue);
+	if (unlikely(rc < 0))
+		uk_pr_err("Failed to submit to the host: %d\n", rc);
+
+	status |= UK_BLKDEV_STATUS_SUCCESS;
+	status |= likely(queue->nb_free > 0) ? UK_BLKDEV_STATUS_MORE : 0x0;
+	return status;
+}
+
+static int fileblk_complete_reqs(struct uk_blkdev *dev,
+				 struct uk_blkdev_queue *queue)
+{
+	struct k_io_uring_cqe *cqe;
+	struct uk_blkreq *req;
+	__u32 head, tail;
+	uint16_t idx;
+	int rc;
+
+	UK_ASSERT(dev);
+	UK_ASSERT(queue);
+
+	/* Queue interrupts have to be off when calling receive */
+	UK_ASSERT(!(queue->intr_enabled & FILEBLK_INTR_EN));
+
+	/* Entries left over from a busy host */
+	rc = fileblk_ring_submit(queue);
+	if (unlikely(rc < 0))
+		uk_pr_err("Failed to submit to the host: %d\n", rc);
+
+moretodo:
+	head = *queue->cq_head;
+	tail = ukarch_load_n(queue->cq_tail);
+	while (head != tail) {
+		cqe = &queue->cqes[head & queue->cq_mask];
+		head++;
+		if (cqe->user_data == FILEBLK_NOTIFY_TAG)
+			continue;
+
+		UK_ASSERT(cqe->user_data <= queue->nb_desc);
+		idx = cqe->user_data - 1;
+		req = queue->slots[idx].req;
+		UK_ASSERT(req);
+		if (cqe->res < 0)
+			req->result = cqe->res;
+		else if (req->operation != UK_BLKREQ_FFLUSH &&
+			 (__sz) cqe->res != queue->slots[idx].iov.iov_len)
+			/* The image is not expected to shrink */
+			req->result = -EIO;
+		else
+			req->result = 0;
+		fileblk_slot_put(queue, idx);
+
+		/* Release the entry before the callback may submit again */
+		ukarch_store_n(queue->cq_head, head);
+
+		uk_blkreq_finished(req);
+		if (req->cb)
+			req->cb(req, req->cb_cookie);
+	}
+	ukarch_store_n(queue->cq_head, head);
+
+	/* Enable interrupt only when user had previously enabled it */
+	if (queue->intr_enabled & FILEBLK_INTR_USR_EN) {
+		queue->intr_enabled |= FILEBLK_INTR_EN;
+		if (ukarch_load_n(queue->cq_tail) != head) {
+			queue->intr_enabled &= ~FILEBLK_INTR_EN;
+			goto moretodo;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * Handler of FILEBLK_SIGNUM, shared by all queues of all devices because
+ * the host coalesces pending signals.
+ */
+static int fileblk_irq_handle(void *arg __unused)
+{
+	struct fileblk_device *fbdev;
+	struct uk_blkdev_queue *queue;
+	char buf[64];
+	uint16_t i;
+
+	UK_TAILQ_FOREACH(fbdev, &fileblk_devs, next) {
+		for (i = 0; i < fbdev->nb_queues; i++) {
+			queue = &fbdev->qs[i];
+			if (queue->ring_fd < 0)
+				continue;
+
+			/* Drain the notifications */
+			while (sys_read(queue->notify_fd[0], buf,
+					sizeof(buf)) > 0)
+				;
+
+			if (!(queue->intr_enabled & FILEBLK_INTR_EN))
+				continue;
+			if (ukarch_load_n(queue->cq_tail) ==
+			    ukarch_load_n(queue->cq_head))
+				continue;
+
+			queue->intr_enabled &= ~FILEBLK_INTR_EN;
+			uk_blkdev_drv_queue_event(&fbdev->blkdev,
+						  queue->queue_id);
+		}
+	}
+	return 1;
+}
+
+static int fileblk_queue_intr_enable(struct uk_blkdev *dev,
+				     struct uk_blkdev_queue *queue)
+{
+	UK_ASSERT(dev);
+	UK_ASSERT(queue);
+
+	/* If the interrupt is enabled */
+	if (queue->intr_enabled & FILEBLK_INTR_EN)
+		return 0;
+
+	queue->intr_enabled = FILEBLK_INTR_USR_EN;
+	/* Completions that arrived in the meantime raised no interrupt */
+	if (ukarch_load_n(queue->cq_tail) != ukarch_load_n(queue->cq_head))
+		return 1;
+
+	queue->intr_enabled |= FILEBLK_INTR_EN;
+	return 0;
+}
+
+static int fileblk_queue_intr_disable(struct uk_blkdev *dev,
+				      struct uk_blkdev_queue *queue)
+{
+	UK_ASSERT(dev);
+	UK_ASSERT(queue);
+
+	queue->intr_enabled &= ~(FILEBLK_INTR_USR_EN | FILEBLK_INTR_EN);
+	return 0;
+}
+
+static void fileblk_ring_release(struct uk_blkdev_queue *queue)
+{
+	unsigned long flags;
+
+	/* Keep the interrupt handler away from the queue */
+	flags = ukplat_lcpu_save_irqf();
+	if (queue->sqes)
+		sys_munmap(queue->sqes, queue->sqes_len);
+	if (queue->ring)
+		sys_munmap(queue->ring, queue->ring_len);
+	if (queue->ring_fd >= 0)
+		sys_close(queue->ring_fd);
+	if (queue->notify_fd[0] >= 0)
+		sys_close(queue->notify_fd[0]);
+	if (queue->notify_fd[1] >= 0)
+		sys_close(queue->notify_fd[1]);
+	queue->sqes = NULL;
+	queue->ring = NULL;
+	queue->ring_fd = -1;
+	queue->notify_fd[0] = -1;
+	queue->notify_fd[1] = -1;
+	ukplat_lcpu_restore_irqf(flags);
+}
+
+static int fileblk_ring_setup(struct uk_blkdev_queue *queue)
+{
+	struct k_io_uring_params p;
+	void *ptr;
+	int rc;
+
+	/* Completion pipe: the read end raises FILEBLK_SIGNUM when the host
+	 * writes to it
+	 */
+	rc = sys_pipe2(queue->notify_fd, O_NONBLOCK | O_CLOEXEC);
+	if (unlikely(rc < 0)) {
+		uk_pr_err("Failed to create the completion pipe: %d\n", rc);
+		goto err_out;
+	}
+	rc = sys_fcntl(queue->notify_fd[0], F_SETSIG, FILEBLK_SIGNUM);
+	if (rc >= 0)
+		rc = sys_fcntl(queue->notify_fd[0], F_SETOWN, sys_getpid());
+	if (rc >= 0)
+		rc = sys_fcntl(queue->notify_fd[0], F_SETFL,
+			       O_NONBLOCK | O_ASYNC);
+	if (unlikely(rc < 0)) {
+		uk_pr_err("Failed to set up signal-driven I/O: %d\n", rc);
+		goto err_out;
+	}
+
+	memset(&p, 0, sizeof(p));
+	rc = sys_io_uring_setup(2 * queue->nb_desc, &p);
+	if (unlikely(rc < 0)) {
+		uk_pr_err("Failed to create an io_uring instance: %d\n", rc);
+		goto err_out;
+	}
+	queue->ring_fd = rc;
+	if (unlikely(!(p.features & K_IORING_FEAT_SINGLE_MMAP))) {
+		uk_pr_err("The host kernel is too old for io_uring\n");
+		rc = -ENOTSUP;
+		goto err_out;
+	}
+
+	queue->ring_len = MAX(p.sq_off.array + p.sq_entries * sizeof(__u32),
+			      p.cq_off.cqes +
+			      p.cq_entries * sizeof(struct k_io_uring_cqe));
+	ptr = sys_mmap(NULL, queue->ring_len, PROT_READ | PROT_WRITE,
+		       MAP_SHARED, queue->ring_fd,
+		       K_IORING_MMAP_OFF(K_IORING_OFF_SQ_RING));
+	if (unlikely(PTRISERR(ptr))) {
+		rc = PTR2ERR(ptr);
+		uk_pr_err("Failed to map the io_uring rings: %d\n", rc);
+		goto err_out;
+	}
+	queue->ring = ptr;
+
+	queue->sqes_len = p.sq_entries * sizeof(struct k_io_uring_sqe);
+	ptr = sys_mmap(NULL, queue->sqes_len, PROT_READ | PROT_WRITE,
+		       MAP_SHARED, queue->ring_fd,
+		       K_IORING_MMAP_OFF(K_IORING_OFF_SQES));
+	if (unlikely(PTRISERR(ptr))) {
+		rc = PTR2ERR(ptr);
+		uk_pr_err("Failed to map the io_uring entries: %d\n", rc);
+		goto err_out;
+	}
+	queue->sqes = ptr;
+
+	queue->sq_head = (__u32 *) ((__u8 *) queue->ring + p.sq_off.head);
+	queue->sq_tail = (__u32 *) ((__u8 *) queue->ring + p.sq_off.tail);
+	queue->sq_array = (__u32 *) ((__u8 *) queue->ring + p.sq_off.array);
+	queue->sq_mask = *(__u32 *) ((__u8 *) queue->ring
+				     + p.sq_off.ring_mask);
+	queue->cq_head = (__u32 *) ((__u8 *) queue->ring + p.cq_off.head);
+	queue->cq_tail = (__u32 *) ((__u8 *) queue->ring + p.cq_off.tail);
+	queue->cqes = (struct k_io_uring_cqe *) ((__u8 *) queue->ring
+						 + p.cq_off.cqes);
+	queue->cq_mask = *(__u32 *) ((__u8 *) queue->ring
+				     + p.cq_off.ring_mask);
+	return 0;
+
+err_out:
+	fileblk_ring_release(queue);
+	return rc;
+}
+
+static struct uk_blkdev_queue *fileblk_queue_setup(struct uk_blkdev *dev,
+		uint16_t queue_id,
+		uint16_t nb_desc,
+		const struct uk_blkdev_queue_conf *queue_conf)
+{
+	struct fileblk_device *fbdev;
+	struct uk_blkdev_queue *queue;
+	uint16_t i;
+	int rc = 0;
+
+	UK_ASSERT(dev != NULL);
+	UK_ASSERT(queue_conf != NULL);
+
+	fbdev = to_fileblkdev(dev);
+	if (unlikely(queue_id >= fbdev->nb_queues)) {
+		uk_pr_err("Invalid queue_id %"__PRIu16"\n", queue_id);
+		rc = -EINVAL;
+		goto err_exit;
+	}
+	if (unlikely(nb_desc > FILEBLK_NB_DESC_MAX)) {
+		uk_pr_err("Max desc: %d Requested desc:%"__PRIu16"\n",
+			  FILEBLK_NB_DESC_MAX, nb_desc);
+		rc = -ENOBUFS;
+		goto err_exit;
+	}
+
+	queue = &fbdev->qs[queue_id];
+	queue->a = queue_conf->a;
+	queue->fbdev = fbdev;
+	queue->queue_id = queue_id;
+	queue->nb_desc = (nb_desc) ? nb_desc : FILEBLK_NB_DESC_MAX;
+
+	queue->slots = uk_calloc(queue->a, queue->nb_desc,
+				 sizeof(*queue->slots));
+	queue->free_slots = uk_malloc(queue->a, queue->nb_desc
+				      * sizeof(*queue->free_slots));
+	if (unlikely(!queue->slots || !queue->free_slots)) {
+		rc = -ENOMEM;
+		goto err_free;
+	}
+	for (i = 0; i < queue->nb_desc; i++)
+		queue->free_slots[i] = queue->nb_desc - i - 1;
+	queue->nb_free = queue->nb_desc;
+
+	rc = fileblk_ring_setup(queue);
+	if (rc < 0) {
+		uk_pr_err("Failed to set up queue %"__PRIu16": %d\n",
+			  queue_id, rc);
+		goto err_free;
+	}
+
+	return queue;
+
+err_free:
+	uk_free(queue->a, queue->free_slots);
+	uk_free(queue->a, queue->slots);
+err_exit:
+	return ERR2PTR(rc);
+}
+
+static int fileblk_queue_release(struct uk_blkdev *dev,
+				 struct uk_blkdev_queue *queue)
+{
+	UK_ASSERT(dev != NULL);
+	UK_ASSERT(queue != NULL);
+
+	fileblk_ring_release(queue);
+	uk_free(queue->a, queue->free_slots);
+	uk_free(queue->a, queue->slots);
+	return 0;
+}
+
+static int fileblk_queue_info_get(struct uk_blkdev *dev,
+				  uint16_t queue_id,
+				  struct uk_blkdev_queue_info *qinfo)
+{
+	struct fileblk_device *fbdev;
+
+	UK_ASSERT(dev);
+	UK_ASSERT(qinfo);
+
+	fbdev = to_fileblkdev(dev);
+	if (unlikely(queue_id >= fbdev->nb_queues)) {
+		uk_pr_err("Invalid queue_id %"__PRIu16"\n", queue_id);
+		return -EINVAL;
+	}
+
+	qinfo->nb_min = 1;
+	qinfo->nb_max = FILEBLK_NB_DESC_MAX;
+	qinfo->nb_align = 1;
+	qinfo->nb_is_power_of_two = 0;
+	return 0;
+}
+
+static int fileblk_configure(struct uk_blkdev *dev,
+			     const struct uk_blkdev_conf *conf)
+{
+	struct fileblk_device *fbdev;
+	uint16_t i;
+
+	UK_ASSERT(dev != NULL);
+	UK_ASSERT(conf != NULL);
+
+	fbdev = to_fileblkdev(dev);
+	if (conf->nb_queues > CONFIG_LINUXU_FILEBLK_MAX_QUEUES) {
+		uk_pr_err("Queue number not supported: %"__PRIu16"\n",
+			  conf->nb_queues);
+		return -ENOTSUP;
+	}
+
+	fbdev->qs = uk_calloc(a, conf->nb_queues, sizeof(*fbdev->qs));
+	if (unlikely(!fbdev->qs)) {
+		uk_pr_err("Failed to allocate memory for queue management\n");
+		return -ENOMEM;
+	}
+	for (i = 0; i < conf->nb_queues; i++) {
+		fbdev->qs[i].ring_fd = -1;
+		fbdev->qs[i].notify_fd[0] = -1;
+		fbdev->qs[i].notify_fd[1] = -1;
+	}
+	fbdev->nb_queues = conf->nb_queues;
+
+	uk_pr_info(DRIVER_NAME": %"__PRIu16" configured\n", fbdev->uid);
+	return 0;
+}
+
+static int fileblk_start(struct uk_blkdev *dev)
+{
+	struct fileblk_device *fbdev;
+
+	UK_ASSERT(dev != NULL);
+
+	fbdev = to_fileblkdev(dev);
+	uk_pr_info(DRIVER_NAME": %"__PRIu16" started\n", fbdev->uid);
+	return 0;
+}
+
+static int fileblk_stop(struct uk_blkdev *dev)
+{
+	struct fileblk_device *fbdev;
+	uint16_t q_id;
+
+	UK_ASSERT(dev != NULL);
+
+	fbdev = to_fileblkdev(dev);
+	for (q_id = 0; q_id < fbdev->nb_queues; ++q_id) {
+		if (fbdev->qs[q_id].nb_free != fbdev->qs[q_id].nb_desc) {
+			uk_pr_err("Queue:%"__PRIu16" has requests in flight\n",
+				  q_id);
+			return -EBUSY;
+		}
+	}
+
+	uk_pr_info(DRIVER_NAME": %"__PRIu16" stopped\n", fbdev->uid);
+	return 0;
+}
+
+static int fileblk_unconfigure(struct uk_blkdev *dev)
+{
+	struct fileblk_device *fbdev;
+
+	UK_ASSERT(dev != NULL);
+
+	fbdev = to_fileblkdev(dev);
+	fbdev->nb_queues = 0;
+	uk_free(a, fbdev->qs);
+	fbdev->qs = NULL;
+	return 0;
+}
+
+static void fileblk_get_info(struct uk_blkdev *dev __unused,
+			     struct uk_blkdev_info *dev_info)
+{
+	UK_ASSERT(dev_info != NULL);
+
+	dev_info->max_queues = CONFIG_LINUXU_FILEBLK_MAX_QUEUES;
+}
+
+static const struct uk_blkdev_ops fileblk_ops = {
+	.get_info = fileblk_get_info,
+	.dev_configure = fileblk_configure,
+	.queue_get_info = fileblk_queue_info_get,
+	.queue_configure = fileblk_queue_setup,
+	.dev_start = fileblk_start,
+	.dev_stop = fileblk_stop,
+	.queue_intr_enable = fileblk_queue_intr_enable,
+	.queue_intr_disable = fileblk_queue_intr_disable,
+	.queue_unconfigure = fileblk_queue_release,
+	.dev_unconfigure = fileblk_unconfigure,
+};
+
+static int fileblk_image_open(struct fileblk_device *fbdev)
+{
+	struct uk_blkdev_cap *cap = &fbdev->blkdev.capabilities;
+	off_t size;
+	int mode = O_RDWR;
+	int rc;
+
+	rc = sys_open(fbdev->path, O_RDWR | O_CLOEXEC);
+	if (rc == -EACCES || rc == -EROFS) {
+		mode = O_RDONLY;
+		rc = sys_open(fbdev->path, O_RDONLY | O_CLOEXEC);
+	}
+	if (rc < 0) {
+		uk_pr_err(DRIVER_NAME": Failed to open %s: %d\n",
+			  fbdev->path, rc);
+		return rc;
+	}
+	fbdev->fd = rc;
+
+	/* Works for regular files and block devices alike */
+	size = sys_lseek(fbdev->fd, 0, SEEK_END);
+	if (size < 0) {
+		rc = (int) size;
+		uk_pr_err(DRIVER_NAME": Failed to query the size of %s: %d\n",
+			  fbdev->path, rc);
+		sys_close(fbdev->fd);
+		fbdev->fd = -1;
+		return rc;
+	}
+
+	cap->ssize = FILEBLK_SECTOR_SIZE;
+	cap->sectors = size / cap->ssize;
+	cap->mode = mode;
+	cap->max_sectors_per_req = FILEBLK_MAX_REQ_SIZE / cap->ssize;
+	cap->ioalign = sizeof(void *);
+	return 0;
+}
+
+static int fileblk_add_dev(__u16 uid, const char *path)
+{
+	struct fileblk_device *fbdev;
+	int rc;
+
+	fbdev = uk_zalloc(a, sizeof(*fbdev));
+	if (!fbdev)
+		return -ENOMEM;
+
+	fbdev->uid = uid;
+	fbdev->path = path;
+	rc = fileblk_image_open(fbdev);
+	if (rc < 0)
+		goto err_free;
+
+	fbdev->blkdev.submit_one = fileblk_submit_request;
+	fbdev->blkdev.finish_reqs = fileblk_complete_reqs;
+	fbdev->blkdev.dev_ops = &fileblk_ops;
+
+	rc = uk_blkdev_drv_register(&fbdev->blkdev, a, drv_name);
+	if (rc < 0) {
+		uk_pr_err("Failed to register fileblk device: %d\n", rc);
+		goto err_close;
+	}
+	UK_TAILQ_INSERT_TAIL(&fileblk_devs, fbdev, next);
+
+	uk_pr_info(DRIVER_NAME": %"__PRIu16" %s: %"__PRIsctr" sectors (%s)\n",
+		   fbdev->uid, fbdev->path, fbdev->blkdev.capabilities.sectors,
+		   (fbdev->blkdev.capabilities.mode == O_RDONLY) ? "ro" : "rw");
+	return 0;
+
+err_close:
+	sys_close(fbdev->fd);
+err_free:
+	uk_free(a, fbdev);
+	return rc;
+}
+
+static int fileblk_drv_probe(void)
+{
+	char *path, *next;
+	__u16 uid = 0;
+	int rc;
+
+	if (!images)
+		return 0;
+
+	for (path = images; path && *path != '\0'; path = next) {
+		next = strchr(path, ' ');
+		if (next)
+			*next++ = '\0';
+		if (*path == '\0')
+			continue;
+
+		rc = fileblk_add_dev(uid, path);
+		if (rc < 0) {
+			uk_pr_err(DRIVER_NAME": Failed to add %s: %d\n",
+				  path, rc);
+			continue;
+		}
+		uid++;
+	}
+
+	if (!uid)
+		return 0;
+	rc = ukplat_irq_register(FILEBLK_SIGNUM, fileblk_irq_handle, NULL);
+	if (rc < 0)
+		uk_pr_err(DRIVER_NAME": Failed to register the interrupt handler: %d\n",
+			  rc);
+	return rc;
+}
+
+static int fileblk_drv_init(struct uk_alloc *drv_allocator)
+{
+	UK_ASSERT(drv_allocator);
+
+	a = drv_allocator;
+	return 0;
+}
+
+static struct uk_bus fileblk_bus = {
+	.init = fileblk_drv_init,
+	.probe = fileblk_drv_probe,
+};
+UK_BUS_REGISTER(&fileblk_bus);
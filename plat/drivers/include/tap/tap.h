@@ -33,6 +33,7 @@
 #define __PLAT_DRV_TAP_H
 
 #include <uk/arch/types.h>
+#include <sys/uio.h>
 
 /**
  * Using the musl as reference for the data structure definition
@@ -43,9 +44,12 @@
 int tap_open(__u32 flags);
 int tap_close(int fd);
 int tap_dev_configure(int fd, __u32 feature_flags, void *arg);
+int tap_dev_offload_set(int fd, __u32 offloads);
 int tap_netif_configure(int fd, __u32 request, void *arg);
 int tap_netif_create(void);
 __ssz tap_read(int fd, void *buf, size_t count);
 __ssz tap_write(int fd, const void *buf, size_t count);
+__ssz tap_readv(int fd, const struct iovec *iov, int iovcnt);
+__ssz tap_writev(int fd, const struct iovec *iov, int iovcnt);
 
 #endif /* __PLAT_DRV_TAP_H */
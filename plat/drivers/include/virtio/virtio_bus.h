@@ -100,8 +100,8 @@ struct virtio_config_ops {
 			  __u32 len, __u8 type_len);
 	/** Get the feature */
 	__u64 (*features_get)(struct virtio_dev *vdev);
-	/** Set the feature */
-	void (*features_set)(struct virtio_dev *vdev, __u64 features);
+	/** Set the feature. Fails if the device rejects the feature set. */
+	int (*features_set)(struct virtio_dev *vdev, __u64 features);
 	/** Get and Set Status */
 	__u8 (*status_get)(struct virtio_dev *vdev);
 	void (*status_set)(struct virtio_dev *vdev, __u8 status);
@@ -148,6 +148,11 @@ struct virtio_dev {
 	struct virtio_driver *vdrv;
 	/* Status of the device */
 	enum virtio_dev_status status;
+	/*
+	 * Entries of the indirect descriptor tables of the virtqueues that
+	 * are set up afterwards, 0 for CONFIG_VIRTIO_RING_INDIRECT_MAX
+	 */
+	__u16 indirect_max;
 };
 
 /**
@@ -221,18 +226,28 @@ static inline __u64 virtio_feature_get(struct virtio_dev *vdev)
 }
 
 /**
- * The function to set the negotiated features.
+ * The function to set the negotiated features. The ring features and
+ * VIRTIO_F_VERSION_1 offered by the host are added on behalf of the driver
+ * and the result is stored in vdev->features, so that the virtqueues created
+ * afterwards use them.
  * @param vdev
  *	Reference to the virtio device.
  * @param feature
  *	A bit map of the feature negotiated.
+ * @return
+ *	0 on success, or a negative errno value if the device does not accept
+ *	the features. The device must not be used in this case.
  */
-static inline void virtio_feature_set(struct virtio_dev *vdev, __u32 feature)
+static inline int virtio_feature_set(struct virtio_dev *vdev, __u64 feature)
 {
 	UK_ASSERT(vdev);
 
+	feature |= virtio_feature_get(vdev)
+		   & (VIRTQUEUE_F_RING | (1ULL << VIRTIO_F_VERSION_1));
+	vdev->features = virtqueue_feature_negotiate(feature);
 	if (likely(vdev->cops->features_set))
-		vdev->cops->features_set(vdev, feature);
+		return vdev->cops->features_set(vdev, vdev->features);
+	return 0;
 }
 
 /**
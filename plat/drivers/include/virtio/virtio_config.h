@@ -46,11 +46,14 @@ extern "C" {
 #define VIRTIO_CONFIG_STATUS_ACK           0x1  /* recognize device as virtio */
 #define VIRTIO_CONFIG_STATUS_DRIVER        0x2  /* driver for the device found*/
 #define VIRTIO_CONFIG_STATUS_DRIVER_OK     0x4  /* initialization is complete */
+#define VIRTIO_CONFIG_STATUS_FEATURES_OK   0x8  /* feature negotiation is done */
 #define VIRTIO_CONFIG_STATUS_NEEDS_RESET   0x40 /* device needs reset */
 #define VIRTIO_CONFIG_STATUS_FAIL          0x80 /* device something's wrong*/
 
 #define VIRTIO_TRANSPORT_F_START    28
 #define VIRTIO_TRANSPORT_F_END      32
+/* Device specific feature bits continue from here on */
+#define VIRTIO_DEVICE_F_HIGH_START  50
 
 /* v1.0 compliant. */
 #define VIRTIO_F_VERSION_1		32
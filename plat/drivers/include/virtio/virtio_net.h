@@ -70,6 +70,8 @@
 					 * Steering
 					 */
 #define VIRTIO_NET_F_CTRL_MAC_ADDR 23	/* Set MAC address */
+#define VIRTIO_NET_F_HASH_REPORT 57	/* Device reports packet hashes */
+#define VIRTIO_NET_F_RSS	60	/* Device supports RSS steering */
 
 #define VIRTIO_NET_F_SPEED_DUPLEX 63	/* Device set linkspeed and duplex */
 
@@ -103,8 +105,27 @@ struct virtio_net_config {
 	 * Any other value stands for unknown.
 	 */
 	__u8 duplex;
+	/* Maximum length of the RSS key (if VIRTIO_NET_F_RSS or
+	 * VIRTIO_NET_F_HASH_REPORT)
+	 */
+	__u8 rss_max_key_size;
+	/* Maximum length of the RSS indirection table (if VIRTIO_NET_F_RSS) */
+	__u16 rss_max_indirection_table_length;
+	/* See VIRTIO_NET_RSS_HASH_TYPE_* */
+	__u32 supported_hash_types;
 } __packed;
 
+/* Hash types for VIRTIO_NET_F_RSS and VIRTIO_NET_F_HASH_REPORT */
+#define VIRTIO_NET_RSS_HASH_TYPE_IPv4		(1 << 0)
+#define VIRTIO_NET_RSS_HASH_TYPE_TCPv4		(1 << 1)
+#define VIRTIO_NET_RSS_HASH_TYPE_UDPv4		(1 << 2)
+#define VIRTIO_NET_RSS_HASH_TYPE_IPv6		(1 << 3)
+#define VIRTIO_NET_RSS_HASH_TYPE_TCPv6		(1 << 4)
+#define VIRTIO_NET_RSS_HASH_TYPE_UDPv6		(1 << 5)
+#define VIRTIO_NET_RSS_HASH_TYPE_IP_EX		(1 << 6)
+#define VIRTIO_NET_RSS_HASH_TYPE_TCP_EX		(1 << 7)
+#define VIRTIO_NET_RSS_HASH_TYPE_UDP_EX		(1 << 8)
+
 /* This header comes first in the scatter-gather list.
  * For legacy virtio, if VIRTIO_F_ANY_LAYOUT is not negotiated, it must
  * be the first element of the scatter-gather list.  If you don't
@@ -136,6 +157,26 @@ struct virtio_net_hdr_mrg_rxbuf {
 	__virtio_le16 num_buffers;	/* Number of merged rx buffers */
 };
 
+/* This is the version of the header to use when the HASH_REPORT
+ * feature has been negotiated.
+ */
+struct virtio_net_hdr_v1_hash {
+	struct virtio_net_hdr_mrg_rxbuf hdr;
+	__virtio_le32 hash_value;
+#define VIRTIO_NET_HASH_REPORT_NONE            0
+#define VIRTIO_NET_HASH_REPORT_IPv4            1
+#define VIRTIO_NET_HASH_REPORT_TCPv4           2
+#define VIRTIO_NET_HASH_REPORT_UDPv4           3
+#define VIRTIO_NET_HASH_REPORT_IPv6            4
+#define VIRTIO_NET_HASH_REPORT_TCPv6           5
+#define VIRTIO_NET_HASH_REPORT_UDPv6           6
+#define VIRTIO_NET_HASH_REPORT_IPv6_EX         7
+#define VIRTIO_NET_HASH_REPORT_TCPv6_EX        8
+#define VIRTIO_NET_HASH_REPORT_UDPv6_EX        9
+	__virtio_le16 hash_report;
+	__virtio_le16 padding;
+};
+
 /*
  * Control virtqueue data structures
  *
@@ -239,6 +280,29 @@ struct virtio_net_ctrl_mq {
  #define VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET        0
  #define VIRTIO_NET_CTRL_MQ_VQ_PAIRS_MIN        1
  #define VIRTIO_NET_CTRL_MQ_VQ_PAIRS_MAX        0x8000
+ #define VIRTIO_NET_CTRL_MQ_RSS_CONFIG          1
+ #define VIRTIO_NET_CTRL_MQ_HASH_CONFIG         2
+
+/*
+ * The command VIRTIO_NET_CTRL_MQ_RSS_CONFIG (with VIRTIO_NET_F_RSS) carries
+ * the following variable-length structure:
+ *
+ *	__le32 hash_types;
+ *	__le16 indirection_table_mask;
+ *	__le16 unclassified_queue;
+ *	__le16 indirection_table[indirection_table_mask + 1];
+ *	__le16 max_tx_vq;
+ *	__u8   hash_key_length;
+ *	__u8   hash_key_data[hash_key_length];
+ *
+ * VIRTIO_NET_CTRL_MQ_HASH_CONFIG (with VIRTIO_NET_F_HASH_REPORT only)
+ * configures hash calculation without steering:
+ *
+ *	__le32 hash_types;
+ *	__le16 reserved[4];
+ *	__u8   hash_key_length;
+ *	__u8   hash_key_data[hash_key_length];
+ */
 
 /*
  * Control network offloads
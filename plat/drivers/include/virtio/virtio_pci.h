@@ -35,7 +35,7 @@ extern "C" {
 #endif /* __cplusplus __ */
 
 /* virtio config space layout */
-/* TODO we currently support only the legacy interface */
+/* Legacy interface, in I/O BAR 0 */
 #define VIRTIO_PCI_HOST_FEATURES        0    /* 32-bit r/o */
 #define VIRTIO_PCI_GUEST_FEATURES       4    /* 32-bit r/w */
 #define VIRTIO_PCI_QUEUE_PFN            8    /* 32-bit r/w */
@@ -63,10 +63,57 @@ extern "C" {
 #define VIRTIO_PCI_ISR_HAS_INTR         0x1  /* interrupt is for this device */
 #define VIRTIO_PCI_ISR_CONFIG           0x2  /* config change bit */
 
-/* TODO Revisit when adding MSI support. */
-#define VIRTIO_PCI_CONFIG_OFF           20
+/*
+ * With MSI-X enabled, the vector registers for the configuration change
+ * interrupt and for the selected queue follow the ISR and move the
+ * device-specific configuration back by 4 bytes.
+ */
+#define VIRTIO_MSI_CONFIG_VECTOR        20   /* 16-bit r/w */
+#define VIRTIO_MSI_QUEUE_VECTOR         22   /* 16-bit r/w */
+#define VIRTIO_MSI_NO_VECTOR            0xffff
+
+#define VIRTIO_PCI_CONFIG_OFF(msix_enabled)	((msix_enabled) ? 24 : 20)
 #define VIRTIO_PCI_VRING_ALIGN          4096
 
+/*
+ * Virtio 1.0 (modern) interface: the device describes where its
+ * configuration structures are located with vendor-specific PCI
+ * capabilities (struct virtio_pci_cap).
+ */
+#define VIRTIO_PCI_CAP_CFG_TYPE         3    /* 8-bit, VIRTIO_PCI_CAP_*_CFG */
+#define VIRTIO_PCI_CAP_BAR              4    /* 8-bit */
+#define VIRTIO_PCI_CAP_OFFSET           8    /* 32-bit, within the BAR */
+#define VIRTIO_PCI_CAP_LENGTH           12   /* 32-bit */
+#define VIRTIO_PCI_NOTIFY_CAP_MULT      16   /* 32-bit, notify cap only */
+
+#define VIRTIO_PCI_CAP_COMMON_CFG       1
+#define VIRTIO_PCI_CAP_NOTIFY_CFG       2
+#define VIRTIO_PCI_CAP_ISR_CFG          3
+#define VIRTIO_PCI_CAP_DEVICE_CFG       4
+#define VIRTIO_PCI_CAP_PCI_CFG          5
+
+/* Common configuration structure (struct virtio_pci_common_cfg) */
+#define VIRTIO_PCI_COMMON_DFSELECT      0    /* 32-bit r/w */
+#define VIRTIO_PCI_COMMON_DF            4    /* 32-bit r/o */
+#define VIRTIO_PCI_COMMON_GFSELECT      8    /* 32-bit r/w */
+#define VIRTIO_PCI_COMMON_GF            12   /* 32-bit r/w */
+#define VIRTIO_PCI_COMMON_MSIX          16   /* 16-bit r/w */
+#define VIRTIO_PCI_COMMON_NUMQ          18   /* 16-bit r/o */
+#define VIRTIO_PCI_COMMON_STATUS        20   /* 8-bit r/w */
+#define VIRTIO_PCI_COMMON_CFGGENERATION 21   /* 8-bit r/o */
+#define VIRTIO_PCI_COMMON_Q_SELECT      22   /* 16-bit r/w */
+#define VIRTIO_PCI_COMMON_Q_SIZE        24   /* 16-bit r/w */
+#define VIRTIO_PCI_COMMON_Q_MSIX        26   /* 16-bit r/w */
+#define VIRTIO_PCI_COMMON_Q_ENABLE      28   /* 16-bit r/w */
+#define VIRTIO_PCI_COMMON_Q_NOFF        30   /* 16-bit r/o */
+#define VIRTIO_PCI_COMMON_Q_DESCLO      32   /* 32-bit r/w */
+#define VIRTIO_PCI_COMMON_Q_DESCHI      36   /* 32-bit r/w */
+#define VIRTIO_PCI_COMMON_Q_AVAILLO     40   /* 32-bit r/w */
+#define VIRTIO_PCI_COMMON_Q_AVAILHI     44   /* 32-bit r/w */
+#define VIRTIO_PCI_COMMON_Q_USEDLO      48   /* 32-bit r/w */
+#define VIRTIO_PCI_COMMON_Q_USEDHI      52   /* 32-bit r/w */
+#define VIRTIO_PCI_COMMON_CFG_LEN       56
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus __ */
@@ -81,6 +81,23 @@ extern "C" {
 /* Arbitrary descriptor layouts. */
 #define VIRTIO_F_ANY_LAYOUT       27
 
+/* Support for the packed virtqueue layout */
+#define VIRTIO_F_RING_PACKED      34
+
+/* Packed ring: This marks a descriptor as available (driver) or used (device)
+ * when the bit equals the respective wrap counter.
+ */
+#define VRING_PACKED_DESC_F_AVAIL	(1 << 7)
+#define VRING_PACKED_DESC_F_USED	(1 << 15)
+
+/* Packed ring: Event suppression flags */
+#define VRING_PACKED_EVENT_FLAG_ENABLE	0x0
+#define VRING_PACKED_EVENT_FLAG_DISABLE	0x1
+/* Only notify when the descriptor at `off_wrap` was made available/used */
+#define VRING_PACKED_EVENT_FLAG_DESC	0x2
+/* Position of the wrap counter bit in `off_wrap` */
+#define VRING_PACKED_EVENT_F_WRAP_CTR	15
+
 /**
  * Virtqueue descriptors: 16 bytes.
  * These can chain together via "next".
@@ -126,6 +143,38 @@ struct vring {
 	struct vring_used *used;
 };
 
+/**
+ * Packed virtqueue descriptors: 16 bytes.
+ * Available and used descriptors share the same ring.
+ */
+struct vring_packed_desc {
+	/* Buffer address (guest-physical). */
+	__virtio_le64 addr;
+	/* Buffer length. */
+	__virtio_le32 len;
+	/* Buffer ID. */
+	__virtio_le16 id;
+	/* The flags depending on descriptor type. */
+	__virtio_le16 flags;
+};
+
+struct vring_packed_desc_event {
+	/* Descriptor ring change event offset and wrap counter. */
+	__virtio_le16 off_wrap;
+	/* Descriptor ring change event flags. */
+	__virtio_le16 flags;
+};
+
+struct vring_packed {
+	unsigned int num;
+
+	struct vring_packed_desc *desc;
+	/* Written by the driver to suppress interrupts */
+	struct vring_packed_desc_event *driver;
+	/* Written by the device to suppress notifications */
+	struct vring_packed_desc_event *device;
+};
+
 /* The standard layout for the ring is a continuous chunk of memory which
  * looks like this.  We assume num is a power of 2.
  *
@@ -157,7 +206,9 @@ struct vring {
  * versa. They are at the end for backwards compatibility.
  */
 #define vring_used_event(vr) ((vr)->avail->ring[(vr)->num])
-#define vring_avail_event(vr) (*(__virtio16 *)&(vr)->used->ring[(vr)->num])
+#define vring_avail_event(vr)						\
+	(*(__virtio_le16 *)((char *)(vr)->used + sizeof(struct vring_used) +	\
+			    (vr)->num * sizeof(struct vring_used_elem)))
 
 static inline void vring_init(struct vring *vr, unsigned int num, uint8_t *p,
 			      unsigned long align)
@@ -183,6 +234,25 @@ static inline unsigned int vring_size(unsigned int num, unsigned long align)
 	return size;
 }
 
+/* The packed layout is the descriptor ring followed by the driver and the
+ * device event suppression structures.
+ */
+static inline void vring_packed_init(struct vring_packed *vr,
+				     unsigned int num, uint8_t *p)
+{
+	vr->num = num;
+	vr->desc = (struct vring_packed_desc *) p;
+	vr->driver = (struct vring_packed_desc_event *) (p +
+			num * sizeof(struct vring_packed_desc));
+	vr->device = vr->driver + 1;
+}
+
+static inline unsigned int vring_packed_size(unsigned int num)
+{
+	return num * sizeof(struct vring_packed_desc)
+		+ 2 * sizeof(struct vring_packed_desc_event);
+}
+
 static inline int vring_need_event(__u16 event_idx, __u16 new_idx,
 				   __u16 old_idx)
 {
@@ -44,6 +44,12 @@
 extern "C" {
 #endif /* __cplusplus */
 
+/* Ring features that are negotiated for every device */
+#define VIRTQUEUE_F_RING			\
+	((1ULL << VIRTIO_F_INDIRECT_DESC) |	\
+	 (1ULL << VIRTIO_F_EVENT_IDX) |		\
+	 (1ULL << VIRTIO_F_RING_PACKED))
+
 /**
  * Type declarations
  */
@@ -112,6 +118,18 @@ __paddr_t virtqueue_get_used_addr(struct virtqueue *vq);
  */
 unsigned int virtqueue_vring_get_num(struct virtqueue *vq);
 
+/**
+ * Get the maximum number of segments of a buffer that is described with an
+ * indirect descriptor table.
+ *
+ * @param vq
+ *	Reference to the virtual queue
+ * @return
+ *	the number of entries of the indirect tables, 0 if indirect
+ *	descriptors are not used
+ */
+unsigned int virtqueue_indirect_max(struct virtqueue *vq);
+
 
 /**
  * Ring interrupt handler. This function is invoked from the interrupt handler
@@ -137,7 +155,9 @@ int virtqueue_ring_interrupt(void *obj);
 __u64 virtqueue_feature_negotiate(__u64 feature_set);
 
 /**
- * Check if host notification is enabled.
+ * Check if host notification is enabled. With VIRTIO_F_EVENT_IDX, this also
+ * records that the host is up to date with the buffers published so far, so
+ * it should only be called right before notifying the host.
  *
  * @param vq
  *	Reference to the virtqueue.
@@ -147,6 +167,19 @@ __u64 virtqueue_feature_negotiate(__u64 feature_set);
  */
 int virtqueue_notify_enabled(struct virtqueue *vq);
 
+/**
+ * Get the number of ring descriptors a buffer occupies.
+ *
+ * @param vq
+ *	Reference to the virtqueue.
+ * @param nr_segs
+ *	The number of segments of the buffer.
+ * @return
+ *	1 if the buffer is described with an indirect descriptor table,
+ *	nr_segs otherwise.
+ */
+int virtqueue_desc_count(struct virtqueue *vq, __u16 nr_segs);
+
 /**
  * Remove the user buffer from the virtqueue.
  *
@@ -192,6 +225,36 @@ int virtqueue_buffer_enqueue(struct virtqueue *vq, void *cookie,
 			     struct uk_sglist *sg, __u16 read_bufs,
 			     __u16 write_bufs);
 
+/**
+ * Create a descriptor chain like virtqueue_buffer_enqueue() but do not make it
+ * visible to the host yet. This allows to add a batch of buffers and publish
+ * them with a single update of the available ring index.
+ * @param vq
+ *	Reference to the virtual queue
+ * @param cookie
+ *	Reference to the cookie to reconstruct the buffer.
+ * @param sg
+ *	Reference to the scatter gather list
+ * @param read_bufs
+ *	The number of read buffer.
+ * @param write_bufs
+ *	The number of write buffer.
+ *
+ * @return
+ *	Same as virtqueue_buffer_enqueue().
+ */
+int virtqueue_buffer_add(struct virtqueue *vq, void *cookie,
+			 struct uk_sglist *sg, __u16 read_bufs,
+			 __u16 write_bufs);
+
+/**
+ * Make all buffers added with virtqueue_buffer_add() visible to the host.
+ * The host still needs to be notified with virtqueue_host_notify().
+ * @param vq
+ *	Reference to the virtual queue
+ */
+void virtqueue_buffer_publish(struct virtqueue *vq);
+
 /**
  * Allocate a virtqueue.
  * @param queue_id
@@ -35,6 +35,7 @@
 #include <string.h>
 #include <uk/alloc.h>
 #include <uk/arch/types.h>
+#include <uk/essentials.h>
 #include <uk/netdev_core.h>
 #include <uk/netdev_driver.h>
 #include <uk/netbuf.h>
@@ -58,6 +59,22 @@
 
 #define ETH_PKT_PAYLOAD_LEN       1500
 
+#ifdef CONFIG_TAP_VNET_HDR
+#define TAP_HDR_LEN               ((__ssz) sizeof(struct uk_tap_vnet_hdr))
+#else
+#define TAP_HDR_LEN               0
+#endif /* CONFIG_TAP_VNET_HDR */
+
+#ifdef CONFIG_TAP_LRO
+/* Enough buffers for a coalesced packet of 64KiB */
+#define TAP_RXPOOL_SIZE           64
+#else
+#define TAP_RXPOOL_SIZE           32
+#endif /* CONFIG_TAP_LRO */
+
+/* Maximum number of buffers of a transmitted packet chain */
+#define TAP_TXIOV_MAX             64
+
 /**
  * TODO: Find a better way of forwarding the command line argument to the
  * driver. For now they are defined as macros from this driver.
@@ -92,6 +109,10 @@ struct uk_netdev_rx_queue {
 	uk_netdev_alloc_rxpkts alloc_rxpkts;
 	/* Reference to a user data */
 	void *alloc_rxpkts_argp;
+	/* Buffers allocated for the upcoming packets */
+	struct uk_netbuf *pool[TAP_RXPOOL_SIZE];
+	/* Number of buffers in the pool */
+	__u16 pool_cnt;
 };
 
 struct tap_net_dev {
@@ -115,8 +136,10 @@ struct tap_net_dev {
 	__u16 tid;
 	/* UK Netdevice identifier */
 	__u16 id;
-	/* File Descriptor for the tap device */
-	int tap_fd;
+	/* File descriptors of the tap device, one per queue pair */
+	int tap_fds[CONFIG_TAP_MAX_QUEUE_PAIRS];
+	/* Number of open file descriptors */
+	__u16 tap_fd_cnt;
 	/* Control socket descriptor */
 	int ctrl_sock;
 	/* Name of the character device */
@@ -169,6 +192,12 @@ static int tap_netdev_xmit(struct uk_netdev *dev,
 static int tap_netdev_recv(struct uk_netdev *dev,
 			   struct uk_netdev_rx_queue *queue,
 			   struct uk_netbuf **pkt);
+static int tap_netdev_xmit_burst(struct uk_netdev *dev,
+				 struct uk_netdev_tx_queue *queue,
+				 struct uk_netbuf **pkts, __u16 *cnt);
+static int tap_netdev_recv_burst(struct uk_netdev *dev,
+				 struct uk_netdev_rx_queue *queue,
+				 struct uk_netbuf **pkts, __u16 *cnt);
 static struct uk_netdev_rx_queue *tap_netdev_rxq_setup(struct uk_netdev *dev,
 					__u16 queue_id, __u16 nb_desc,
 					struct uk_netdev_rxqueue_conf *conf);
@@ -190,7 +219,9 @@ static int tap_netdev_rxq_info_get(struct uk_netdev *dev, __u16 queue_id,
 				   struct uk_netdev_queue_info *qinfo);
 static int tap_netdev_txq_info_get(struct uk_netdev *dev, __u16 queue_id,
 				   struct uk_netdev_queue_info *qinfo);
-static int tap_device_create(struct tap_net_dev *tdev, __u32 feature_flags);
+static int tap_device_create(struct tap_net_dev *tdev, __u32 feature_flags,
+			     __u16 nb_queues);
+static void tap_device_close(struct tap_net_dev *tdev);
 static int tap_mac_generate(__u8 *addr, __u8 dev_id);
 static int tap_dev_br_add(struct tap_net_dev *tdev);
 static int tap_dev_index_get(struct tap_net_dev *tdev);
@@ -250,60 +281,222 @@ exit:
 	return rc;
 }
 
-static int tap_netdev_recv(struct uk_netdev *dev,
-			   struct uk_netdev_rx_queue *queue,
-			   struct uk_netbuf **pkt)
+#ifdef CONFIG_TAP_VNET_HDR
+static void tap_rxhdr_parse(struct uk_netbuf *buf,
+			    const struct uk_tap_vnet_hdr *vhdr)
 {
-	int rc = 0;
-	struct tap_net_dev *tdev __maybe_unused;
-	struct uk_netbuf *_pkt = NULL;
+	buf->flags  = ((vhdr->flags & UK_TAP_VNET_HDR_F_DATA_VALID)
+		       ? UK_NETBUF_F_DATA_VALID   : 0x0);
+	if (vhdr->flags & UK_TAP_VNET_HDR_F_NEEDS_CSUM) {
+		buf->flags |= UK_NETBUF_F_PARTIAL_CSUM;
+		buf->csum_offset = vhdr->csum_offset;
+		/* The header is read into a separate buffer */
+		buf->csum_start  = vhdr->csum_start;
+	}
 
-	UK_ASSERT(dev);
-	UK_ASSERT(queue && pkt);
+	switch (vhdr->gso_type & ~UK_TAP_VNET_HDR_GSO_ECN) {
+	case UK_TAP_VNET_HDR_GSO_TCPV4:
+		buf->flags |= UK_NETBUF_F_GSO_TCPV4;
+		break;
+	case UK_TAP_VNET_HDR_GSO_TCPV6:
+		buf->flags |= UK_NETBUF_F_GSO_TCPV6;
+		break;
+	case UK_TAP_VNET_HDR_GSO_UDP:
+		buf->flags |= UK_NETBUF_F_GSO_UDP;
+		break;
+	default:
+		buf->gso_size = 0;
+		buf->header_len = 0;
+		return;
+	}
+	if (vhdr->gso_type & UK_TAP_VNET_HDR_GSO_ECN)
+		buf->flags |= UK_NETBUF_F_GSO_ECN;
+	buf->gso_size = vhdr->gso_size;
+	buf->header_len = vhdr->hdr_len;
+}
 
-	tdev = to_tapnetdev(dev);
+static int tap_txhdr_fill(struct uk_tap_vnet_hdr *vhdr,
+			  const struct uk_netbuf *pkt)
+{
+	__u8 gso_type;
 
-	if (!queue->alloc_rxpkts)
+	memset(vhdr, 0, sizeof(*vhdr));
+	if (pkt->flags & UK_NETBUF_F_PARTIAL_CSUM) {
+		vhdr->flags       = UK_TAP_VNET_HDR_F_NEEDS_CSUM;
+		vhdr->csum_start  = pkt->csum_start;
+		vhdr->csum_offset = pkt->csum_offset;
+	}
+
+	switch (pkt->flags & UK_NETBUF_F_GSO_MASK) {
+	case 0:
+		return 0;
+	case UK_NETBUF_F_GSO_TCPV4:
+		gso_type = UK_TAP_VNET_HDR_GSO_TCPV4;
+		break;
+	case UK_NETBUF_F_GSO_TCPV6:
+		gso_type = UK_TAP_VNET_HDR_GSO_TCPV6;
+		break;
+	case UK_NETBUF_F_GSO_UDP:
+		/* UFO is deprecated and refused by recent host kernels */
+		return -ENOTSUP;
+	default:
+		uk_pr_err(DRIVER_NAME": Conflicting segmentation offload flags: %x\n",
+			  pkt->flags);
 		return -EINVAL;
+	}
+
+	if (unlikely(!(pkt->flags & UK_NETBUF_F_PARTIAL_CSUM))) {
+		uk_pr_err(DRIVER_NAME": Segmentation offload requires a partial checksum\n");
+		return -EINVAL;
+	}
+	if (pkt->flags & UK_NETBUF_F_GSO_ECN)
+		gso_type |= UK_TAP_VNET_HDR_GSO_ECN;
+	vhdr->gso_type = gso_type;
+	vhdr->gso_size = pkt->gso_size;
+	vhdr->hdr_len  = pkt->header_len;
+	return 0;
+}
+#endif /* CONFIG_TAP_VNET_HDR */
 
+/**
+ * Top up the buffer pool of a receive queue to `want` buffers.
+ */
+static inline void tap_rxq_refill(struct uk_netdev_rx_queue *rxq, __u16 want)
+{
+	if (want > TAP_RXPOOL_SIZE)
+		want = TAP_RXPOOL_SIZE;
+	if (rxq->pool_cnt >= want)
+		return;
+
+	rxq->pool_cnt += rxq->alloc_rxpkts(rxq->alloc_rxpkts_argp,
+					   &rxq->pool[rxq->pool_cnt],
+					   want - rxq->pool_cnt);
+}
 
-	/**
-	 * Allocate the packet in which the packet will be received.
-	 */
-	rc = queue->alloc_rxpkts(queue->alloc_rxpkts_argp, &_pkt, 1);
-	if (rc == 0) {
-		uk_pr_err(DRIVER_NAME": Failed to allocate the memory\n");
-		_pkt = NULL;
-		rc = UK_NETDEV_STATUS_UNDERRUN | UK_NETDEV_STATUS_MORE;
+/**
+ * Read one packet into the buffers at the head of the pool. A coalesced
+ * packet spans as many of them as it takes and is returned as a chain.
+ * Returns the length of the packet, 0 if there is none, or a negative
+ * error code.
+ */
+static int tap_rxq_read(struct uk_netdev_rx_queue *rxq,
+			struct uk_netbuf **pkt)
+{
+	struct iovec iov[TAP_RXPOOL_SIZE + 1];
+#ifdef CONFIG_TAP_VNET_HDR
+	struct uk_tap_vnet_hdr vhdr;
+#endif /* CONFIG_TAP_VNET_HDR */
+	struct uk_netbuf *head = NULL, *buf;
+	int iovcnt = 0;
+	__u16 nbufs, i;
+	__ssz rc;
+	__sz left;
+
+	UK_ASSERT(rxq->pool_cnt > 0);
+
+#ifdef CONFIG_TAP_VNET_HDR
+	iov[iovcnt].iov_base = &vhdr;
+	iov[iovcnt].iov_len = sizeof(vhdr);
+	iovcnt++;
+#endif /* CONFIG_TAP_VNET_HDR */
+#ifdef CONFIG_TAP_LRO
+	nbufs = rxq->pool_cnt;
+#else
+	nbufs = 1;
+#endif /* CONFIG_TAP_LRO */
+	for (i = 0; i < nbufs; i++) {
+		iov[iovcnt].iov_base = rxq->pool[i]->data;
+		iov[iovcnt].iov_len = rxq->pool[i]->len;
+		iovcnt++;
+	}
+
+	rc = tap_readv(rxq->fd, iov, iovcnt);
+	if (rc == 0 || rc == -EWOULDBLOCK || rc == -EAGAIN)
+		return 0;
+	if (rc < 0)
 		return rc;
+	if (unlikely(rc <= TAP_HDR_LEN)) {
+		uk_pr_err(DRIVER_NAME": Received truncated packet (%ld bytes)\n",
+			  (long) rc);
+		return -EIO;
 	}
-	uk_pr_debug(DRIVER_NAME": Receiving on interface %s(%d) %p(%d)\n",
-		    tdev->name, queue->fd, _pkt->data, _pkt->len);
-	rc = tap_read(queue->fd, _pkt->data, _pkt->len);
-	if (rc > 0) {
-		uk_pr_debug(DRIVER_NAME": Recv pkt size: %d\n", rc);
-		/* Setting the length of the packet */
-		_pkt->len = rc;
-		rc = UK_NETDEV_STATUS_SUCCESS | UK_NETDEV_STATUS_MORE;
-	} else if (rc == 0 || rc == -EWOULDBLOCK || rc == -EAGAIN) {
-		rc = 0;
-		goto err_exit;
-	} else {
-		uk_pr_err(DRIVER_NAME": Failed(%d) to read the packet\n", rc);
-		goto err_exit;
+
+	left = rc - TAP_HDR_LEN;
+	for (i = 0; left > 0; i++) {
+		buf = rxq->pool[i];
+		if (buf->len > left)
+			buf->len = left;
+		left -= buf->len;
+		if (!head)
+			head = buf;
+		else
+			uk_netbuf_append(head, buf);
 	}
-	uk_pr_debug("uk_netdev buf ptr: %p\n", _pkt);
+	rxq->pool_cnt -= i;
+	memmove(&rxq->pool[0], &rxq->pool[i],
+		rxq->pool_cnt * sizeof(rxq->pool[0]));
+
+#ifdef CONFIG_TAP_VNET_HDR
+	tap_rxhdr_parse(head, &vhdr);
+#endif /* CONFIG_TAP_VNET_HDR */
+	*pkt = head;
+	return rc - TAP_HDR_LEN;
+}
 
-	*pkt = _pkt;
+/**
+ * Write a packet, including all buffers of its chain and the vnet header,
+ * with a single system call.
+ */
+static int tap_txq_write(struct uk_netdev_tx_queue *txq,
+			 struct uk_netbuf *pkt)
+{
+	struct iovec iov[TAP_TXIOV_MAX];
+#ifdef CONFIG_TAP_VNET_HDR
+	struct uk_tap_vnet_hdr vhdr;
+#endif /* CONFIG_TAP_VNET_HDR */
+	struct uk_netbuf *buf;
+	int iovcnt = 0;
+	int rc;
+
+#ifdef CONFIG_TAP_VNET_HDR
+	rc = tap_txhdr_fill(&vhdr, pkt);
+	if (unlikely(rc < 0))
+		return rc;
+	iov[iovcnt].iov_base = &vhdr;
+	iov[iovcnt].iov_len = sizeof(vhdr);
+	iovcnt++;
+#endif /* CONFIG_TAP_VNET_HDR */
+	UK_NETBUF_CHAIN_FOREACH(buf, pkt) {
+		if (!buf->len)
+			continue;
+		if (unlikely(iovcnt == TAP_TXIOV_MAX)) {
+			uk_pr_err(DRIVER_NAME": Packet consists of too many buffers\n");
+			return -EMSGSIZE;
+		}
+		iov[iovcnt].iov_base = buf->data;
+		iov[iovcnt].iov_len = buf->len;
+		iovcnt++;
+	}
 
-exit:
+	rc = tap_writev(txq->fd, iov, iovcnt);
+	if (rc > 0)
+		uk_pr_debug(DRIVER_NAME": Sent packet of size %d\n", rc);
 	return rc;
+}
 
-err_exit:
-	if (_pkt)
-		uk_netbuf_free(_pkt);
-	*pkt = NULL;
-	goto exit;
+static int tap_netdev_recv(struct uk_netdev *dev,
+			   struct uk_netdev_rx_queue *queue,
+			   struct uk_netbuf **pkt)
+{
+	__u16 cnt = 1;
+	int rc;
+
+	UK_ASSERT(pkt);
+
+	rc = tap_netdev_recv_burst(dev, queue, pkt, &cnt);
+	if (cnt == 0)
+		*pkt = NULL;
+	return rc;
 }
 
 static int tap_netdev_xmit(struct uk_netdev *dev,
@@ -311,26 +504,105 @@ static int tap_netdev_xmit(struct uk_netdev *dev,
 			   struct uk_netbuf *pkt)
 {
 	int rc = -EINVAL;
-	struct tap_net_dev *tdev __unused;
 
 	UK_ASSERT(dev);
 	UK_ASSERT(queue && pkt);
 
-	tdev = to_tapnetdev(dev);
-
-	rc = tap_write(queue->fd, pkt->data, pkt->len);
+	rc = tap_txq_write(queue, pkt);
 	if (rc > 0) {
-		uk_pr_info(DRIVER_NAME": Send packet of size %d\n", rc);
 		uk_netbuf_free(pkt);
 		rc = UK_NETDEV_STATUS_SUCCESS | UK_NETDEV_STATUS_MORE;
 	} else if (rc == -EWOULDBLOCK || rc == -EAGAIN) {
-		uk_pr_info(DRIVER_NAME": The send queue is full\n");
+		uk_pr_debug(DRIVER_NAME": The send queue is full\n");
 		rc = UK_NETDEV_STATUS_UNDERRUN;
 	}
 
 	return rc;
 }
 
+static int tap_netdev_recv_burst(struct uk_netdev *dev,
+				 struct uk_netdev_rx_queue *queue,
+				 struct uk_netbuf **pkts, __u16 *cnt)
+{
+	int rc = 0;
+	int status = 0x0;
+	__u16 n;
+
+	UK_ASSERT(dev);
+	UK_ASSERT(queue && pkts && cnt);
+
+	if (!queue->alloc_rxpkts)
+		return -EINVAL;
+
+	for (n = 0; n < *cnt; n++) {
+		/**
+		 * Buffers are allocated for the whole burst at once and kept
+		 * in the pool when no packet arrives.
+		 */
+#ifdef CONFIG_TAP_LRO
+		tap_rxq_refill(queue, TAP_RXPOOL_SIZE);
+#else
+		tap_rxq_refill(queue, *cnt - n);
+#endif /* CONFIG_TAP_LRO */
+		if (unlikely(!queue->pool_cnt)) {
+			status |= UK_NETDEV_STATUS_UNDERRUN;
+			break;
+		}
+
+		rc = tap_rxq_read(queue, &pkts[n]);
+		if (rc <= 0) {
+			if (rc < 0)
+				uk_pr_err(DRIVER_NAME": Failed(%d) to read the packet\n",
+					  rc);
+			break;
+		}
+	}
+	uk_pr_debug(DRIVER_NAME": Received %"__PRIu16" packets on fd %d\n",
+		    n, queue->fd);
+
+	if (n == 0 && rc < 0) {
+		*cnt = 0;
+		return rc;
+	}
+	if (n > 0) {
+		status |= UK_NETDEV_STATUS_SUCCESS;
+		/* The tap device may have more packets if the burst is full */
+		status |= (n == *cnt) ? UK_NETDEV_STATUS_MORE : 0x0;
+	}
+	*cnt = n;
+	return status;
+}
+
+static int tap_netdev_xmit_burst(struct uk_netdev *dev,
+				 struct uk_netdev_tx_queue *queue,
+				 struct uk_netbuf **pkts, __u16 *cnt)
+{
+	int rc = 0;
+	int status = 0x0;
+	__u16 n;
+
+	UK_ASSERT(dev);
+	UK_ASSERT(queue && pkts && cnt);
+
+	for (n = 0; n < *cnt; n++) {
+		rc = tap_txq_write(queue, pkts[n]);
+		if (rc <= 0)
+			break;
+		uk_netbuf_free(pkts[n]);
+	}
+	uk_pr_debug(DRIVER_NAME": Sent %"__PRIu16" packets on fd %d\n",
+		    n, queue->fd);
+
+	if (n == 0 && rc < 0 && rc != -EWOULDBLOCK && rc != -EAGAIN)
+		return rc;
+	if (n > 0) {
+		status |= UK_NETDEV_STATUS_SUCCESS;
+		status |= (n == *cnt) ? UK_NETDEV_STATUS_MORE : 0x0;
+	}
+	*cnt = n;
+	return status;
+}
+
 static int tap_netdev_txq_info_get(struct uk_netdev *dev __unused,
 				   __u16 queue_id __unused,
 				   struct uk_netdev_queue_info *qinfo)
@@ -410,6 +682,7 @@ static struct uk_netdev_rx_queue *tap_netdev_rxq_setup(struct uk_netdev *dev,
 	UK_ASSERT(dev && conf);
 
 	tdev = to_tapnetdev(dev);
+	UK_ASSERT(queue_id < tdev->tap_fd_cnt);
 	/* Fetch the default queue length of the rx queue */
 	rc = tap_dev_rxqlen_get(tdev);
 	if (rc < 0) {
@@ -442,7 +715,7 @@ static struct uk_netdev_rx_queue *tap_netdev_rxq_setup(struct uk_netdev *dev,
 	rxq->a = conf->a;
 	rxq->alloc_rxpkts = conf->alloc_rxpkts;
 	rxq->alloc_rxpkts_argp = conf->alloc_rxpkts_argp;
-	rxq->fd = tdev->tap_fd;
+	rxq->fd = tdev->tap_fds[queue_id];
 	UK_TAILQ_INSERT_TAIL(&tdev->rxqs, rxq, next);
 	tdev->rxq_cnt++;
 exit:
@@ -466,6 +739,7 @@ static struct uk_netdev_tx_queue *tap_netdev_txq_setup(struct uk_netdev *dev,
 	UK_ASSERT(dev && conf);
 
 	tdev = to_tapnetdev(dev);
+	UK_ASSERT(queue_id < tdev->tap_fd_cnt);
 	txq = uk_zalloc(conf->a, sizeof(*txq));
 	if (!txq) {
 		uk_pr_err(DRIVER_NAME": Failed to allocate the tx queue\n");
@@ -474,7 +748,7 @@ static struct uk_netdev_tx_queue *tap_netdev_txq_setup(struct uk_netdev *dev,
 	}
 
 	txq->queue_id = queue_id;
-	txq->fd = tdev->tap_fd;
+	txq->fd = tdev->tap_fds[queue_id];
 	txq->a = conf->a;
 	UK_TAILQ_INSERT_TAIL(&tdev->txqs, txq, next);
 	tdev->txq_cnt++;
@@ -510,15 +784,29 @@ static int tap_netdev_start(struct uk_netdev *n)
 	return 0;
 }
 
-static void tap_netdev_info_get(struct uk_netdev *dev __unused,
+static void tap_netdev_info_get(struct uk_netdev *dev,
 				struct uk_netdev_info *dev_info)
 {
-	UK_ASSERT(dev_info);
-	dev_info->max_rx_queues = 1;
-	dev_info->max_tx_queues = 1;
+	struct tap_net_dev *tdev;
+
+	UK_ASSERT(dev && dev_info);
+	tdev = to_tapnetdev(dev);
+
+	dev_info->max_rx_queues = tdev->max_qpairs;
+	dev_info->max_tx_queues = tdev->max_qpairs;
+	/* Each file descriptor serves one rx and one tx queue */
+	dev_info->in_queue_pairs = 1;
 	dev_info->nb_encap_tx = 0;
 	dev_info->nb_encap_rx = 0;
 	dev_info->features = 0;
+#ifdef CONFIG_TAP_VNET_HDR
+	dev_info->features |= UK_NETDEV_F_PARTIAL_CSUM
+			      | UK_NETDEV_F_TSO4
+			      | UK_NETDEV_F_TSO6;
+#endif /* CONFIG_TAP_VNET_HDR */
+#ifdef CONFIG_TAP_LRO
+	dev_info->features |= UK_NETDEV_F_LRO;
+#endif /* CONFIG_TAP_LRO */
 }
 
 static unsigned int tap_netdev_promisc_get(struct uk_netdev *n)
@@ -647,6 +935,7 @@ static int tap_netdev_configure(struct uk_netdev *n,
 	int rc = 0;
 	struct tap_net_dev *tdev = NULL;
 	__u32 feature_flag = 0;
+	__u16 nb_queues;
 
 	UK_ASSERT(n && conf);
 	tdev = to_tapnetdev(n);
@@ -656,17 +945,20 @@ static int tap_netdev_configure(struct uk_netdev *n,
 		uk_pr_err(DRIVER_NAME": rx-queue:%d, tx-queue:%d not supported",
 			  conf->nb_rx_queues, conf->nb_tx_queues);
 		return -ENOTSUP;
-	} else if (conf->nb_rx_queues > 1 || conf->nb_tx_queues > 1)
-		/**
-		 * TODO:
-		 * We don't support multi-queues on the uknetdev. Might need to
-		 * revisit this when implementing multi-queue support on
-		 * uknetdev
-		 */
+	}
+
+	/* Every queue pair gets its own file descriptor */
+	nb_queues = MAX(conf->nb_rx_queues, conf->nb_tx_queues);
+	if (nb_queues == 0)
+		nb_queues = 1;
+	else if (nb_queues > 1)
 		feature_flag |= UK_IFF_MULTI_QUEUE;
+#ifdef CONFIG_TAP_VNET_HDR
+	feature_flag |= UK_IFF_VNET_HDR;
+#endif /* CONFIG_TAP_VNET_HDR */
 
 	/* Open the device and configure the tap interface */
-	rc = tap_device_create(tdev, feature_flag);
+	rc = tap_device_create(tdev, feature_flag, nb_queues);
 	if (rc < 0) {
 		uk_pr_err(DRIVER_NAME": Failed to configure the tap device\n");
 		goto exit;
@@ -708,39 +1000,75 @@ exit:
 close_ctrl_sock:
 	tap_close(tdev->ctrl_sock);
 close_tap_dev:
-	tap_close(tdev->tap_fd);
+	tap_device_close(tdev);
 	goto exit;
 }
 
-static int tap_device_create(struct tap_net_dev *tdev, __u32 feature_flags)
+static void tap_device_close(struct tap_net_dev *tdev)
+{
+	while (tdev->tap_fd_cnt > 0) {
+		tdev->tap_fd_cnt--;
+		tap_close(tdev->tap_fds[tdev->tap_fd_cnt]);
+		tdev->tap_fds[tdev->tap_fd_cnt] = -1;
+	}
+}
+
+static int tap_device_create(struct tap_net_dev *tdev, __u32 feature_flags,
+			     __u16 nb_queues)
 {
 	int rc = 0;
 	struct uk_ifreq ifreq = {0};
+	__u16 i;
 
-	/* Open the tap device */
-	rc = tap_open(O_RDWR | O_NONBLOCK);
-	if (rc < 0) {
-		uk_pr_err(DRIVER_NAME": Failed(%d) to open the tap device\n",
-			  rc);
-		return rc;
-	}
+	UK_ASSERT(nb_queues > 0 && nb_queues <= CONFIG_TAP_MAX_QUEUE_PAIRS);
 
-	tdev->tap_fd = rc;
+	for (i = 0; i < nb_queues; i++) {
+		/* Open the tap device */
+		rc = tap_open(O_RDWR | O_NONBLOCK);
+		if (rc < 0) {
+			uk_pr_err(DRIVER_NAME": Failed(%d) to open the tap device\n",
+				  rc);
+			goto close_tap;
+		}
+		tdev->tap_fds[i] = rc;
+		tdev->tap_fd_cnt++;
 
-	rc = tap_dev_configure(tdev->tap_fd, feature_flags, &ifreq);
+		/**
+		 * The interface name returned for the first queue attaches
+		 * the remaining ones to the same interface.
+		 */
+		rc = tap_dev_configure(tdev->tap_fds[i], feature_flags, &ifreq);
+		if (rc < 0) {
+			uk_pr_err(DRIVER_NAME": Failed to setup the tap device\n");
+			goto close_tap;
+		}
+	}
+
+#ifdef CONFIG_TAP_VNET_HDR
+	/**
+	 * Accept packets with partial checksums from the host and, with LRO,
+	 * packets that it coalesced. This applies to all queues.
+	 */
+	rc = tap_dev_offload_set(tdev->tap_fds[0], UK_TUN_F_CSUM
+#ifdef CONFIG_TAP_LRO
+				 | UK_TUN_F_TSO4 | UK_TUN_F_TSO6
+				 | UK_TUN_F_TSO_ECN
+#endif /* CONFIG_TAP_LRO */
+				 );
 	if (rc < 0) {
-		uk_pr_err(DRIVER_NAME": Failed to setup the tap device\n");
+		uk_pr_err(DRIVER_NAME": Failed to enable receive offloads\n");
 		goto close_tap;
 	}
+#endif /* CONFIG_TAP_VNET_HDR */
 
 	snprintf(tdev->name, sizeof(tdev->name), "%s", ifreq.ifr_name);
-	uk_pr_info(DRIVER_NAME": Configured tap device %s\n", tdev->name);
+	uk_pr_info(DRIVER_NAME": Configured tap device %s with %"__PRIu16" queues\n",
+		   tdev->name, nb_queues);
 
 exit:
 	return rc;
 close_tap:
-	tap_close(tdev->tap_fd);
-	tdev->tap_fd = -1;
+	tap_device_close(tdev);
 	goto exit;
 }
 
@@ -775,13 +1103,11 @@ static int tap_dev_init(int id)
 	}
 	tdev->ndev.rx_one = tap_netdev_recv;
 	tdev->ndev.tx_one = tap_netdev_xmit;
+	tdev->ndev.rx_burst = tap_netdev_recv_burst;
+	tdev->ndev.tx_burst = tap_netdev_xmit_burst;
 	tdev->ndev.ops = &tap_netdev_ops;
 	tdev->tid = id;
-	/**
-	 * TODO:
-	 * As an initial implementation we have limit on the number of queues.
-	 */
-	tdev->max_qpairs = 1;
+	tdev->max_qpairs = CONFIG_TAP_MAX_QUEUE_PAIRS;
 
 	/* Registering the tap device with libuknet*/
 	rc = uk_netdev_drv_register(&tdev->ndev, tap_drv.a, drv_name);
@@ -41,9 +41,15 @@
 #include <virtio/virtio_bus.h>
 #include <virtio/virtio_9p.h>
 #include <uk/plat/spinlock.h>
+#include <uk/isr/string.h>
 
 #define DRIVER_NAME	"virtio-9p"
 #define NUM_SEGMENTS	128 /** The number of virtqueue descriptors. */
+#if CONFIG_VIRTIO_9P_INDIRECT_SEGMENTS > NUM_SEGMENTS
+#define MAX_SEGMENTS	CONFIG_VIRTIO_9P_INDIRECT_SEGMENTS
+#else
+#define MAX_SEGMENTS	NUM_SEGMENTS
+#endif
 static struct uk_alloc *a;
 
 /* List of initialized virtio 9p devices. */
@@ -65,7 +71,7 @@ struct virtio_9p_device {
 	struct uk_9pdev *p9dev;
 	/* Scatter-gather list. */
 	struct uk_sglist sg;
-	struct uk_sglist_seg sgsegs[NUM_SEGMENTS];
+	struct uk_sglist_seg sgsegs[MAX_SEGMENTS];
 	/* Spinlock protecting the sg list and the vq. */
 	__spinlock spinlock;
 };
@@ -102,8 +108,16 @@ static int virtio_9p_connect(struct uk_9pdev *p9dev,
 	 * msize, and the request will not exceed one segment.
 	 * Similarly for write requests, but in reverse. Other requests should
 	 * not exceed one page for both recv and xmit fcalls.
+	 *
+	 * With indirect descriptors, a message is bound by the size of the
+	 * indirect tables instead. The fcall buffers of a request may cross
+	 * a page boundary each, as may the zero-copy buffer.
 	 */
-	p9dev->max_msize = (NUM_SEGMENTS - 1) * __PAGE_SIZE;
+	if (virtqueue_indirect_max(dev->vq) > NUM_SEGMENTS)
+		p9dev->max_msize = (virtqueue_indirect_max(dev->vq) - 5) *
+				   __PAGE_SIZE;
+	else
+		p9dev->max_msize = (NUM_SEGMENTS - 1) * __PAGE_SIZE;
 
 	dev->p9dev = p9dev;
 	p9dev->priv = dev;
@@ -267,9 +281,10 @@ static int virtio_9p_recv(struct virtqueue *vq, void *priv)
 		 * needed.
 		 */
 		if (req->recv.type == UK_9P_RERROR) {
-			memcpy(req->recv.buf + req->recv.zc_offset,
-			       req->recv.zc_buf,
-			       MIN(req->recv.zc_size, len - UK_9P_HEADER_SIZE));
+			memcpy_isr(req->recv.buf + req->recv.zc_offset,
+				   req->recv.zc_buf,
+				   MIN(req->recv.zc_size,
+				       len - UK_9P_HEADER_SIZE));
 		}
 
 		uk_9preq_put(req);
@@ -368,7 +383,9 @@ static int virtio_9p_feature_negotiate(struct virtio_9p_device *d)
 	d->tag[tag_len] = '\0';
 
 	d->vdev->features &= host_features;
-	virtio_feature_set(d->vdev, d->vdev->features);
+	rc = virtio_feature_set(d->vdev, d->vdev->features);
+	if (unlikely(rc))
+		goto free_mem;
 	return 0;
 
 free_mem:
@@ -434,6 +451,9 @@ static int virtio_9p_add_dev(struct virtio_dev *vdev)
 	}
 	ukarch_spin_init(&d->spinlock);
 	d->vdev = vdev;
+#if MAX_SEGMENTS > NUM_SEGMENTS
+	vdev->indirect_max = MAX_SEGMENTS;
+#endif
 	virtio_9p_feature_set(d);
 	rc = virtio_9p_configure(d);
 	if (rc)
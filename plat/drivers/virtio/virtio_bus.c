@@ -153,6 +153,7 @@ int virtio_bus_register_device(struct virtio_dev *vdev)
 
 	/* Initialize the virtqueue list */
 	UK_TAILQ_INIT(&vdev->vqs);
+	vdev->indirect_max = 0;
 
 	/* Calling the driver add device */
 	rc = drv->add_dev(vdev);
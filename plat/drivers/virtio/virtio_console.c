@@ -9,6 +9,7 @@
 #include <virtio/virtio_ids.h>
 #include <virtio/virtio_console.h>
 #include <uk/console.h>
+#include <uk/plat/spinlock.h>
 
 #if CONFIG_LIBUKSCHED
 #include <uk/sched.h>
@@ -22,18 +23,50 @@ extern __u64 ushell_interrupt;
 #define DRIVER_NAME "virtio-console"
 static struct uk_alloc *a;
 
+/* Size of the transmit ring buffer; a page so that it is contiguous */
+#define VTCONS_TX_RING_SIZE	__PAGE_SIZE
+/* Maximum number of transmit buffers that are in flight */
+#define VTCONS_TX_SLOTS		32
+
 struct virtio_console_queue {
 	struct virtqueue *vq;
 	uint16_t hwvq_id;
 	struct uk_sglist sg;
-	struct uk_sglist_seg sgsegs[1];
+	/* A transmit buffer may wrap around the end of the ring */
+	struct uk_sglist_seg sgsegs[2];
 	char buf[VTCONS_QBUF_SIZE];
 };
 
+/* A transmit buffer that was handed to the device */
+struct virtio_console_tx_slot {
+	/* Ring position after the last byte of the buffer */
+	__u32 end;
+	int done;
+};
+
+/**
+ * Output is copied to a ring buffer and handed to the device without
+ * waiting for its completion. Bytes [tx_tail, tx_head) of the ring are
+ * still owned by the device. Completed buffers are reclaimed on the next
+ * write, in submission order.
+ */
+struct virtio_console_tx {
+	char *ring;
+	/* Free-running ring positions */
+	__u32 head;
+	__u32 tail;
+	struct virtio_console_tx_slot slots[VTCONS_TX_SLOTS];
+	/* Free-running indices of the in-flight slots */
+	__u16 slot_head;
+	__u16 slot_tail;
+	__spinlock lock;
+};
+
 struct virtio_console_device {
 	struct virtio_dev *vdev;
 	struct virtio_console_queue *rxq;
 	struct virtio_console_queue *txq;
+	struct virtio_console_tx tx;
 	struct uk_console_device uk_cdev;
 	int interrupt_enabled;
 #if CONFIG_LIBUKSCHED
@@ -78,7 +111,8 @@ static int virtio_console_feature_negotiate(struct virtio_console_device *d)
 
 	uk_pr_info(DRIVER_NAME ": host feature = %#lx\n", host_features);
 
-	return 0;
+	/* No device features are used, but the ring features are */
+	return virtio_feature_set(d->vdev, d->vdev->features);
 }
 
 /* call back function when receiving an interrupt */
@@ -164,7 +198,8 @@ static int virtio_console_vq_alloc(struct virtio_console_device *d)
 		rc = PTR2ERR(d->txq->vq);
 		goto exit;
 	}
-	uk_sglist_init(&d->txq->sg, 1, &d->txq->sgsegs[0]);
+	uk_sglist_init(&d->txq->sg, ARRAY_SIZE(d->txq->sgsegs),
+		       &d->txq->sgsegs[0]);
 	d->txq->vq->priv = d;
 
 exit:
@@ -254,37 +289,133 @@ static int virtio_console_peak(struct virtio_console_device *cdev)
 	return virtqueue_hasdata(cdev->rxq->vq);
 }
 
-static void virtio_console_putc(struct uk_console_device *uk_cdev, char c)
+/* Release the ring space of completed transmit buffers */
+static void virtio_console_tx_reclaim(struct virtio_console_device *cdev)
 {
-	struct virtio_console_device *cdev = to_virtiocdev(uk_cdev);
+	struct virtio_console_tx *tx = &cdev->tx;
+	struct virtio_console_tx_slot *slot;
+	void *cookie;
+
+	while (virtqueue_buffer_dequeue(cdev->txq->vq, &cookie, NULL) >= 0) {
+		slot = cookie;
+		slot->done = 1;
+	}
+
+	while (tx->slot_tail != tx->slot_head) {
+		slot = &tx->slots[tx->slot_tail % VTCONS_TX_SLOTS];
+		if (!slot->done)
+			break;
+		tx->tail = slot->end;
+		tx->slot_tail++;
+	}
+}
+
+/* Make sure the device processes in-flight buffers and wait for one */
+static void virtio_console_tx_wait(struct virtio_console_device *cdev)
+{
+	virtqueue_host_notify(cdev->txq->vq);
+	while (!virtqueue_hasdata(cdev->txq->vq))
+		ukarch_spinwait();
+	virtio_console_tx_reclaim(cdev);
+}
+
+/* Hand [tx->head, tx->head + len) of the ring to the device */
+static int virtio_console_tx_submit(struct virtio_console_device *cdev,
+				    __u32 len)
+{
+	struct virtio_console_tx *tx = &cdev->tx;
+	struct virtio_console_tx_slot *slot;
 	struct uk_sglist *sg = &cdev->txq->sg;
-	void *buf = &cdev->txq->buf[0];
+	__u32 off = tx->head % VTCONS_TX_RING_SIZE;
+	__u32 first = MIN(len, VTCONS_TX_RING_SIZE - off);
 	int rc;
-	__u32 len;
 
-	cdev->txq->buf[0] = c;
 	uk_sglist_reset(sg);
-	rc = uk_sglist_append(sg, buf, 1);
+	rc = uk_sglist_append(sg, tx->ring + off, first);
+	if (likely(rc == 0) && first < len)
+		rc = uk_sglist_append(sg, tx->ring, len - first);
 	if (unlikely(rc != 0)) {
 		uk_pr_err(DRIVER_NAME ": Failed to uk_sglist_append()\n");
-		return;
+		return rc;
 	}
 
-	rc = virtqueue_buffer_enqueue(cdev->txq->vq, buf, sg, sg->sg_nseg, 0);
-	if (unlikely(rc < 0)) {
-		uk_pr_err(DRIVER_NAME
-			  ": Failed to virtqueue_buffer_enqueue()\n");
-	} else {
-		virtqueue_host_notify(cdev->txq->vq);
-		// wait for completion
-		while (!virtqueue_hasdata(cdev->txq->vq)) {
-			ukarch_spinwait();
+	slot = &tx->slots[tx->slot_head % VTCONS_TX_SLOTS];
+	slot->end = tx->head + len;
+	slot->done = 0;
+	rc = virtqueue_buffer_enqueue(cdev->txq->vq, slot, sg,
+				      sg->sg_nseg, 0);
+	if (unlikely(rc < 0))
+		return rc;
+
+	tx->slot_head++;
+	tx->head += len;
+	return 0;
+}
+
+static int virtio_console_write(struct uk_console_device *uk_cdev,
+				const char *buf, int len)
+{
+	struct virtio_console_device *cdev = to_virtiocdev(uk_cdev);
+	struct virtio_console_tx *tx = &cdev->tx;
+	unsigned long flags;
+	__u32 space, chunk, off, first;
+	int done = 0, rc;
+
+	if (unlikely(len <= 0))
+		return 0;
+
+	ukplat_spin_lock_irqsave(&tx->lock, flags);
+	virtio_console_tx_reclaim(cdev);
+	while (done < len) {
+		space = VTCONS_TX_RING_SIZE - (tx->head - tx->tail);
+		if (space == 0 ||
+		    (__u16)(tx->slot_head - tx->slot_tail) == VTCONS_TX_SLOTS) {
+			virtio_console_tx_wait(cdev);
+			continue;
 		}
-		rc = virtqueue_buffer_dequeue(cdev->txq->vq, (void **)&buf,
-					      &len);
-		UK_ASSERT(rc == 0);
-		UK_ASSERT(buf == &cdev->txq->buf[0]);
+
+		/* Copy as much as possible and submit it as one buffer */
+		chunk = MIN((__u32)(len - done), space);
+		off = tx->head % VTCONS_TX_RING_SIZE;
+		first = MIN(chunk, VTCONS_TX_RING_SIZE - off);
+		memcpy(tx->ring + off, buf + done, first);
+		memcpy(tx->ring, buf + done + first, chunk - first);
+
+		rc = virtio_console_tx_submit(cdev, chunk);
+		if (rc == -ENOSPC) {
+			/* Out of descriptors, the copy is simply redone */
+			virtio_console_tx_wait(cdev);
+			continue;
+		} else if (unlikely(rc < 0)) {
+			uk_pr_err(DRIVER_NAME
+				  ": Failed to virtqueue_buffer_enqueue()\n");
+			break;
+		}
+		done += chunk;
 	}
+	/* One notification for everything that was submitted */
+	virtqueue_host_notify(cdev->txq->vq);
+	ukplat_spin_unlock_irqrestore(&tx->lock, flags);
+
+	return done ? done : -EIO;
+}
+
+static void virtio_console_putc(struct uk_console_device *uk_cdev, char c)
+{
+	virtio_console_write(uk_cdev, &c, 1);
+}
+
+static void virtio_console_flush(struct uk_console_device *uk_cdev)
+{
+	struct virtio_console_device *cdev = to_virtiocdev(uk_cdev);
+	struct virtio_console_tx *tx = &cdev->tx;
+	unsigned long flags;
+
+	ukplat_spin_lock_irqsave(&tx->lock, flags);
+	virtio_console_tx_reclaim(cdev);
+	while (tx->slot_tail != tx->slot_head)
+		virtio_console_tx_wait(cdev);
+	ukplat_spin_unlock_irqrestore(&tx->lock, flags);
 }
 
 static int virtio_console_add_dev(struct virtio_dev *vdev)
@@ -333,6 +464,14 @@ static int virtio_console_add_dev(struct virtio_dev *vdev)
 		goto out_free;
 	}
 
+	vcdev->tx.ring = uk_memalign(a, VTCONS_TX_RING_SIZE,
+				     VTCONS_TX_RING_SIZE);
+	if (!vcdev->tx.ring) {
+		rc = -ENOMEM;
+		goto out_free;
+	}
+	ukarch_spin_init(&vcdev->tx.lock);
+
 	virtio_console_feature_set(vcdev);
 	rc = virtio_console_configure(vcdev);
 	if (rc)
@@ -345,6 +484,8 @@ static int virtio_console_add_dev(struct virtio_dev *vdev)
 	strncpy(&vcdev->uk_cdev.name[0], "virtio-console",
 		sizeof(vcdev->uk_cdev.name));
 	vcdev->uk_cdev.ops.putc = virtio_console_putc;
+	vcdev->uk_cdev.ops.write = virtio_console_write;
+	vcdev->uk_cdev.ops.flush = virtio_console_flush;
 
 #if CONFIG_LIBUKSCHED
 	uk_waitq_init(&vcdev->wq);
@@ -358,6 +499,7 @@ out_free:
 	if (vcdev) {
 		uk_free(a, vcdev->rxq);
 		uk_free(a, vcdev->txq);
+		uk_free(a, vcdev->tx.ring);
 	}
 	uk_free(a, vcdev);
 	goto out;
@@ -104,19 +104,19 @@ static __u64 vm_get_features(struct virtio_dev *vdev)
 	return features;
 }
 
-static void vm_set_features(struct virtio_dev *vdev,
-					 __u64 features)
+static int vm_set_features(struct virtio_dev *vdev,
+			   __u64 features)
 {
 	struct virtio_mmio_device *vm_dev = to_virtio_mmio_device(vdev);
 
 	/* Give virtio_ring a chance to accept features. */
-	virtqueue_feature_negotiate(features);
+	vdev->features = virtqueue_feature_negotiate(features);
 
 	/* Make sure there are no mixed devices */
 	if (vm_dev->version == 2 &&
 		!uk_test_bit(VIRTIO_F_VERSION_1, &vdev->features)) {
 		uk_pr_err("New virtio-mmio devices (version 2) must provide VIRTIO_F_VERSION_1 feature!\n");
-		return;
+		return -EINVAL;
 	}
 
 	virtio_mmio_cwrite32(vm_dev->base, VIRTIO_MMIO_DRIVER_FEATURES_SEL, 1);
@@ -126,6 +126,7 @@ static void vm_set_features(struct virtio_dev *vdev,
 	virtio_mmio_cwrite32(vm_dev->base, VIRTIO_MMIO_DRIVER_FEATURES_SEL, 0);
 	virtio_mmio_cwrite32(vm_dev->base, VIRTIO_MMIO_DRIVER_FEATURES,
 			     (__u32)vdev->features);
+	return 0;
 }
 
 static int vm_get(struct virtio_dev *vdev, __u16 offset,
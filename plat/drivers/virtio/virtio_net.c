@@ -44,12 +44,17 @@
 /**
  * VIRTIO_PKT_BUFFER_LEN = VIRTIO_NET_HDR + ETH_HDR + ETH_PKT_PAYLOAD_LEN
  * VIRTIO_NET_HDR: 10 bytes in length in legacy mode + 2 byte of padded data.
- *		   12 bytes in length in modern mode.
+ *		   12 bytes in length in modern mode, 20 bytes with hash
+ *		   reports (see virtio_net_device.hdr_len).
  */
 #define VIRTIO_HDR_LEN          12
-#define VIRTIO_PKT_BUFFER_LEN ((UK_ETH_PAYLOAD_MAXLEN) \
-			       + (UK_ETH_HDR_UNTAGGED_LEN) \
-			       + (VIRTIO_HDR_LEN))
+#define VIRTIO_PKT_BUFFER_LEN(hdr_len) ((UK_ETH_PAYLOAD_MAXLEN) \
+					+ (UK_ETH_HDR_UNTAGGED_LEN) \
+					+ (hdr_len))
+/**
+ * Segmentation offloaded packets may carry up to 64KiB of frame data.
+ */
+#define VIRTIO_GSO_PKT_BUFFER_LEN(hdr_len) ((__U16_MAX) + (hdr_len))
 
 #define DRIVER_NAME           "virtio-net"
 
@@ -65,6 +70,14 @@
  */
 #define NET_MAX_FRAGMENTS    ((__U16_MAX >> __PAGE_SHIFT) + 2)
 
+/**
+ * Size of the RSS hash key and the upper limit of the indirection table
+ * that we program. The device may support less.
+ */
+#define VTNET_RSS_KEY_LEN    40
+#define VTNET_RSS_TABLE_LEN  128
+#define VTNET_CTRL_DATA_LEN  (12 + 2 * VTNET_RSS_TABLE_LEN + VTNET_RSS_KEY_LEN)
+
 #define to_virtionetdev(ndev) \
 	__containerof(ndev, struct virtio_net_device, netdev)
 
@@ -78,12 +91,26 @@ typedef enum {
  * below is placed at the beginning of the netbuf data. Use 4 bytes of pad to
  * both keep the VirtIO header and the data non-contiguous and to keep the
  * frame's payload 4 byte aligned.
+ * With mergeable buffers, the receive header (struct virtio_net_hdr_mrg_rxbuf)
+ * directly precedes the frame within the same descriptor. Transmitted
+ * packets keep using the padded layout with the longer header.
  */
 struct virtio_net_hdr_padded {
 	struct virtio_net_hdr vhdr;
 	char            vrh_pad[VTNET_RX_HEADER_PAD];
 };
 
+/**
+ * @internal buffers of a command on the control virtqueue.
+ */
+struct virtio_net_ctrl {
+	struct virtio_net_ctrl_hdr hdr;
+	__u8 data[VTNET_CTRL_DATA_LEN];
+	virtio_net_ctrl_ack ack;
+	struct uk_sglist sg;
+	struct uk_sglist_seg sgsegs[3];
+};
+
 /**
  * @internal structure to represent the transmit queue.
  */
@@ -141,6 +168,17 @@ struct virtio_net_device {
 	struct uk_netdev netdev;
 	/* Count of the number of the virtqueues */
 	__u16 max_vqueue_pairs;
+	/* Number of queue pairs offered by the device */
+	__u16 hw_vqueue_pairs;
+	/* Number of queue pairs configured by the user */
+	__u16 vqueue_pairs;
+	/* Control virtqueue (if VIRTIO_NET_F_CTRL_VQ) */
+	struct virtqueue *ctrlq;
+	struct virtio_net_ctrl ctrl;
+	/* RSS capabilities of the device */
+	__u32 rss_hash_types;
+	__u16 rss_table_len;
+	__u8 rss_key_len;
 	/* List of the Rx/Tx queue */
 	__u16    rx_vqueue_cnt;
 	struct   uk_netdev_rx_queue *rxqs;
@@ -158,6 +196,14 @@ struct virtio_net_device {
 	__u8 state;
 	/* RX promiscuous mode. */
 	__u8 promisc : 1;
+	/* Receive header shares the buffer with the frame and carries
+	 * num_buffers (mergeable buffers or virtio 1.0)
+	 */
+	__u8 mrg_rxbuf : 1;
+	/* Hash reporting negotiated */
+	__u8 hash_report : 1;
+	/* Length of the virtio-net header in front of each packet */
+	__u16 hdr_len;
 };
 
 /**
@@ -195,6 +241,12 @@ static int virtio_netdev_xmit(struct uk_netdev *dev,
 static int virtio_netdev_recv(struct uk_netdev *dev,
 			      struct uk_netdev_rx_queue *queue,
 			      struct uk_netbuf **pkt);
+static int virtio_netdev_xmit_burst(struct uk_netdev *dev,
+				    struct uk_netdev_tx_queue *queue,
+				    struct uk_netbuf **pkts, __u16 *cnt);
+static int virtio_netdev_recv_burst(struct uk_netdev *dev,
+				    struct uk_netdev_rx_queue *queue,
+				    struct uk_netbuf **pkts, __u16 *cnt);
 static const struct uk_hwaddr *virtio_net_mac_get(struct uk_netdev *n);
 static __u16 virtio_net_mtu_get(struct uk_netdev *n);
 static unsigned virtio_net_promisc_get(struct uk_netdev *n);
@@ -216,6 +268,24 @@ static int virtio_netdev_rx_fillup(struct uk_netdev_rx_queue *rxq,
 static const char *drv_name = DRIVER_NAME;
 static struct uk_alloc *a;
 
+/* Default Toeplitz key, as used by most NIC drivers */
+static const __u8 vtnet_rss_key[VTNET_RSS_KEY_LEN] = {
+	0x6d, 0x5a, 0x56, 0xda, 0x25, 0x5b, 0x0e, 0xc2,
+	0x41, 0x67, 0x25, 0x3d, 0x43, 0xa3, 0x8f, 0xb0,
+	0xd0, 0xca, 0x2b, 0xcb, 0xae, 0x7b, 0x30, 0xb4,
+	0x77, 0xcb, 0x2d, 0xa3, 0x80, 0x30, 0xf2, 0x0c,
+	0x6a, 0x42, 0xb7, 0x3b, 0xbe, 0xac, 0x01, 0xfa,
+};
+
+/**
+ * Headroom that is reserved in front of each packet for the virtio header.
+ */
+static inline __u16 virtio_netdev_encap_len(struct virtio_net_device *vndev)
+{
+	return MAX((__u16)sizeof(struct virtio_net_hdr_padded),
+		   vndev->hdr_len);
+}
+
 /**
  * The Driver method implementation.
  */
@@ -267,24 +337,29 @@ static int virtio_netdev_rx_fillup(struct uk_netdev_rx_queue *rxq,
 				   int notify)
 {
 	struct uk_netbuf *netbuf[RX_FILLUP_BATCHLEN];
+	struct virtio_net_device *vndev = to_virtionetdev(rxq->ndev);
 	int rc = 0;
 	int status = 0x0;
 	__u16 i, j;
 	__u16 req;
 	__u16 cnt = 0;
 	__u16 filled = 0;
+	__u16 descs;
 
 	/**
-	 * Fixed amount of memory is allocated to each received buffer. In
-	 * our case since we don't support jumbo frame or LRO yet we require
-	 * that the buffer feed to the ring descriptor is atleast
-	 * ethernet MTU + virtio net header.
-	 * Because we using 2 descriptor for a single netbuf, our effective
-	 * queue size is just the half.
+	 * Fixed amount of memory is allocated to each received buffer.
+	 * Without mergeable buffers, we require that the buffer feed to the
+	 * ring descriptor is atleast ethernet MTU + virtio net header.
+	 * Because we are then using 2 descriptor for a single netbuf, our
+	 * effective queue size is just the half. With mergeable buffers, each
+	 * netbuf occupies a single descriptor and larger packets are spread
+	 * over multiple netbufs by the host. The same holds for a pair that
+	 * is described with an indirect descriptor.
 	 */
-	nb_desc = ALIGN_DOWN(nb_desc, 2);
+	descs = virtqueue_desc_count(rxq->vq, vndev->mrg_rxbuf ? 1 : 2);
+	nb_desc = ALIGN_DOWN(nb_desc, descs);
 	while (filled < nb_desc) {
-		req = MIN(nb_desc / 2, RX_FILLUP_BATCHLEN);
+		req = MIN((nb_desc - filled) / descs, RX_FILLUP_BATCHLEN);
 		cnt = rxq->alloc_rxpkts(rxq->alloc_rxpkts_argp, netbuf, req);
 		for (i = 0; i < cnt; i++) {
 			uk_pr_debug("Enqueue netbuf %"PRIu16"/%"PRIu16" (%p) to virtqueue %p...\n",
@@ -303,7 +378,7 @@ static int virtio_netdev_rx_fillup(struct uk_netdev_rx_queue *rxq,
 				status |= UK_NETDEV_STATUS_UNDERRUN;
 				goto out;
 			}
-			filled += 2;
+			filled += descs;
 		}
 
 		if (unlikely(cnt < req)) {
@@ -316,41 +391,96 @@ static int virtio_netdev_rx_fillup(struct uk_netdev_rx_queue *rxq,
 
 out:
 	uk_pr_debug("Programmed %"PRIu16" receive netbufs to receive virtqueue %p (status %x)\n",
-		    filled / 2, rxq, status);
+		    filled / descs, rxq, status);
 
 	/**
-	 * Notify the host, when we submit new descriptor(s).
+	 * Publish all new descriptors at once and notify the host, when we
+	 * submit new descriptor(s).
 	 */
-	if (notify && filled)
-		virtqueue_host_notify(rxq->vq);
+	if (filled) {
+		virtqueue_buffer_publish(rxq->vq);
+		if (notify)
+			virtqueue_host_notify(rxq->vq);
+	}
 
 	return status;
 }
 
-static int virtio_netdev_xmit(struct uk_netdev *dev,
-			      struct uk_netdev_tx_queue *queue,
-			      struct uk_netbuf *pkt)
+/**
+ * Translate the segmentation offload request of a packet to the
+ * corresponding virtio-net GSO type.
+ * Returns -ENOTSUP if the offload was not negotiated with the host or
+ * -EINVAL if the packet does not request a partial checksum as well.
+ */
+static int virtio_netdev_gso_type(struct virtio_net_device *vndev,
+				  struct uk_netbuf *pkt)
 {
-	struct virtio_net_device *vndev __unused;
+	__u64 features = vndev->vdev->features;
+	int gso_type;
+
+	switch (pkt->flags & UK_NETBUF_F_GSO_MASK) {
+	case 0:
+		return VIRTIO_NET_HDR_GSO_NONE;
+	case UK_NETBUF_F_GSO_TCPV4:
+		if (!VIRTIO_FEATURE_HAS(features, VIRTIO_NET_F_HOST_TSO4))
+			return -ENOTSUP;
+		gso_type = VIRTIO_NET_HDR_GSO_TCPV4;
+		break;
+	case UK_NETBUF_F_GSO_TCPV6:
+		if (!VIRTIO_FEATURE_HAS(features, VIRTIO_NET_F_HOST_TSO6))
+			return -ENOTSUP;
+		gso_type = VIRTIO_NET_HDR_GSO_TCPV6;
+		break;
+	case UK_NETBUF_F_GSO_UDP:
+		if (!VIRTIO_FEATURE_HAS(features, VIRTIO_NET_F_HOST_UFO))
+			return -ENOTSUP;
+		gso_type = VIRTIO_NET_HDR_GSO_UDP;
+		break;
+	default:
+		uk_pr_err("Conflicting segmentation offload flags: %x\n",
+			  pkt->flags);
+		return -EINVAL;
+	}
+
+	if (unlikely(!(pkt->flags & UK_NETBUF_F_PARTIAL_CSUM))) {
+		uk_pr_err("Segmentation offload requires a partial checksum\n");
+		return -EINVAL;
+	}
+	if (pkt->flags & UK_NETBUF_F_GSO_ECN) {
+		if (!VIRTIO_FEATURE_HAS(features, VIRTIO_NET_F_HOST_ECN))
+			return -ENOTSUP;
+		gso_type |= VIRTIO_NET_HDR_GSO_ECN;
+	}
+	return gso_type;
+}
+
+/**
+ * Prepare the virtio header of a packet and add it to the transmit ring
+ * without publishing it to the host.
+ * Returns the number of free descriptors (>= 0), -ENOSPC if the ring is full,
+ * or another negative error code. In the error cases the packet is unchanged.
+ */
+static int virtio_netdev_xmit_add(struct uk_netdev_tx_queue *queue,
+				  struct uk_netbuf *pkt)
+{
+	struct virtio_net_device *vndev;
 	struct virtio_net_hdr *vhdr;
-	struct virtio_net_hdr_padded *padded_hdr;
-	int16_t header_sz = sizeof(*padded_hdr);
+	int16_t header_sz;
 	int rc = 0;
-	int status = 0x0;
+	int gso_type;
 	size_t total_len = 0;
+	size_t max_len;
 	__u8  *buf_start;
 	size_t buf_len;
 
-	UK_ASSERT(dev);
 	UK_ASSERT(pkt && queue);
+	vndev = to_virtionetdev(queue->ndev);
+	header_sz = virtio_netdev_encap_len(vndev);
+	max_len = VIRTIO_PKT_BUFFER_LEN(vndev->hdr_len);
 
-	vndev = to_virtionetdev(dev);
-	/**
-	 * We are reclaiming the free descriptors from buffers. The function is
-	 * not protected by means of locks. We need to be careful if there are
-	 * multiple context through which we free the tx descriptors.
-	 */
-	virtio_netdev_xmit_free(queue);
+	gso_type = virtio_netdev_gso_type(vndev, pkt);
+	if (unlikely(gso_type < 0))
+		return gso_type;
 
 	buf_start = pkt->data;
 	buf_len = pkt->len;
@@ -360,8 +490,7 @@ static int virtio_netdev_xmit(struct uk_netdev *dev,
 	rc = uk_netbuf_header(pkt, header_sz);
 	if (unlikely(rc != 1)) {
 		uk_pr_err("Failed to prepend virtio header\n");
-		rc = -ENOSPC;
-		goto err_exit;
+		return -ENOBUFS;
 	}
 	vhdr = pkt->data;
 
@@ -378,14 +507,19 @@ static int virtio_netdev_xmit(struct uk_netdev *dev,
 	 *       to `uk_sglist_append_netbuf()`. However, a netbuf
 	 *       chain can only once have set the PARTIAL_CSUM flag.
 	 */
-	memset(vhdr, 0, sizeof(*vhdr));
+	memset(vhdr, 0, vndev->hdr_len);
 	if (pkt->flags & UK_NETBUF_F_PARTIAL_CSUM) {
 		vhdr->flags       |= VIRTIO_NET_HDR_F_NEEDS_CSUM;
 		/* `csum_start` is without header size */
 		vhdr->csum_start   = pkt->csum_start - header_sz;
 		vhdr->csum_offset  = pkt->csum_offset;
 	}
-	vhdr->gso_type = VIRTIO_NET_HDR_GSO_NONE;
+	vhdr->gso_type = gso_type;
+	if (gso_type != VIRTIO_NET_HDR_GSO_NONE) {
+		vhdr->gso_size = pkt->gso_size;
+		vhdr->hdr_len  = pkt->header_len;
+		max_len = VIRTIO_GSO_PKT_BUFFER_LEN(vndev->hdr_len);
+	}
 
 	/**
 	 * Prepare the sglist and enqueue the buffer to the virtio-ring.
@@ -400,7 +534,7 @@ static int virtio_netdev_xmit(struct uk_netdev *dev,
 	 * 1 for the virtio header and the other for the actual network packet.
 	 */
 	/* Appending the data to the list. */
-	rc = uk_sglist_append(&queue->sg, vhdr, sizeof(*vhdr));
+	rc = uk_sglist_append(&queue->sg, vhdr, vndev->hdr_len);
 	if (unlikely(rc != 0)) {
 		uk_pr_err("Failed to append to the sg list\n");
 		goto err_remove_vhdr;
@@ -419,9 +553,9 @@ static int virtio_netdev_xmit(struct uk_netdev *dev,
 	}
 
 	total_len = uk_sglist_length(&queue->sg);
-	if (unlikely(total_len > VIRTIO_PKT_BUFFER_LEN)) {
-		uk_pr_err("Packet size too big: %lu, max:%u\n",
-			  total_len, VIRTIO_PKT_BUFFER_LEN);
+	if (unlikely(total_len > max_len)) {
+		uk_pr_err("Packet size too big: %lu, max:%lu\n",
+			  total_len, max_len);
 		rc = -ENOTSUP;
 		goto err_remove_vhdr;
 	}
@@ -429,45 +563,107 @@ static int virtio_netdev_xmit(struct uk_netdev *dev,
 	/**
 	 * Adding the descriptors to the virtqueue.
 	 */
-	rc = virtqueue_buffer_enqueue(queue->vq, pkt, &queue->sg,
-				      queue->sg.sg_nseg, 0);
+	rc = virtqueue_buffer_add(queue->vq, pkt, &queue->sg,
+				  queue->sg.sg_nseg, 0);
+	if (likely(rc >= 0))
+		return rc;
+	if (rc == -ENOSPC)
+		uk_pr_debug("No more descriptor available\n");
+	else
+		uk_pr_err("Failed to enqueue descriptors into the ring: %d\n",
+			  rc);
+
+err_remove_vhdr:
+	/**
+	 * Remove header before exiting because we could not send
+	 */
+	uk_netbuf_header(pkt, -header_sz);
+	UK_ASSERT(rc < 0);
+	return rc;
+}
+
+static int virtio_netdev_xmit(struct uk_netdev *dev,
+			      struct uk_netdev_tx_queue *queue,
+			      struct uk_netbuf *pkt)
+{
+	int status = 0x0;
+	int rc;
+
+	UK_ASSERT(dev);
+	UK_ASSERT(pkt && queue);
+
+	/**
+	 * We are reclaiming the free descriptors from buffers. The function is
+	 * not protected by means of locks. We need to be careful if there are
+	 * multiple context through which we free the tx descriptors.
+	 */
+	virtio_netdev_xmit_free(queue);
+
+	rc = virtio_netdev_xmit_add(queue, pkt);
 	if (likely(rc >= 0)) {
 		status |= UK_NETDEV_STATUS_SUCCESS;
 		/**
 		 * Notify the host the new buffer.
 		 */
+		virtqueue_buffer_publish(queue->vq);
 		virtqueue_host_notify(queue->vq);
 		/**
 		 * When there is further space available in the ring
 		 * return UK_NETDEV_STATUS_MORE.
 		 */
 		status |= likely(rc > 0) ? UK_NETDEV_STATUS_MORE : 0x0;
-	} else if (rc == -ENOSPC) {
-		uk_pr_debug("No more descriptor available\n");
+	} else if (rc != -ENOSPC) {
+		return rc;
+	}
+	return status;
+}
+
+static int virtio_netdev_xmit_burst(struct uk_netdev *dev,
+				    struct uk_netdev_tx_queue *queue,
+				    struct uk_netbuf **pkts, __u16 *cnt)
+{
+	int status = 0x0;
+	int rc = 0;
+	__u16 i;
+
+	UK_ASSERT(dev);
+	UK_ASSERT(queue && pkts && cnt);
+
+	virtio_netdev_xmit_free(queue);
+
+	for (i = 0; i < *cnt; i++) {
+		rc = virtio_netdev_xmit_add(queue, pkts[i]);
+		if (rc < 0)
+			break;
+	}
+
+	if (i > 0) {
 		/**
-		 * Remove header before exiting because we could not send
+		 * Publish the whole burst with one index update and one
+		 * notification of the host.
 		 */
-		uk_netbuf_header(pkt, -header_sz);
-	} else {
-		uk_pr_err("Failed to enqueue descriptors into the ring: %d\n",
-			  rc);
-		goto err_remove_vhdr;
+		virtqueue_buffer_publish(queue->vq);
+		virtqueue_host_notify(queue->vq);
+		status |= UK_NETDEV_STATUS_SUCCESS;
+		/* `rc` is the number of free descriptors or the reason of a
+		 * short burst
+		 */
+		status |= (rc > 0) ? UK_NETDEV_STATUS_MORE : 0x0;
+	} else if (rc < 0 && rc != -ENOSPC) {
+		return rc;
 	}
-	return status;
 
-err_remove_vhdr:
-	uk_netbuf_header(pkt, -header_sz);
-err_exit:
-	UK_ASSERT(rc < 0);
-	return rc;
+	*cnt = i;
+	return status;
 }
 
 static int virtio_netdev_rxq_enqueue(struct uk_netdev_rx_queue *rxq,
 				     struct uk_netbuf *netbuf)
 {
+	struct virtio_net_device *vndev = to_virtionetdev(rxq->ndev);
 	int rc = 0;
-	struct virtio_net_hdr_padded *rxhdr;
-	int16_t header_sz = sizeof(*rxhdr);
+	void *rxhdr;
+	int16_t header_sz = sizeof(struct virtio_net_hdr_padded);
 	__u8 *buf_start;
 	size_t buf_len = 0;
 	struct uk_sglist *sg;
@@ -484,8 +680,11 @@ static int virtio_netdev_rxq_enqueue(struct uk_netdev_rx_queue *rxq,
 	buf_len = netbuf->len;
 
 	/**
-	 * Retrieve the buffer header length.
+	 * Retrieve the buffer header length. With mergeable buffers the
+	 * header is placed right in front of the frame.
 	 */
+	if (vndev->mrg_rxbuf)
+		header_sz = vndev->hdr_len;
 	rc = uk_netbuf_header(netbuf, header_sz);
 	if (unlikely(rc != 1)) {
 		uk_pr_err("Failed to allocate space to prepend virtio header\n");
@@ -496,23 +695,147 @@ static int virtio_netdev_rxq_enqueue(struct uk_netdev_rx_queue *rxq,
 	sg = &rxq->sg;
 	uk_sglist_reset(sg);
 
-	/* Appending the header buffer to the sglist */
-	uk_sglist_append(sg, rxhdr, sizeof(struct virtio_net_hdr));
+	if (vndev->mrg_rxbuf) {
+		/**
+		 * Header and data share a single descriptor. The host
+		 * continues a packet that does not fit into this buffer at
+		 * the start of the following buffers, where no header is
+		 * written.
+		 */
+		uk_sglist_append(sg, rxhdr, header_sz + buf_len);
+	} else {
+		/* Appending the header buffer to the sglist */
+		uk_sglist_append(sg, rxhdr, sizeof(struct virtio_net_hdr));
 
-	/* Appending the data buffer to the sglist */
-	uk_sglist_append(sg, buf_start, buf_len);
+		/* Appending the data buffer to the sglist */
+		uk_sglist_append(sg, buf_start, buf_len);
+	}
 
-	rc = virtqueue_buffer_enqueue(rxq->vq, netbuf, sg, 0, sg->sg_nseg);
+	rc = virtqueue_buffer_add(rxq->vq, netbuf, sg, 0, sg->sg_nseg);
 	return rc;
 }
 
+/**
+ * Copy the offload information of a received virtio header to the netbuf.
+ * `header_sz` is the space between the start of the header and the frame.
+ */
+static void virtio_netdev_rxhdr_parse(struct uk_netbuf *buf,
+				      const struct virtio_net_hdr *vhdr,
+				      int16_t header_sz)
+{
+	buf->flags  = ((vhdr->flags & VIRTIO_NET_HDR_F_DATA_VALID)
+		       ? UK_NETBUF_F_DATA_VALID   : 0x0);
+	if (vhdr->flags & VIRTIO_NET_HDR_F_NEEDS_CSUM) {
+		buf->flags |= UK_NETBUF_F_PARTIAL_CSUM;
+		buf->csum_offset = vhdr->csum_offset;
+		/* NOTE: csum_start is without virtio header
+		 *       (uk_netbuf_header() will remove it again)
+		 */
+		buf->csum_start  = vhdr->csum_start + header_sz;
+	}
+
+	switch (vhdr->gso_type & ~VIRTIO_NET_HDR_GSO_ECN) {
+	case VIRTIO_NET_HDR_GSO_TCPV4:
+		buf->flags |= UK_NETBUF_F_GSO_TCPV4;
+		break;
+	case VIRTIO_NET_HDR_GSO_TCPV6:
+		buf->flags |= UK_NETBUF_F_GSO_TCPV6;
+		break;
+	case VIRTIO_NET_HDR_GSO_UDP:
+		buf->flags |= UK_NETBUF_F_GSO_UDP;
+		break;
+	default:
+		buf->gso_size = 0;
+		buf->header_len = 0;
+		return;
+	}
+	if (vhdr->gso_type & VIRTIO_NET_HDR_GSO_ECN)
+		buf->flags |= UK_NETBUF_F_GSO_ECN;
+	buf->gso_size = vhdr->gso_size;
+	buf->header_len = vhdr->hdr_len;
+}
+
+/**
+ * Assemble a packet that the host spread over `num_buffers` receive buffers
+ * into a netbuf chain. `head` is the first buffer with `len` bytes used,
+ * `ret` the return value of its dequeue.
+ */
+static int virtio_netdev_rxq_dequeue_mrg(struct uk_netdev_rx_queue *rxq,
+					 struct uk_netbuf *head, __u32 len,
+					 int ret, struct uk_netbuf **netbuf)
+{
+	struct virtio_net_device *vndev = to_virtionetdev(rxq->ndev);
+	struct virtio_net_hdr_mrg_rxbuf *vhdr;
+	struct virtio_net_hdr_v1_hash *hhdr;
+	int16_t header_sz = vndev->hdr_len;
+	struct uk_netbuf *buf;
+	__u16 num_buffers;
+	int invalid = 0;
+	int rc __maybe_unused;
+	__u16 i;
+
+	if (unlikely(len < (__u32)header_sz)) {
+		uk_pr_err("Received invalid packet size: %"__PRIu32"\n", len);
+		uk_netbuf_free(head);
+		return -EINVAL;
+	}
+
+	vhdr = (struct virtio_net_hdr_mrg_rxbuf *) head->data;
+	num_buffers = vhdr->num_buffers;
+	if (unlikely((len < (__u32)header_sz + UK_ETH_HDR_UNTAGGED_LEN)
+		     || (len > head->len) || (num_buffers == 0))) {
+		uk_pr_err("Received invalid packet size: %"__PRIu32"\n", len);
+		invalid = 1;
+	}
+
+	virtio_netdev_rxhdr_parse(head, &vhdr->hdr, header_sz);
+	if (vndev->hash_report) {
+		hhdr = (struct virtio_net_hdr_v1_hash *) vhdr;
+		if (hhdr->hash_report != VIRTIO_NET_HASH_REPORT_NONE) {
+			head->flags |= UK_NETBUF_F_HASH;
+			head->hash = hhdr->hash_value;
+		}
+	}
+	head->len = MIN(len, (__u32)head->len);
+	rc = uk_netbuf_header(head, -header_sz);
+	UK_ASSERT(rc == 1);
+
+	/**
+	 * The host marks all buffers of a packet as used before it updates
+	 * the used index, so the remaining buffers are available already.
+	 */
+	for (i = 1; i < num_buffers; i++) {
+		ret = virtqueue_buffer_dequeue(rxq->vq, (void **) &buf, &len);
+		if (unlikely(ret < 0)) {
+			uk_pr_err("Packet is missing %"__PRIu16" buffers\n",
+				  num_buffers - i);
+			uk_netbuf_free(head);
+			return -EINVAL;
+		}
+		if (unlikely(len == 0 || len > buf->len)) {
+			uk_pr_err("Received invalid buffer size: %"__PRIu32"\n",
+				  len);
+			invalid = 1;
+		}
+		buf->flags = 0x0;
+		buf->len = MIN(len, (__u32)buf->len);
+		uk_netbuf_append(head, buf);
+	}
+
+	if (unlikely(invalid)) {
+		uk_netbuf_free(head);
+		return -EINVAL;
+	}
+	*netbuf = head;
+	return ret;
+}
+
 static int virtio_netdev_rxq_dequeue(struct uk_netdev_rx_queue *rxq,
 				     struct uk_netbuf **netbuf)
 {
 	int ret;
 	int rc __maybe_unused = 0;
 	struct uk_netbuf *buf = NULL;
-	struct virtio_net_hdr *vhdr;
 	__u32 len;
 
 	UK_ASSERT(netbuf);
@@ -523,8 +846,12 @@ static int virtio_netdev_rxq_dequeue(struct uk_netdev_rx_queue *rxq,
 		*netbuf = NULL;
 		return rxq->nb_desc;
 	}
+	if (to_virtionetdev(rxq->ndev)->mrg_rxbuf)
+		return virtio_netdev_rxq_dequeue_mrg(rxq, buf, len, ret,
+						     netbuf);
+
 	if (unlikely((len < VIRTIO_HDR_LEN + UK_ETH_HDR_UNTAGGED_LEN)
-		     || (len > VIRTIO_PKT_BUFFER_LEN))) {
+		     || (len > VIRTIO_PKT_BUFFER_LEN(VIRTIO_HDR_LEN)))) {
 		uk_pr_err("Received invalid packet size: %"__PRIu32"\n", len);
 		return -EINVAL;
 	}
@@ -532,18 +859,8 @@ static int virtio_netdev_rxq_dequeue(struct uk_netdev_rx_queue *rxq,
 	/**
 	 * Copy virtio header flags to netbuf
 	 */
-	vhdr = (struct virtio_net_hdr *) buf->data;
-	buf->flags  = ((vhdr->flags & VIRTIO_NET_HDR_F_DATA_VALID)
-		       ? UK_NETBUF_F_DATA_VALID   : 0x0);
-	if (vhdr->flags & VIRTIO_NET_HDR_F_NEEDS_CSUM) {
-		buf->flags |= UK_NETBUF_F_PARTIAL_CSUM;
-		buf->csum_offset = vhdr->csum_offset;
-		/* NOTE: csum_start is without virtio header
-		 *       (uk_netbuf_header() will remove it again)
-		 */
-		buf->csum_start  = vhdr->csum_start
-			+ ((uint16_t)sizeof(struct virtio_net_hdr_padded));
-	}
+	virtio_netdev_rxhdr_parse(buf, (struct virtio_net_hdr *) buf->data,
+				  sizeof(struct virtio_net_hdr_padded));
 
 	/**
 	 * Removing the virtio header from the buffer and adjusting length.
@@ -627,6 +944,93 @@ err_exit:
 	return rc;
 }
 
+/**
+ * Dequeue up to `cnt` packets. `used` is updated with the number of used
+ * ring slots after the last successful dequeue.
+ * Returns the number of dequeued packets or a negative error code if the
+ * first dequeue failed.
+ */
+static int virtio_netdev_rxq_dequeue_burst(struct uk_netdev_rx_queue *rxq,
+					   struct uk_netbuf **pkts, __u16 cnt,
+					   int *used)
+{
+	__u16 n;
+	int rc;
+
+	for (n = 0; n < cnt; n++) {
+		rc = virtio_netdev_rxq_dequeue(rxq, &pkts[n]);
+		if (unlikely(rc < 0)) {
+			uk_pr_err("Failed to dequeue the packet: %d\n", rc);
+			if (n == 0)
+				return rc;
+			break;
+		}
+		if (!pkts[n])
+			break;
+		*used = rc;
+	}
+	return n;
+}
+
+static int virtio_netdev_recv_burst(struct uk_netdev *dev __unused,
+				    struct uk_netdev_rx_queue *queue,
+				    struct uk_netbuf **pkts, __u16 *cnt)
+{
+	int status = 0x0;
+	int used = queue->nb_desc;
+	int more = 0;
+	__u16 n;
+	int rc;
+
+	UK_ASSERT(dev && queue);
+	UK_ASSERT(pkts && cnt);
+
+	/* Queue interrupts have to be off when calling receive */
+	UK_ASSERT(!(queue->intr_enabled & VTNET_INTR_EN));
+
+	rc = virtio_netdev_rxq_dequeue_burst(queue, pkts, *cnt, &used);
+	if (unlikely(rc < 0))
+		return rc;
+	n = rc;
+
+	/* Refill all consumed slots with a single publish and notification */
+	status |= virtio_netdev_rx_fillup(queue, (queue->nb_desc - used), 1);
+
+	if (n == *cnt) {
+		/**
+		 * The burst was cut by the caller. Keep interrupts off and
+		 * let the next call find out whether the queue is drained.
+		 */
+		more = 1;
+	} else if (queue->intr_enabled & VTNET_INTR_USR_EN_MASK) {
+		/* The queue is drained, enable interrupts again */
+		rc = virtqueue_intr_enable(queue->vq);
+		if (rc == 1) {
+			/**
+			 * Packets arrived after reading the queue and before
+			 * enabling the interrupt
+			 */
+			used = queue->nb_desc;
+			rc = virtio_netdev_rxq_dequeue_burst(queue, pkts + n,
+							     *cnt - n, &used);
+			if (rc > 0) {
+				n += rc;
+				status |= virtio_netdev_rx_fillup(queue,
+						(queue->nb_desc - used), 1);
+			}
+			rc = virtqueue_intr_enable(queue->vq);
+			more = (rc == 1);
+		}
+	}
+
+	if (n > 0) {
+		status |= UK_NETDEV_STATUS_SUCCESS;
+		status |= more ? UK_NETDEV_STATUS_MORE : 0x0;
+	}
+	*cnt = n;
+	return status;
+}
+
 static struct uk_netdev_rx_queue *virtio_netdev_rx_queue_setup(
 				struct uk_netdev *n, uint16_t queue_id,
 				uint16_t nb_desc,
@@ -641,7 +1045,7 @@ static struct uk_netdev_rx_queue *virtio_netdev_rx_queue_setup(
 	UK_ASSERT(conf->alloc_rxpkts);
 
 	vndev = to_virtionetdev(n);
-	if (queue_id >= vndev->max_vqueue_pairs) {
+	if (queue_id >= vndev->vqueue_pairs) {
 		uk_pr_err("Invalid virtqueue identifier: %"__PRIu16"\n",
 			  queue_id);
 		rc = -EINVAL;
@@ -693,13 +1097,13 @@ static int virtio_netdev_vqueue_setup(struct virtio_net_device *vndev,
 	uint16_t max_desc, hwvq_id;
 	struct virtqueue *vq;
 
+	/* The user queue identifier has been checked by the caller */
+	id = queue_id;
 	if (queue_type == VNET_RX) {
-		id = vndev->rx_vqueue_cnt;
 		callback = virtio_netdev_recv_done;
 		max_desc = vndev->rxqs[id].max_nb_desc;
 		hwvq_id = vndev->rxqs[id].hwvq_id;
 	} else {
-		id = vndev->tx_vqueue_cnt;
 		/* We don't support the callback from the txqueue yet */
 		callback = NULL;
 		max_desc = vndev->txqs[id].max_nb_desc;
@@ -756,7 +1160,7 @@ static struct uk_netdev_tx_queue *virtio_netdev_tx_queue_setup(
 
 	UK_ASSERT(n);
 	vndev = to_virtionetdev(n);
-	if (queue_id >= vndev->max_vqueue_pairs) {
+	if (queue_id >= vndev->vqueue_pairs) {
 		uk_pr_err("Invalid virtqueue identifier: %"__PRIu16"\n",
 			  queue_id);
 		rc = -EINVAL;
@@ -924,11 +1328,165 @@ static int virtio_netdev_feature_negotiate(struct uk_netdev *n)
 		VIRTIO_FEATURE_SET(drv_features, VIRTIO_NET_F_GUEST_CSUM);
 	}
 
+	/**
+	 * Mergeable receive buffers
+	 * NOTE: Each receive netbuf occupies a single descriptor and packets
+	 *       that do not fit into one netbuf are received as netbuf chain.
+	 */
+	if (VIRTIO_FEATURE_HAS(host_features, VIRTIO_NET_F_MRG_RXBUF))
+		VIRTIO_FEATURE_SET(drv_features, VIRTIO_NET_F_MRG_RXBUF);
+
+	/**
+	 * Segmentation offloading on transmit
+	 * NOTE: Segmentation is only requested for netbufs that are marked
+	 *       with UK_NETBUF_F_GSO_*. It depends on checksum offloading.
+	 */
+	if (VIRTIO_FEATURE_HAS(drv_features, VIRTIO_NET_F_CSUM)) {
+		if (VIRTIO_FEATURE_HAS(host_features, VIRTIO_NET_F_HOST_TSO4))
+			VIRTIO_FEATURE_SET(drv_features,
+					   VIRTIO_NET_F_HOST_TSO4);
+		if (VIRTIO_FEATURE_HAS(host_features, VIRTIO_NET_F_HOST_TSO6))
+			VIRTIO_FEATURE_SET(drv_features,
+					   VIRTIO_NET_F_HOST_TSO6);
+		if (VIRTIO_FEATURE_HAS(host_features, VIRTIO_NET_F_HOST_UFO))
+			VIRTIO_FEATURE_SET(drv_features,
+					   VIRTIO_NET_F_HOST_UFO);
+		if ((VIRTIO_FEATURE_HAS(drv_features, VIRTIO_NET_F_HOST_TSO4)
+		     || VIRTIO_FEATURE_HAS(drv_features,
+					   VIRTIO_NET_F_HOST_TSO6))
+		    && VIRTIO_FEATURE_HAS(host_features,
+					  VIRTIO_NET_F_HOST_ECN))
+			VIRTIO_FEATURE_SET(drv_features,
+					   VIRTIO_NET_F_HOST_ECN);
+	}
+
+#if CONFIG_VIRTIO_NET_LRO
+	/**
+	 * Coalesced packets on receive
+	 * NOTE: We require mergeable buffers so that packets of up to 64KiB
+	 *       can be received into MTU-sized netbufs.
+	 */
+	if (VIRTIO_FEATURE_HAS(drv_features, VIRTIO_NET_F_GUEST_CSUM)
+	    && VIRTIO_FEATURE_HAS(drv_features, VIRTIO_NET_F_MRG_RXBUF)) {
+		if (VIRTIO_FEATURE_HAS(host_features, VIRTIO_NET_F_GUEST_TSO4))
+			VIRTIO_FEATURE_SET(drv_features,
+					   VIRTIO_NET_F_GUEST_TSO4);
+		if (VIRTIO_FEATURE_HAS(host_features, VIRTIO_NET_F_GUEST_TSO6))
+			VIRTIO_FEATURE_SET(drv_features,
+					   VIRTIO_NET_F_GUEST_TSO6);
+		if (VIRTIO_FEATURE_HAS(host_features, VIRTIO_NET_F_GUEST_UFO))
+			VIRTIO_FEATURE_SET(drv_features,
+					   VIRTIO_NET_F_GUEST_UFO);
+		if ((VIRTIO_FEATURE_HAS(drv_features, VIRTIO_NET_F_GUEST_TSO4)
+		     || VIRTIO_FEATURE_HAS(drv_features,
+					   VIRTIO_NET_F_GUEST_TSO6))
+		    && VIRTIO_FEATURE_HAS(host_features,
+					  VIRTIO_NET_F_GUEST_ECN))
+			VIRTIO_FEATURE_SET(drv_features,
+					   VIRTIO_NET_F_GUEST_ECN);
+	}
+#endif /* CONFIG_VIRTIO_NET_LRO */
+
+	/**
+	 * Multiqueue and receive side scaling
+	 * NOTE: The queue pairs in use and the RSS configuration are
+	 *       programmed via the control virtqueue when the device is
+	 *       started.
+	 */
+	if (VIRTIO_FEATURE_HAS(host_features, VIRTIO_NET_F_CTRL_VQ)) {
+		VIRTIO_FEATURE_SET(drv_features, VIRTIO_NET_F_CTRL_VQ);
+		if (VIRTIO_FEATURE_HAS(host_features, VIRTIO_NET_F_MQ))
+			VIRTIO_FEATURE_SET(drv_features, VIRTIO_NET_F_MQ);
+		if (VIRTIO_FEATURE_HAS(host_features, VIRTIO_NET_F_RSS))
+			VIRTIO_FEATURE_SET(drv_features, VIRTIO_NET_F_RSS);
+		/* The longer header is only supported with the mergeable
+		 * buffers layout
+		 */
+		if (VIRTIO_FEATURE_HAS(host_features,
+				       VIRTIO_NET_F_HASH_REPORT)
+		    && VIRTIO_FEATURE_HAS(drv_features,
+					  VIRTIO_NET_F_MRG_RXBUF))
+			VIRTIO_FEATURE_SET(drv_features,
+					   VIRTIO_NET_F_HASH_REPORT);
+	}
+
+	vndev->hw_vqueue_pairs = 1;
+	if (VIRTIO_FEATURE_HAS(drv_features, VIRTIO_NET_F_MQ)
+	    || VIRTIO_FEATURE_HAS(drv_features, VIRTIO_NET_F_RSS)) {
+		rc = virtio_config_get(vndev->vdev,
+				       __offsetof(struct virtio_net_config,
+						  max_virtqueue_pairs),
+				       &vndev->hw_vqueue_pairs,
+				       sizeof(vndev->hw_vqueue_pairs), 1);
+		if (unlikely(rc < 0 || vndev->hw_vqueue_pairs == 0)) {
+			uk_pr_err("%p: Failed to read max. queue pairs\n", n);
+			rc = -EINVAL;
+			goto err_negotiate_feature;
+		}
+	}
+	vndev->max_vqueue_pairs = MIN(vndev->hw_vqueue_pairs,
+				      CONFIG_LIBUKNETDEV_MAXNBQUEUES);
+
+	if (VIRTIO_FEATURE_HAS(drv_features, VIRTIO_NET_F_RSS)
+	    || VIRTIO_FEATURE_HAS(drv_features, VIRTIO_NET_F_HASH_REPORT)) {
+		virtio_config_get(vndev->vdev,
+				  __offsetof(struct virtio_net_config,
+					     rss_max_key_size),
+				  &vndev->rss_key_len,
+				  sizeof(vndev->rss_key_len), 1);
+		virtio_config_get(vndev->vdev,
+				  __offsetof(struct virtio_net_config,
+					     rss_max_indirection_table_length),
+				  &vndev->rss_table_len,
+				  sizeof(vndev->rss_table_len), 1);
+		virtio_config_get(vndev->vdev,
+				  __offsetof(struct virtio_net_config,
+					     supported_hash_types),
+				  &vndev->rss_hash_types,
+				  sizeof(vndev->rss_hash_types), 1);
+		vndev->rss_key_len = MIN(vndev->rss_key_len,
+					 VTNET_RSS_KEY_LEN);
+		/* We need a power of two for the indirection table mask */
+		vndev->rss_table_len = MIN(vndev->rss_table_len,
+					   VTNET_RSS_TABLE_LEN);
+		while (vndev->rss_table_len & (vndev->rss_table_len - 1))
+			vndev->rss_table_len &= vndev->rss_table_len - 1;
+		vndev->rss_hash_types &= (VIRTIO_NET_RSS_HASH_TYPE_IPv4
+					  | VIRTIO_NET_RSS_HASH_TYPE_TCPv4
+					  | VIRTIO_NET_RSS_HASH_TYPE_UDPv4
+					  | VIRTIO_NET_RSS_HASH_TYPE_IPv6
+					  | VIRTIO_NET_RSS_HASH_TYPE_TCPv6
+					  | VIRTIO_NET_RSS_HASH_TYPE_UDPv6);
+		if (vndev->rss_table_len == 0)
+			VIRTIO_FEATURE_CLEAR(drv_features, VIRTIO_NET_F_RSS);
+	}
+
 	/**
 	 * Announce our enabled driver features back to the backend device
 	 */
 	vndev->vdev->features = drv_features;
-	virtio_feature_set(vndev->vdev, vndev->vdev->features);
+	rc = virtio_feature_set(vndev->vdev, vndev->vdev->features);
+	if (unlikely(rc))
+		goto err_negotiate_feature;
+
+	/**
+	 * With mergeable buffers, the header carries the number of buffers
+	 * a packet is spread over. Virtio 1.0 devices always use this header
+	 * (with num_buffers set to 1 if buffers are not merged), so their
+	 * receive buffers are laid out the same way.
+	 */
+	vndev->mrg_rxbuf = VIRTIO_FEATURE_HAS(vndev->vdev->features,
+					      VIRTIO_NET_F_MRG_RXBUF)
+			   || VIRTIO_FEATURE_HAS(vndev->vdev->features,
+						 VIRTIO_F_VERSION_1);
+	vndev->hash_report = VIRTIO_FEATURE_HAS(drv_features,
+						VIRTIO_NET_F_HASH_REPORT);
+	if (vndev->hash_report)
+		vndev->hdr_len = sizeof(struct virtio_net_hdr_v1_hash);
+	else if (vndev->mrg_rxbuf)
+		vndev->hdr_len = sizeof(struct virtio_net_hdr_mrg_rxbuf);
+	else
+		vndev->hdr_len = sizeof(struct virtio_net_hdr);
 
 	/**
 	 * According to Virtio specification, section 2.3.1. Config fields
@@ -955,16 +1513,28 @@ static int virtio_netdev_rxtx_alloc(struct virtio_net_device *vndev,
 	int rc = 0;
 	int i = 0;
 	int vq_avail = 0;
-	int total_vqs = conf->nb_rx_queues + conf->nb_tx_queues;
-	__u16 qdesc_size[total_vqs];
+	int total_vqs;
+	__u16 ctrlq_id = 2 * vndev->hw_vqueue_pairs;
 
-	if (conf->nb_rx_queues != 1 || conf->nb_tx_queues != 1) {
+	if (conf->nb_rx_queues != conf->nb_tx_queues
+	    || conf->nb_rx_queues == 0
+	    || conf->nb_rx_queues > vndev->max_vqueue_pairs) {
 		uk_pr_err("Queue combination not supported: %"__PRIu16"/%"__PRIu16" rx/tx\n",
 			  conf->nb_rx_queues, conf->nb_tx_queues);
 
 		return -ENOTSUP;
 	}
 
+	/**
+	 * The control virtqueue follows the queue pairs of the device,
+	 * independent of how many of them we use.
+	 */
+	if (VIRTIO_FEATURE_HAS(vndev->vdev->features, VIRTIO_NET_F_CTRL_VQ))
+		total_vqs = ctrlq_id + 1;
+	else
+		total_vqs = 2 * conf->nb_rx_queues;
+	__u16 qdesc_size[total_vqs];
+
 	/**
 	 * TODO:
 	 * The virtio device management data structure are allocated using the
@@ -997,7 +1567,7 @@ static int virtio_netdev_rxtx_alloc(struct virtio_net_device *vndev,
 	 * ...
 	 * Virtqueue-ctrlq
 	 */
-	for (i = 0; i < vndev->max_vqueue_pairs; i++) {
+	for (i = 0; i < conf->nb_rx_queues; i++) {
 		/**
 		 * Initialize the received queue with the information received
 		 * from the device.
@@ -1020,17 +1590,159 @@ static int virtio_netdev_rxtx_alloc(struct virtio_net_device *vndev,
 				sizeof(vndev->txqs[i].sgsegs[0])),
 			       &vndev->txqs[i].sgsegs[0]);
 	}
+	vndev->vqueue_pairs = conf->nb_rx_queues;
+
+	if (VIRTIO_FEATURE_HAS(vndev->vdev->features, VIRTIO_NET_F_CTRL_VQ)) {
+		/* Commands are polled, so no callback is needed */
+		vndev->ctrlq = virtio_vqueue_setup(vndev->vdev, ctrlq_id,
+						   qdesc_size[ctrlq_id],
+						   NULL, a);
+		if (unlikely(PTRISERR(vndev->ctrlq))) {
+			uk_pr_err("Failed to set up control virtqueue\n");
+			rc = PTR2ERR(vndev->ctrlq);
+			vndev->ctrlq = NULL;
+			goto err_free_txrx;
+		}
+		uk_sglist_init(&vndev->ctrl.sg,
+			       ARRAY_SIZE(vndev->ctrl.sgsegs),
+			       &vndev->ctrl.sgsegs[0]);
+	}
 exit:
 	return rc;
 
 err_free_txrx:
-	if (!vndev->rxqs)
+	if (vndev->rxqs)
 		uk_free(a, vndev->rxqs);
-	if (!vndev->txqs)
+	if (vndev->txqs)
 		uk_free(a, vndev->txqs);
+	vndev->rxqs = NULL;
+	vndev->txqs = NULL;
 	goto exit;
 }
 
+/**
+ * Issue a command on the control virtqueue and wait for its completion.
+ * `len` bytes of command data are taken from `vndev->ctrl.data`.
+ */
+static int virtio_netdev_ctrl_cmd(struct virtio_net_device *vndev,
+				  __u8 class, __u8 cmd, __u32 len)
+{
+	struct virtio_net_ctrl *ctrl = &vndev->ctrl;
+	void *cookie;
+	int rc;
+
+	UK_ASSERT(vndev->ctrlq);
+	UK_ASSERT(len <= sizeof(ctrl->data));
+
+	ctrl->hdr.class = class;
+	ctrl->hdr.cmd = cmd;
+	ctrl->ack = VIRTIO_NET_ERR;
+
+	uk_sglist_reset(&ctrl->sg);
+	rc = uk_sglist_append(&ctrl->sg, &ctrl->hdr, sizeof(ctrl->hdr));
+	if (likely(rc == 0 && len))
+		rc = uk_sglist_append(&ctrl->sg, ctrl->data, len);
+	if (likely(rc == 0))
+		rc = uk_sglist_append(&ctrl->sg, &ctrl->ack, sizeof(ctrl->ack));
+	if (unlikely(rc != 0))
+		return rc;
+
+	rc = virtqueue_buffer_enqueue(vndev->ctrlq, ctrl, &ctrl->sg,
+				      ctrl->sg.sg_nseg - 1, 1);
+	if (unlikely(rc < 0))
+		return rc;
+	virtqueue_host_notify(vndev->ctrlq);
+
+	/* The device processes commands synchronously, wait for it */
+	while (virtqueue_buffer_dequeue(vndev->ctrlq, &cookie, NULL) < 0)
+		ukarch_spinwait();
+	UK_ASSERT(cookie == ctrl);
+
+	return (ctrl->ack == VIRTIO_NET_OK) ? 0 : -EIO;
+}
+
+static inline __u8 *vtnet_put16(__u8 *p, __u16 v)
+{
+	memcpy(p, &v, sizeof(v));
+	return p + sizeof(v);
+}
+
+static inline __u8 *vtnet_put32(__u8 *p, __u32 v)
+{
+	memcpy(p, &v, sizeof(v));
+	return p + sizeof(v);
+}
+
+/**
+ * Spread the flows over all configured receive queues with RSS, or
+ * configure the hash calculation for reporting only.
+ */
+static int virtio_netdev_rss_configure(struct virtio_net_device *vndev)
+{
+	__u8 *p = vndev->ctrl.data;
+	__u16 table_len;
+	__u16 i;
+	__u8 cmd;
+
+	if (VIRTIO_FEATURE_HAS(vndev->vdev->features, VIRTIO_NET_F_RSS)) {
+		table_len = vndev->rss_table_len;
+		p = vtnet_put32(p, vndev->rss_hash_types);
+		p = vtnet_put16(p, table_len - 1);   /* indirection_table_mask */
+		p = vtnet_put16(p, 0);               /* unclassified_queue */
+		for (i = 0; i < table_len; i++)
+			p = vtnet_put16(p, i % vndev->vqueue_pairs);
+		p = vtnet_put16(p, vndev->vqueue_pairs);  /* max_tx_vq */
+		cmd = VIRTIO_NET_CTRL_MQ_RSS_CONFIG;
+	} else {
+		p = vtnet_put32(p, vndev->rss_hash_types);
+		memset(p, 0, 4 * sizeof(__u16));      /* reserved */
+		p += 4 * sizeof(__u16);
+		cmd = VIRTIO_NET_CTRL_MQ_HASH_CONFIG;
+	}
+	*p++ = vndev->rss_key_len;
+	memcpy(p, vtnet_rss_key, vndev->rss_key_len);
+	p += vndev->rss_key_len;
+
+	return virtio_netdev_ctrl_cmd(vndev, VIRTIO_NET_CTRL_MQ, cmd,
+				      p - vndev->ctrl.data);
+}
+
+/**
+ * Tell the device how many queue pairs are in use. Until then, it only
+ * delivers packets to the first receive queue.
+ */
+static int virtio_netdev_mq_configure(struct virtio_net_device *vndev)
+{
+	struct virtio_net_ctrl_mq *mq;
+	int rc;
+
+	if (VIRTIO_FEATURE_HAS(vndev->vdev->features, VIRTIO_NET_F_RSS)
+	    || vndev->hash_report) {
+		rc = virtio_netdev_rss_configure(vndev);
+		if (unlikely(rc < 0)) {
+			uk_pr_err("Failed to configure RSS: %d\n", rc);
+			return rc;
+		}
+		if (VIRTIO_FEATURE_HAS(vndev->vdev->features,
+				       VIRTIO_NET_F_RSS))
+			return 0;
+	}
+
+	if (!VIRTIO_FEATURE_HAS(vndev->vdev->features, VIRTIO_NET_F_MQ)
+	    || vndev->vqueue_pairs == 1)
+		return 0;
+
+	mq = (struct virtio_net_ctrl_mq *) vndev->ctrl.data;
+	mq->virtqueue_pairs = vndev->vqueue_pairs;
+	rc = virtio_netdev_ctrl_cmd(vndev, VIRTIO_NET_CTRL_MQ,
+				    VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET,
+				    sizeof(*mq));
+	if (unlikely(rc < 0))
+		uk_pr_err("Failed to enable %"__PRIu16" queue pairs: %d\n",
+			  vndev->vqueue_pairs, rc);
+	return rc;
+}
+
 static int virtio_netdev_configure(struct uk_netdev *n,
 				   const struct uk_netdev_conf *conf)
 {
@@ -1102,18 +1814,37 @@ static void virtio_net_info_get(struct uk_netdev *dev,
 	dev_info->max_rx_queues = vndev->max_vqueue_pairs;
 	dev_info->max_tx_queues = vndev->max_vqueue_pairs;
 	dev_info->max_mtu = vndev->max_mtu;
-	dev_info->nb_encap_tx = sizeof(struct virtio_net_hdr_padded);
-	dev_info->nb_encap_rx = sizeof(struct virtio_net_hdr_padded);
+	dev_info->in_queue_pairs = 1;
+	dev_info->nb_encap_tx = virtio_netdev_encap_len(vndev);
+	dev_info->nb_encap_rx = virtio_netdev_encap_len(vndev);
 	dev_info->ioalign = sizeof(void *); /* word size alignment */
 	dev_info->features = UK_NETDEV_F_RXQ_INTR
 		| (VIRTIO_FEATURE_HAS(vndev->vdev->features, VIRTIO_NET_F_CSUM)
-		   ? UK_NETDEV_F_PARTIAL_CSUM : 0);
+		   ? UK_NETDEV_F_PARTIAL_CSUM : 0)
+		| (VIRTIO_FEATURE_HAS(vndev->vdev->features,
+				      VIRTIO_NET_F_HOST_TSO4)
+		   ? UK_NETDEV_F_TSO4 : 0)
+		| (VIRTIO_FEATURE_HAS(vndev->vdev->features,
+				      VIRTIO_NET_F_HOST_TSO6)
+		   ? UK_NETDEV_F_TSO6 : 0)
+		| (VIRTIO_FEATURE_HAS(vndev->vdev->features,
+				      VIRTIO_NET_F_HOST_UFO)
+		   ? UK_NETDEV_F_UFO : 0)
+		| ((VIRTIO_FEATURE_HAS(vndev->vdev->features,
+				       VIRTIO_NET_F_GUEST_TSO4)
+		    || VIRTIO_FEATURE_HAS(vndev->vdev->features,
+					  VIRTIO_NET_F_GUEST_TSO6)
+		    || VIRTIO_FEATURE_HAS(vndev->vdev->features,
+					  VIRTIO_NET_F_GUEST_UFO))
+		   ? UK_NETDEV_F_LRO : 0)
+		| (vndev->hash_report ? UK_NETDEV_F_RSS : 0);
 }
 
 static int virtio_net_start(struct uk_netdev *n)
 {
 	struct virtio_net_device *d;
 	int i = 0;
+	int rc;
 
 	UK_ASSERT(n != NULL);
 	d = to_virtionetdev(n);
@@ -1137,7 +1868,17 @@ static int virtio_net_start(struct uk_netdev *n)
 	 * Set the DRIVER_OK status bit. At this point the device is "live".
 	 */
 	virtio_dev_drv_up(d->vdev);
-	uk_pr_info(DRIVER_NAME": %"__PRIu16" started\n", d->uid);
+
+	/*
+	 * The control virtqueue can only be used on a live device.
+	 */
+	if (d->ctrlq) {
+		rc = virtio_netdev_mq_configure(d);
+		if (unlikely(rc < 0))
+			return rc;
+	}
+	uk_pr_info(DRIVER_NAME": %"__PRIu16" started with %"__PRIu16" queue pair(s)\n",
+		   d->uid, d->vqueue_pairs);
 
 	return 0;
 }
@@ -1174,6 +1915,8 @@ static int virtio_net_add_dev(struct virtio_dev *vdev)
 	/* register netdev */
 	vndev->netdev.rx_one = virtio_netdev_recv;
 	vndev->netdev.tx_one = virtio_netdev_xmit;
+	vndev->netdev.rx_burst = virtio_netdev_recv_burst;
+	vndev->netdev.tx_burst = virtio_netdev_xmit_burst;
 	vndev->netdev.ops = &virtio_netdev_ops;
 
 	rc = uk_netdev_drv_register(&vndev->netdev, a, drv_name);
@@ -1187,11 +1930,9 @@ static int virtio_net_add_dev(struct virtio_dev *vdev)
 	vndev->mtu = vndev->max_mtu;
 	vndev->promisc = 0;
 
-	/**
-	 * TODO:
-	 * Adding multiqueue support for the virtio net driver.
-	 */
+	/* Updated with the multiqueue capabilities on feature negotiation */
 	vndev->max_vqueue_pairs = 1;
+	vndev->hw_vqueue_pairs = 1;
 	uk_pr_debug("virtio-net device registered with libuknet\n");
 
 exit:
@@ -60,6 +60,26 @@ struct virtio_pci_dev {
 	__u64 pci_isr_addr;
 	/* Pci device information */
 	struct pci_device *pdev;
+	/* Whether MSI-X is enabled, this moves the device configuration */
+	int msix_enabled;
+#ifdef CONFIG_KVM_PCI_MSIX
+	/* Number of queue vectors, they follow the config vector (0) */
+	__u16 msix_nvqs;
+	/* Virtqueue served by each queue vector, NULL while not set up */
+	struct virtqueue **msix_vqs;
+#endif /* CONFIG_KVM_PCI_MSIX */
+#ifdef CONFIG_VIRTIO_PCI_MODERN
+	/* Structures of the modern interface, NULL for legacy devices */
+	void *common_cfg;
+	void *device_cfg;
+	__u32 device_cfg_len;
+	void *isr_cfg;
+	void *notify_base;
+	__u32 notify_off_mult;
+	__u16 num_queues;
+	/* Doorbell of each queue, as offset from notify_base */
+	__u32 *notify_offs;
+#endif /* CONFIG_VIRTIO_PCI_MODERN */
 };
 
 /**
@@ -79,8 +99,8 @@ static int vpci_legacy_pci_config_set(struct virtio_dev *vdev, __u16 offset,
 static int vpci_legacy_pci_config_get(struct virtio_dev *vdev, __u16 offset,
 				      void *buf, __u32 len, __u8 type_len);
 static __u64 vpci_legacy_pci_features_get(struct virtio_dev *vdev);
-static void vpci_legacy_pci_features_set(struct virtio_dev *vdev,
-					 __u64 features);
+static int vpci_legacy_pci_features_set(struct virtio_dev *vdev,
+					__u64 features);
 static int vpci_legacy_pci_vq_find(struct virtio_dev *vdev, __u16 num_vq,
 				   __u16 *qdesc_size);
 static void vpci_legacy_pci_status_set(struct virtio_dev *vdev, __u8 status);
@@ -135,7 +155,13 @@ static int virtio_pci_handle(void *arg)
 	UK_ASSERT(arg);
 
 	/* Reading the isr status is used to acknowledge the interrupt */
-	isr_status = virtio_cread8((void *)(unsigned long)d->pci_isr_addr, 0);
+#ifdef CONFIG_VIRTIO_PCI_MODERN
+	if (d->common_cfg)
+		isr_status = virtio_mmio_cread8(d->isr_cfg, 0);
+	else
+#endif /* CONFIG_VIRTIO_PCI_MODERN */
+		isr_status = virtio_cread8((void *)(unsigned long)
+					   d->pci_isr_addr, 0);
 	/* We don't support configuration interrupt on the device */
 	if (isr_status & VIRTIO_PCI_ISR_CONFIG) {
 		uk_pr_warn("Unsupported config change interrupt received on virtio-pci device %p\n",
@@ -150,6 +176,95 @@ static int virtio_pci_handle(void *arg)
 	return rc;
 }
 
+#ifdef CONFIG_KVM_PCI_MSIX
+static int virtio_pci_config_handle(void *arg)
+{
+	UK_ASSERT(arg);
+
+	/* We don't support configuration interrupt on the device */
+	uk_pr_warn("Unsupported config change interrupt received on virtio-pci device %p\n",
+		   arg);
+	return 1;
+}
+
+static int virtio_pci_vq_handle(void *arg)
+{
+	struct virtqueue *vq;
+
+	UK_ASSERT(arg);
+
+	/* The vector belongs to this queue alone: there is no ISR to read
+	 * and no other queue to poll.
+	 */
+	vq = *(struct virtqueue **)arg;
+	if (likely(vq))
+		virtqueue_ring_interrupt(vq);
+	return 1;
+}
+
+/**
+ * Switches the device to MSI-X with a vector for configuration changes and
+ * one for each of the first num_vqs queues.
+ */
+static int virtio_pci_msix_setup(struct virtio_pci_dev *vpdev, __u16 num_vqs)
+{
+	unsigned long *irqs;
+	__u16 i, vector;
+	int rc;
+
+	irqs = uk_malloc(a, (num_vqs + 1) * sizeof(*irqs));
+	vpdev->msix_vqs = uk_calloc(a, num_vqs, sizeof(*vpdev->msix_vqs));
+	if (!irqs || !vpdev->msix_vqs) {
+		rc = -ENOMEM;
+		goto err_free;
+	}
+
+	rc = pci_msix_enable(vpdev->pdev, irqs, num_vqs + 1);
+	if (rc)
+		goto err_free;
+
+	/* From here on the device no longer raises INTx */
+	vpdev->msix_enabled = 1;
+	vpdev->msix_nvqs = num_vqs;
+
+	rc = ukplat_irq_register(irqs[0], virtio_pci_config_handle, vpdev);
+	for (i = 0; i < num_vqs && rc == 0; i++)
+		rc = ukplat_irq_register(irqs[i + 1], virtio_pci_vq_handle,
+					 &vpdev->msix_vqs[i]);
+	if (rc) {
+		uk_pr_err("Failed to register the MSI-X interrupts: %d\n", rc);
+		goto out;
+	}
+
+#ifdef CONFIG_VIRTIO_PCI_MODERN
+	if (vpdev->common_cfg) {
+		virtio_mmio_cwrite16(vpdev->common_cfg,
+				     VIRTIO_PCI_COMMON_MSIX, 0);
+		vector = virtio_mmio_cread16(vpdev->common_cfg,
+					     VIRTIO_PCI_COMMON_MSIX);
+	} else
+#endif /* CONFIG_VIRTIO_PCI_MODERN */
+	{
+		virtio_cwrite16((void *)(unsigned long)vpdev->pci_base_addr,
+				VIRTIO_MSI_CONFIG_VECTOR, 0);
+		vector = virtio_cread16((void *)(unsigned long)
+					vpdev->pci_base_addr,
+					VIRTIO_MSI_CONFIG_VECTOR);
+	}
+	if (vector == VIRTIO_MSI_NO_VECTOR)
+		uk_pr_warn("Device has no vector for config changes\n");
+
+out:
+	uk_free(a, irqs);
+	return rc;
+
+err_free:
+	uk_free(a, vpdev->msix_vqs);
+	vpdev->msix_vqs = NULL;
+	goto out;
+}
+#endif /* CONFIG_KVM_PCI_MSIX */
+
 static struct virtqueue *vpci_legacy_vq_setup(struct virtio_dev *vdev,
 					      __u16 queue_id,
 					      __u16 num_desc,
@@ -164,6 +279,14 @@ static struct virtqueue *vpci_legacy_vq_setup(struct virtio_dev *vdev,
 	UK_ASSERT(vdev != NULL);
 
 	vpdev = to_virtiopcidev(vdev);
+#ifdef CONFIG_KVM_PCI_MSIX
+	if (vpdev->msix_enabled && queue_id >= vpdev->msix_nvqs) {
+		uk_pr_err("No MSI-X vector for virtqueue %"__PRIu16"\n",
+			  queue_id);
+		return ERR2PTR(-ENOSPC);
+	}
+#endif /* CONFIG_KVM_PCI_MSIX */
+
 	vq = virtqueue_create(queue_id, num_desc, VIRTIO_PCI_VRING_ALIGN,
 			      callback, vpci_legacy_notify, vdev, a);
 	if (PTRISERR(vq)) {
@@ -183,8 +306,24 @@ static struct virtqueue *vpci_legacy_vq_setup(struct virtio_dev *vdev,
 
 	flags = ukplat_lcpu_save_irqf();
 	UK_TAILQ_INSERT_TAIL(&vpdev->vdev.vqs, vq, next);
+#ifdef CONFIG_KVM_PCI_MSIX
+	if (vpdev->msix_enabled)
+		vpdev->msix_vqs[queue_id] = vq;
+#endif /* CONFIG_KVM_PCI_MSIX */
 	ukplat_lcpu_restore_irqf(flags);
 
+#ifdef CONFIG_KVM_PCI_MSIX
+	if (vpdev->msix_enabled) {
+		virtio_cwrite16((void *)(unsigned long)vpdev->pci_base_addr,
+				VIRTIO_MSI_QUEUE_VECTOR, queue_id + 1);
+		if (virtio_cread16((void *)(unsigned long)vpdev->pci_base_addr,
+				   VIRTIO_MSI_QUEUE_VECTOR)
+		    == VIRTIO_MSI_NO_VECTOR)
+			uk_pr_warn("Device has no vector for virtqueue %"__PRIu16"\n",
+				   queue_id);
+	}
+#endif /* CONFIG_KVM_PCI_MSIX */
+
 err_exit:
 	return vq;
 }
@@ -204,14 +343,55 @@ static void vpci_legacy_vq_release(struct virtio_dev *vdev,
 			VIRTIO_PCI_QUEUE_SEL, vq->queue_id);
 	virtio_cwrite32((void *)(unsigned long)vpdev->pci_base_addr,
 			VIRTIO_PCI_QUEUE_PFN, 0);
+#ifdef CONFIG_KVM_PCI_MSIX
+	if (vpdev->msix_enabled)
+		virtio_cwrite16((void *)(unsigned long)vpdev->pci_base_addr,
+				VIRTIO_MSI_QUEUE_VECTOR, VIRTIO_MSI_NO_VECTOR);
+#endif /* CONFIG_KVM_PCI_MSIX */
 
 	flags = ukplat_lcpu_save_irqf();
 	UK_TAILQ_REMOVE(&vpdev->vdev.vqs, vq, next);
+#ifdef CONFIG_KVM_PCI_MSIX
+	if (vpdev->msix_enabled)
+		vpdev->msix_vqs[vq->queue_id] = NULL;
+#endif /* CONFIG_KVM_PCI_MSIX */
 	ukplat_lcpu_restore_irqf(flags);
 
 	virtqueue_destroy(vq, a);
 }
 
+/**
+ * Sets up the interrupts of the device: MSI-X vectors if possible, the
+ * shared INTx line otherwise.
+ */
+static int virtio_pci_irq_setup(struct virtio_pci_dev *vpdev,
+				__u16 num_vqs __maybe_unused)
+{
+	int rc = 0;
+
+#ifdef CONFIG_KVM_PCI_MSIX
+	if (!vpdev->msix_enabled) {
+		rc = virtio_pci_msix_setup(vpdev, num_vqs);
+		if (unlikely(rc && vpdev->msix_enabled))
+			return rc;
+		if (rc)
+			uk_pr_info("Using INTx for virtio-pci device %p: %d\n",
+				   vpdev, rc);
+	}
+#endif /* CONFIG_KVM_PCI_MSIX */
+
+	if (!vpdev->msix_enabled) {
+		/* Registering the interrupt for the queue */
+		rc = ukplat_irq_register(vpdev->pdev->irq, virtio_pci_handle,
+					 vpdev);
+		if (rc != 0) {
+			uk_pr_err("Failed to register the interrupt\n");
+			return rc;
+		}
+	}
+	return 0;
+}
+
 static int vpci_legacy_pci_vq_find(struct virtio_dev *vdev, __u16 num_vqs,
 				   __u16 *qdesc_size)
 {
@@ -221,12 +401,9 @@ static int vpci_legacy_pci_vq_find(struct virtio_dev *vdev, __u16 num_vqs,
 	UK_ASSERT(vdev);
 	vpdev = to_virtiopcidev(vdev);
 
-	/* Registering the interrupt for the queue */
-	rc = ukplat_irq_register(vpdev->pdev->irq, virtio_pci_handle, vpdev);
-	if (rc != 0) {
-		uk_pr_err("Failed to register the interrupt\n");
+	rc = virtio_pci_irq_setup(vpdev, num_vqs);
+	if (rc != 0)
 		return rc;
-	}
 
 	for (i = 0; i < num_vqs; i++) {
 		virtio_cwrite16((void *) (unsigned long)vpdev->pci_base_addr,
@@ -252,7 +429,8 @@ static int vpci_legacy_pci_config_set(struct virtio_dev *vdev, __u16 offset,
 	vpdev = to_virtiopcidev(vdev);
 
 	_virtio_cwrite_bytes((void *)(unsigned long)vpdev->pci_base_addr,
-			     VIRTIO_PCI_CONFIG_OFF + offset, buf, len, 1);
+			     VIRTIO_PCI_CONFIG_OFF(vpdev->msix_enabled) + offset,
+			     buf, len, 1);
 
 	return 0;
 }
@@ -270,12 +448,14 @@ static int vpci_legacy_pci_config_get(struct virtio_dev *vdev, __u16 offset,
 	if (type_len == len && type_len <= 4) {
 		_virtio_cread_bytes(
 				(void *) (unsigned long)vpdev->pci_base_addr,
-				VIRTIO_PCI_CONFIG_OFF + offset, buf, len,
+				VIRTIO_PCI_CONFIG_OFF(vpdev->msix_enabled)
+				+ offset, buf, len,
 				type_len);
 	} else {
 		rc = virtio_cread_bytes_many(
 				(void *) (unsigned long)vpdev->pci_base_addr,
-				VIRTIO_PCI_CONFIG_OFF + offset,	buf, len);
+				VIRTIO_PCI_CONFIG_OFF(vpdev->msix_enabled)
+				+ offset, buf, len);
 		if (rc != (int)len)
 			return -EFAULT;
 	}
@@ -348,8 +528,8 @@ static __u64 vpci_legacy_pci_features_get(struct virtio_dev *vdev)
 	return features;
 }
 
-static void vpci_legacy_pci_features_set(struct virtio_dev *vdev,
-					 __u64 features)
+static int vpci_legacy_pci_features_set(struct virtio_dev *vdev,
+					__u64 features)
 {
 	struct virtio_pci_dev *vpdev = NULL;
 
@@ -359,7 +539,437 @@ static void vpci_legacy_pci_features_set(struct virtio_dev *vdev,
 	features = virtqueue_feature_negotiate(features);
 	virtio_cwrite32((void *) (unsigned long)vpdev->pci_base_addr,
 			VIRTIO_PCI_GUEST_FEATURES, (__u32)features);
+	return 0;
+}
+
+#ifdef CONFIG_VIRTIO_PCI_MODERN
+static int vpci_modern_notify(struct virtio_dev *vdev, __u16 queue_id)
+{
+	struct virtio_pci_dev *vpdev;
+
+	UK_ASSERT(vdev);
+	vpdev = to_virtiopcidev(vdev);
+	UK_ASSERT(queue_id < vpdev->num_queues);
+
+	/* A plain memory write, the host does not have to decode port I/O */
+	virtio_mmio_cwrite16((__u8 *)vpdev->notify_base
+			     + vpdev->notify_offs[queue_id], 0, queue_id);
+	return 0;
+}
+
+static void vpci_modern_dev_reset(struct virtio_dev *vdev)
+{
+	struct virtio_pci_dev *vpdev;
+
+	UK_ASSERT(vdev);
+	vpdev = to_virtiopcidev(vdev);
+
+	virtio_mmio_cwrite8(vpdev->common_cfg, VIRTIO_PCI_COMMON_STATUS,
+			    VIRTIO_CONFIG_STATUS_RESET);
+	/* The reset is complete once the status reads back as 0 */
+	while (virtio_mmio_cread8(vpdev->common_cfg, VIRTIO_PCI_COMMON_STATUS)
+	       != VIRTIO_CONFIG_STATUS_RESET)
+		;
+}
+
+static __u8 vpci_modern_status_get(struct virtio_dev *vdev)
+{
+	struct virtio_pci_dev *vpdev;
+
+	UK_ASSERT(vdev);
+	vpdev = to_virtiopcidev(vdev);
+	return virtio_mmio_cread8(vpdev->common_cfg, VIRTIO_PCI_COMMON_STATUS);
+}
+
+static void vpci_modern_status_set(struct virtio_dev *vdev, __u8 status)
+{
+	struct virtio_pci_dev *vpdev;
+
+	/* Reset should be performed using the reset interface */
+	UK_ASSERT(vdev && status != VIRTIO_CONFIG_STATUS_RESET);
+	vpdev = to_virtiopcidev(vdev);
+
+	status |= vpci_modern_status_get(vdev);
+	virtio_mmio_cwrite8(vpdev->common_cfg, VIRTIO_PCI_COMMON_STATUS,
+			    status);
+}
+
+static __u64 vpci_modern_features_get(struct virtio_dev *vdev)
+{
+	struct virtio_pci_dev *vpdev;
+	__u64 features;
+
+	UK_ASSERT(vdev);
+	vpdev = to_virtiopcidev(vdev);
+
+	virtio_mmio_cwrite32(vpdev->common_cfg, VIRTIO_PCI_COMMON_DFSELECT, 1);
+	features = virtio_mmio_cread32(vpdev->common_cfg,
+				       VIRTIO_PCI_COMMON_DF);
+	features <<= 32;
+	virtio_mmio_cwrite32(vpdev->common_cfg, VIRTIO_PCI_COMMON_DFSELECT, 0);
+	features |= virtio_mmio_cread32(vpdev->common_cfg,
+					VIRTIO_PCI_COMMON_DF);
+	return features;
+}
+
+static int vpci_modern_features_set(struct virtio_dev *vdev,
+				    __u64 features)
+{
+	struct virtio_pci_dev *vpdev;
+
+	UK_ASSERT(vdev);
+	vpdev = to_virtiopcidev(vdev);
+
+	/* Mask out features not supported by the virtqueue driver */
+	features = virtqueue_feature_negotiate(features);
+	if (unlikely(!VIRTIO_FEATURE_HAS(features, VIRTIO_F_VERSION_1)))
+		uk_pr_warn("VIRTIO_F_VERSION_1 not negotiated on virtio-pci device %p\n",
+			   vpdev);
+
+	virtio_mmio_cwrite32(vpdev->common_cfg, VIRTIO_PCI_COMMON_GFSELECT, 0);
+	virtio_mmio_cwrite32(vpdev->common_cfg, VIRTIO_PCI_COMMON_GF,
+			     (__u32)features);
+	virtio_mmio_cwrite32(vpdev->common_cfg, VIRTIO_PCI_COMMON_GFSELECT, 1);
+	virtio_mmio_cwrite32(vpdev->common_cfg, VIRTIO_PCI_COMMON_GF,
+			     (__u32)(features >> 32));
+
+	/* The device refuses a feature set it cannot work with */
+	vpci_modern_status_set(vdev, VIRTIO_CONFIG_STATUS_FEATURES_OK);
+	if (unlikely(!(vpci_modern_status_get(vdev)
+		       & VIRTIO_CONFIG_STATUS_FEATURES_OK))) {
+		uk_pr_err("Features 0x%"__PRIx64" not accepted by virtio-pci device %p\n",
+			  features, vpdev);
+		vpci_modern_status_set(vdev, VIRTIO_CONFIG_STATUS_FAIL);
+		return -EIO;
+	}
+
+	return 0;
+}
+
+/* Device configuration fields must be accessed with their natural width, up
+ * to 32 bits
+ */
+static inline __u32 vpci_modern_config_width(__u32 len, __u8 type_len)
+{
+	if (type_len == 2 && !(len & 1))
+		return 2;
+	if (type_len >= 4 && !(len & 3))
+		return 4;
+	return 1;
+}
+
+static int vpci_modern_config_get(struct virtio_dev *vdev, __u16 offset,
+				  void *buf, __u32 len, __u8 type_len)
+{
+	struct virtio_pci_dev *vpdev;
+	__u8 *base, *dst = buf;
+	__u32 width, i;
+	__u8 gen;
+
+	UK_ASSERT(vdev);
+	vpdev = to_virtiopcidev(vdev);
+
+	if (unlikely((__u32)offset + len > vpdev->device_cfg_len))
+		return -EINVAL;
+
+	base = (__u8 *)vpdev->device_cfg + offset;
+	width = vpci_modern_config_width(len, type_len);
+
+	/* Retry if the device changed its configuration in the meantime */
+	do {
+		gen = virtio_mmio_cread8(vpdev->common_cfg,
+					 VIRTIO_PCI_COMMON_CFGGENERATION);
+		for (i = 0; i < len; i += width) {
+			if (width == 4)
+				*(__u32 *)(dst + i) = read_u32(
+					(unsigned long)(base + i));
+			else if (width == 2)
+				*(__u16 *)(dst + i) = read_u16(
+					(unsigned long)(base + i));
+			else
+				dst[i] = read_u8((unsigned long)(base + i));
+		}
+	} while (gen != virtio_mmio_cread8(vpdev->common_cfg,
+					   VIRTIO_PCI_COMMON_CFGGENERATION));
+	return 0;
+}
+
+static int vpci_modern_config_set(struct virtio_dev *vdev, __u16 offset,
+				  const void *buf, __u32 len)
+{
+	struct virtio_pci_dev *vpdev;
+	const __u8 *src = buf;
+	__u8 *base;
+	__u32 width, i;
+
+	UK_ASSERT(vdev);
+	vpdev = to_virtiopcidev(vdev);
+
+	if (unlikely((__u32)offset + len > vpdev->device_cfg_len))
+		return -EINVAL;
+
+	base = (__u8 *)vpdev->device_cfg + offset;
+	width = (len == 2 || len == 4) ? len : 1;
+	for (i = 0; i < len; i += width) {
+		if (width == 4)
+			write_u32((unsigned long)(base + i),
+				  *(const __u32 *)(src + i));
+		else if (width == 2)
+			write_u16((unsigned long)(base + i),
+				  *(const __u16 *)(src + i));
+		else
+			write_u8((unsigned long)(base + i), src[i]);
+	}
+	return 0;
+}
+
+static int vpci_modern_vqs_find(struct virtio_dev *vdev, __u16 num_vqs,
+				__u16 *qdesc_size)
+{
+	struct virtio_pci_dev *vpdev;
+	int vq_cnt = 0, i = 0, rc = 0;
+
+	UK_ASSERT(vdev);
+	vpdev = to_virtiopcidev(vdev);
+
+	rc = virtio_pci_irq_setup(vpdev, num_vqs);
+	if (rc != 0)
+		return rc;
+
+	for (i = 0; i < num_vqs; i++) {
+		qdesc_size[i] = 0;
+		if (i < vpdev->num_queues) {
+			virtio_mmio_cwrite16(vpdev->common_cfg,
+					     VIRTIO_PCI_COMMON_Q_SELECT, i);
+			qdesc_size[i] = virtio_mmio_cread16(vpdev->common_cfg,
+						VIRTIO_PCI_COMMON_Q_SIZE);
+		}
+		if (unlikely(!qdesc_size[i])) {
+			uk_pr_err("Virtqueue %d not available\n", i);
+			continue;
+		}
+		vq_cnt++;
+	}
+	return vq_cnt;
+}
+
+static inline void vpci_modern_write64(void *base, __u8 off_lo, __u64 val)
+{
+	virtio_mmio_cwrite32(base, off_lo, (__u32)val);
+	virtio_mmio_cwrite32(base, off_lo + 4, (__u32)(val >> 32));
+}
+
+static struct virtqueue *vpci_modern_vq_setup(struct virtio_dev *vdev,
+					      __u16 queue_id,
+					      __u16 num_desc,
+					      virtqueue_callback_t callback,
+					      struct uk_alloc *a)
+{
+	struct virtio_pci_dev *vpdev;
+	struct virtqueue *vq;
+	long flags;
+
+	UK_ASSERT(vdev != NULL);
+	vpdev = to_virtiopcidev(vdev);
+
+	if (unlikely(queue_id >= vpdev->num_queues))
+		return ERR2PTR(-EINVAL);
+#ifdef CONFIG_KVM_PCI_MSIX
+	if (vpdev->msix_enabled && queue_id >= vpdev->msix_nvqs) {
+		uk_pr_err("No MSI-X vector for virtqueue %"__PRIu16"\n",
+			  queue_id);
+		return ERR2PTR(-ENOSPC);
+	}
+#endif /* CONFIG_KVM_PCI_MSIX */
+
+	vq = virtqueue_create(queue_id, num_desc, VIRTIO_PCI_VRING_ALIGN,
+			      callback, vpci_modern_notify, vdev, a);
+	if (PTRISERR(vq)) {
+		uk_pr_err("Failed to create the virtqueue: %d\n",
+			  PTR2ERR(vq));
+		return vq;
+	}
+
+	/* The three parts of the ring are placed independently */
+	virtio_mmio_cwrite16(vpdev->common_cfg, VIRTIO_PCI_COMMON_Q_SELECT,
+			     queue_id);
+	virtio_mmio_cwrite16(vpdev->common_cfg, VIRTIO_PCI_COMMON_Q_SIZE,
+			     num_desc);
+	vpci_modern_write64(vpdev->common_cfg, VIRTIO_PCI_COMMON_Q_DESCLO,
+			    virtqueue_physaddr(vq));
+	vpci_modern_write64(vpdev->common_cfg, VIRTIO_PCI_COMMON_Q_AVAILLO,
+			    virtqueue_get_avail_addr(vq));
+	vpci_modern_write64(vpdev->common_cfg, VIRTIO_PCI_COMMON_Q_USEDLO,
+			    virtqueue_get_used_addr(vq));
+	vpdev->notify_offs[queue_id] =
+		virtio_mmio_cread16(vpdev->common_cfg,
+				    VIRTIO_PCI_COMMON_Q_NOFF)
+		* vpdev->notify_off_mult;
+
+	flags = ukplat_lcpu_save_irqf();
+	UK_TAILQ_INSERT_TAIL(&vpdev->vdev.vqs, vq, next);
+#ifdef CONFIG_KVM_PCI_MSIX
+	if (vpdev->msix_enabled)
+		vpdev->msix_vqs[queue_id] = vq;
+#endif /* CONFIG_KVM_PCI_MSIX */
+	ukplat_lcpu_restore_irqf(flags);
+
+#ifdef CONFIG_KVM_PCI_MSIX
+	if (vpdev->msix_enabled) {
+		virtio_mmio_cwrite16(vpdev->common_cfg,
+				     VIRTIO_PCI_COMMON_Q_MSIX, queue_id + 1);
+		if (virtio_mmio_cread16(vpdev->common_cfg,
+					VIRTIO_PCI_COMMON_Q_MSIX)
+		    == VIRTIO_MSI_NO_VECTOR)
+			uk_pr_warn("Device has no vector for virtqueue %"__PRIu16"\n",
+				   queue_id);
+	}
+#endif /* CONFIG_KVM_PCI_MSIX */
+
+	virtio_mmio_cwrite16(vpdev->common_cfg, VIRTIO_PCI_COMMON_Q_ENABLE, 1);
+	return vq;
+}
+
+static void vpci_modern_vq_release(struct virtio_dev *vdev,
+				   struct virtqueue *vq, struct uk_alloc *a)
+{
+	struct virtio_pci_dev *vpdev;
+	long flags;
+
+	UK_ASSERT(vq != NULL);
+	UK_ASSERT(a != NULL);
+	vpdev = to_virtiopcidev(vdev);
+
+	/* A queue cannot be disabled again short of a device reset. It is
+	 * only detached from its interrupt here.
+	 */
+#ifdef CONFIG_KVM_PCI_MSIX
+	if (vpdev->msix_enabled) {
+		virtio_mmio_cwrite16(vpdev->common_cfg,
+				     VIRTIO_PCI_COMMON_Q_SELECT, vq->queue_id);
+		virtio_mmio_cwrite16(vpdev->common_cfg,
+				     VIRTIO_PCI_COMMON_Q_MSIX,
+				     VIRTIO_MSI_NO_VECTOR);
+	}
+#endif /* CONFIG_KVM_PCI_MSIX */
+
+	flags = ukplat_lcpu_save_irqf();
+	UK_TAILQ_REMOVE(&vpdev->vdev.vqs, vq, next);
+#ifdef CONFIG_KVM_PCI_MSIX
+	if (vpdev->msix_enabled)
+		vpdev->msix_vqs[vq->queue_id] = NULL;
+#endif /* CONFIG_KVM_PCI_MSIX */
+	ukplat_lcpu_restore_irqf(flags);
+
+	virtqueue_destroy(vq, a);
+}
+
+/**
+ * Configuration operations modern PCI device.
+ */
+static struct virtio_config_ops vpci_modern_ops = {
+	.device_reset = vpci_modern_dev_reset,
+	.config_get   = vpci_modern_config_get,
+	.config_set   = vpci_modern_config_set,
+	.features_get = vpci_modern_features_get,
+	.features_set = vpci_modern_features_set,
+	.status_get   = vpci_modern_status_get,
+	.status_set   = vpci_modern_status_set,
+	.vqs_find     = vpci_modern_vqs_find,
+	.vq_setup     = vpci_modern_vq_setup,
+	.vq_release   = vpci_modern_vq_release,
+};
+
+/**
+ * Locates the configuration structures of the modern interface. Returns
+ * -ENODEV if the device does not offer it.
+ */
+static int virtio_pci_modern_add_dev(struct pci_device *pci_dev,
+				     struct virtio_pci_dev *vpci_dev)
+{
+	__u32 offset, length;
+	__u8 pos, type, bar;
+	__u16 cmd;
+	__u8 *base;
+
+	for (pos = pci_find_capability(pci_dev, PCI_CAP_ID_VNDR, 0); pos;
+	     pos = pci_find_capability(pci_dev, PCI_CAP_ID_VNDR, pos)) {
+		type = pci_conf_read8(pci_dev, pos + VIRTIO_PCI_CAP_CFG_TYPE);
+		if (type < VIRTIO_PCI_CAP_COMMON_CFG ||
+		    type > VIRTIO_PCI_CAP_DEVICE_CFG)
+			continue;
+
+		bar = pci_conf_read8(pci_dev, pos + VIRTIO_PCI_CAP_BAR);
+		offset = pci_conf_read32(pci_dev, pos + VIRTIO_PCI_CAP_OFFSET);
+		length = pci_conf_read32(pci_dev, pos + VIRTIO_PCI_CAP_LENGTH);
+		base = pci_map_bar(pci_dev, bar);
+		if (!base)
+			continue;
+		base += offset;
+
+		/* The first usable capability of each type is taken */
+		switch (type) {
+		case VIRTIO_PCI_CAP_COMMON_CFG:
+			if (!vpci_dev->common_cfg &&
+			    length >= VIRTIO_PCI_COMMON_CFG_LEN)
+				vpci_dev->common_cfg = base;
+			break;
+		case VIRTIO_PCI_CAP_NOTIFY_CFG:
+			if (!vpci_dev->notify_base && length >= 2) {
+				vpci_dev->notify_base = base;
+				vpci_dev->notify_off_mult = pci_conf_read32(
+					pci_dev, pos + VIRTIO_PCI_NOTIFY_CAP_MULT);
+			}
+			break;
+		case VIRTIO_PCI_CAP_ISR_CFG:
+			if (!vpci_dev->isr_cfg && length >= 1)
+				vpci_dev->isr_cfg = base;
+			break;
+		case VIRTIO_PCI_CAP_DEVICE_CFG:
+			if (!vpci_dev->device_cfg) {
+				vpci_dev->device_cfg = base;
+				vpci_dev->device_cfg_len = length;
+			}
+			break;
+		}
+	}
+
+	if (!vpci_dev->common_cfg || !vpci_dev->notify_base ||
+	    !vpci_dev->isr_cfg) {
+		vpci_dev->common_cfg = NULL;
+		return -ENODEV;
+	}
+
+	vpci_dev->num_queues = virtio_mmio_cread16(vpci_dev->common_cfg,
+						   VIRTIO_PCI_COMMON_NUMQ);
+	vpci_dev->notify_offs = uk_calloc(a, vpci_dev->num_queues,
+					  sizeof(*vpci_dev->notify_offs));
+	if (vpci_dev->num_queues && !vpci_dev->notify_offs) {
+		vpci_dev->common_cfg = NULL;
+		return -ENOMEM;
+	}
+
+	/* The structures live in memory BARs, and the rings are DMA */
+	cmd = pci_conf_read16(pci_dev, PCI_COMMAND);
+	pci_conf_write16(pci_dev, PCI_COMMAND,
+			 cmd | PCI_COMMAND_MEMORY | PCI_COMMAND_MASTER);
+
+	/* Setting the configuration operation */
+	vpci_dev->vdev.cops = &vpci_modern_ops;
+
+	/* Transitional devices keep the virtio ID in the subsystem ID */
+	if (pci_dev->id.device_id >= VIRTIO_PCI_MODERN_DEVICEID_START)
+		vpci_dev->vdev.id.virtio_device_id = pci_dev->id.device_id
+					- VIRTIO_PCI_MODERN_DEVICEID_START;
+	else
+		vpci_dev->vdev.id.virtio_device_id =
+					pci_dev->id.subsystem_device_id;
+
+	uk_pr_info("Added virtio-pci device %04x (modern, %"__PRIu16" queues)\n",
+		   pci_dev->id.device_id, vpci_dev->num_queues);
+	return 0;
 }
+#endif /* CONFIG_VIRTIO_PCI_MODERN */
 
 static int virtio_pci_legacy_add_dev(struct pci_device *pci_dev,
 				     struct virtio_pci_dev *vpci_dev)
@@ -394,7 +1004,7 @@ static int virtio_pci_add_dev(struct pci_device *pci_dev)
 
 	UK_ASSERT(pci_dev != NULL);
 
-	vpci_dev = uk_malloc(a, sizeof(*vpci_dev));
+	vpci_dev = uk_calloc(a, 1, sizeof(*vpci_dev));
 	if (!vpci_dev) {
 		uk_pr_err("Failed to allocate virtio-pci device\n");
 		return -ENOMEM;
@@ -405,13 +1015,16 @@ static int virtio_pci_add_dev(struct pci_device *pci_dev)
 	vpci_dev->pci_base_addr = pci_dev->base;
 
 	/**
-	 * Probing for the legacy virtio device. We separate the legacy probing
-	 * with the possibility of supporting the modern PCI device in the
-	 * future.
+	 * Transitional devices offer both the modern and the legacy
+	 * interface, the modern one is preferred.
 	 */
-	rc = virtio_pci_legacy_add_dev(pci_dev, vpci_dev);
+#ifdef CONFIG_VIRTIO_PCI_MODERN
+	rc = virtio_pci_modern_add_dev(pci_dev, vpci_dev);
+	if (rc == -ENODEV)
+#endif /* CONFIG_VIRTIO_PCI_MODERN */
+		rc = virtio_pci_legacy_add_dev(pci_dev, vpci_dev);
 	if (rc != 0) {
-		uk_pr_err("Failed to probe (legacy) pci device: %d\n", rc);
+		uk_pr_err("Failed to probe pci device: %d\n", rc);
 		goto free_pci_dev;
 	}
 
@@ -425,6 +1038,9 @@ exit:
 	return rc;
 
 free_pci_dev:
+#ifdef CONFIG_VIRTIO_PCI_MODERN
+	uk_free(a, vpci_dev->notify_offs);
+#endif /* CONFIG_VIRTIO_PCI_MODERN */
 	uk_free(a, vpci_dev);
 	goto exit;
 }
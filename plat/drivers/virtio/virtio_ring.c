@@ -43,28 +43,60 @@
 #include <uk/plat/io.h>
 #include <virtio/virtio_ring.h>
 #include <virtio/virtqueue.h>
+#include <virtio/virtio_bus.h>
 
 #define VIRTQUEUE_MAX_SIZE  32768
 #define to_virtqueue_vring(vq)			\
 	__containerof(vq, struct virtqueue_vring, vq)
 
+#ifdef CONFIG_VIRTIO_RING_INDIRECT_MAX
+#define VIRTQUEUE_INDIRECT_MAX CONFIG_VIRTIO_RING_INDIRECT_MAX
+#else
+#define VIRTQUEUE_INDIRECT_MAX 0
+#endif
+
 struct virtqueue_desc_info {
 	void *cookie;
 	__u16 desc_count;
+	/* Packed ring: Next free buffer id */
+	__u16 next;
 };
 
 struct virtqueue_vring {
 	struct virtqueue vq;
 	/* Descriptor Ring */
 	struct vring vring;
+	/* Descriptor Ring, packed layout */
+	struct vring_packed pvring;
 	/* Reference to the vring */
 	void   *vring_mem;
+	/* Indirect descriptor tables, one per buffer id */
+	void   *indirect;
+	/* Number of entries of each indirect table, 0 if not negotiated */
+	__u16 indirect_max;
+	/* VIRTIO_F_RING_PACKED was negotiated */
+	__u8 packed;
+	/* VIRTIO_F_EVENT_IDX was negotiated */
+	__u8 event_idx;
 	/* Keep track of available descriptors */
 	__u16 desc_avail;
-	/* Index of the next available slot */
+	/* Split ring: Index of the next free descriptor
+	 * Packed ring: Next free buffer id
+	 */
 	__u16 head_free_desc;
 	/* Index of the last used descriptor by the host */
 	__u16 last_used_desc_idx;
+	/* Split ring: Available ring index including entries not yet published
+	 * Packed ring: Index of the next descriptor to make available
+	 */
+	__u16 avail_shadow_idx;
+	/* Split ring: Available ring index at the last notification */
+	__u16 avail_notified_idx;
+	/* Packed ring: Descriptors made available since the last notification */
+	__u16 avail_added;
+	/* Packed ring: Wrap counters */
+	__u8 avail_wrap;
+	__u8 used_wrap;
 	/* Cookie to identify driver buffer */
 	struct virtqueue_desc_info vq_info[];
 };
@@ -74,6 +106,7 @@ struct virtqueue_vring {
  */
 static inline void virtqueue_ring_update_avail(struct virtqueue_vring *vrq,
 					       __u16 idx);
+static inline void virtqueue_ring_publish_avail(struct virtqueue_vring *vrq);
 static inline void virtqueue_detach_desc(struct virtqueue_vring *vrq,
 					 __u16 head_idx);
 static inline int virtqueue_buffer_enqueue_segments(
@@ -85,6 +118,26 @@ static inline int virtqueue_buffer_enqueue_segments(
 static void virtqueue_vring_init(struct virtqueue_vring *vrq, __u16 nr_desc,
 				 __u16 align);
 
+static inline int virtqueue_use_indirect(struct virtqueue_vring *vrq,
+					 __u32 total_desc)
+{
+	return total_desc > 1 && total_desc <= vrq->indirect_max;
+}
+
+static inline void *virtqueue_indirect_table(struct virtqueue_vring *vrq,
+					     __u16 id)
+{
+	return (char *)vrq->indirect +
+		(__sz)id * vrq->indirect_max * sizeof(struct vring_desc);
+}
+
+static inline __u16 virtqueue_packed_flags(struct virtqueue_vring *vrq)
+{
+	/* Available descriptors have AVAIL == avail_wrap and USED != it */
+	return vrq->avail_wrap ? VRING_PACKED_DESC_F_AVAIL
+			       : VRING_PACKED_DESC_F_USED;
+}
+
 /**
  * Driver implementation
  */
@@ -95,46 +148,73 @@ void virtqueue_intr_disable(struct virtqueue *vq)
 	UK_ASSERT(vq);
 
 	vrq = to_virtqueue_vring(vq);
+	if (vrq->packed) {
+		vrq->pvring.driver->flags = VRING_PACKED_EVENT_FLAG_DISABLE;
+		return;
+	}
+
 	vrq->vring.avail->flags |= (VRING_AVAIL_F_NO_INTERRUPT);
+	/**
+	 * With event indices the flag is ignored by the host. Move the event
+	 * as far away as possible instead.
+	 */
+	if (vrq->event_idx)
+		vring_used_event(&vrq->vring) =
+			vrq->last_used_desc_idx + 0x8000;
+}
+
+static inline void virtqueue_intr_arm(struct virtqueue_vring *vrq)
+{
+	if (vrq->packed) {
+		if (vrq->event_idx) {
+			vrq->pvring.driver->off_wrap = vrq->last_used_desc_idx |
+				(vrq->used_wrap << VRING_PACKED_EVENT_F_WRAP_CTR);
+			/* The event needs to be valid before we enable it */
+			wmb();
+			vrq->pvring.driver->flags =
+				VRING_PACKED_EVENT_FLAG_DESC;
+		} else {
+			vrq->pvring.driver->flags =
+				VRING_PACKED_EVENT_FLAG_ENABLE;
+		}
+		return;
+	}
+
+	if (vrq->event_idx)
+		vring_used_event(&vrq->vring) = vrq->last_used_desc_idx;
+	vrq->vring.avail->flags &= (~VRING_AVAIL_F_NO_INTERRUPT);
 }
 
 int virtqueue_intr_enable(struct virtqueue *vq)
 {
 	struct virtqueue_vring *vrq;
-	int rc = 0;
 
 	UK_ASSERT(vq);
 
 	vrq = to_virtqueue_vring(vq);
-	/* Check if there are no more packets enabled */
-	if (!virtqueue_hasdata(vq)) {
-		if (vrq->vring.avail->flags | VRING_AVAIL_F_NO_INTERRUPT) {
-			vrq->vring.avail->flags &=
-				(~VRING_AVAIL_F_NO_INTERRUPT);
-			/**
-			 * We enabled the interrupts. We ensure it using the
-			 * memory barrier and check if there are any further
-			 * data available in the queue. The check for data
-			 * after enabling the interrupt is to make sure we do
-			 * not miss any interrupt while transitioning to enable
-			 * interrupt. This is inline with the requirement from
-			 * virtio specification section 3.2.2
-			 */
-			mb();
-			/* Check if there are further descriptors */
-			if (virtqueue_hasdata(vq)) {
-				virtqueue_intr_disable(vq);
-				rc = 1;
-			}
-		}
-	} else {
-		/**
-		 * There are more packet in the virtqueue to be processed while
-		 * the interrupt was disabled.
-		 */
-		rc = 1;
+	/**
+	 * There are more packet in the virtqueue to be processed while
+	 * the interrupt was disabled.
+	 */
+	if (virtqueue_hasdata(vq))
+		return 1;
+
+	virtqueue_intr_arm(vrq);
+	/**
+	 * We enabled the interrupts. We ensure it using the memory barrier
+	 * and check if there are any further data available in the queue.
+	 * The check for data after enabling the interrupt is to make sure we
+	 * do not miss any interrupt while transitioning to enable interrupt.
+	 * This is inline with the requirement from virtio specification
+	 * section 3.2.2
+	 */
+	mb();
+	/* Check if there are further descriptors */
+	if (virtqueue_hasdata(vq)) {
+		virtqueue_intr_disable(vq);
+		return 1;
 	}
-	return rc;
+	return 0;
 }
 
 static inline void virtqueue_ring_update_avail(struct virtqueue_vring *vrq,
@@ -142,15 +222,20 @@ static inline void virtqueue_ring_update_avail(struct virtqueue_vring *vrq,
 {
 	__u16 avail_idx;
 
-	avail_idx = vrq->vring.avail->idx & (vrq->vring.num - 1);
-	/* Adding the idx to available ring */
+	avail_idx = vrq->avail_shadow_idx++ & (vrq->vring.num - 1);
+	/* Adding the idx to available ring; visible to the host on publish */
 	vrq->vring.avail->ring[avail_idx] = idx;
+}
+
+static inline void virtqueue_ring_publish_avail(struct virtqueue_vring *vrq)
+{
 	/**
-	 * Write barrier to make sure we push the descriptor on the available
-	 * descriptor and then increment available index.
+	 * Write barrier to make sure we push the descriptors on the available
+	 * ring and then update the available index.
 	 */
 	wmb();
-	vrq->vring.avail->idx++;
+	if (!vrq->packed)
+		vrq->vring.avail->idx = vrq->avail_shadow_idx;
 }
 
 static inline void virtqueue_detach_desc(struct virtqueue_vring *vrq,
@@ -177,14 +262,46 @@ static inline void virtqueue_detach_desc(struct virtqueue_vring *vrq,
 	vrq->head_free_desc = head_idx;
 }
 
+static int virtqueue_packed_notify_enabled(struct virtqueue_vring *vrq)
+{
+	__u16 new_idx, old_idx, off_wrap, flags, event_idx;
+
+	new_idx = vrq->avail_shadow_idx;
+	old_idx = new_idx - vrq->avail_added;
+	vrq->avail_added = 0;
+
+	off_wrap = vrq->pvring.device->off_wrap;
+	flags = vrq->pvring.device->flags;
+	if (flags != VRING_PACKED_EVENT_FLAG_DESC)
+		return flags != VRING_PACKED_EVENT_FLAG_DISABLE;
+
+	/* The event refers to the previous lap when the counters differ */
+	event_idx = off_wrap & ~(1 << VRING_PACKED_EVENT_F_WRAP_CTR);
+	if ((off_wrap >> VRING_PACKED_EVENT_F_WRAP_CTR) != vrq->avail_wrap)
+		event_idx -= vrq->pvring.num;
+	return vring_need_event(event_idx, new_idx, old_idx);
+}
+
 int virtqueue_notify_enabled(struct virtqueue *vq)
 {
 	struct virtqueue_vring *vrq;
+	__u16 new_idx, old_idx;
 
 	UK_ASSERT(vq);
 	vrq = to_virtqueue_vring(vq);
 
-	return ((vrq->vring.used->flags & VRING_USED_F_NO_NOTIFY) == 0);
+	if (vrq->packed)
+		return virtqueue_packed_notify_enabled(vrq);
+
+	if (!vrq->event_idx)
+		return ((vrq->vring.used->flags & VRING_USED_F_NO_NOTIFY) == 0);
+
+	/* Notify only if the host asked for one of the published entries */
+	new_idx = vrq->vring.avail->idx;
+	old_idx = vrq->avail_notified_idx;
+	vrq->avail_notified_idx = new_idx;
+	return vring_need_event(vring_avail_event(&vrq->vring),
+				new_idx, old_idx);
 }
 
 static inline int virtqueue_buffer_enqueue_segments(
@@ -194,10 +311,31 @@ static inline int virtqueue_buffer_enqueue_segments(
 {
 	int i = 0, total_desc = 0;
 	struct uk_sglist_seg *segs;
+	struct vring_desc *table;
 	__u16 idx = 0;
 
 	total_desc = read_bufs + write_bufs;
 
+	if (virtqueue_use_indirect(vrq, total_desc)) {
+		/* The whole chain goes to the table of this head */
+		table = virtqueue_indirect_table(vrq, head);
+		for (i = 0; i < total_desc; i++) {
+			segs = &sg->sg_segs[i];
+			table[i].addr = segs->ss_paddr;
+			table[i].len = segs->ss_len;
+			table[i].flags = 0;
+			if (i >= read_bufs)
+				table[i].flags |= VRING_DESC_F_WRITE;
+			if (i < total_desc - 1)
+				table[i].flags |= VRING_DESC_F_NEXT;
+			table[i].next = i + 1;
+		}
+		vrq->vring.desc[head].addr = ukplat_virt_to_phys(table);
+		vrq->vring.desc[head].len = total_desc * sizeof(*table);
+		vrq->vring.desc[head].flags = VRING_DESC_F_INDIRECT;
+		return vrq->vring.desc[head].next;
+	}
+
 	for (i = 0, idx = head; i < total_desc; i++) {
 		segs = &sg->sg_segs[i];
 		vrq->vring.desc[idx].addr = segs->ss_paddr;
@@ -213,6 +351,17 @@ static inline int virtqueue_buffer_enqueue_segments(
 	return idx;
 }
 
+static inline int virtqueue_packed_hasdata(struct virtqueue_vring *vrq)
+{
+	__u16 flags;
+	int avail, used;
+
+	flags = UK_READ_ONCE(vrq->pvring.desc[vrq->last_used_desc_idx].flags);
+	avail = !!(flags & VRING_PACKED_DESC_F_AVAIL);
+	used = !!(flags & VRING_PACKED_DESC_F_USED);
+	return avail == used && used == vrq->used_wrap;
+}
+
 int virtqueue_hasdata(struct virtqueue *vq)
 {
 	struct virtqueue_vring *vring;
@@ -220,6 +369,8 @@ int virtqueue_hasdata(struct virtqueue *vq)
 	UK_ASSERT(vq);
 
 	vring = to_virtqueue_vring(vq);
+	if (vring->packed)
+		return virtqueue_packed_hasdata(vring);
 	return (vring->last_used_desc_idx != vring->vring.used->idx);
 }
 
@@ -228,9 +379,19 @@ __u64 virtqueue_feature_negotiate(__u64 feature_set)
 	__u64 feature = (1ULL << VIRTIO_TRANSPORT_F_START) - 1;
 
 	/**
-	 * Currently out vring driver does not support any ring feature. We will
-	 * add support to transport feature in the future.
+	 * Besides the device specific features, we keep the ring features
+	 * that are implemented here and the virtio 1.0 flag.
 	 */
+	feature |= VIRTQUEUE_F_RING | (1ULL << VIRTIO_F_VERSION_1);
+	feature |= ~((1ULL << VIRTIO_DEVICE_F_HIGH_START) - 1);
+#if VIRTQUEUE_INDIRECT_MAX < 2
+	feature &= ~(1ULL << VIRTIO_F_INDIRECT_DESC);
+#endif
+	/* The packed layout is only defined for virtio 1.0 devices */
+#ifdef CONFIG_VIRTIO_RING_PACKED
+	if (!(feature_set & (1ULL << VIRTIO_F_VERSION_1)))
+#endif
+		feature &= ~(1ULL << VIRTIO_F_RING_PACKED);
 	feature &= feature_set;
 	return feature;
 }
@@ -267,6 +428,10 @@ __paddr_t virtqueue_get_avail_addr(struct virtqueue *vq)
 	UK_ASSERT(vq);
 
 	vrq = to_virtqueue_vring(vq);
+	/* The driver event suppression area takes the place of avail */
+	if (vrq->packed)
+		return virtqueue_physaddr(vq) +
+			((char *)vrq->pvring.driver - (char *)vrq->pvring.desc);
 	return virtqueue_physaddr(vq) +
 		((char *)vrq->vring.avail - (char *)vrq->vring.desc);
 }
@@ -278,6 +443,10 @@ __paddr_t virtqueue_get_used_addr(struct virtqueue *vq)
 	UK_ASSERT(vq);
 
 	vrq = to_virtqueue_vring(vq);
+	/* The device event suppression area takes the place of used */
+	if (vrq->packed)
+		return virtqueue_physaddr(vq) +
+			((char *)vrq->pvring.device - (char *)vrq->pvring.desc);
 	return virtqueue_physaddr(vq) +
 		((char *)vrq->vring.used - (char *)vrq->vring.desc);
 }
@@ -289,7 +458,63 @@ unsigned int virtqueue_vring_get_num(struct virtqueue *vq)
 	UK_ASSERT(vq);
 
 	vrq = to_virtqueue_vring(vq);
-	return vrq->vring.num;
+	return vrq->packed ? vrq->pvring.num : vrq->vring.num;
+}
+
+unsigned int virtqueue_indirect_max(struct virtqueue *vq)
+{
+	UK_ASSERT(vq);
+
+	return to_virtqueue_vring(vq)->indirect_max;
+}
+
+int virtqueue_desc_count(struct virtqueue *vq, __u16 nr_segs)
+{
+	UK_ASSERT(vq);
+
+	return virtqueue_use_indirect(to_virtqueue_vring(vq), nr_segs) ?
+		1 : nr_segs;
+}
+
+static int virtqueue_packed_dequeue(struct virtqueue_vring *vrq,
+				    void **cookie, __u32 *len)
+{
+	struct vring_packed_desc *desc;
+	struct virtqueue_desc_info *vq_info;
+	__u16 id;
+
+	if (!virtqueue_packed_hasdata(vrq))
+		return -ENOMSG;
+	/**
+	 * We are reading from the used descriptor information updated by the
+	 * host.
+	 */
+	rmb();
+	desc = &vrq->pvring.desc[vrq->last_used_desc_idx];
+	id = desc->id;
+	UK_ASSERT(id < vrq->pvring.num);
+	vq_info = &vrq->vq_info[id];
+	if (len)
+		*len = desc->len;
+	*cookie = vq_info->cookie;
+
+	/* The device skips over the remaining descriptors of the chain */
+	vrq->last_used_desc_idx += vq_info->desc_count;
+	if (vrq->last_used_desc_idx >= vrq->pvring.num) {
+		vrq->last_used_desc_idx -= vrq->pvring.num;
+		vrq->used_wrap ^= 1;
+	}
+	vrq->desc_avail += vq_info->desc_count;
+	vq_info->desc_count = 0;
+	vq_info->cookie = NULL;
+	vq_info->next = vrq->head_free_desc;
+	vrq->head_free_desc = id;
+
+	/* Keep the interrupt event in step when interrupts are enabled */
+	if (vrq->pvring.driver->flags == VRING_PACKED_EVENT_FLAG_DESC)
+		vrq->pvring.driver->off_wrap = vrq->last_used_desc_idx |
+			(vrq->used_wrap << VRING_PACKED_EVENT_F_WRAP_CTR);
+	return (vrq->pvring.num - vrq->desc_avail);
 }
 
 int virtqueue_buffer_dequeue(struct virtqueue *vq, void **cookie, __u32 *len)
@@ -302,6 +527,9 @@ int virtqueue_buffer_dequeue(struct virtqueue *vq, void **cookie, __u32 *len)
 	UK_ASSERT(cookie);
 	vrq = to_virtqueue_vring(vq);
 
+	if (vrq->packed)
+		return virtqueue_packed_dequeue(vrq, cookie, len);
+
 	/* No new descriptor since last dequeue operation */
 	if (!virtqueue_hasdata(vq))
 		return -ENOMSG;
@@ -321,11 +549,86 @@ int virtqueue_buffer_dequeue(struct virtqueue *vq, void **cookie, __u32 *len)
 	return (vrq->vring.num - vrq->desc_avail);
 }
 
-int virtqueue_buffer_enqueue(struct virtqueue *vq, void *cookie,
-			     struct uk_sglist *sg, __u16 read_bufs,
-			     __u16 write_bufs)
+static int virtqueue_packed_add(struct virtqueue_vring *vrq, void *cookie,
+				struct uk_sglist *sg, __u16 read_bufs,
+				__u16 write_bufs, __u16 ring_desc)
 {
-	__u32 total_desc = 0;
+	struct vring_packed_desc *desc, *table;
+	struct uk_sglist_seg *segs;
+	__u16 total_desc = read_bufs + write_bufs;
+	__u16 id, idx, head, flags, head_flags = 0;
+	__u16 wrap_flags = virtqueue_packed_flags(vrq);
+	int i;
+
+	/* Take a free buffer id */
+	id = vrq->head_free_desc;
+	UK_ASSERT(id < vrq->pvring.num);
+	vrq->head_free_desc = vrq->vq_info[id].next;
+	vrq->vq_info[id].cookie = cookie;
+	vrq->vq_info[id].desc_count = ring_desc;
+
+	head = idx = vrq->avail_shadow_idx;
+	if (ring_desc == 1 && total_desc > 1) {
+		table = virtqueue_indirect_table(vrq, id);
+		for (i = 0; i < total_desc; i++) {
+			segs = &sg->sg_segs[i];
+			table[i].addr = segs->ss_paddr;
+			table[i].len = segs->ss_len;
+			table[i].id = 0;
+			table[i].flags = (i >= read_bufs) ?
+				VRING_DESC_F_WRITE : 0;
+		}
+		desc = &vrq->pvring.desc[head];
+		desc->addr = ukplat_virt_to_phys(table);
+		desc->len = total_desc * sizeof(*table);
+		desc->id = id;
+		head_flags = VRING_DESC_F_INDIRECT | wrap_flags;
+		idx++;
+	} else {
+		for (i = 0; i < total_desc; i++) {
+			segs = &sg->sg_segs[i];
+			desc = &vrq->pvring.desc[idx];
+			desc->addr = segs->ss_paddr;
+			desc->len = segs->ss_len;
+			desc->id = id;
+			flags = wrap_flags;
+			if (i >= read_bufs)
+				flags |= VRING_DESC_F_WRITE;
+			if (i < total_desc - 1)
+				flags |= VRING_DESC_F_NEXT;
+			/* The head makes the whole chain visible, so it is
+			 * written last
+			 */
+			if (i == 0)
+				head_flags = flags;
+			else
+				desc->flags = flags;
+
+			if (++idx >= vrq->pvring.num) {
+				idx = 0;
+				vrq->avail_wrap ^= 1;
+				wrap_flags = virtqueue_packed_flags(vrq);
+			}
+		}
+	}
+	if (idx >= vrq->pvring.num) {
+		idx = 0;
+		vrq->avail_wrap ^= 1;
+	}
+	vrq->avail_shadow_idx = idx;
+	vrq->avail_added += ring_desc;
+	vrq->desc_avail -= ring_desc;
+
+	wmb();
+	vrq->pvring.desc[head].flags = head_flags;
+	return vrq->desc_avail;
+}
+
+int virtqueue_buffer_add(struct virtqueue *vq, void *cookie,
+			 struct uk_sglist *sg, __u16 read_bufs,
+			 __u16 write_bufs)
+{
+	__u32 total_desc = 0, ring_desc;
 	__u16 head_idx = 0, idx = 0;
 	struct virtqueue_vring *vrq = NULL;
 
@@ -333,21 +636,28 @@ int virtqueue_buffer_enqueue(struct virtqueue *vq, void *cookie,
 
 	vrq = to_virtqueue_vring(vq);
 	total_desc = read_bufs + write_bufs;
-	if (unlikely(total_desc < 1 || total_desc > vrq->vring.num)) {
+	ring_desc = virtqueue_use_indirect(vrq, total_desc) ? 1 : total_desc;
+	if (unlikely(total_desc < 1 ||
+		     ring_desc > virtqueue_vring_get_num(vq))) {
 		uk_pr_err("%"__PRIu32" invalid number of descriptor\n",
 			  total_desc);
 		return -EINVAL;
-	} else if (vrq->desc_avail < total_desc) {
+	} else if (vrq->desc_avail < ring_desc) {
 		uk_pr_err("Available descriptor:%"__PRIu16", Requested descriptor:%"__PRIu32"\n",
-			  vrq->desc_avail, total_desc);
+			  vrq->desc_avail, ring_desc);
 		return -ENOSPC;
 	}
+	UK_ASSERT(cookie);
+
+	if (vrq->packed)
+		return virtqueue_packed_add(vrq, cookie, sg, read_bufs,
+					    write_bufs, ring_desc);
+
 	/* Get the head of free descriptor */
 	head_idx = vrq->head_free_desc;
-	UK_ASSERT(cookie);
 	/* Additional information to reconstruct the data buffer */
 	vrq->vq_info[head_idx].cookie = cookie;
-	vrq->vq_info[head_idx].desc_count = total_desc;
+	vrq->vq_info[head_idx].desc_count = ring_desc;
 
 	/**
 	 * We separate the descriptor management to enqueue segment(s).
@@ -356,7 +666,7 @@ int virtqueue_buffer_enqueue(struct virtqueue *vq, void *cookie,
 			read_bufs, write_bufs);
 	/* Metadata maintenance for the virtqueue */
 	vrq->head_free_desc = idx;
-	vrq->desc_avail -= total_desc;
+	vrq->desc_avail -= ring_desc;
 
 	uk_pr_debug("Old head:%d, new head:%d, total_desc:%d\n",
 		    head_idx, idx, total_desc);
@@ -365,16 +675,51 @@ int virtqueue_buffer_enqueue(struct virtqueue *vq, void *cookie,
 	return vrq->desc_avail;
 }
 
+void virtqueue_buffer_publish(struct virtqueue *vq)
+{
+	UK_ASSERT(vq);
+
+	virtqueue_ring_publish_avail(to_virtqueue_vring(vq));
+}
+
+int virtqueue_buffer_enqueue(struct virtqueue *vq, void *cookie,
+			     struct uk_sglist *sg, __u16 read_bufs,
+			     __u16 write_bufs)
+{
+	int rc;
+
+	rc = virtqueue_buffer_add(vq, cookie, sg, read_bufs, write_bufs);
+	if (likely(rc >= 0))
+		virtqueue_ring_publish_avail(to_virtqueue_vring(vq));
+	return rc;
+}
+
 static void virtqueue_vring_init(struct virtqueue_vring *vrq, __u16 nr_desc,
 				 __u16 align)
 {
 	int i = 0;
 
+	vrq->head_free_desc = 0;
+	vrq->last_used_desc_idx = 0;
+	vrq->avail_shadow_idx = 0;
+	vrq->avail_notified_idx = 0;
+	vrq->avail_added = 0;
+	/* Both wrap counters start at 1 */
+	vrq->avail_wrap = 1;
+	vrq->used_wrap = 1;
+
+	if (vrq->packed) {
+		vring_packed_init(&vrq->pvring, nr_desc, vrq->vring_mem);
+		vrq->desc_avail = nr_desc;
+		/* Buffer ids are handed out from a free list */
+		for (i = 0; i < nr_desc; i++)
+			vrq->vq_info[i].next = i + 1;
+		return;
+	}
+
 	vring_init(&vrq->vring, nr_desc, vrq->vring_mem, align);
 
 	vrq->desc_avail = vrq->vring.num;
-	vrq->head_free_desc = 0;
-	vrq->last_used_desc_idx = 0;
 	for (i = 0; i < nr_desc - 1; i++)
 		vrq->vring.desc[i].next = i + 1;
 	/**
@@ -393,6 +738,7 @@ struct virtqueue *virtqueue_create(__u16 queue_id, __u16 nr_descs, __u16 align,
 	struct virtqueue *vq;
 	int rc;
 	size_t ring_size = 0;
+	size_t indirect_size;
 
 	UK_ASSERT(a);
 
@@ -409,8 +755,26 @@ struct virtqueue *virtqueue_create(__u16 queue_id, __u16 nr_descs, __u16 align,
 	 * allocation.
 	 */
 	vrq->vring_mem = NULL;
+	vrq->indirect = NULL;
+	vrq->indirect_max = 0;
+	vrq->packed = 0;
+	vrq->event_idx = 0;
+	if (vdev) {
+		vrq->packed = VIRTIO_FEATURE_HAS(vdev->features,
+						 VIRTIO_F_RING_PACKED);
+		vrq->event_idx = VIRTIO_FEATURE_HAS(vdev->features,
+						    VIRTIO_F_EVENT_IDX);
+		if (VIRTIO_FEATURE_HAS(vdev->features,
+				       VIRTIO_F_INDIRECT_DESC))
+			vrq->indirect_max = vdev->indirect_max ?
+					    vdev->indirect_max :
+					    VIRTQUEUE_INDIRECT_MAX;
+	}
 
-	ring_size = vring_size(nr_descs, align);
+	if (vrq->packed)
+		ring_size = vring_packed_size(nr_descs);
+	else
+		ring_size = vring_size(nr_descs, align);
 	if (uk_posix_memalign(a, &vrq->vring_mem,
 			      __PAGE_SIZE, ring_size) != 0) {
 		uk_pr_err("Allocation of vring failed\n");
@@ -418,6 +782,18 @@ struct virtqueue *virtqueue_create(__u16 queue_id, __u16 nr_descs, __u16 align,
 		goto err_freevq;
 	}
 	memset(vrq->vring_mem, 0, ring_size);
+
+	if (vrq->indirect_max) {
+		indirect_size = (size_t)nr_descs * vrq->indirect_max *
+				sizeof(struct vring_desc);
+		if (uk_posix_memalign(a, &vrq->indirect,
+				      __PAGE_SIZE, indirect_size) != 0) {
+			/* Not fatal, we just use chains in the ring */
+			uk_pr_warn("Allocation of indirect descriptors failed\n");
+			vrq->indirect = NULL;
+			vrq->indirect_max = 0;
+		}
+	}
 	virtqueue_vring_init(vrq, nr_descs, align);
 
 	vq = &vrq->vq;
@@ -443,6 +819,8 @@ void virtqueue_destroy(struct virtqueue *vq, struct uk_alloc *a)
 
 	/* Free the ring */
 	uk_free(a, vrq->vring_mem);
+	if (vrq->indirect)
+		uk_free(a, vrq->indirect);
 
 	/* Free the virtqueue metadata */
 	uk_free(a, vrq);
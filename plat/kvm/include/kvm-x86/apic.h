@@ -0,0 +1,99 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __KVM_X86_APIC_H__
+#define __KVM_X86_APIC_H__
+
+#include <uk/arch/types.h>
+#include <x86/cpu.h>
+
+#define APIC_MSR_BASE			0x01b
+#define APIC_BASE_EXTD			(1 << 10)
+#define APIC_BASE_EN			(1 << 11)
+
+/* x2APIC registers, accessed as MSRs */
+#define X2APIC_MSR_ID			0x802
+#define X2APIC_MSR_TPR			0x808
+#define X2APIC_MSR_EOI			0x80b
+#define X2APIC_MSR_SVR			0x80f
+#define X2APIC_MSR_LVT_TIMER		0x832
+#define X2APIC_MSR_LVT_LINT0		0x835
+#define X2APIC_MSR_LVT_LINT1		0x836
+
+#define APIC_MSR_TSC_DEADLINE		0x6e0
+
+#define APIC_SVR_ENABLE			(1 << 8)
+#define APIC_LVT_DM_NMI			(4 << 8)
+#define APIC_LVT_DM_EXTINT		(7 << 8)
+#define APIC_LVT_MASKED			(1 << 16)
+#define APIC_LVT_TIMER_TSC_DEADLINE	(2 << 17)
+
+/* Spurious interrupts are not acknowledged. The lower four bits of the
+ * vector are hardwired to 1 on older APICs.
+ */
+#define APIC_SPURIOUS_VECTOR		0xff
+
+/* Address and data of a message-signalled interrupt: fixed delivery to the
+ * local APIC with the given ID, edge triggered
+ */
+#define APIC_MSI_ADDR_BASE		0xfee00000UL
+#define APIC_MSI_ADDR_DEST_SHIFT	12
+
+/*
+ * Switches the local APIC to x2APIC mode. The 8259 PIC stays connected
+ * through LINT0 (virtual wire mode), so device interrupts are unaffected.
+ * Returns -ENOTSUP if the CPU has no x2APIC.
+ */
+int apic_init(void);
+
+/*
+ * Delivers the local APIC timer in TSC-deadline mode on the given vector.
+ * Returns -ENOTSUP without an x2APIC or without TSC-deadline support.
+ */
+int apic_timer_init(__u8 vector);
+
+int apic_timer_enabled(void);
+
+static inline void apic_timer_set_deadline(__u64 tsc)
+{
+	wrmsrl(APIC_MSR_TSC_DEADLINE, tsc);
+}
+
+static inline __u32 apic_id(void)
+{
+	return (__u32)rdmsrl(X2APIC_MSR_ID);
+}
+
+static inline void apic_eoi(void)
+{
+	wrmsrl(X2APIC_MSR_EOI, 0);
+}
+
+#endif /* __KVM_X86_APIC_H__ */
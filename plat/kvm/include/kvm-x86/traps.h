@@ -42,4 +42,4 @@
 #define GDT_DESC_DATA_VAL       0x00cf93000000ffff
 
 
-#define IDT_NUM_ENTRIES         48
+#define IDT_NUM_ENTRIES         256
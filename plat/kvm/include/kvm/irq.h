@@ -34,8 +34,23 @@
 #define __KVM_IRQ_H_
 
 #include <sys/types.h>
+#include <uk/config.h>
+#include <uk/arch/types.h>
 #include <uk/plat/irq.h>
 
 void _ukplat_irq_handle(unsigned long irq);
 
+#ifdef CONFIG_KVM_PCI_MSIX
+/*
+ * Reserves num consecutive IRQs for message-signalled interrupts and
+ * stores the first one in irq. Returns -ENOSPC when not enough are left.
+ */
+int irq_msi_alloc(unsigned int num, unsigned long *irq);
+
+/* Returns the message that raises the given MSI IRQ when written by a
+ * device: data has to be written to addr.
+ */
+void irq_msi_compose(unsigned long irq, __u64 *addr, __u32 *data);
+#endif /* CONFIG_KVM_PCI_MSIX */
+
 #endif /* __KVM_IRQ_H_ */
@@ -33,8 +33,10 @@
 #ifndef __KVM_TSCCLOCK_H__
 #define __KVM_TSCCLOCK_H__
 
-int tscclock_init(void);
+int tscclock_init(__u64 tsc_freq);
 __u64 tscclock_monotonic(void);
 __u64 tscclock_epochoffset(void);
+void tscclock_set_alarm(__u64 until);
+void tscclock_alarm_fired(void);
 
 #endif /* __KVM_TSCCLOCK_H__ */
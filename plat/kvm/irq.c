@@ -37,6 +37,9 @@
 #include <uk/print.h>
 #include <errno.h>
 #include <uk/bitops.h>
+#ifdef CONFIG_KVM_PCI_MSIX
+#include <kvm-x86/apic.h>
+#endif /* CONFIG_KVM_PCI_MSIX */
 
 /* IRQ handlers declarations */
 struct irq_handler {
@@ -81,6 +84,40 @@ int ukplat_irq_register(unsigned long irq, irq_handler_func_t func, void *arg)
 	return 0;
 }
 
+#ifdef CONFIG_KVM_PCI_MSIX
+/* MSI IRQs are handed out once and never given back */
+static unsigned long irq_msi_next = X86_MSI_IRQ_BASE;
+
+int irq_msi_alloc(unsigned int num, unsigned long *irq)
+{
+	unsigned long flags;
+	int rc = 0;
+
+	UK_ASSERT(irq);
+
+	flags = ukplat_lcpu_save_irqf();
+	if (num > __MAX_IRQ - irq_msi_next) {
+		rc = -ENOSPC;
+	} else {
+		*irq = irq_msi_next;
+		irq_msi_next += num;
+	}
+	ukplat_lcpu_restore_irqf(flags);
+	return rc;
+}
+
+void irq_msi_compose(unsigned long irq, __u64 *addr, __u32 *data)
+{
+	UK_ASSERT(irq >= X86_MSI_IRQ_BASE && irq < __MAX_IRQ);
+	UK_ASSERT(addr && data);
+
+	/* Everything is delivered to the boot CPU */
+	*addr = APIC_MSI_ADDR_BASE |
+		((__u64)apic_id() << APIC_MSI_ADDR_DEST_SHIFT);
+	*data = 32 + irq;
+}
+#endif /* CONFIG_KVM_PCI_MSIX */
+
 /*
  * TODO: This is a temporary solution used to identify non TSC clock
  * interrupts in order to stop waiting for interrupts with deadline.
@@ -0,0 +1,96 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Local APIC in x2APIC mode. Its registers are MSRs, so acknowledging an
+ * interrupt is a single wrmsr that KVM handles without going through the
+ * MMIO emulation path, or without an exit at all with APIC virtualization.
+ * The timer runs in TSC-deadline mode: a wakeup is programmed with one MSR
+ * write of an absolute TSC value and has no minimum delay.
+ */
+
+#include <errno.h>
+#include <uk/print.h>
+#include <x86/cpu.h>
+#include <kvm-x86/apic.h>
+
+static int x2apic_enabled;
+static int timer_enabled;
+
+int apic_init(void)
+{
+	__u32 eax, ebx, ecx, edx;
+	__u64 base;
+
+	cpuid(1, 0, &eax, &ebx, &ecx, &edx);
+	if (!(edx & X86_CPUID1_EDX_APIC) || !(ecx & X86_CPUID1_ECX_X2APIC))
+		return -ENOTSUP;
+
+	/* x2APIC mode can only be entered from enabled xAPIC mode */
+	base = rdmsrl(APIC_MSR_BASE);
+	if (!(base & APIC_BASE_EN)) {
+		base |= APIC_BASE_EN;
+		wrmsrl(APIC_MSR_BASE, base);
+	}
+	wrmsrl(APIC_MSR_BASE, base | APIC_BASE_EXTD);
+
+	wrmsrl(X2APIC_MSR_TPR, 0);
+	wrmsrl(X2APIC_MSR_LVT_TIMER, APIC_LVT_MASKED);
+	wrmsrl(X2APIC_MSR_LVT_LINT0, APIC_LVT_DM_EXTINT);
+	wrmsrl(X2APIC_MSR_LVT_LINT1, APIC_LVT_DM_NMI);
+	wrmsrl(X2APIC_MSR_SVR, APIC_SVR_ENABLE | APIC_SPURIOUS_VECTOR);
+
+	x2apic_enabled = 1;
+	uk_pr_info("Local APIC in x2APIC mode\n");
+	return 0;
+}
+
+int apic_timer_init(__u8 vector)
+{
+	__u32 eax, ebx, ecx, edx;
+
+	if (!x2apic_enabled)
+		return -ENOTSUP;
+
+	cpuid(1, 0, &eax, &ebx, &ecx, &edx);
+	if (!(ecx & X86_CPUID1_ECX_TSC_DEADLINE))
+		return -ENOTSUP;
+
+	apic_timer_set_deadline(0);
+	wrmsrl(X2APIC_MSR_LVT_TIMER, APIC_LVT_TIMER_TSC_DEADLINE | vector);
+
+	timer_enabled = 1;
+	return 0;
+}
+
+int apic_timer_enabled(void)
+{
+	return timer_enabled;
+}
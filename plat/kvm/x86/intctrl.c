@@ -24,7 +24,11 @@
 
 #include <stdint.h>
 #include <x86/cpu.h>
+#include <x86/irq.h>
 #include <kvm/intctrl.h>
+#ifdef CONFIG_KVM_APIC
+#include <kvm-x86/apic.h>
+#endif /* CONFIG_KVM_APIC */
 
 #define PIC1             0x20    /* IO base address for master PIC */
 #define PIC2             0xA0    /* IO base address for slave PIC */
@@ -83,6 +87,9 @@ static void PIC_remap(int offset1, int offset2)
 
 void intctrl_init(void)
 {
+#ifdef CONFIG_KVM_APIC
+	apic_init();
+#endif /* CONFIG_KVM_APIC */
 
 #if defined(CONFIG_VIRTIO_MMIO) && defined (__X86_64__)
 	/* FIXME:
@@ -106,6 +113,21 @@ void intctrl_init(void)
 
 void intctrl_ack_irq(unsigned int irq)
 {
+#ifdef CONFIG_KVM_PCI_MSIX
+	if (irq >= X86_MSI_IRQ_BASE) {
+		apic_eoi();
+		return;
+	}
+#endif /* CONFIG_KVM_PCI_MSIX */
+
+#ifdef CONFIG_KVM_APIC
+	/* The timer interrupt comes from the local APIC instead of the PIT */
+	if (irq == 0 && apic_timer_enabled()) {
+		apic_eoi();
+		return;
+	}
+#endif /* CONFIG_KVM_APIC */
+
 	if (!IRQ_ON_MASTER(irq))
 		outb(PIC2_COMMAND, PIC_EOI);
 
@@ -116,6 +138,12 @@ void intctrl_mask_irq(unsigned int irq)
 {
 	__u16 port;
 
+#ifdef CONFIG_KVM_PCI_MSIX
+	/* MSIs are masked in the MSI-X table of the device */
+	if (irq >= X86_MSI_IRQ_BASE)
+		return;
+#endif /* CONFIG_KVM_PCI_MSIX */
+
 	port = IRQ_PORT(irq);
 	outb(port, inb(port) | (1 << IRQ_OFFSET(irq)));
 }
@@ -124,6 +152,16 @@ void intctrl_clear_irq(unsigned int irq)
 {
 	__u16 port;
 
+#ifdef CONFIG_KVM_APIC
+	/* Keep the PIT from delivering on the timer vector */
+	if (irq == 0 && apic_timer_enabled())
+		return;
+#endif /* CONFIG_KVM_APIC */
+#ifdef CONFIG_KVM_PCI_MSIX
+	if (irq >= X86_MSI_IRQ_BASE)
+		return;
+#endif /* CONFIG_KVM_PCI_MSIX */
+
 	port = IRQ_PORT(irq);
 	outb(port, inb(port) & ~(1 << IRQ_OFFSET(irq)));
 }
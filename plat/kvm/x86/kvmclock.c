@@ -0,0 +1,181 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * kvmclock: the host publishes a (tsc_timestamp, system_time) pair and the
+ * scaling factors of the TSC in a page that it keeps up to date. Reading the
+ * clock is a seqlock-style read of that page plus one rdtsc, so it does not
+ * exit to the host, needs no calibration at boot and follows frequency
+ * changes of the host TSC.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <uk/arch/lcpu.h>
+#include <uk/arch/time.h>
+#include <uk/essentials.h>
+#include <uk/plat/io.h>
+#include <uk/print.h>
+#include <x86/cpu.h>
+#include <kvm-x86/kvmclock.h>
+
+#define KVM_CPUID_SIGNATURE		0x40000000
+#define KVM_CPUID_FEATURES		0x40000001
+#define KVM_FEATURE_CLOCKSOURCE2	(1 << 3)
+
+#define MSR_KVM_WALL_CLOCK_NEW		0x4b564d00
+#define MSR_KVM_SYSTEM_TIME_NEW		0x4b564d01
+#define KVM_SYSTEM_TIME_ENABLE		0x1
+
+struct pvclock_vcpu_time_info {
+	__u32 version;
+	__u32 pad0;
+	__u64 tsc_timestamp;
+	__u64 system_time;
+	__u32 tsc_to_system_mul;
+	__s8 tsc_shift;
+	__u8 flags;
+	__u8 pad[2];
+} __packed;
+
+struct pvclock_wall_clock {
+	__u32 version;
+	__u32 sec;
+	__u32 nsec;
+} __packed;
+
+/* The host requires that neither structure crosses a page boundary */
+static volatile struct pvclock_vcpu_time_info kvmclock_ti __align(64);
+static volatile struct pvclock_wall_clock kvmclock_wc __align(16);
+
+/* System time at kvmclock_init() */
+static __u64 kvmclock_base;
+/* Wall time at kvmclock_init() */
+static __u64 kvmclock_epoch;
+
+static inline __u64 pvclock_scale(__u64 delta, __s8 shift, __u32 mul)
+{
+	if (shift < 0)
+		delta >>= -shift;
+	else
+		delta <<= shift;
+	return mul64_32(delta, mul);
+}
+
+/*
+ * The host makes the version odd while it updates the page. rmb() is an
+ * lfence, which also keeps rdtsc from being executed ahead of the version
+ * read.
+ */
+static inline __u64 kvmclock_system_time(void)
+{
+	__u32 version;
+	__u64 t;
+
+	do {
+		version = kvmclock_ti.version;
+		rmb();
+		t = kvmclock_ti.system_time +
+			pvclock_scale(rdtsc() - kvmclock_ti.tsc_timestamp,
+				      kvmclock_ti.tsc_shift,
+				      kvmclock_ti.tsc_to_system_mul);
+		rmb();
+	} while ((version & 1) || version != kvmclock_ti.version);
+
+	return t;
+}
+
+static int is_kvm(void)
+{
+	__u32 reg[4];
+
+	cpuid(KVM_CPUID_SIGNATURE, 0, &reg[0], &reg[1], &reg[2], &reg[3]);
+	return !memcmp(&reg[1], "KVMKVMKVM\0\0\0", 12)
+		&& reg[0] >= KVM_CPUID_FEATURES;
+}
+
+int kvmclock_init(void)
+{
+	__u32 eax, ebx, ecx, edx;
+	__u32 version;
+	__u64 wall;
+
+	if (!is_kvm())
+		return -ENOTSUP;
+	cpuid(KVM_CPUID_FEATURES, 0, &eax, &ebx, &ecx, &edx);
+	if (!(eax & KVM_FEATURE_CLOCKSOURCE2))
+		return -ENOTSUP;
+
+	wrmsrl(MSR_KVM_SYSTEM_TIME_NEW,
+	       ukplat_virt_to_phys(&kvmclock_ti) | KVM_SYSTEM_TIME_ENABLE);
+
+	/* The host fills in the wall time at system time 0 on this write */
+	wrmsrl(MSR_KVM_WALL_CLOCK_NEW, ukplat_virt_to_phys(&kvmclock_wc));
+	do {
+		version = kvmclock_wc.version;
+		rmb();
+		wall = ukarch_time_sec_to_nsec((__u64) kvmclock_wc.sec)
+			+ kvmclock_wc.nsec;
+		rmb();
+	} while ((version & 1) || version != kvmclock_wc.version);
+
+	kvmclock_base = kvmclock_system_time();
+	kvmclock_epoch = wall + kvmclock_base;
+
+	uk_pr_info("Clock source: kvmclock, TSC frequency is %llu Hz\n",
+		   (unsigned long long) kvmclock_tsc_freq());
+	return 0;
+}
+
+__u64 kvmclock_monotonic(void)
+{
+	return kvmclock_system_time() - kvmclock_base;
+}
+
+__u64 kvmclock_epochoffset(void)
+{
+	return kvmclock_epoch;
+}
+
+__u64 kvmclock_tsc_freq(void)
+{
+	__u64 freq;
+	__s8 shift = kvmclock_ti.tsc_shift;
+
+	if (unlikely(!kvmclock_ti.tsc_to_system_mul))
+		return 0;
+
+	freq = (UKARCH_NSEC_PER_SEC << 32) / kvmclock_ti.tsc_to_system_mul;
+	if (shift < 0)
+		freq <<= -shift;
+	else
+		freq >>= shift;
+	return freq;
+}
@@ -27,6 +27,7 @@
  */
 
 #include <string.h>
+#include <errno.h>
 #include <uk/plat/common/sections.h>
 #include <x86/cpu.h>
 #include <x86/traps.h>
@@ -423,6 +424,14 @@ static void _init_paging(struct multiboot_info *mi)
 	res_memory = __STACK_SIZE;			/* boot stack */
 	res_memory += PT_PAGES(frames) << PAGE_SHIFT;	/* page tables */
 
+	/* Leave the requested share of memory to the frame allocator */
+	free_memory = PAGE_ALIGN_DOWN(free_memory / 100 *
+				      CONFIG_PAGING_HEAP_SHARE);
+	if (unlikely(free_memory <= res_memory)) {
+		rc = -ENOMEM;
+		goto EXIT_FATAL;
+	}
+
 	_libkvmplat_cfg.heap.start = PG_HEAP_MAP_START;
 	_libkvmplat_cfg.heap.end = PG_HEAP_MAP_START + free_memory - res_memory;
 	_libkvmplat_cfg.heap.len = _libkvmplat_cfg.heap.end -
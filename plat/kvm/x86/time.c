@@ -41,41 +41,76 @@
 #include <stdlib.h>
 #include <uk/plat/time.h>
 #include <uk/plat/irq.h>
+#include <uk/preempt.h>
 #include <kvm/tscclock.h>
+#ifdef CONFIG_KVM_KVMCLOCK
+#include <kvm-x86/kvmclock.h>
+#endif /* CONFIG_KVM_KVMCLOCK */
 #include <uk/assert.h>
 
+#ifdef CONFIG_KVM_KVMCLOCK
+static int have_kvmclock;
+#endif /* CONFIG_KVM_KVMCLOCK */
+
 /* return ns since time_init() */
 __nsec ukplat_monotonic_clock(void)
 {
+#ifdef CONFIG_KVM_KVMCLOCK
+	if (likely(have_kvmclock))
+		return kvmclock_monotonic();
+#endif /* CONFIG_KVM_KVMCLOCK */
 	return tscclock_monotonic();
 }
 
 /* return wall time in nsecs */
 __nsec ukplat_wall_clock(void)
 {
+#ifdef CONFIG_KVM_KVMCLOCK
+	if (likely(have_kvmclock))
+		return kvmclock_monotonic() + kvmclock_epochoffset();
+#endif /* CONFIG_KVM_KVMCLOCK */
 	return tscclock_monotonic() + tscclock_epochoffset();
 }
 
-/* NB: If this ever does more than an immediate return, it will need to be
- * compiled with NO_X86_EXTREGS_FLAGS to prevent potential clobbering of
- * registers that are not saved on interrupt handling.
+/* NB: Interrupt handling does not save the extended registers. This file
+ * and tscclock.c are therefore compiled with the ISR flags, which keep the
+ * compiler from using them.
  */
 static int timer_handler(void *arg __unused)
 {
+	tscclock_alarm_fired();
+	uk_preempt_tick(ukplat_monotonic_clock());
+
 	/* Yes, we handled the irq. */
 	return 1;
 }
 
+void ukplat_time_set_alarm(__nsec until)
+{
+	tscclock_set_alarm(until);
+}
+
 /* must be called before interrupts are enabled */
 void ukplat_time_init(void)
 {
+	__u64 tsc_freq = 0;
 	int rc;
 
 	rc = ukplat_irq_register(0, timer_handler, NULL);
 	if (rc < 0)
 		UK_CRASH("Failed to register timer interrupt handler\n");
 
-	rc = tscclock_init();
+	/*
+	 * The TSC clock still drives the wakeup timer. With kvmclock it takes
+	 * the TSC frequency from there and skips the calibration.
+	 */
+#ifdef CONFIG_KVM_KVMCLOCK
+	have_kvmclock = (kvmclock_init() == 0);
+	if (have_kvmclock)
+		tsc_freq = kvmclock_tsc_freq();
+#endif /* CONFIG_KVM_KVMCLOCK */
+
+	rc = tscclock_init(tsc_freq);
 	if (rc < 0)
 		UK_CRASH("Failed to initialize TSCCLOCK\n");
 }
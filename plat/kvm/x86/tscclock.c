@@ -59,6 +59,10 @@
 #include <uk/print.h>
 #include <uk/assert.h>
 #include <uk/bitops.h>
+#ifdef CONFIG_KVM_APIC
+#include <kvm/intctrl.h>
+#include <kvm-x86/apic.h>
+#endif /* CONFIG_KVM_APIC */
 
 #define TIMER_CNTR           0x40
 #define TIMER_MODE           0x43
@@ -116,6 +120,23 @@ static __u32 tsc_mult;
 static const __u32 pit_mult =
 	(1ULL << 63) / ((UKARCH_NSEC_PER_SEC << 31) / TIMER_HZ);
 
+/* Alarm that is further away than the PIT can count, 0 if none */
+static __u64 pit_alarm;
+
+#ifdef CONFIG_KVM_APIC
+/* Wakeups are programmed as TSC deadlines on the local APIC timer */
+static int tsc_deadline;
+
+/* Multiplier for converting nsecs to TSC ticks. (32.32) fixed point. */
+static __u64 tsc_deadline_mult;
+
+static inline __u64 tsc_deadline_ticks(__u64 ns)
+{
+	return ns * (tsc_deadline_mult >> 32)
+		+ mul64_32(ns, (__u32) tsc_deadline_mult);
+}
+#endif /* CONFIG_KVM_APIC */
+
 
 /*
  * Read the current i8254 channel 0 tick count.
@@ -212,11 +233,12 @@ __u64 tscclock_monotonic(void)
 }
 
 /*
- * Calibrate TSC and initialise TSC clock.
+ * Calibrate TSC and initialise TSC clock. Calibration is skipped if the
+ * TSC frequency is already known (tsc_freq != 0).
  */
-int tscclock_init(void)
+int tscclock_init(__u64 tsc_freq)
 {
-	__u64 tsc_freq = 0, rtc_boot;
+	__u64 rtc_boot;
 	__u32 eax, ebx, ecx, edx;
 
 	/* Initialise i8254 timer channel 0 to mode 2 at CONFIG_HZ frequency */
@@ -236,12 +258,16 @@ int tscclock_init(void)
 	 * frequency in kHz, or 0 if the feature is not supported by the
 	 * hypervisor.
 	 */
-	cpuid(0x40000000, 0, &eax, &ebx, &ecx, &edx);
-	if (eax >= 0x40000010) {
-		uk_pr_info("Retrieving TSC clock frequency from hypervisor\n");
+	if (tsc_freq) {
 		tsc_base = rdtsc();
-		cpuid(0x40000010, 0, &eax, &ebx, &ecx, &edx);
-		tsc_freq = eax * 1000;
+	} else {
+		cpuid(0x40000000, 0, &eax, &ebx, &ecx, &edx);
+		if (eax >= 0x40000010) {
+			uk_pr_info("Retrieving TSC clock frequency from hypervisor\n");
+			tsc_base = rdtsc();
+			cpuid(0x40000010, 0, &eax, &ebx, &ecx, &edx);
+			tsc_freq = eax * 1000;
+		}
 	}
 
 	/*
@@ -291,6 +317,22 @@ int tscclock_init(void)
 	 */
 	outb(TIMER_MODE, TIMER_SEL0 | TIMER_ONESHOT | TIMER_16BIT);
 
+#ifdef CONFIG_KVM_APIC
+	/*
+	 * Prefer the local APIC timer in TSC-deadline mode. It raises the
+	 * same vector as the PIT, which is masked on the PIC from now on.
+	 */
+	if (apic_timer_init(32) == 0) {
+		intctrl_mask_irq(0);
+		tsc_deadline_mult =
+			((tsc_freq / UKARCH_NSEC_PER_SEC) << 32)
+			+ ((tsc_freq % UKARCH_NSEC_PER_SEC) << 32)
+			  / UKARCH_NSEC_PER_SEC;
+		tsc_deadline = 1;
+		uk_pr_info("Clock event: local APIC TSC-deadline timer\n");
+	}
+#endif /* CONFIG_KVM_APIC */
+
 	return 0;
 }
 
@@ -302,6 +344,30 @@ __u64 tscclock_epochoffset(void)
 	return rtc_epochoffset;
 }
 
+/*
+ * Program the PIT to interrupt the CPU after delta_ticks. Maximum timer delay
+ * is 65535 ticks.
+ */
+static void i8254_oneshot(__u64 delta_ticks)
+{
+	unsigned int ticks;
+
+	if (delta_ticks > 65535)
+		ticks = 65535;
+	else if (delta_ticks < 2)
+		ticks = 2;
+	else
+		ticks = delta_ticks;
+
+	/*
+	 * Note that according to the Intel 82C54 datasheet, p12 the
+	 * interrupt is actually delivered in N + 1 ticks.
+	 */
+	ticks -= 1;
+	outb(TIMER_CNTR, ticks & 0xff);
+	outb(TIMER_CNTR, ticks >> 8);
+}
+
 /*
  * Minimum delta to sleep using PIT. Programming seems to have an overhead of
  * 3-4us, but play it safe here.
@@ -323,12 +389,27 @@ static void tscclock_cpu_block(__u64 until)
 {
 	__u64 now, delta_ns;
 	__u64 delta_ticks;
-	unsigned int ticks;
 
 	UK_ASSERT(ukplat_lcpu_irqs_disabled());
 
 	now = ukplat_monotonic_clock();
 
+#ifdef CONFIG_KVM_APIC
+	/*
+	 * A deadline that already passed fires right away, so there is no
+	 * minimum delay to care about. A deadline that is left armed after
+	 * another interrupt woke us up is overwritten by the next call.
+	 */
+	if (tsc_deadline) {
+		if (until <= now)
+			return;
+		apic_timer_set_deadline(rdtsc() +
+					tsc_deadline_ticks(until - now));
+		ukplat_lcpu_halt_irq();
+		return;
+	}
+#endif /* CONFIG_KVM_APIC */
+
 	/*
 	 * Compute delta in PIT ticks. Return if it is less than minimum safe
 	 * amount of ticks.  Essentially this will cause us to spin until
@@ -348,22 +429,9 @@ static void tscclock_cpu_block(__u64 until)
 		return;
 	}
 
-	/*
-	 * Program the timer to interrupt the CPU after the delay has expired.
-	 * Maximum timer delay is 65535 ticks.
-	 */
-	if (delta_ticks > 65535)
-		ticks = 65535;
-	else
-		ticks = delta_ticks;
-
-	/*
-	 * Note that according to the Intel 82C54 datasheet, p12 the
-	 * interrupt is actually delivered in N + 1 ticks.
-	 */
-	ticks -= 1;
-	outb(TIMER_CNTR, ticks & 0xff);
-	outb(TIMER_CNTR, ticks >> 8);
+	/* Program the timer to interrupt the CPU after the delay has expired */
+	pit_alarm = 0;
+	i8254_oneshot(delta_ticks);
 
 	/*
 	 * Wait for any interrupt. If we got an interrupt then just
@@ -378,6 +446,37 @@ static void tscclock_cpu_block(__u64 until)
 	ukplat_lcpu_halt_irq();
 }
 
+/*
+ * Arms the timer interrupt for `until` without halting the CPU. An alarm
+ * beyond the range of the PIT is approached in steps, see
+ * tscclock_alarm_fired().
+ */
+void tscclock_set_alarm(__u64 until)
+{
+	__u64 now, delta_ticks;
+
+	now = ukplat_monotonic_clock();
+
+#ifdef CONFIG_KVM_APIC
+	if (tsc_deadline) {
+		apic_timer_set_deadline(rdtsc() + ((until > now)
+				? tsc_deadline_ticks(until - now) : 0));
+		return;
+	}
+#endif /* CONFIG_KVM_APIC */
+
+	delta_ticks = (until > now) ? mul64_32(until - now, pit_mult) : 0;
+	pit_alarm = (delta_ticks > 65535) ? until : 0;
+	i8254_oneshot(delta_ticks);
+}
+
+/* Called on the timer interrupt */
+void tscclock_alarm_fired(void)
+{
+	if (pit_alarm)
+		tscclock_set_alarm(pit_alarm);
+}
+
 unsigned long sched_have_pending_events;
 
 void time_block_until(__snsec until)
@@ -0,0 +1,150 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Definitions of the io_uring interface of the Linux kernel (see
+ * include/uapi/linux/io_uring.h) that are needed to drive a ring with
+ * plain system calls.
+ */
+#ifndef __LINUXU_IO_URING_H__
+#define __LINUXU_IO_URING_H__
+
+#include <uk/arch/types.h>
+#include <linuxu/syscall.h>
+
+struct k_io_sqring_offsets {
+	__u32 head;
+	__u32 tail;
+	__u32 ring_mask;
+	__u32 ring_entries;
+	__u32 flags;
+	__u32 dropped;
+	__u32 array;
+	__u32 resv1;
+	__u64 resv2;
+};
+
+struct k_io_cqring_offsets {
+	__u32 head;
+	__u32 tail;
+	__u32 ring_mask;
+	__u32 ring_entries;
+	__u32 overflow;
+	__u32 cqes;
+	__u32 flags;
+	__u32 resv1;
+	__u64 resv2;
+};
+
+struct k_io_uring_params {
+	__u32 sq_entries;
+	__u32 cq_entries;
+	__u32 flags;
+	__u32 sq_thread_cpu;
+	__u32 sq_thread_idle;
+	__u32 features;
+	__u32 wq_fd;
+	__u32 resv[3];
+	struct k_io_sqring_offsets sq_off;
+	struct k_io_cqring_offsets cq_off;
+};
+
+/* Submission queue entry */
+struct k_io_uring_sqe {
+	__u8 opcode;
+	__u8 flags;
+	__u16 ioprio;
+	__s32 fd;
+	__u64 off;
+	__u64 addr;
+	__u32 len;
+	__u32 op_flags;
+	__u64 user_data;
+	__u16 buf_index;
+	__u16 personality;
+	__s32 splice_fd_in;
+	__u64 __pad2[2];
+};
+
+/* Completion queue entry */
+struct k_io_uring_cqe {
+	__u64 user_data;
+	__s32 res;
+	__u32 flags;
+};
+
+/* sqe->opcode */
+#define K_IORING_OP_NOP		0
+#define K_IORING_OP_READV	1
+#define K_IORING_OP_WRITEV	2
+#define K_IORING_OP_FSYNC	3
+
+/* sqe->flags */
+#define K_IOSQE_IO_LINK		(1U << 2)
+#define K_IOSQE_IO_HARDLINK	(1U << 3)
+
+/* params->features */
+#define K_IORING_FEAT_SINGLE_MMAP	(1U << 0)
+
+/* Offsets for mmap() on the ring file descriptor */
+#define K_IORING_OFF_SQ_RING	0x0UL
+#define K_IORING_OFF_SQES	0x10000000UL
+
+/* io_uring_enter() flags */
+#define K_IORING_ENTER_GETEVENTS	(1U << 0)
+
+#if defined __ARM_32__
+/* mmap2() takes the offset in pages */
+#define K_IORING_MMAP_OFF(off)	((off) >> 12)
+#else
+#define K_IORING_MMAP_OFF(off)	(off)
+#endif
+
+static inline int sys_io_uring_setup(__u32 entries,
+				     struct k_io_uring_params *p)
+{
+	return (int) syscall2(__SC_IO_URING_SETUP,
+			      (long) (entries),
+			      (long) (p));
+}
+
+static inline int sys_io_uring_enter(int fd, __u32 to_submit,
+				     __u32 min_complete, __u32 flags)
+{
+	return (int) syscall6(__SC_IO_URING_ENTER,
+			      (long) (fd),
+			      (long) (to_submit),
+			      (long) (min_complete),
+			      (long) (flags),
+			      (long) (NULL),
+			      (long) (0));
+}
+
+#endif /* __LINUXU_IO_URING_H__ */
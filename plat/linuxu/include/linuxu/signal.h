@@ -41,6 +41,7 @@
 #define __SIGNAL_H__
 
 /* Signal numbers */
+#define SIGUSR1       10
 #define SIGALRM       14
 
 /* type definitions */
@@ -38,6 +38,8 @@
 
 #define __SC_READ       3
 #define __SC_WRITE      4
+#define __SC_READV     145
+#define __SC_WRITEV    146
 #define __SC_OPENAT     322
 #define __SC_CLOSE      6
 #define __SC_MMAP     192 /* use mmap2() since mmap() is obsolete */
@@ -57,6 +59,11 @@
 #define __SC_CLOCK_GETTIME    263
 #define __SC_SOCKET           281
 #define __SC_PSELECT6 335
+#define __SC_LSEEK            19
+#define __SC_GETPID           20
+#define __SC_PIPE2            359
+#define __SC_IO_URING_SETUP   425
+#define __SC_IO_URING_ENTER   426
 
 #ifndef O_TMPFILE
 #define O_TMPFILE 020040000
@@ -40,6 +40,8 @@
 
 #define __SC_READ       63
 #define __SC_WRITE      64
+#define __SC_READV      65
+#define __SC_WRITEV     66
 #define __SC_OPENAT     56 /* changed to openat because open is not on arm64 */
 #define __SC_CLOSE      57
 #define __SC_MMAP      222 /* use mmap2() since mmap() is obsolete */
@@ -59,6 +61,11 @@
 #define __SC_CLOCK_GETTIME    113
 #define __SC_SOCKET           198
 #define __SC_PSELECT6         72
+#define __SC_LSEEK            62
+#define __SC_GETPID           172
+#define __SC_PIPE2            59
+#define __SC_IO_URING_SETUP   425
+#define __SC_IO_URING_ENTER   426
 
 #ifndef O_TMPFILE
 #define O_TMPFILE 020040000
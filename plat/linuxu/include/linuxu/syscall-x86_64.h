@@ -38,6 +38,8 @@
 
 #define __SC_READ    0
 #define __SC_WRITE   1
+#define __SC_READV   19
+#define __SC_WRITEV  20
 #define __SC_OPENAT  257
 #define __SC_CLOSE   3
 #define __SC_FSTAT   5
@@ -57,6 +59,11 @@
 #define __SC_TIMER_DELETE     226
 #define __SC_CLOCK_GETTIME    228
 #define __SC_PSELECT6 270
+#define __SC_LSEEK            8
+#define __SC_GETPID           39
+#define __SC_PIPE2            293
+#define __SC_IO_URING_SETUP   425
+#define __SC_IO_URING_ENTER   426
 
 
 #ifndef O_TMPFILE
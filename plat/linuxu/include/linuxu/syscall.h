@@ -39,6 +39,7 @@
 #include <linuxu/stat.h>
 #include <linuxu/mode.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <linuxu/signal.h>
 
 #if defined __X86_64__
@@ -73,6 +74,22 @@ static inline ssize_t sys_write(int fd, const char *buf, size_t len)
 				  (long) (len));
 }
 
+static inline ssize_t sys_readv(int fd, const struct iovec *iov, int iovcnt)
+{
+	return (ssize_t) syscall3(__SC_READV,
+				  (long) (fd),
+				  (long) (iov),
+				  (long) (iovcnt));
+}
+
+static inline ssize_t sys_writev(int fd, const struct iovec *iov, int iovcnt)
+{
+	return (ssize_t) syscall3(__SC_WRITEV,
+				  (long) (fd),
+				  (long) (iov),
+				  (long) (iovcnt));
+}
+
 struct stat;
 static inline int sys_fstat(int fd, struct k_stat *statbuf)
 {
@@ -113,6 +130,26 @@ static inline int sys_fstat(int fd, struct k_stat *statbuf)
 #define F_SETFD  2
 #endif
 
+#ifndef F_GETFL
+#define F_GETFL  3
+#endif
+
+#ifndef F_SETFL
+#define F_SETFL  4
+#endif
+
+#ifndef F_SETOWN
+#define F_SETOWN 8
+#endif
+
+#ifndef F_SETSIG
+#define F_SETSIG 10
+#endif
+
+#ifndef O_ASYNC
+#define O_ASYNC  020000
+#endif
+
 #ifndef AT_FDCWD
 #define AT_FDCWD (-100)
 #endif
@@ -138,6 +175,38 @@ static inline int sys_open(const char *pathname, int flags, ...)
 	return fd;
 }
 
+static inline int sys_fcntl(int fd, int cmd, long arg)
+{
+	return (int) syscall3(__SC_FCNTL,
+			      (long) (fd),
+			      (long) (cmd),
+			      (long) (arg));
+}
+
+static inline int sys_pipe2(int fds[2], int flags)
+{
+	return (int) syscall2(__SC_PIPE2,
+			      (long) (fds),
+			      (long) (flags));
+}
+
+#ifndef SEEK_END
+#define SEEK_END 2
+#endif
+
+static inline off_t sys_lseek(int fd, off_t offset, int whence)
+{
+	return (off_t) syscall3(__SC_LSEEK,
+				(long) (fd),
+				(long) (offset),
+				(long) (whence));
+}
+
+static inline int sys_getpid(void)
+{
+	return (int) syscall0(__SC_GETPID);
+}
+
 #ifndef SOCK_STREAM
 #define SOCK_STREAM    1
 #endif /* SOCK_STREAM */
@@ -198,6 +267,13 @@ static inline void *sys_mmap(void *addr, size_t len, int prot, int flags,
 				 (long) (offset));
 }
 
+static inline int sys_munmap(void *addr, size_t len)
+{
+	return (int) syscall2(__SC_MUNMAP,
+			      (long) (addr),
+			      (long) (len));
+}
+
 #define sys_mapmem(addr, len)				  \
 	sys_mmap((addr), (len), (PROT_READ | PROT_WRITE), \
 		 (MAP_SHARED | MAP_ANONYMOUS), -1, 0)
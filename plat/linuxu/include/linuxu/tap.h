@@ -117,6 +117,7 @@ struct uk_ifreq {
 #define ifr_newname uk_ifr_ifru.ifru_newname
 
 #define UK_TUNSETIFF     (0x400454ca)
+#define UK_TUNSETOFFLOAD (0x400454d0)
 #define UK_SIOCGIFNAME   (0x8910)
 #define UK_SIOCGIFFLAGS  (0x8913)
 #define UK_SIOCSIFFLAGS  (0x8914)
@@ -146,6 +147,35 @@ struct uk_ifreq {
 #define UK_IFF_UP	(0x1)
 #define UK_IFF_PROMISC	(0x100)
 
+/* TUNSETOFFLOAD flags */
+#define UK_TUN_F_CSUM    (0x01)
+#define UK_TUN_F_TSO4    (0x02)
+#define UK_TUN_F_TSO6    (0x04)
+#define UK_TUN_F_TSO_ECN (0x08)
+#define UK_TUN_F_UFO     (0x10)
+
+/**
+ * Header that precedes every packet on a tap device that is opened with
+ * UK_IFF_VNET_HDR (struct virtio_net_hdr, in host byte order)
+ */
+struct uk_tap_vnet_hdr {
+	__u8 flags;
+	__u8 gso_type;
+	__u16 hdr_len;
+	__u16 gso_size;
+	__u16 csum_start;
+	__u16 csum_offset;
+};
+
+#define UK_TAP_VNET_HDR_F_NEEDS_CSUM	(0x01)
+#define UK_TAP_VNET_HDR_F_DATA_VALID	(0x02)
+
+#define UK_TAP_VNET_HDR_GSO_NONE	(0x00)
+#define UK_TAP_VNET_HDR_GSO_TCPV4	(0x01)
+#define UK_TAP_VNET_HDR_GSO_UDP		(0x03)
+#define UK_TAP_VNET_HDR_GSO_TCPV6	(0x04)
+#define UK_TAP_VNET_HDR_GSO_ECN		(0x80)
+
 /* Adding the bridge interface */
 #define UK_SIOCBRADDIF (0x89a2)
 
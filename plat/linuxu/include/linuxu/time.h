@@ -45,6 +45,8 @@
 #define K_CLOCK_REALTIME       0
 #define K_CLOCK_MONOTONIC      1
 
+#define K_TIMER_ABSTIME        1
+
 typedef int k_clockid_t;
 
 typedef int k_timer_t;
@@ -148,11 +148,17 @@ asm("__restorer:mov x8, #0x8b\nsvc #0");
 
 static void _irq_handle(int irq)
 {
+	unsigned long flags = irq_enabled;
 	struct irq_handler *h;
 	int i;
 
 	UK_ASSERT(irq >= 0 && irq < __MAX_IRQ);
 
+	/* Handlers run with IRQs disabled as on the other platforms. This also
+	 * keeps a preemptive scheduler from switching threads within them.
+	 */
+	irq_enabled = 0;
+
 	for (i = 0; i < CONFIG_LINUXU_MAX_IRQ_HANDLER_ENTRIES; i++) {
 		if (irq_handlers[irq][i].func == NULL)
 			break;
@@ -160,7 +166,7 @@ static void _irq_handle(int irq)
 			continue; /* reserved entry */
 		h = &irq_handlers[irq][i];
 		if (h->func(h->arg) == 1)
-			return;
+			goto out;
 	}
 	/*
 	 * Just warn about unhandled interrupts. We do this to
@@ -169,6 +175,9 @@ static void _irq_handle(int irq)
 	 * one interrupt line that would then stay disabled.
 	 */
 	uk_pr_crit("Unhandled irq=%d\n", irq);
+
+out:
+	irq_enabled = flags;
 }
 
 int ukplat_irq_register(unsigned long irq, irq_handler_func_t func, void *arg)
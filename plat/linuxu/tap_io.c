@@ -60,6 +60,19 @@ int tap_dev_configure(int fd, __u32 feature_flags, void *arg)
 	return rc;
 }
 
+int tap_dev_offload_set(int fd, __u32 offloads)
+{
+	int rc;
+
+	/* The offload flags are passed by value */
+	rc = sys_ioctl(fd, UK_TUNSETOFFLOAD, (unsigned long) offloads);
+	if (rc < 0)
+		uk_pr_err("Failed(%d) to set the offloads of the tap device\n",
+			  rc);
+
+	return rc;
+}
+
 int tap_netif_configure(int fd, __u32 request, void *arg)
 {
 	int rc;
@@ -154,6 +167,39 @@ ssize_t tap_write(int fd, const void *buf, size_t count)
 	return (ssize_t)written;
 }
 
+ssize_t tap_readv(int fd, const struct iovec *iov, int iovcnt)
+{
+	ssize_t rc = -EINTR;
+
+	while (rc == -EINTR)
+		rc = sys_readv(fd, iov, iovcnt);
+
+	if (rc == -11)
+		/* Explicitly added since linux errno has -11 for EAGAIN */
+		rc = -EWOULDBLOCK;
+	else if (rc < 0)
+		uk_pr_err("Failed(%ld) to read from the tap device\n", rc);
+
+	return rc;
+}
+
+ssize_t tap_writev(int fd, const struct iovec *iov, int iovcnt)
+{
+	ssize_t rc = -EINTR;
+
+	/* The tap device consumes a frame in full or not at all */
+	while (rc == -EINTR)
+		rc = sys_writev(fd, iov, iovcnt);
+
+	if (rc == -11)
+		/* Explicitly added since linux errno has -11 for EAGAIN */
+		rc = -EAGAIN;
+	else if (rc < 0)
+		uk_pr_err("Failed(%ld) to write to the tap device\n", rc);
+
+	return rc;
+}
+
 int tap_close(int fd)
 {
 	return sys_close(fd);
@@ -35,10 +35,14 @@
 #include <uk/plat/time.h>
 #include <uk/plat/irq.h>
 #include <uk/assert.h>
+#include <uk/print.h>
+#include <uk/preempt.h>
 #include <linuxu/syscall.h>
 #include <linuxu/time.h>
 
 static k_timer_t timerid;
+/* One-shot timer for ukplat_time_set_alarm(), raises the same signal */
+static k_timer_t alarmid;
 
 
 __nsec ukplat_monotonic_clock(void)
@@ -75,10 +79,12 @@ __nsec ukplat_wall_clock(void)
 
 static int timer_handler(void *arg __unused)
 {
-	/* We only use the timer interrupt to wake up. As we end up here, the
-	 * timer interrupt has already done its job and we can acknowledge
+	/* We only use the timer interrupt to wake up and to tell a preemptive
+	 * scheduler that its deadline passed. As we end up here, the timer
+	 * interrupt has already done its job and we can acknowledge
 	 * receiving it.
 	 */
+	uk_preempt_tick(ukplat_monotonic_clock());
 	return 1;
 }
 
@@ -108,9 +114,35 @@ void ukplat_time_init(void)
 	rc = sys_timer_settime(timerid, 0, &its, NULL);
 	if (unlikely(rc != 0))
 		UK_CRASH("Failed to setup timer: %d\n", rc);
+
+	/* Alarms are absolute times of ukplat_monotonic_clock() */
+	sigev.sigev_value.sival_ptr = &alarmid;
+	rc = sys_timer_create(K_CLOCK_MONOTONIC, &sigev, &alarmid);
+	if (unlikely(rc != 0))
+		UK_CRASH("Failed to create alarm timer: %d\n", rc);
+}
+
+void ukplat_time_set_alarm(__nsec until)
+{
+	struct k_itimerspec its;
+	int rc;
+
+	/* An expiration of zero would disarm the timer */
+	if (until == 0)
+		until = 1;
+
+	its.it_value.tv_sec  = until / ukarch_time_sec_to_nsec(1);
+	its.it_value.tv_nsec = until % ukarch_time_sec_to_nsec(1);
+	its.it_interval.tv_sec  = 0;
+	its.it_interval.tv_nsec = 0;
+
+	rc = sys_timer_settime(alarmid, K_TIMER_ABSTIME, &its, NULL);
+	if (unlikely(rc != 0))
+		uk_pr_warn("Failed to set alarm: %d\n", rc);
 }
 
 void ukplat_time_fini(void)
 {
+	sys_timer_delete(alarmid);
 	sys_timer_delete(timerid);
 }
@@ -117,36 +117,28 @@ static int network_tx_buf_gc(struct uk_netdev_tx_queue *txq)
 	return count;
 }
 
-static int netfront_xmit(struct uk_netdev *n,
+/* Put a packet on the transmit ring without pushing it to the backend.
+ * Returns 0 on success, -ENOSPC if the ring is full.
+ */
+static int netfront_xmit_add(struct netfront_dev *nfdev,
 		struct uk_netdev_tx_queue *txq,
 		struct uk_netbuf *pkt)
 {
-	struct netfront_dev *nfdev;
-	unsigned long flags;
 	uint16_t id;
 	RING_IDX req_prod;
 	netif_tx_request_t *tx_req;
-	bool more_to_do;
-	int notify;
-	int status;
 
-	UK_ASSERT(n != NULL);
-	UK_ASSERT(txq != NULL);
 	UK_ASSERT(pkt != NULL);
 	UK_ASSERT(pkt->len < PAGE_SIZE);
 	UK_ASSERT(!pkt->next); /* TODO: Support for netbuf chains missing */
 	UK_ASSERT(((unsigned long) pkt->buf & ~PAGE_MASK) == 0);
 
-	nfdev = to_netfront_dev(n);
-
-	local_irq_save(flags);
 	if (unlikely(RING_FULL(&txq->ring))) {
 		/* try some cleanup */
 		network_tx_buf_gc(txq);
 		if (unlikely(RING_FULL(&txq->ring))) {
 			uk_pr_debug("tx queue is full\n");
-			local_irq_restore(flags);
-			return 0x0;
+			return -ENOSPC;
 		}
 	}
 
@@ -182,28 +174,86 @@ static int netfront_xmit(struct uk_netdev *n,
 	tx_req->flags |= (pkt->flags & UK_NETBUF_F_DATA_VALID)
 			 ? NETTXF_data_validated : 0x0;
 	tx_req->id = id;
-	status = UK_NETDEV_STATUS_SUCCESS;
 
 	txq->ring.req_prod_pvt = req_prod + 1;
+	return 0;
+}
+
+/* Push queued requests to the backend and reclaim finished ones */
+static int netfront_xmit_push(struct uk_netdev_tx_queue *txq)
+{
+	bool more_to_do;
+	int notify;
+
 	wmb(); /* Ensure backend sees requests */
 
 	RING_PUSH_REQUESTS_AND_CHECK_NOTIFY(&txq->ring, notify);
 	if (notify)
 		notify_remote_via_evtchn(txq->evtchn);
 
-
 	/* some cleanup */
 	do {
 		network_tx_buf_gc(txq);
 		RING_FINAL_CHECK_FOR_RESPONSES(&txq->ring, more_to_do);
 	} while (more_to_do);
 
-	status |= (RING_FULL(&txq->ring)) ? 0x0 : UK_NETDEV_STATUS_MORE;
+	return (RING_FULL(&txq->ring)) ? 0x0 : UK_NETDEV_STATUS_MORE;
+}
+
+static int netfront_xmit(struct uk_netdev *n,
+		struct uk_netdev_tx_queue *txq,
+		struct uk_netbuf *pkt)
+{
+	unsigned long flags;
+	int status;
+
+	UK_ASSERT(n != NULL);
+	UK_ASSERT(txq != NULL);
+	UK_ASSERT(pkt != NULL);
+
+	local_irq_save(flags);
+	if (unlikely(netfront_xmit_add(to_netfront_dev(n), txq, pkt) < 0)) {
+		local_irq_restore(flags);
+		return 0x0;
+	}
+	status = UK_NETDEV_STATUS_SUCCESS;
+	status |= netfront_xmit_push(txq);
 	local_irq_restore(flags);
 
 	return status;
 }
 
+static int netfront_xmit_burst(struct uk_netdev *n,
+		struct uk_netdev_tx_queue *txq,
+		struct uk_netbuf **pkts, uint16_t *cnt)
+{
+	struct netfront_dev *nfdev;
+	unsigned long flags;
+	int status = 0x0;
+	uint16_t i;
+
+	UK_ASSERT(n != NULL);
+	UK_ASSERT(txq != NULL);
+	UK_ASSERT(pkts != NULL && cnt != NULL);
+
+	nfdev = to_netfront_dev(n);
+
+	local_irq_save(flags);
+	for (i = 0; i < *cnt; i++) {
+		if (netfront_xmit_add(nfdev, txq, pkts[i]) < 0)
+			break;
+	}
+	/* One push and at most one notification for the whole burst */
+	if (i > 0) {
+		status = UK_NETDEV_STATUS_SUCCESS;
+		status |= netfront_xmit_push(txq);
+	}
+	local_irq_restore(flags);
+
+	*cnt = i;
+	return status;
+}
+
 static int netfront_rxq_enqueue(struct uk_netdev_rx_queue *rxq,
 		struct uk_netbuf *netbuf)
 {
@@ -211,7 +261,6 @@ static int netfront_rxq_enqueue(struct uk_netdev_rx_queue *rxq,
 	uint16_t id;
 	netif_rx_request_t *rx_req;
 	struct netfront_dev *nfdev;
-	int notify;
 
 	/* buffer must be page aligned */
 	UK_ASSERT(((unsigned long) netbuf->buf & ~PAGE_MASK) == 0);
@@ -246,13 +295,8 @@ static int netfront_rxq_enqueue(struct uk_netdev_rx_queue *rxq,
 	UK_ASSERT(rxq->gref[id] != GRANT_INVALID_REF);
 
 	rx_req->gref = rxq->gref[id];
-	wmb(); /* Ensure backend sees requests */
 	rxq->ring.req_prod_pvt = req_prod + 1;
 
-	RING_PUSH_REQUESTS_AND_CHECK_NOTIFY(&rxq->ring, notify);
-	if (notify)
-		notify_remote_via_evtchn(rxq->evtchn);
-
 	return 0;
 }
 
@@ -322,6 +366,7 @@ static int netfront_rx_fillup(struct uk_netdev_rx_queue *rxq, uint16_t nb_desc)
 	struct uk_netbuf *netbuf[nb_desc];
 	int rc, status = 0;
 	uint16_t cnt;
+	int notify;
 
 	cnt = rxq->alloc_rxpkts(rxq->alloc_rxpkts_argp, netbuf, nb_desc);
 
@@ -348,6 +393,12 @@ static int netfront_rx_fillup(struct uk_netdev_rx_queue *rxq, uint16_t nb_desc)
 		status |= UK_NETDEV_STATUS_UNDERRUN;
 
 out:
+	/* Push all new requests with a single notification */
+	wmb(); /* Ensure backend sees requests */
+	RING_PUSH_REQUESTS_AND_CHECK_NOTIFY(&rxq->ring, notify);
+	if (notify)
+		notify_remote_via_evtchn(rxq->evtchn);
+
 	return status;
 }
 
@@ -425,6 +476,55 @@ static int netfront_recv(struct uk_netdev *n __unused,
 	return status;
 }
 
+static int netfront_recv_burst(struct uk_netdev *n __unused,
+		struct uk_netdev_rx_queue *rxq,
+		struct uk_netbuf **pkts, uint16_t *cnt)
+{
+	int status = 0;
+	int more = 0;
+	uint16_t i = 0;
+
+	UK_ASSERT(n != NULL);
+	UK_ASSERT(rxq != NULL);
+	UK_ASSERT(pkts != NULL && cnt != NULL);
+
+	/* Queue interrupts have to be off when calling receive */
+	UK_ASSERT(!(rxq->intr_enabled & NETFRONT_INTR_EN));
+
+	while (i < *cnt && netfront_rxq_dequeue(rxq, &pkts[i]) > 0)
+		i++;
+
+	/* Refill all consumed slots with a single push */
+	status |= netfront_rx_fillup(rxq, i);
+
+	if (i == *cnt) {
+		/* The burst was cut by the caller, keep interrupts off */
+		RING_FINAL_CHECK_FOR_RESPONSES(&rxq->ring, more);
+	} else if (rxq->intr_enabled & NETFRONT_INTR_USR_EN_MASK) {
+		/* The queue is drained, enable interrupts again */
+		if (netfront_rxq_intr_enable(rxq) == 1) {
+			/**
+			 * Packets arrived after reading the queue and before
+			 * enabling the interrupt
+			 */
+			uint16_t start = i;
+
+			while (i < *cnt
+			       && netfront_rxq_dequeue(rxq, &pkts[i]) > 0)
+				i++;
+			status |= netfront_rx_fillup(rxq, i - start);
+			more = (netfront_rxq_intr_enable(rxq) == 1);
+		}
+	}
+
+	if (i > 0) {
+		status |= UK_NETDEV_STATUS_SUCCESS;
+		status |= (more) ? UK_NETDEV_STATUS_MORE : 0x0;
+	}
+	*cnt = i;
+	return status;
+}
+
 static struct uk_netdev_tx_queue *netfront_txq_setup(struct uk_netdev *n,
 		uint16_t queue_id,
 		uint16_t nb_desc __unused,
@@ -876,6 +976,8 @@ static int netfront_add_dev(struct xenbus_device *xendev)
 	nfdev->max_queue_pairs = 1;
 	nfdev->netdev.tx_one = netfront_xmit;
 	nfdev->netdev.rx_one = netfront_recv;
+	nfdev->netdev.tx_burst = netfront_xmit_burst;
+	nfdev->netdev.rx_burst = netfront_recv_burst;
 	nfdev->netdev.ops = &netfront_ops;
 	rc = uk_netdev_drv_register(&nfdev->netdev, drv_allocator, DRIVER_NAME);
 	if (rc < 0) {
@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: BSD-3-Clause
+#
+# Copyright (c) 2026, The Unikraft Authors.
+#
+# Builds the hashed symbol index that ushell loads to resolve relocations
+# of programs against the kernel image. The input is the output of
+# `nm -n` (`<addr> <type> <name>` per line); the output is a binary
+# little-endian file with the following layout:
+#
+#   struct hdr { char magic[4]; u32 version, nbuckets, nsyms, strsz, pad; }
+#   u32 buckets[nbuckets]   index of the first symbol of each bucket,
+#                           0xffffffff if the bucket is empty
+#   u32 hashes[nsyms]       GNU hash of each symbol, the lowest bit is
+#                           set on the last symbol of a chain; padded
+#                           with zeroes to a multiple of 8 bytes
+#   struct sym { u64 addr; u32 name; u32 pad; } syms[nsyms]
+#   char strtab[strsz]      NUL-terminated symbol names
+#
+# Symbols are sorted by bucket so that every chain is a contiguous run
+# of the hash and symbol arrays.
+
+import argparse
+import struct
+import sys
+
+USHSYM_MAGIC = b'USYM'
+USHSYM_VERSION = 1
+USHSYM_EMPTY = 0xffffffff
+
+# nm types that do not describe an address in the image
+SKIP_TYPES = 'UuwvN'
+
+def gnu_hash(name):
+    h = 5381
+    for c in name.encode():
+        h = (h * 33 + c) & 0xffffffff
+    return h
+
+def parse_nm(lines):
+    syms = {}
+    for line in lines:
+        fields = line.split()
+        if len(fields) == 3:
+            addr, typ, name = fields
+        elif len(fields) == 2:
+            addr, name = fields
+            typ = 't'
+        else:
+            continue
+        if typ in SKIP_TYPES:
+            continue
+        try:
+            addr = int(addr, 16)
+        except ValueError:
+            continue
+        # Keep the first definition, but let a global symbol replace a
+        # local one of the same name
+        prev = syms.get(name)
+        if prev is None or (prev[1].islower() and typ.isupper()):
+            syms[name] = (addr, typ)
+    return [(name, addr) for name, (addr, _) in syms.items()]
+
+def build_index(syms):
+    nsyms = len(syms)
+    nbuckets = max(1, nsyms // 2)
+    hashed = sorted(((gnu_hash(n), n, a) for n, a in syms),
+                    key=lambda s: (s[0] % nbuckets, s[1]))
+
+    buckets = [USHSYM_EMPTY] * nbuckets
+    hashes = []
+    entries = []
+    strtab = bytearray()
+    for i, (h, name, addr) in enumerate(hashed):
+        b = h % nbuckets
+        if buckets[b] == USHSYM_EMPTY:
+            buckets[b] = i
+        last = (i + 1 == nsyms or hashed[i + 1][0] % nbuckets != b)
+        hashes.append((h & ~1) | (1 if last else 0))
+        entries.append(struct.pack('<QII', addr, len(strtab), 0))
+        strtab += name.encode() + b'\0'
+
+    out = bytearray()
+    out += struct.pack('<4sIIIII', USHSYM_MAGIC, USHSYM_VERSION,
+                       nbuckets, nsyms, len(strtab), 0)
+    out += struct.pack('<%dI' % nbuckets, *buckets)
+    out += struct.pack('<%dI' % nsyms, *hashes)
+    out += bytes(-len(out) % 8)
+    out += b''.join(entries)
+    out += strtab
+    return out
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Build a hashed ushell symbol index from nm output')
+    parser.add_argument('-o', '--output', required=True,
+                        help='Output file')
+    parser.add_argument('input', nargs='?', default='-',
+                        help='nm output (default: stdin)')
+    opt = parser.parse_args()
+
+    if opt.input == '-':
+        syms = parse_nm(sys.stdin)
+    else:
+        with open(opt.input, 'r') as f:
+            syms = parse_nm(f)
+
+    with open(opt.output, 'wb') as f:
+        f.write(build_index(syms))
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())